@@ -0,0 +1,3 @@
+-include ../../OBJ.linux.x86_64/lib/liblswsd/lswsd_notify.d # lswsd_notify.o
+-include ../../OBJ.linux.x86_64/lib/liblswsd/lswsd_notifyf.d # lswsd_notifyf.o
+-include ../../OBJ.linux.x86_64/lib/liblswsd/lswsd_watchdog_enabled.d # lswsd_watchdog_enabled.o
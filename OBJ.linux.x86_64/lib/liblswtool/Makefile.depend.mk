@@ -0,0 +1,2 @@
+-include ../../OBJ.linux.x86_64/lib/liblswtool/lswlog.d # lswlog.o
+-include ../../OBJ.linux.x86_64/lib/liblswtool/libreswan_exit.d # libreswan_exit.o
@@ -0,0 +1,232 @@
+-include ../../OBJ.linux.x86_64/lib/libswan/x509dn.d # x509dn.o
+-include ../../OBJ.linux.x86_64/lib/libswan/asn1.d # asn1.o
+-include ../../OBJ.linux.x86_64/lib/libswan/oid.d # oid.o
+-include ../../OBJ.linux.x86_64/lib/libswan/authby.d # authby.o
+-include ../../OBJ.linux.x86_64/lib/libswan/rnd.d # rnd.o
+-include ../../OBJ.linux.x86_64/lib/libswan/auth_names.d # auth_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ddos_mode_names.d # ddos_mode_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/connection_kind_names.d # connection_kind_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/option_names.d # option_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/encap_type_names.d # encap_type_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/encap_mode_names.d # encap_mode_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/encap_proto_names.d # encap_proto_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/initiated_by_names.d # initiated_by_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ocsp_method_names.d # ocsp_method_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/connection_owner_names.d # connection_owner_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/sa_kind_names.d # sa_kind_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/keyword_host_names.d # keyword_host_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/shunt_names.d # shunt_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/global_redirect_names.d # global_redirect_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/send_ca_policy_names.d # send_ca_policy_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/sendcert_policy_names.d # sendcert_policy_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/xauthby_names.d # xauthby_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/xauthfail_names.d # xauthfail_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/fips_mode.d # fips_mode.o
+-include ../../OBJ.linux.x86_64/lib/libswan/fips_mode_names.d # fips_mode_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/state_category_names.d # state_category_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/end_names.d # end_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/terminate_reason_names.d # terminate_reason_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/constants.d # constants.o
+-include ../../OBJ.linux.x86_64/lib/libswan/id.d # id.o
+-include ../../OBJ.linux.x86_64/lib/libswan/lex.d # lex.o
+-include ../../OBJ.linux.x86_64/lib/libswan/sameaddr.d # sameaddr.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttodata.d # ttodata.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttosaid.d # ttosaid.o
+-include ../../OBJ.linux.x86_64/lib/libswan/secitem_chunk.d # secitem_chunk.o
+-include ../../OBJ.linux.x86_64/lib/libswan/lswnss.d # lswnss.o
+-include ../../OBJ.linux.x86_64/lib/libswan/alg_byname.d # alg_byname.o
+-include ../../OBJ.linux.x86_64/lib/libswan/cloexec_socket.d # cloexec_socket.o
+-include ../../OBJ.linux.x86_64/lib/libswan/secret_pubkey_stuff_to_pubkey_der.d # secret_pubkey_stuff_to_pubkey_der.o
+-include ../../OBJ.linux.x86_64/lib/libswan/pubkey_der_to_pubkey_content.d # pubkey_der_to_pubkey_content.o
+-include ../../OBJ.linux.x86_64/lib/libswan/clone_shunk_tokens.d # clone_shunk_tokens.o
+-include ../../OBJ.linux.x86_64/lib/libswan/secrets.d # secrets.o
+-include ../../OBJ.linux.x86_64/lib/libswan/pubkey/pubkey_types.d # pubkey/pubkey_types.o
+-include ../../OBJ.linux.x86_64/lib/libswan/pubkey/pubkey_signer_rsa.d # pubkey/pubkey_signer_rsa.o
+-include ../../OBJ.linux.x86_64/lib/libswan/pubkey/pubkey_signer_ecdsa.d # pubkey/pubkey_signer_ecdsa.o
+-include ../../OBJ.linux.x86_64/lib/libswan/pubkey/pubkey_signer_eddsa.d # pubkey/pubkey_signer_eddsa.o
+-include ../../OBJ.linux.x86_64/lib/libswan/pubkey/pubkey_type_rsa.d # pubkey/pubkey_type_rsa.o
+-include ../../OBJ.linux.x86_64/lib/libswan/pubkey/pubkey_type_ecp.d # pubkey/pubkey_type_ecp.o
+-include ../../OBJ.linux.x86_64/lib/libswan/sparse_names.d # sparse_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttoaddress_dns.d # ttoaddress_dns.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttoaddress_num.d # ttoaddress_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttoaddresses_num.d # ttoaddresses_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttobool.d # ttobool.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttocidr_num.d # ttocidr_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttoips_num.d # ttoips_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttopool_num.d # ttopool_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttopools_num.d # ttopools_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttoport.d # ttoport.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttoprotocol.d # ttoprotocol.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttoprotoport.d # ttoprotoport.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttorange_num.d # ttorange_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttoranges_num.d # ttoranges_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttoselector_num.d # ttoselector_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttoselectors_num.d # ttoselectors_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttosubnet_num.d # ttosubnet_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttosubnets_num.d # ttosubnets_num.o
+-include ../../OBJ.linux.x86_64/lib/libswan/binaryscale-iec-60027-2.d # binaryscale-iec-60027-2.o
+-include ../../OBJ.linux.x86_64/lib/libswan/alloc.d # alloc.o
+-include ../../OBJ.linux.x86_64/lib/libswan/slab.d # slab.o
+-include ../../OBJ.linux.x86_64/lib/libswan/alloc_printf.d # alloc_printf.o
+-include ../../OBJ.linux.x86_64/lib/libswan/pem.d # pem.o
+-include ../../OBJ.linux.x86_64/lib/libswan/diag.d # diag.o
+-include ../../OBJ.linux.x86_64/lib/libswan/passert.d # passert.o
+-include ../../OBJ.linux.x86_64/lib/libswan/pexpect.d # pexpect.o
+-include ../../OBJ.linux.x86_64/lib/libswan/nss_cert_load.d # nss_cert_load.o
+-include ../../OBJ.linux.x86_64/lib/libswan/certs.d # certs.o
+-include ../../OBJ.linux.x86_64/lib/libswan/reqid.d # reqid.o
+-include ../../OBJ.linux.x86_64/lib/libswan/keyid.d # keyid.o
+-include ../../OBJ.linux.x86_64/lib/libswan/kernel_mode.d # kernel_mode.o
+-include ../../OBJ.linux.x86_64/lib/libswan/kernel_netlink_reply.d # kernel_netlink_reply.o
+-include ../../OBJ.linux.x86_64/lib/libswan/kernel_netlink_query.d # kernel_netlink_query.o
+-include ../../OBJ.linux.x86_64/lib/libswan/linux_netlink.d # linux_netlink.o
+-include ../../OBJ.linux.x86_64/lib/libswan/netlink_attrib.d # netlink_attrib.o
+-include ../../OBJ.linux.x86_64/lib/libswan/defaultroute_linux.d # defaultroute_linux.o
+-include ../../OBJ.linux.x86_64/lib/libswan/log_ip.d # log_ip.o
+-include ../../OBJ.linux.x86_64/lib/libswan/fd.d # fd.o
+-include ../../OBJ.linux.x86_64/lib/libswan/message_role.d # message_role.o
+-include ../../OBJ.linux.x86_64/lib/libswan/sa_role.d # sa_role.o
+-include ../../OBJ.linux.x86_64/lib/libswan/datatot.d # datatot.o
+-include ../../OBJ.linux.x86_64/lib/libswan/vendorid.d # vendorid.o
+-include ../../OBJ.linux.x86_64/lib/libswan/proposals.d # proposals.o
+-include ../../OBJ.linux.x86_64/lib/libswan/proposal_transform_names.d # proposal_transform_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/v1_proposals.d # v1_proposals.o
+-include ../../OBJ.linux.x86_64/lib/libswan/v2_proposals.d # v2_proposals.o
+-include ../../OBJ.linux.x86_64/lib/libswan/esp_info.d # esp_info.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ah_info.d # ah_info.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_info.d # ike_info.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ckaid.d # ckaid.o
+-include ../../OBJ.linux.x86_64/lib/libswan/chunk.d # chunk.o
+-include ../../OBJ.linux.x86_64/lib/libswan/shunk.d # shunk.o
+-include ../../OBJ.linux.x86_64/lib/libswan/hunk.d # hunk.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_address.d # ip_address.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_base.d # ip_base.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_bytes.d # ip_bytes.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_cidr.d # ip_cidr.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_encap.d # ip_encap.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_endpoint.d # ip_endpoint.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_info.d # ip_info.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_packet.d # ip_packet.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_port.d # ip_port.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_port_range.d # ip_port_range.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_protocol.d # ip_protocol.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_protoport.d # ip_protoport.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_range.d # ip_range.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_pool.d # ip_pool.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_said.d # ip_said.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_selector.d # ip_selector.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_sockaddr.d # ip_sockaddr.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ip_subnet.d # ip_subnet.o
+-include ../../OBJ.linux.x86_64/lib/libswan/lmod.d # lmod.o
+-include ../../OBJ.linux.x86_64/lib/libswan/lset.d # lset.o
+-include ../../OBJ.linux.x86_64/lib/libswan/scale.d # scale.o
+-include ../../OBJ.linux.x86_64/lib/libswan/timescale.d # timescale.o
+-include ../../OBJ.linux.x86_64/lib/libswan/deltatime.d # deltatime.o
+-include ../../OBJ.linux.x86_64/lib/libswan/realtime.d # realtime.o
+-include ../../OBJ.linux.x86_64/lib/libswan/monotime.d # monotime.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttodeltatime.d # ttodeltatime.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ttorealtime.d # ttorealtime.o
+-include ../../OBJ.linux.x86_64/lib/libswan/refcnt.d # refcnt.o
+-include ../../OBJ.linux.x86_64/lib/libswan/debug.d # debug.o
+-include ../../OBJ.linux.x86_64/lib/libswan/impair.d # impair.o
+-include ../../OBJ.linux.x86_64/lib/libswan/cur_debugging.d # cur_debugging.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ldbg.d # ldbg.o
+-include ../../OBJ.linux.x86_64/lib/libswan/cur_debugging.d # cur_debugging.o
+-include ../../OBJ.linux.x86_64/lib/libswan/llog_base64_bytes.d # llog_base64_bytes.o
+-include ../../OBJ.linux.x86_64/lib/libswan/llog_pem_bytes.d # llog_pem_bytes.o
+-include ../../OBJ.linux.x86_64/lib/libswan/log_errno.d # log_errno.o
+-include ../../OBJ.linux.x86_64/lib/libswan/fatal.d # fatal.o
+-include ../../OBJ.linux.x86_64/lib/libswan/bad_enum_where.d # bad_enum_where.o
+-include ../../OBJ.linux.x86_64/lib/libswan/bad_case_where.d # bad_case_where.o
+-include ../../OBJ.linux.x86_64/lib/libswan/bad_sparse_where.d # bad_sparse_where.o
+-include ../../OBJ.linux.x86_64/lib/libswan/lswglob.d # lswglob.o
+-include ../../OBJ.linux.x86_64/lib/libswan/optarg.d # optarg.o
+-include ../../OBJ.linux.x86_64/lib/libswan/global_logger.d # global_logger.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jambuf.d # jambuf.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_humber.d # jam_humber.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_bytes.d # jam_bytes.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_base64_bytes.d # jam_base64_bytes.o
+-include ../../OBJ.linux.x86_64/lib/libswan/llog.d # llog.o
+-include ../../OBJ.linux.x86_64/lib/libswan/llog_dump.d # llog_dump.o
+-include ../../OBJ.linux.x86_64/lib/libswan/llog_va_list.d # llog_va_list.o
+-include ../../OBJ.linux.x86_64/lib/libswan/log_nss_error.d # log_nss_error.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_logger.d # jam_logger.o
+-include ../../OBJ.linux.x86_64/lib/libswan/logjam.d # logjam.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_nss_cka.d # jam_nss_cka.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_nss_ckg.d # jam_nss_ckg.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_nss_ckf.d # jam_nss_ckf.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_nss_ckm.d # jam_nss_ckm.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_nss_error.d # jam_nss_error.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_nss_oid.d # jam_nss_oid.o
+-include ../../OBJ.linux.x86_64/lib/libswan/jam_nss_secitem.d # jam_nss_secitem.o
+-include ../../OBJ.linux.x86_64/lib/libswan/test_buffer.d # test_buffer.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg.d # ike_alg.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_hash_identity.d # ike_alg_hash_identity.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_ipcomp.d # ike_alg_ipcomp.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_sn.d # ike_alg_sn.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_test.d # ike_alg_test.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_hash_nss_ops.d # ike_alg_hash_nss_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_kem.d # ike_alg_kem.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_kem_ecp_nss_ops.d # ike_alg_kem_ecp_nss_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_kem_modp_nss_ops.d # ike_alg_kem_modp_nss_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_prf_mac_hmac_ops.d # ike_alg_prf_mac_hmac_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_prf_mac_nss_ops.d # ike_alg_prf_mac_nss_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_prf_mac_xcbc_ops.d # ike_alg_prf_mac_xcbc_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_prf_ikev1_mac_ops.d # ike_alg_prf_ikev1_mac_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_prf_ikev2_mac_ops.d # ike_alg_prf_ikev2_mac_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_prf_ikev1_nss_ops.d # ike_alg_prf_ikev1_nss_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_prf_ikev2_nss_ops.d # ike_alg_prf_ikev2_nss_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_encrypt_null_ops.d # ike_alg_encrypt_null_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_encrypt_chacha20_poly1305.d # ike_alg_encrypt_chacha20_poly1305.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_encrypt_nss_aead_ops.d # ike_alg_encrypt_nss_aead_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_encrypt_nss_cbc_ops.d # ike_alg_encrypt_nss_cbc_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_encrypt_nss_ctr_ops.d # ike_alg_encrypt_nss_ctr_ops.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_desc.d # ike_alg_desc.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_3des.d # ike_alg_3des.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_aes.d # ike_alg_aes.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_camellia.d # ike_alg_camellia.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_hash_md5.d # ike_alg_hash_md5.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_md5.d # ike_alg_md5.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_none.d # ike_alg_none.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_hash_sha1.d # ike_alg_hash_sha1.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_sha1.d # ike_alg_sha1.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_hash_sha2_256.d # ike_alg_hash_sha2_256.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_sha2.d # ike_alg_sha2.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_encrypt_cbc_test_vectors.d # ike_alg_encrypt_cbc_test_vectors.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_encrypt_ctr_test_vectors.d # ike_alg_encrypt_ctr_test_vectors.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_encrypt_gcm_test_vectors.d # ike_alg_encrypt_gcm_test_vectors.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ike_alg_prf_test_vectors.d # ike_alg_prf_test_vectors.o
+-include ../../OBJ.linux.x86_64/lib/libswan/crypt_cipher.d # crypt_cipher.o
+-include ../../OBJ.linux.x86_64/lib/libswan/crypt_hash.d # crypt_hash.o
+-include ../../OBJ.linux.x86_64/lib/libswan/crypt_mac.d # crypt_mac.o
+-include ../../OBJ.linux.x86_64/lib/libswan/crypt_prf.d # crypt_prf.o
+-include ../../OBJ.linux.x86_64/lib/libswan/crypt_symkey.d # crypt_symkey.o
+-include ../../OBJ.linux.x86_64/lib/libswan/crypt_kem.d # crypt_kem.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ikev1_prf.d # ikev1_prf.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ikev2_prf.d # ikev2_prf.o
+-include ../../OBJ.linux.x86_64/lib/libswan/names.d # names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/enum_names.d # enum_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/pluto_exit_code_names.d # pluto_exit_code_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipseckey_algorithm_type_names.d # ipseckey_algorithm_type_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipseckey_algorithm_config_names.d # ipseckey_algorithm_config_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/xfrm_policy_names.d # xfrm_policy_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/autostart_names.d # autostart_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/seccomp_mode_names.d # seccomp_mode_names.o
+-include ../../OBJ.linux.x86_64/lib/libswan/whack/pickle.d # whack/pickle.o
+-include ../../OBJ.linux.x86_64/lib/libswan/whack/send.d # whack/send.o
+-include ../../OBJ.linux.x86_64/lib/libswan/whack/aliascomp.d # whack/aliascomp.o
+-include ../../OBJ.linux.x86_64/lib/libswan/whack/whack_magic.d # whack/whack_magic.o
+-include ../../OBJ.linux.x86_64/lib/libswan/whack/init_whack_message.d # whack/init_whack_message.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipsecconf/confcache.d # ipsecconf/confcache.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipsecconf/config_conn.d # ipsecconf/config_conn.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipsecconf/config_setup.d # ipsecconf/config_setup.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipsecconf/confread.d # ipsecconf/confread.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipsecconf/confwrite.d # ipsecconf/confwrite.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipsecconf/interfaces.d # ipsecconf/interfaces.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipsecconf/keywords.d # ipsecconf/keywords.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipsecconf/starterwhack.d # ipsecconf/starterwhack.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipsecconf/scanner.d # ipsecconf/scanner.o
+-include ../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.d # ipsecconf/parser.tab.o
+-include ../../OBJ.linux.x86_64/lib/libswan/version.d # version.o
+-include ../../OBJ.linux.x86_64/lib/libswan/enum_names_checklist.d # enum_names_checklist.o
+-include ../../OBJ.linux.x86_64/lib/libswan/enum_enum_names_checklist.d # enum_enum_names_checklist.o
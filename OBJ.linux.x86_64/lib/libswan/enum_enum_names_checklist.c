@@ -0,0 +1,28 @@
+/* enum name checklist, for libreswan
+ *
+ * Copyright (C) 2023-2024  Andrew Cagney
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#include "constants.h" /* for typedef ${names} */
+#include "enum_names.h"
+
+#include "ietf_constants.h"
+#include "names_constant.h"
+
+const struct enum_enum_names_check enum_enum_names_checklist[] = {
+  { "exchange_type_names", &exchange_type_names, },
+  { "ikev1_ipsec_attr_value_names", &ikev1_ipsec_attr_value_names, },
+  { "ikev1_oakley_attr_value_names", &ikev1_oakley_attr_value_names, },
+  { "payload_type_names", &payload_type_names, },
+  { NULL, NULL, }
+};
@@ -0,0 +1,2222 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "ipsecconf/parser.y"
+   /* -*- bison-mode -*- */
+/* Libreswan config file parser (parser.y)
+ * Copyright (C) 2001 Mathieu Lafon - Arkoon Network Security
+ * Copyright (C) 2004 Michael Richardson <mcr@sandelman.ottawa.on.ca>
+ * Copyright (C) 2013 Paul Wouters <pwouters@redhat.com>
+ * Copyright (C) 2013 Philippe Vouters <Philippe.Vouters@laposte.net>
+ * Copyright (C) 2013 Antony Antony <antony@phenome.org>
+ * Copyright (C) 2013 D. Hugh Redelmeier <hugh@mimosa.com>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include <unistd.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+#define YYDEBUG 1
+
+#include "deltatime.h"
+#include "timescale.h"
+#include "binaryscale-iec-60027-2.h"
+
+#include "ipsecconf/keywords.h"
+#include "ipsecconf/parser.h"	/* includes parser.tab.h" */
+#include "ipsecconf/scanner.h"
+#include "ipsecconf/confread.h"
+#include "lswlog.h"
+#include "lmod.h"
+#include "sparse_names.h"
+#include "lswalloc.h"
+#include "lswglob.h"
+
+#define YYERROR_VERBOSE
+#define ERRSTRING_LEN	256
+
+static void parser_key_value_warning(struct parser *parser,
+				     const struct ipsec_conf_keyval *key,
+				     shunk_t value,
+				     const char *s, ...) PRINTF_LIKE(4);
+
+void parse_keyval(struct parser *parser, enum end default_end,
+		  shunk_t key, shunk_t value);
+
+static void yyerror(struct parser *parser, const char *msg);
+
+static void append_parser_key_value(struct parser *parser,
+				    struct ipsec_conf_keyval *key,
+				    shunk_t value,
+				    uintmax_t number,
+				    deltatime_t deltatime);
+
+static void add_parser_key_value(struct parser *parser,
+				 struct ipsec_conf_keyval *key,
+				 shunk_t value,
+				 uintmax_t number,
+				 deltatime_t time);
+
+/**
+ * Functions
+ */
+
+
+#line 148 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "parser.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_EQUAL = 3,                      /* EQUAL  */
+  YYSYMBOL_FIRST_SPACES = 4,               /* FIRST_SPACES  */
+  YYSYMBOL_EOL = 5,                        /* EOL  */
+  YYSYMBOL_CONFIG = 6,                     /* CONFIG  */
+  YYSYMBOL_SETUP = 7,                      /* SETUP  */
+  YYSYMBOL_CONN = 8,                       /* CONN  */
+  YYSYMBOL_INCLUDE = 9,                    /* INCLUDE  */
+  YYSYMBOL_VERSION = 10,                   /* VERSION  */
+  YYSYMBOL_STRING = 11,                    /* STRING  */
+  YYSYMBOL_KEYWORD = 12,                   /* KEYWORD  */
+  YYSYMBOL_COMMENT = 13,                   /* COMMENT  */
+  YYSYMBOL_YYACCEPT = 14,                  /* $accept  */
+  YYSYMBOL_config_file = 15,               /* config_file  */
+  YYSYMBOL_versionstmt = 16,               /* versionstmt  */
+  YYSYMBOL_blanklines = 17,                /* blanklines  */
+  YYSYMBOL_sections = 18,                  /* sections  */
+  YYSYMBOL_section_or_include = 19,        /* section_or_include  */
+  YYSYMBOL_20_1 = 20,                      /* $@1  */
+  YYSYMBOL_21_2 = 21,                      /* $@2  */
+  YYSYMBOL_kw_sections = 22,               /* kw_sections  */
+  YYSYMBOL_kw_section = 23,                /* kw_section  */
+  YYSYMBOL_statement_kw = 24               /* statement_kw  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  3
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   29
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  14
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  11
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  23
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  38
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   268
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_uint8 yyrline[] =
+{
+       0,    93,    93,    98,    99,   105,   106,   109,   110,   114,
+     114,   119,   119,   138,   145,   146,   149,   150,   153,   167,
+     175,   181,   187,   192
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "EQUAL",
+  "FIRST_SPACES", "EOL", "CONFIG", "SETUP", "CONN", "INCLUDE", "VERSION",
+  "STRING", "KEYWORD", "COMMENT", "$accept", "config_file", "versionstmt",
+  "blanklines", "sections", "section_or_include", "$@1", "$@2",
+  "kw_sections", "kw_section", "statement_kw", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-13)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int8 yypact[] =
+{
+     -13,     4,    -4,   -13,   -13,    -6,   -13,     5,     6,   -13,
+       9,     7,     8,   -13,    12,    15,    16,    17,    12,   -13,
+     -13,   -13,   -13,   -13,    19,    19,    -5,   -13,   -13,    21,
+      22,    23,    -9,    18,   -13,   -13,   -13,   -13
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       5,     0,     3,     1,     6,     0,     7,     0,     2,     5,
+       0,     0,     0,     5,     4,     0,     0,     0,     8,     9,
+      11,    13,    14,    14,    10,    12,     0,    15,    17,     0,
+      23,     0,    20,    22,    16,    19,    18,    21
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
+{
+     -13,   -13,   -13,     0,   -13,   -13,   -13,   -13,   -12,   -13,
+     -13
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,     1,     6,     2,     8,    13,    22,    23,    24,    27,
+      31
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int8 yytable[] =
+{
+      28,     4,    35,    36,     3,     7,     5,    29,    30,    14,
+       9,    25,    10,    18,    11,    12,    15,     4,    16,    17,
+      19,    20,    21,    26,    32,    33,     0,     0,    34,    37
+};
+
+static const yytype_int8 yycheck[] =
+{
+       5,     5,    11,    12,     0,    11,    10,    12,    13,     9,
+       5,    23,     6,    13,     8,     9,     7,     5,    11,    11,
+       5,     5,     5,     4,     3,     3,    -1,    -1,     5,    11
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,    15,    17,     0,     5,    10,    16,    11,    18,     5,
+       6,     8,     9,    19,    17,     7,    11,    11,    17,     5,
+       5,     5,    20,    21,    22,    22,     4,    23,     5,    12,
+      13,    24,     3,     3,     5,    11,    12,    11
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    14,    15,    16,    16,    17,    17,    18,    18,    20,
+      19,    21,    19,    19,    22,    22,    23,    23,    24,    24,
+      24,    24,    24,    24
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     3,     0,     4,     0,     2,     0,     3,     0,
+       5,     0,     5,     3,     0,     2,     3,     2,     3,     3,
+       2,     3,     2,     1
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (parser, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, parser); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, struct parser *parser)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (parser);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, struct parser *parser)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep, parser);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, struct parser *parser)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], parser);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, parser); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, struct parser *parser)
+{
+  YY_USE (yyvaluep);
+  YY_USE (parser);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (struct parser *parser)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (parser);
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 4: /* versionstmt: VERSION STRING EOL blanklines  */
+#line 99 "ipsecconf/parser.y"
+                                        {
+		/* free strings allocated by lexer */
+		pfreeany((yyvsp[-2].s));
+	}
+#line 1175 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+    break;
+
+  case 9: /* $@1: %empty  */
+#line 114 "ipsecconf/parser.y"
+                         {
+		parser->keyvals = &parser->cfg->config_setup;
+		parser->section = SECTION_CONFIG_SETUP;
+		ldbg(parser->logger, "reading config setup");
+	}
+#line 1185 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+    break;
+
+  case 11: /* $@2: %empty  */
+#line 119 "ipsecconf/parser.y"
+                          {
+		struct section_list *section = alloc_thing(struct section_list, "section list");
+		PASSERT(parser->logger, section != NULL);
+
+		section->name = clone_str((yyvsp[-1].s), "section->name");
+		TAILQ_INIT(&section->keyvals);
+		TAILQ_INSERT_TAIL(&parser->cfg->sections, section, next);
+
+		/* setup keyword section to record values */
+		parser->keyvals = &section->keyvals;
+		parser->section = (streq(section->name, "%default") ? SECTION_CONN_DEFAULT :
+				   SECTION_CONN);
+
+		ldbg(parser->logger, "reading conn %s", section->name);
+
+		/* free strings allocated by lexer */
+		pfreeany((yyvsp[-1].s));
+
+	}
+#line 1209 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+    break;
+
+  case 13: /* section_or_include: INCLUDE STRING EOL  */
+#line 138 "ipsecconf/parser.y"
+                             {
+		scanner_include((yyvsp[-1].s), parser);
+		/* free strings allocated by lexer */
+		pfreeany((yyvsp[-1].s))
+	}
+#line 1219 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+    break;
+
+  case 18: /* statement_kw: KEYWORD EQUAL KEYWORD  */
+#line 153 "ipsecconf/parser.y"
+                              {
+		/*
+		 * Because the third argument was also a keyword, we
+		 * dig up the string representation.
+		 *
+		 * There should be a way to stop the lexer converting
+		 * the third field into a keyword.
+		 */
+		char *key = (yyvsp[-2].s); /* must free? */
+		char *value = (yyvsp[0].s); /* must free */
+		parse_keyval(parser, END_ROOF, shunk1(key), shunk1(value));
+		pfreeany(key);
+		pfreeany(value);
+	}
+#line 1238 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+    break;
+
+  case 19: /* statement_kw: KEYWORD EQUAL STRING  */
+#line 167 "ipsecconf/parser.y"
+                               {
+		char *key = (yyvsp[-2].s);
+		char *value = (yyvsp[0].s);
+		parse_keyval(parser, END_ROOF, shunk1(key), shunk1(value));
+		/* free strings allocated by lexer */
+		pfreeany(key);
+		pfreeany(value);
+	}
+#line 1251 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+    break;
+
+  case 20: /* statement_kw: KEYWORD EQUAL  */
+#line 175 "ipsecconf/parser.y"
+                        {
+		char *key = (yyvsp[-1].s);
+		parse_keyval(parser, END_ROOF, shunk1(key), shunk1(""));
+		pfreeany(key);
+	}
+#line 1261 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+    break;
+
+  case 21: /* statement_kw: COMMENT EQUAL STRING  */
+#line 181 "ipsecconf/parser.y"
+                               {
+		parser_warning(parser, 0/*error*/, "X- style comment ignored: %s=%s", (yyvsp[-2].s), (yyvsp[0].s));
+		/* free strings allocated by lexer */
+		pfreeany((yyvsp[-2].s));
+		pfreeany((yyvsp[0].s));
+	}
+#line 1272 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+    break;
+
+  case 22: /* statement_kw: COMMENT EQUAL  */
+#line 187 "ipsecconf/parser.y"
+                        {
+		parser_warning(parser, 0/*error*/, "X- style comment ignored: %s=", (yyvsp[-1].s));
+		/* free strings allocated by lexer */
+		pfreeany((yyvsp[-1].s));
+	}
+#line 1282 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+    break;
+
+  case 23: /* statement_kw: COMMENT  */
+#line 192 "ipsecconf/parser.y"
+                  {
+		parser_warning(parser, 0/*error*/, "X- style comment ignored: %s", (yyvsp[0].s));
+		/* free strings allocated by lexer */
+		pfreeany((yyvsp[0].s));
+	}
+#line 1292 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+    break;
+
+
+#line 1296 "../../OBJ.linux.x86_64/lib/libswan/ipsecconf/parser.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (parser, YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, parser);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, parser);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (parser, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, parser);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, parser);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 198 "ipsecconf/parser.y"
+
+
+void parser_warning(struct parser *parser, int error, const char *s, ...)
+{
+	if (parser->stream.warning != NO_STREAM) {
+		LLOG_JAMBUF(parser->stream.warning, parser->logger, buf) {
+			jam_scanner_file_line(buf, parser);
+			va_list ap;
+			va_start(ap, s);
+			jam_va_list(buf, s, ap);
+			va_end(ap);
+			if (error > 0) {
+				jam_errno(buf, error);
+			}
+		}
+	}
+}
+
+void parser_fatal(struct parser *parser, int error, const char *s, ...)
+{
+	LLOG_FATAL_JAMBUF(PLUTO_EXIT_FAIL, parser->logger, buf) {
+		jam_scanner_file_line(buf, parser);
+		va_list ap;
+		va_start(ap, s);
+		jam_va_list(buf, s, ap);
+		va_end(ap);
+		if (error > 0) {
+			jam_errno(buf, error);
+		}
+        }
+	abort(); /* gcc doesn't believe above always exits */
+}
+
+static const char *leftright(const struct ipsec_conf_keyval *keyval)
+{
+	if (keyval->left && !keyval->right) {
+		return "left";
+	}
+	if (!keyval->left && keyval->right) {
+		return "right";
+	}
+	return "";
+}
+
+/*
+ * Note: VALUE hasn't yet been copied into KEY.
+ */
+
+void parser_key_value_warning(struct parser *parser,
+			      const struct ipsec_conf_keyval *key,
+			      shunk_t value,
+			      const char *s, ...)
+{
+	if (parser->stream.warning != NO_STREAM) {
+		LLOG_JAMBUF(parser->stream.warning, parser->logger, buf) {
+			jam(buf, PRI_KEYVAL_SAL": ", pri_keyval_sal(key));
+			/* message */
+			va_list ap;
+			va_start(ap, s);
+			jam_va_list(buf, s, ap);
+			va_end(ap);
+			/* what was specified */
+			jam_string(buf, ": ");
+			jam_string(buf, leftright(key));
+			jam_string(buf, key->key->keyname);
+			jam_string(buf, "=");
+			jam_shunk(buf, value);
+		}
+	}
+}
+
+void yyerror(struct parser *parser, const char *s)
+{
+	if (parser->stream.error != NO_STREAM) {
+		LLOG_JAMBUF(parser->stream.error, parser->logger, buf) {
+			jam_scanner_file_line(buf, parser);
+			jam_string(buf, s);
+		}
+	}
+}
+
+struct ipsec_conf *alloc_ipsec_conf(void)
+{
+	struct ipsec_conf *cfgp = alloc_thing(struct ipsec_conf, __func__);
+	TAILQ_INIT(&cfgp->config_setup);
+	TAILQ_INIT(&cfgp->sections);
+	TAILQ_INIT(&cfgp->sources);
+	TAILQ_INIT(&cfgp->include_dirs);
+	return cfgp;
+}
+
+bool ipsec_conf_add_file(struct ipsec_conf *ipsec_conf,
+			 const char *file,
+			 struct logger *logger,
+			 unsigned verbosity)
+{
+	struct parser parser = {
+		.logger = logger,
+		.stream.warning = WARNING_STREAM,
+		.stream.error = ERROR_STREAM,
+		.verbosity = verbosity,
+		.cfg = ipsec_conf,
+	};
+
+	if (!scanner_open(&parser, file)) {
+		return false;
+	}
+
+	if (yyparse(&parser) != 0) {
+		/* suppress errors and warnings */
+		enum stream stream =  (LDBGP(DBG_BASE, logger) ? DEBUG_STREAM : NO_STREAM);
+		parser.stream.warning = stream;
+		parser.stream.error = stream;
+		do {} while (yyparse(&parser) != 0);
+		scanner_close(&parser);
+		return false;
+	}
+
+	scanner_close(&parser);
+
+	/**
+	 * Config valid
+	 */
+	return true;
+}
+
+bool ipsec_conf_add_argv_conn(struct ipsec_conf *ipsec_conf,
+			      const char *name,
+			      char *argv[], int start,
+			      struct logger *logger)
+{
+	struct parser parser = {
+		.cfg = ipsec_conf,
+		.logger = logger,
+		.setuponly = false,
+	};
+
+	/*
+	 * There's only section and it's a conn; fudge things up so
+	 * that processing just started.
+	 */
+
+	struct section_list *section = alloc_thing(struct section_list, __func__);
+	section->name = clone_str(name, __func__);
+	TAILQ_INIT(&section->keyvals);
+	TAILQ_INSERT_TAIL(&parser.cfg->sections, section, next);
+
+	parser.section = SECTION_CONN;
+	parser.keyvals = &section->keyvals,
+
+	scanner_init(&parser, "argv", start);
+
+	/* for options that should have an end, but don't */
+	enum end default_end = LEFT_END;
+
+	for (char **argp = argv + start; (*argp) != NULL; argp++) {
+
+		const char *const arg = (*argp);
+		shunk_t cursor = shunk1(arg);
+
+		/* only whack options have -- */
+		bool whack = hunk_streat(&cursor, "--");
+
+		/*
+		 * Parse simple whack --OPTIONs (remember leading "--"
+		 * indicating a whack option was stripped and WHACK
+		 * set).
+		 */
+
+		if (whack && hunk_streq(cursor, "to")) {
+			default_end++;
+			if (default_end >= END_ROOF) {
+				llog(ERROR_STREAM, logger, "too many '--to's");
+				pfree_ipsec_conf(&parser.cfg);
+				exit(1);
+			}
+			scanner_next_line(&parser);
+			continue;
+		}
+
+		if (whack && hunk_streat(&cursor, "nego")) {
+			parse_keyval(&parser, default_end,
+				     shunk1("negotiationshunt"),
+				     cursor);
+			scanner_next_line(&parser);
+			continue;
+		}
+
+		if (whack && hunk_streat(&cursor, "fail")) {
+			parse_keyval(&parser, default_end,
+				     shunk1("failureshunt"),
+				     cursor);
+			scanner_next_line(&parser);
+			continue;
+		}
+
+		/*
+		 * Parse KEY=VALUE (and --KEY=VALUE).  When whack,
+		 * also allow --KEY VALUE.
+		 */
+
+		char sep;
+		shunk_t key = shunk_token(&cursor, &sep, "=");
+		shunk_t value;
+		if (sep == '=') {
+			value = cursor;
+		} else if (whack) {
+			/* only allow --KEY VALUE when whack compat */
+			if (argp[1] == NULL) {
+				llog(ERROR_STREAM, logger, "missing argument for %s", arg);
+				return false;
+			}
+			/* skip/use next arg */
+			argp++;
+			value = shunk1(*argp);
+			scanner_next_line(&parser);
+		} else {
+			llog(ERROR_STREAM, logger, "missing '=' in %s", arg);
+			pfree_ipsec_conf(&parser.cfg);
+			exit(1);
+		}
+
+		/*
+		 * Handle whack --KEY=VALUE options by mapping the KEY
+		 * onto the equivalent ipsec.conf KEY.
+		 */
+
+		if (whack && hunk_streq(key, "host")) {
+			key = shunk1(default_end == LEFT_END ? "left" :
+				     default_end == RIGHT_END ? "right" :
+				     "???");
+		}
+
+		if (whack && hunk_streq(key, "authby")) {
+			/* XXX: whack's authby semantics */
+			key = shunk1("auth");
+		}
+
+		parse_keyval(&parser, default_end, key, value);
+		scanner_next_line(&parser);
+	}
+
+	scanner_close(&parser);
+	return true;
+}
+
+static void pfree_keyval_list(struct keyval_list *list)
+{
+	struct keyval_entry *head;
+	while ((head = TAILQ_FIRST(list)) != NULL) {
+		TAILQ_REMOVE(list, head, next);
+		pfreeany(head->keyval.val);
+		pfree(head);
+	}
+}
+
+const char *add_ipsec_conf_source(struct ipsec_conf *cfg, const char *name)
+{
+	struct ipsec_conf_source *source = alloc_thing(struct ipsec_conf_source, __func__);
+	source->name = clone_str(name, __func__);
+	TAILQ_INSERT_TAIL(&cfg->sources, source, next);
+	return source->name;
+}
+
+static void add_include_dir(struct ipsec_conf *cfg, const char *dir)
+{
+	struct ipsec_conf_source *source;
+	TAILQ_FOREACH(source, &cfg->include_dirs, next) {
+		if (streq(source->name, dir)) {
+			return;
+		}
+	}
+
+	source = alloc_thing(struct ipsec_conf_source, __func__);
+	source->name = clone_str(dir, __func__);
+	TAILQ_INSERT_TAIL(&cfg->include_dirs, source, next);
+}
+
+struct lswglob_context {
+	struct ipsec_conf *cfg;
+};
+
+static void include_dir_callback(unsigned count, char **dirs,
+				 struct lswglob_context *context,
+				 struct logger *logger UNUSED)
+{
+	for (unsigned i = 0; i < count; i++) {
+		struct stat st;
+		if (stat(dirs[i], &st) == 0 && S_ISDIR(st.st_mode)) {
+			add_include_dir(context->cfg, dirs[i]);
+		}
+	}
+}
+
+/*
+ * Record the directories that the include PATTERN is globbed in so
+ * that a file appearing there can be noticed.  Like
+ * scanner_include(), a relative pattern is resolved against the
+ * current directory (recorded as an absolute path), and a directory
+ * part containing wildcards is itself globbed (and its parent
+ * recorded).
+ */
+
+void add_ipsec_conf_include_dir(struct ipsec_conf *cfg, const char *pattern,
+				struct logger *logger)
+{
+	const char *slash = strrchr(pattern, '/');
+	char *dir = (slash == NULL ? clone_str(".", __func__) :
+		     slash == pattern ? clone_str("/", __func__) :
+		     clone_bytes(pattern, slash - pattern + 1, __func__));
+	if (slash != NULL && slash != pattern) {
+		dir[slash - pattern] = '\0';
+	}
+
+	if (dir[0] != '/') {
+		char cwd[PATH_MAX];
+		if (getcwd(cwd, sizeof(cwd)) == NULL) {
+			llog_errno(RC_LOG, logger, errno,
+				   "include directory '%s' not recorded, getcwd() failed: ", dir);
+			pfree(dir);
+			return;
+		}
+		char *abs = (streq(dir, ".") ? clone_str(cwd, __func__) :
+			     alloc_printf("%s/%s", cwd, dir));
+		pfree(dir);
+		dir = abs;
+	}
+
+	if (strpbrk(dir, "*?[") == NULL) {
+		add_include_dir(cfg, dir);
+		pfree(dir);
+		return;
+	}
+
+	/* e.g., /etc/ipsec.d/<asterisk>/ipsec.conf */
+	add_ipsec_conf_include_dir(cfg, dir, logger);
+	struct lswglob_context context = {
+		.cfg = cfg,
+	};
+	lswglob(dir, "ipsec.conf", include_dir_callback, &context, logger);
+	pfree(dir);
+}
+
+static void pfree_ipsec_conf_sources(struct ipsec_conf_sources *sources)
+{
+	/* keep deleting the first entry */
+	struct ipsec_conf_source *source;
+	while ((source = TAILQ_FIRST(sources)) != NULL) {
+		TAILQ_REMOVE(sources, source, next);
+		pfreeany(source->name);
+		pfreeany(source);
+	}
+}
+
+void pfree_ipsec_conf(struct ipsec_conf **cfgp)
+{
+	if ((*cfgp) != NULL) {
+		struct ipsec_conf *cfg = (*cfgp);
+		pfree_keyval_list(&cfg->config_setup);
+
+		/* keep deleting the first entry */
+		struct section_list *section;
+		while ((section = TAILQ_FIRST(&cfg->sections)) != NULL) {
+			TAILQ_REMOVE(&cfg->sections, section, next);
+			pfreeany(section->name);
+			pfree_keyval_list(&section->keyvals);
+			pfree(section);
+		}
+
+		pfree_ipsec_conf_sources(&cfg->sources);
+		pfree_ipsec_conf_sources(&cfg->include_dirs);
+
+		pfreeany(*cfgp);
+	}
+}
+
+void add_parser_key_value(struct parser *parser,
+			  struct ipsec_conf_keyval *key,
+			  shunk_t value,
+			  uintmax_t number,
+			  deltatime_t deltatime)
+{
+	/* both means no prefix */
+	const char *section = str_parser_section(parser);
+
+	/* Find end, while looking for duplicates. */
+	struct keyval_entry *kv;
+	TAILQ_FOREACH(kv, parser->keyvals, next) {
+		if (kv->keyval.key != key->key) {
+			continue;
+		}
+		if ((kv->keyval.left != key->left) &&
+		    (kv->keyval.right != key->right)) {
+			continue;
+		}
+		if (key->key->validity & kv_duplicateok) {
+			continue;
+		}
+		/* note the weird behaviour! */
+		if (parser->section == SECTION_CONFIG_SETUP) {
+			parser_key_value_warning(parser, key, value,
+						 "overriding earlier '%s' keyword with new value", section);
+			pfreeany(kv->keyval.val);
+			kv->keyval.val = clone_hunk_as_string(&value, "keyword.string"); /*handles NULL*/
+			kv->number = number;
+			kv->deltatime = deltatime;
+			return;
+		}
+		parser_key_value_warning(parser, key, value,
+					 "ignoring duplicate %s keyword", section);
+		return;
+	}
+
+	append_parser_key_value(parser, key, value, number, deltatime);
+}
+
+static void append_parser_key_value(struct parser *parser,
+				    struct ipsec_conf_keyval *key,
+				    shunk_t value,
+				    uintmax_t number,
+				    deltatime_t deltatime)
+{
+	/*
+	 * fill the values into new
+	 * (either string or number might have a placeholder value
+	 */
+	struct keyval_entry *new = alloc_thing(struct keyval_entry, "kw_list");
+	(*new) = (struct keyval_entry) {
+		.keyval = *key,
+		.number = number,
+		.deltatime = deltatime,
+	};
+
+	/* add the value */
+	new->keyval.val = clone_hunk_as_string(&value/*handles NULL*/,
+					       "keyword.list");
+
+	if (LDBGP(DBG_TMI, parser->logger)) {
+		LLOG_JAMBUF(DEBUG_STREAM, parser->logger, buf) {
+			jam(buf, "  %s%s=%s", leftright(key),
+			    key->key->keyname, new->keyval.val);
+			jam(buf, " number=%ju", new->number);
+			jam(buf, " field=%u", key->key->field);
+			jam_string(buf, " deltatime=");
+			jam_deltatime(buf, new->deltatime);
+		}
+	}
+
+	/* append the new kw_list to the list */
+	TAILQ_INSERT_TAIL(parser->keyvals, new, next);
+}
+
+diag_t parse_kt_unsigned(const struct ipsec_conf_keyval *key UNUSED,
+			 shunk_t value, uintmax_t *number)
+{
+	/* treat -1 as special, turning it into max */
+	if (hunk_streq(value, "-1")) {
+		(*number) = UINTMAX_MAX;
+		return NULL;
+	}
+
+	err_t err = shunk_to_uintmax(value, NULL, /*base*/10, number);
+	if (err == NULL) {
+		return NULL;
+	}
+
+	return diag("%s", err);
+}
+
+diag_t parse_kt_deltatime(const struct ipsec_conf_keyval *key UNUSED,
+			  shunk_t value, deltatime_t *deltatime)
+{
+	diag_t diag = ttodeltatime(value, deltatime);
+	if (diag != NULL) {
+		return diag;
+	}
+
+	return NULL;
+}
+
+diag_t parse_kt_sparse_name(const struct ipsec_conf_keyval *key,
+			    shunk_t value, uintmax_t *number,
+			    enum stream warning_stream, struct logger *logger)
+{
+	const struct sparse_names *names = key->key->sparse_names;
+
+	const struct sparse_name *sn = sparse_lookup_by_name(names, value);
+	if (sn == NULL) {
+		/*
+		 * We didn't find anything, complain.
+		 *
+		 * XXX: call jam_sparse_names() to list what is valid?
+		 */
+		return diag("invalid");
+	}
+
+	(*number) = sn->value & ~NAME_FLAGS;
+
+	if (warning_stream != NO_STREAM) {
+		enum name_flags flags = (sn->value & NAME_FLAGS);
+		name_buf new_name;
+
+		switch (flags) {
+		case NAME_IMPLEMENTED_AS:
+			llog(warning_stream, logger, PRI_KEYVAL_SAL": "PRI_SHUNK" implemented as %s: %s="PRI_SHUNK,
+			     pri_keyval_sal(key),
+			     pri_shunk(value), str_sparse_short(names, (*number), &new_name),
+			     key->key->keyname, pri_shunk(value));
+			return NULL;
+		case NAME_RENAMED_TO:
+			llog(warning_stream, logger, PRI_KEYVAL_SAL": "PRI_SHUNK" renamed to %s: %s="PRI_SHUNK,
+			     pri_keyval_sal(key),
+			     pri_shunk(value), str_sparse_short(names, (*number), &new_name),
+			     key->key->keyname, pri_shunk(value));
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Look for one of the tokens, and set the value up right.
+ */
+
+static bool parse_leftright(shunk_t s,
+			    const struct keyword_def *k,
+			    const char *leftright)
+{
+	/* gobble up "left|right" */
+	if (!hunk_strcaseeat(&s, leftright)) {
+		return false;
+	}
+
+	/* if present and kw non-empty, gobble up "-" */
+	if (strlen(k->keyname) > 0) {
+		hunk_streat(&s, "-");
+	}
+
+	/* keyword matches? */
+	if (!hunk_strcaseeq(s, k->keyname)) {
+		return false;
+	}
+
+	/* success */
+	return true;
+}
+
+/* type is really "token" type, which is actually int */
+static bool parser_find_key(shunk_t skey, enum end default_end,
+			    struct ipsec_conf_keyval *key,
+			    struct parser *parser)
+{
+	bool left = false;
+	bool right = false;
+
+	zero(key);
+
+	const struct keywords_def *keywords =
+		(parser->section == SECTION_CONFIG_SETUP ? &config_setup_keywords :
+		 &config_conn_keywords);
+
+	const struct keyword_def *found = NULL;
+	ITEMS_FOR_EACH(k, keywords) {
+
+		if (k->keyname == NULL) {
+			continue;
+		}
+
+		if (parser->section == SECTION_CONN_DEFAULT &&
+		    k->field == KSCF_ALSO) {
+			continue;
+		}
+
+		if (hunk_strcaseeq(skey, k->keyname)) {
+
+			/*
+			 * Given a KEY with BOTH|LEFTRIGHT, BOTH
+			 * trumps LEFTRIGHT.
+			 *
+			 * For instance:
+			 *
+			 *   --key=value --to ...
+			 *
+			 * sets left-key and right-key.  To only set
+			 * one end, specify:
+			 *
+			 *   --right-key=value --to ...
+			 *
+			 */
+			if (k->validity & kv_both) {
+				left = true;
+				right = true;
+				found = k;
+				break;
+			}
+
+			/*
+			 * For instance --auth=... --to ...
+			 */
+			if (k->validity & kv_leftright) {
+				if (default_end == LEFT_END) {
+					left = true;
+					found = k;
+					break;
+				}
+				if (default_end == RIGHT_END) {
+					right = true;
+					found = k;
+					break;
+				}
+
+#if 0 /* see github#663 */
+				continue;
+#else
+				parser_warning(parser, 0, "%s= is being treated as right-%s=",
+					       k->keyname, k->keyname);
+				right = true;
+#endif
+			}
+			found = k;
+			break;
+		}
+
+		if (k->validity & kv_leftright) {
+			left = parse_leftright(skey, k, "left");
+			if (left) {
+				found = k;
+				break;
+			}
+			right = parse_leftright(skey, k, "right");
+			if (right) {
+				found = k;
+				break;
+			}
+		}
+	}
+
+	/* if we still found nothing */
+	if (found == NULL) {
+		parser_fatal(parser, /*errno*/0, "unrecognized '%s' keyword '"PRI_SHUNK"'",
+			     str_parser_section(parser), pri_shunk(skey));
+		/* never returns */
+		return false;
+	}
+
+	if (found->validity & kv_optarg_only) {
+		parser_fatal(parser, /*errno*/0, "'%s' keyword '"PRI_SHUNK"' invalid; use command line option",
+			     str_parser_section(parser), pri_shunk(skey));
+		/* never returns */
+		return false;
+	}
+
+	/* else, set up llval.k to point, and return KEYWORD */
+	key->key = found;
+	key->left = left;
+	key->right = right;
+	key->val = NULL; /* later */
+	key->sal = scanner_sal(parser);
+	return true;
+}
+
+void parse_keyval(struct parser *parser, enum end default_end,
+		  shunk_t skey, shunk_t value)
+{
+	struct ipsec_conf_keyval key;
+	if (!parser_find_key(skey, default_end, &key, parser)) {
+		return;
+	}
+
+	/* fill in once look succeeds */
+	PEXPECT(parser->logger, key.val == NULL);
+
+	if (parser->section == SECTION_CONFIG_SETUP) {
+		/*
+		 * Throw everything onto the end of the list:
+		 *
+		 * Note: this includes kt_obsolete keyvalues.
+		 * Note: this includes duplicate keywords.
+		 */
+		append_parser_key_value(parser, &key, value, 0, (deltatime_t){0});
+		return;
+	}
+
+
+	uintmax_t number = 0;		/* neutral placeholding value */
+	deltatime_t deltatime = {.is_set = false, };
+	diag_t d = NULL;
+
+	switch (key.key->type) {
+
+	case kt_sparse_name:
+		d = parse_kt_sparse_name(&key, value, &number,
+					 parser->stream.warning,
+					 parser->logger);
+		break;
+
+	case kt_string:
+	case kt_also:
+	case kt_appendstring:
+	case kt_appendlist:
+		break;
+
+	case kt_unsigned:
+		d = parse_kt_unsigned(&key, value, &number);
+		break;
+
+	case kt_seconds:
+		d = parse_kt_deltatime(&key, value, &deltatime);
+		break;
+
+	case kt_obsolete:
+		/* drop it on the floor */
+		parser_key_value_warning(parser, &key, value, "obsolete keyword ignored");
+		return;
+
+	case kt_nosup:
+		/* drop it on the floor */
+		parser_key_value_warning(parser, &key, value, "unsupported keyword ignored");
+		return;
+
+	}
+
+	if (d != NULL) {
+		llog(WARNING_STREAM, parser->logger,
+		     PRI_KEYVAL_SAL": %s, keyword ignored: %s%s="PRI_SHUNK,
+		     pri_keyval_sal(&key), str_diag(d),
+		     leftright(&key), key.key->keyname, pri_shunk(value));
+		pfree_diag(&d);
+		return;
+	}
+
+	add_parser_key_value(parser, &key, value, number, deltatime);
+}
@@ -0,0 +1,179 @@
+-include ../../OBJ.linux.x86_64/programs/pluto/send.d # send.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ipsec_interface.d # ipsec_interface.o
+-include ../../OBJ.linux.x86_64/programs/pluto/kernel_ipsec_interface.d # kernel_ipsec_interface.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_cert.d # ikev1_cert.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_send.d # ikev1_send.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_notification.d # ikev1_notification.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_peer_id.d # ikev1_peer_id.o
+-include ../../OBJ.linux.x86_64/programs/pluto/unpack.d # unpack.o
+-include ../../OBJ.linux.x86_64/programs/pluto/impair_message.d # impair_message.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ddos.d # ddos.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_helper.d # ikev2_helper.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_unsecured.d # ikev2_unsecured.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_ike_sa_init.d # ikev2_ike_sa_init.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_ike_session_resume.d # ikev2_ike_session_resume.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_ike_intermediate.d # ikev2_ike_intermediate.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_ike_auth.d # ikev2_ike_auth.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_create_child_sa.d # ikev2_create_child_sa.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_informational.d # ikev2_informational.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_ke.d # ikev2_ke.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_cert.d # ikev2_cert.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_certreq.d # ikev2_certreq.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_notification.d # ikev2_notification.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_cp.d # ikev2_cp.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_ts.d # ikev2_ts.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_peer_id.d # ikev2_peer_id.o
+-include ../../OBJ.linux.x86_64/programs/pluto/peer_id.d # peer_id.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_mobike.d # ikev2_mobike.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_send.d # ikev2_send.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_message.d # ikev2_message.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_cookie.d # ikev2_cookie.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_msgid.d # ikev2_msgid.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_auth.d # ikev2_auth.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_auth_helper.d # ikev2_auth_helper.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_delete.d # ikev2_delete.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_liveness.d # ikev2_liveness.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_eap.d # ikev2_eap.o
+-include ../../OBJ.linux.x86_64/programs/pluto/state_db.d # state_db.o
+-include ../../OBJ.linux.x86_64/programs/pluto/show.d # show.o
+-include ../../OBJ.linux.x86_64/programs/pluto/binlog.d # binlog.o
+-include ../../OBJ.linux.x86_64/programs/pluto/retransmit.d # retransmit.o
+-include ../../OBJ.linux.x86_64/programs/pluto/quirks.d # quirks.o
+-include ../../OBJ.linux.x86_64/programs/pluto/rcv_whack.d # rcv_whack.o
+-include ../../OBJ.linux.x86_64/programs/pluto/visit_connection.d # visit_connection.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_add.d # whack_add.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_briefconnectionstatus.d # whack_briefconnectionstatus.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_connectionstatus.d # whack_connectionstatus.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_crash.d # whack_crash.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_debug.d # whack_debug.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_delete.d # whack_delete.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_deleteid.d # whack_deleteid.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_deletestate.d # whack_deletestate.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_deleteuser.d # whack_deleteuser.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_down.d # whack_down.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_impair.d # whack_impair.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_initiate.d # whack_initiate.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_pubkey.d # whack_pubkey.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_route.d # whack_route.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_sa.d # whack_sa.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_showstates.d # whack_showstates.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_shutdown.d # whack_shutdown.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_status.d # whack_status.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_suspend.d # whack_suspend.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_redirect.d # whack_redirect.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_trafficstatus.d # whack_trafficstatus.o
+-include ../../OBJ.linux.x86_64/programs/pluto/whack_unroute.d # whack_unroute.o
+-include ../../OBJ.linux.x86_64/programs/pluto/kernel.d # kernel.o
+-include ../../OBJ.linux.x86_64/programs/pluto/kernel_policy.d # kernel_policy.o
+-include ../../OBJ.linux.x86_64/programs/pluto/kernel_ops.d # kernel_ops.o
+-include ../../OBJ.linux.x86_64/programs/pluto/kernel_alg.d # kernel_alg.o
+-include ../../OBJ.linux.x86_64/programs/pluto/kernel_info.d # kernel_info.o
+-include ../../OBJ.linux.x86_64/programs/pluto/updown.d # updown.o
+-include ../../OBJ.linux.x86_64/programs/pluto/updown_names.d # updown_names.o
+-include ../../OBJ.linux.x86_64/programs/pluto/kernel_xfrm.d # kernel_xfrm.o
+-include ../../OBJ.linux.x86_64/programs/pluto/kernel_xfrm_interface.d # kernel_xfrm_interface.o
+-include ../../OBJ.linux.x86_64/programs/pluto/x509.d # x509.o
+-include ../../OBJ.linux.x86_64/programs/pluto/x509_ocsp.d # x509_ocsp.o
+-include ../../OBJ.linux.x86_64/programs/pluto/x509_crl.d # x509_crl.o
+-include ../../OBJ.linux.x86_64/programs/pluto/addresspool.d # addresspool.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_xauth.d # ikev1_xauth.o
+-include ../../OBJ.linux.x86_64/programs/pluto/xauth_passwd.d # xauth_passwd.o
+-include ../../OBJ.linux.x86_64/programs/pluto/labeled_ipsec.d # labeled_ipsec.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_db_ops.d # ikev1_db_ops.o
+-include ../../OBJ.linux.x86_64/programs/pluto/iface.d # iface.o
+-include ../../OBJ.linux.x86_64/programs/pluto/iface_udp.d # iface_udp.o
+-include ../../OBJ.linux.x86_64/programs/pluto/iface_tcp.d # iface_tcp.o
+-include ../../OBJ.linux.x86_64/programs/pluto/kernel_iface.d # kernel_iface.o
+-include ../../OBJ.linux.x86_64/programs/pluto/kernel_iface_linux.d # kernel_iface_linux.o
+-include ../../OBJ.linux.x86_64/programs/pluto/linux_audit.d # linux_audit.o
+-include ../../OBJ.linux.x86_64/programs/pluto/connections.d # connections.o
+-include ../../OBJ.linux.x86_64/programs/pluto/extract.d # extract.o
+-include ../../OBJ.linux.x86_64/programs/pluto/instantiate.d # instantiate.o
+-include ../../OBJ.linux.x86_64/programs/pluto/connection_db.d # connection_db.o
+-include ../../OBJ.linux.x86_64/programs/pluto/connection_event.d # connection_event.o
+-include ../../OBJ.linux.x86_64/programs/pluto/spd_db.d # spd_db.o
+-include ../../OBJ.linux.x86_64/programs/pluto/routing.d # routing.o
+-include ../../OBJ.linux.x86_64/programs/pluto/routing_names.d # routing_names.o
+-include ../../OBJ.linux.x86_64/programs/pluto/routing_story.d # routing_story.o
+-include ../../OBJ.linux.x86_64/programs/pluto/acquire.d # acquire.o
+-include ../../OBJ.linux.x86_64/programs/pluto/initiate.d # initiate.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ddns.d # ddns.o
+-include ../../OBJ.linux.x86_64/programs/pluto/terminate.d # terminate.o
+-include ../../OBJ.linux.x86_64/programs/pluto/pending.d # pending.o
+-include ../../OBJ.linux.x86_64/programs/pluto/crypto.d # crypto.o
+-include ../../OBJ.linux.x86_64/programs/pluto/defs.d # defs.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ike_spi.d # ike_spi.o
+-include ../../OBJ.linux.x86_64/programs/pluto/foodgroups.d # foodgroups.o
+-include ../../OBJ.linux.x86_64/programs/pluto/log.d # log.o
+-include ../../OBJ.linux.x86_64/programs/pluto/log_limiter.d # log_limiter.o
+-include ../../OBJ.linux.x86_64/programs/pluto/state.d # state.o
+-include ../../OBJ.linux.x86_64/programs/pluto/plutomain.d # plutomain.o
+-include ../../OBJ.linux.x86_64/programs/pluto/plutoalg.d # plutoalg.o
+-include ../../OBJ.linux.x86_64/programs/pluto/lock_file.d # lock_file.o
+-include ../../OBJ.linux.x86_64/programs/pluto/revival.d # revival.o
+-include ../../OBJ.linux.x86_64/programs/pluto/pacer.d # pacer.o
+-include ../../OBJ.linux.x86_64/programs/pluto/rekey_smoothing.d # rekey_smoothing.o
+-include ../../OBJ.linux.x86_64/programs/pluto/checkpoint.d # checkpoint.o
+-include ../../OBJ.linux.x86_64/programs/pluto/replication.d # replication.o
+-include ../../OBJ.linux.x86_64/programs/pluto/redirect_load.d # redirect_load.o
+-include ../../OBJ.linux.x86_64/programs/pluto/orient.d # orient.o
+-include ../../OBJ.linux.x86_64/programs/pluto/server.d # server.o
+-include ../../OBJ.linux.x86_64/programs/pluto/server_fork.d # server_fork.o
+-include ../../OBJ.linux.x86_64/programs/pluto/server_pool.d # server_pool.o
+-include ../../OBJ.linux.x86_64/programs/pluto/server_run.d # server_run.o
+-include ../../OBJ.linux.x86_64/programs/pluto/hash_table.d # hash_table.o
+-include ../../OBJ.linux.x86_64/programs/pluto/list_entry.d # list_entry.o
+-include ../../OBJ.linux.x86_64/programs/pluto/timer.d # timer.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_host_pair.d # ikev2_host_pair.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_retransmit.d # ikev2_retransmit.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ipsec_doi.d # ipsec_doi.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1.d # ikev1.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_aggr.d # ikev1_aggr.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_quick.d # ikev1_quick.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_dpd.d # ikev1_dpd.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_spdb_struct.d # ikev1_spdb_struct.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_msgid.d # ikev1_msgid.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_states.d # ikev1_states.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_hash.d # ikev1_hash.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_message.d # ikev1_message.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_nat.d # ikev1_nat.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_main.d # ikev1_main.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_delete.d # ikev1_delete.o
+-include ../../OBJ.linux.x86_64/programs/pluto/crypt_dh_v1.d # crypt_dh_v1.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_retransmit.d # ikev1_retransmit.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_replace.d # ikev1_replace.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_host_pair.d # ikev1_host_pair.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_spdb.d # ikev1_spdb.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2.d # ikev2.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_parent.d # ikev2_parent.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_child.d # ikev2_child.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_replace.d # ikev2_replace.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_proposals.d # ikev2_proposals.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_states.d # ikev2_states.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_psk.d # ikev2_psk.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_ppk.d # ikev2_ppk.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_crypto.d # ikev2_crypto.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_redirect.d # ikev2_redirect.o
+-include ../../OBJ.linux.x86_64/programs/pluto/cert_decode_helper.d # cert_decode_helper.o
+-include ../../OBJ.linux.x86_64/programs/pluto/pluto_stats.d # pluto_stats.o
+-include ../../OBJ.linux.x86_64/programs/pluto/demux.d # demux.o
+-include ../../OBJ.linux.x86_64/programs/pluto/msgdigest.d # msgdigest.o
+-include ../../OBJ.linux.x86_64/programs/pluto/keys.d # keys.o
+-include ../../OBJ.linux.x86_64/programs/pluto/reply_cache.d # reply_cache.o
+-include ../../OBJ.linux.x86_64/programs/pluto/crypt_ke.d # crypt_ke.o
+-include ../../OBJ.linux.x86_64/programs/pluto/crypt_dh.d # crypt_dh.o
+-include ../../OBJ.linux.x86_64/programs/pluto/crypt_dh_v2.d # crypt_dh_v2.o
+-include ../../OBJ.linux.x86_64/programs/pluto/hourly.d # hourly.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev1_vendorid.d # ikev1_vendorid.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_vendorid.d # ikev2_vendorid.o
+-include ../../OBJ.linux.x86_64/programs/pluto/nat_traversal.d # nat_traversal.o
+-include ../../OBJ.linux.x86_64/programs/pluto/ikev2_nat.d # ikev2_nat.o
+-include ../../OBJ.linux.x86_64/programs/pluto/virtual_ip.d # virtual_ip.o
+-include ../../OBJ.linux.x86_64/programs/pluto/packet.d # packet.o
+-include ../../OBJ.linux.x86_64/programs/pluto/pluto_constants.d # pluto_constants.o
+-include ../../OBJ.linux.x86_64/programs/pluto/nss_cert_verify.d # nss_cert_verify.o
+-include ../../OBJ.linux.x86_64/programs/pluto/root_certs.d # root_certs.o
+-include ../../OBJ.linux.x86_64/programs/pluto/pluto_timing.d # pluto_timing.o
+-include ../../OBJ.linux.x86_64/programs/pluto/nss_cert_reread.d # nss_cert_reread.o
+-include ../../OBJ.linux.x86_64/programs/pluto/rekeyfuzz.d # rekeyfuzz.o
+-include ../../OBJ.linux.x86_64/programs/pluto//root/repo/OBJ.linux.x86_64/lib/libswan/libswan.d # /root/repo/OBJ.linux.x86_64/lib/libswan/libswan.a
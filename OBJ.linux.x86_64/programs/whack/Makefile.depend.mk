@@ -0,0 +1,4 @@
+-include ../../OBJ.linux.x86_64/programs/whack/whack.d # whack.o
+-include ../../OBJ.linux.x86_64/programs/whack//root/repo/OBJ.linux.x86_64/lib/libswan/libswan.d # /root/repo/OBJ.linux.x86_64/lib/libswan/libswan.a
+-include ../../OBJ.linux.x86_64/programs/whack//root/repo/OBJ.linux.x86_64/lib/liblswtool/liblswtool.d # /root/repo/OBJ.linux.x86_64/lib/liblswtool/liblswtool.a
+-include ../../OBJ.linux.x86_64/programs/whack//root/repo/OBJ.linux.x86_64/lib/libswan/libswan.d # /root/repo/OBJ.linux.x86_64/lib/libswan/libswan.a
@@ -0,0 +1,4 @@
+-include ../../../OBJ.linux.x86_64/testing/programs/asn1check/asn1check.d # asn1check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/asn1check//root/repo/OBJ.linux.x86_64/lib/libswan/libswan.d # /root/repo/OBJ.linux.x86_64/lib/libswan/libswan.a
+-include ../../../OBJ.linux.x86_64/testing/programs/asn1check//root/repo/OBJ.linux.x86_64/lib/liblswtool/liblswtool.d # /root/repo/OBJ.linux.x86_64/lib/liblswtool/liblswtool.a
+-include ../../../OBJ.linux.x86_64/testing/programs/asn1check//root/repo/OBJ.linux.x86_64/lib/libswan/libswan.d # /root/repo/OBJ.linux.x86_64/lib/libswan/libswan.a
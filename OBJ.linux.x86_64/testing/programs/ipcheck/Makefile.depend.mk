@@ -0,0 +1,19 @@
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ipcheck.d # ipcheck.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_sockaddr_check.d # ip_sockaddr_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_address_check.d # ip_address_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_endpoint_check.d # ip_endpoint_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_range_check.d # ip_range_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_subnet_check.d # ip_subnet_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_selector_check.d # ip_selector_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_said_check.d # ip_said_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_info_check.d # ip_info_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_protoport_check.d # ip_protoport_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_port_check.d # ip_port_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_port_range_check.d # ip_port_range_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_cidr_check.d # ip_cidr_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_protocol_check.d # ip_protocol_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_packet_check.d # ip_packet_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck/ip_pool_check.d # ip_pool_check.o
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck//root/repo/OBJ.linux.x86_64/lib/libswan/libswan.d # /root/repo/OBJ.linux.x86_64/lib/libswan/libswan.a
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck//root/repo/OBJ.linux.x86_64/lib/liblswtool/liblswtool.d # /root/repo/OBJ.linux.x86_64/lib/liblswtool/liblswtool.a
+-include ../../../OBJ.linux.x86_64/testing/programs/ipcheck//root/repo/OBJ.linux.x86_64/lib/libswan/libswan.d # /root/repo/OBJ.linux.x86_64/lib/libswan/libswan.a
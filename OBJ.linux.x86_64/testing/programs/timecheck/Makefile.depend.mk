@@ -0,0 +1,7 @@
+-include ../../../OBJ.linux.x86_64/testing/programs/timecheck/timecheck.d # timecheck.o
+-include ../../../OBJ.linux.x86_64/testing/programs/timecheck/check_monotime.d # check_monotime.o
+-include ../../../OBJ.linux.x86_64/testing/programs/timecheck/check_realtime.d # check_realtime.o
+-include ../../../OBJ.linux.x86_64/testing/programs/timecheck/check_deltatime.d # check_deltatime.o
+-include ../../../OBJ.linux.x86_64/testing/programs/timecheck//root/repo/OBJ.linux.x86_64/lib/libswan/libswan.d # /root/repo/OBJ.linux.x86_64/lib/libswan/libswan.a
+-include ../../../OBJ.linux.x86_64/testing/programs/timecheck//root/repo/OBJ.linux.x86_64/lib/liblswtool/liblswtool.d # /root/repo/OBJ.linux.x86_64/lib/liblswtool/liblswtool.a
+-include ../../../OBJ.linux.x86_64/testing/programs/timecheck//root/repo/OBJ.linux.x86_64/lib/libswan/libswan.d # /root/repo/OBJ.linux.x86_64/lib/libswan/libswan.a
@@ -88,6 +88,8 @@ const char *str_id(const struct id *id, id_buf *buf);
  */
 
 struct id clone_id(const struct id *id, const char *why);
+/* .name points into ID which must out-live the result; .scratch is NULL */
+struct id share_id(const struct id *id);
 extern void free_id_content(struct id *id); /* also blats ID */
 
 extern bool id_is_any(const struct id *a);
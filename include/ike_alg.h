@@ -777,7 +777,8 @@ struct sn_desc {
 extern bool encrypt_desc_is_aead(const struct encrypt_desc *enc_desc);
 
 void init_ike_alg(struct logger *logger);
-void test_ike_alg(struct logger *logger);
+void test_ike_alg(const char *fail, struct logger *logger);	/* in parallel; FAIL is for testing */
+void disable_ike_alg(const struct ike_alg *alg, struct logger *logger);
 
 /*
  * Iterate over all enabled algorithms.
@@ -174,6 +174,8 @@ struct impair {
 	bool event_check_crls;
 	bool ignore_soft_expire;
 	bool ignore_hard_expire;
+	bool xfrm_event_overflow;
+	bool xfrm_event_duplicate;
 
 	bool cannot_ondemand;
 
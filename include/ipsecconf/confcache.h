@@ -0,0 +1,42 @@
+/* Libreswan compiled config file cache (confcache.h)
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#ifndef IPSECCONF_CONFCACHE_H
+#define IPSECCONF_CONFCACHE_H
+
+struct logger;
+struct starter_config;
+struct ipsec_conf;
+
+/*
+ * A compiled (already parsed and translated) struct starter_config,
+ * along with the config setup values, that can be mmap()ed back in.
+ *
+ * The cache is keyed by a hash of the contents and stat() of every
+ * file that went into the config (ipsec.conf and its includes), the
+ * stat() of each include directory, and the libreswan version.  When
+ * any of that changes the cache is ignored.
+ */
+
+struct starter_config *confcache_load(const char *cachefile,
+				      const char *file,
+				      struct logger *logger);
+
+void confcache_save(const char *cachefile,
+		    const struct starter_config *cfg,
+		    const struct ipsec_conf *ipsec_conf,
+		    struct logger *logger);
+
+#endif
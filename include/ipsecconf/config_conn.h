@@ -168,6 +168,7 @@ enum config_conn_keyword {
 	KWS_REKEYFUZZ,
 	KWYN_COMPRESS,
 	KWS_REPLAY_WINDOW,
+	KWS_IKE_WINDOW,		/* RFC 7296 2.3 SET_WINDOW_SIZE */
 	KNCF_IKELIFETIME,
 	KNCF_RETRANSMIT_TIMEOUT,
 	KWS_RETRANSMIT_INTERVAL,
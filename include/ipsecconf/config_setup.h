@@ -24,6 +24,7 @@
 enum yn_options;
 struct logger;
 struct ipsec_conf;
+struct keyword_value;
 
 enum config_setup_keyword {
 	/* zero is reserved */
@@ -49,6 +50,8 @@ enum config_setup_keyword {
 	KSF_PROTOSTACK,
 	KBF_GLOBAL_REDIRECT,
 	KSF_GLOBAL_REDIRECT_TO,
+	KSF_GLOBAL_REDIRECT_PEERS,
+	KSF_GLOBAL_REDIRECT_LOAD_SOCKET,
 	KSF_OCSP_URI,
 	KSF_OCSP_TRUSTNAME,
 	KSF_EXPIRE_SHUNT_INTERVAL,
@@ -87,6 +90,13 @@ enum config_setup_keyword {
 	KBF_SHUNTLIFETIME,
 	KBF_DDOS_IKE_THRESHOLD,
 	KBF_MAX_HALFOPEN_IKE,
+	KBF_GLOBAL_REDIRECT_LOAD,	/* percent; redirect when auto */
+	KBF_GLOBAL_REDIRECT_CAPACITY,	/* established IKE SAs at 100% load */
+	KBF_INITIATE_RATE,	/* new IKE SA initiates per second */
+	KBF_REKEY_RATE,		/* rekeys per second */
+	KYN_WARM_RESTART,	/* checkpoint SAs on --leave-state */
+	KSF_REPLICATE_TO,	/* stream SAs to this standby */
+	KSF_REPLICATE_FROM,	/* accept SAs streamed from the active */
 	KBF_NFLOG_ALL,		/* Enable global nflog device */
 	KBF_DDOS_MODE,		/* set DDOS mode */
 	KBF_SECCOMP,		/* set SECCOMP mode */
@@ -115,6 +125,8 @@ void update_setup_string(enum config_setup_keyword kw, const char *string);
 void update_setup_yn(enum config_setup_keyword kw, enum yn_options yn);
 void update_setup_deltatime(enum config_setup_keyword kw, deltatime_t deltatime);
 void update_setup_option(enum config_setup_keyword kw, uintmax_t option);
+void update_setup_keyword_value(enum config_setup_keyword kw,
+				const struct keyword_value *value);
 
 const char *config_setup_string(const struct config_setup *setup, enum config_setup_keyword field);
 const char *config_setup_string_or_unset(const struct config_setup *setup, enum config_setup_keyword field, const char *unset);
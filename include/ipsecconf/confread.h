@@ -109,6 +109,16 @@ struct starter_config *confread_load(const char *file,
 				     struct logger *logger,
 				     unsigned verbosity);
 
+/*
+ * Like confread_load() (without SETUPONLY), but first try the
+ * compiled config in CACHEFILE; when that is stale, load FILE and
+ * update CACHEFILE.
+ */
+struct starter_config *confread_load_cached(const char *file,
+					    const char *cachefile,
+					    struct logger *logger,
+					    unsigned verbosity);
+
 struct starter_config *confread_load_argv(const char *file,
 					  const char *name, char *argv[], int start,
 					  struct logger *logger, unsigned verbosity);
@@ -84,6 +84,8 @@ struct ipsec_conf_source {
 TAILQ_HEAD(ipsec_conf_sources, ipsec_conf_source);
 
 const char *add_ipsec_conf_source(struct ipsec_conf *cfg, const char *name);
+void add_ipsec_conf_include_dir(struct ipsec_conf *cfg, const char *pattern,
+				struct logger *logger);
 
 struct ipsec_conf {
 	struct keyval_list config_setup;
@@ -94,6 +96,7 @@ struct ipsec_conf {
 	struct section_list conn_default;
 
 	struct ipsec_conf_sources sources;
+	struct ipsec_conf_sources include_dirs;	/* where include globs look */
 };
 
 struct parser {
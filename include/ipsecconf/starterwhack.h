@@ -19,10 +19,14 @@
 struct starter_conn;
 struct starter_config;
 struct logger;
+struct whack_stream;
 
 int starter_whack_add_conn(const char *ctlsocket,
 			   const struct starter_conn *conn,
 			   struct logger *logger);
+int starter_whack_stream_add_conn(struct whack_stream *ws,
+				  const struct starter_conn *conn,
+				  struct logger *logger);
 extern int starter_whack_listen(const char *ctlsocket,
 				struct logger *logger);
 
@@ -23,6 +23,7 @@
 
 #include <sys/types.h>
 #include <stdarg.h>
+#include <stdint.h>		/* for uintmax_t */
 
 #include "constants.h"
 #include "lswcdefs.h"
@@ -128,6 +129,54 @@ void append_str(char **sentence, const char *sep, const char *word);
 
 #define replace(p, q) { pfreeany(p); (p) = (q); }
 
+/*
+ * Slabs: per-type free lists for hot objects (states, connections,
+ * message digests, events, ...).
+ *
+ *   static struct slab state_slab = SLAB(union sas, "state");
+ *   union sas *sap = alloc_slab_thing(&state_slab, union sas, "struct state");
+ *   ...
+ *   pfree_slab(&state_slab, sap);
+ *
+ * Objects are carved from large chunks and, once freed, recycled
+ * through a per-thread cache backed by a per-slab free list; memory
+ * is never returned to the heap.  This keeps churning objects from
+ * fragmenting the heap.
+ *
+ * With leak_detective each object is instead an individual
+ * alloc_bytes() so that report_leaks() (and the 0xEF scribbling)
+ * continue to work.
+ *
+ * Either way live and peak counts are maintained; see slab_stats().
+ */
+
+struct slab_private;
+
+struct slab {
+	const char *name;
+	size_t size;
+	struct slab_private *private;	/* created on first use */
+};
+
+#define SLAB(TYPE, NAME) { .name = NAME, .size = sizeof(TYPE), }
+
+void *alloc_slab_bytes(struct slab *slab, size_t size, const char *name);
+void pfree_slab(struct slab *slab, void *ptr);
+
+#define alloc_slab_thing(SLAB, THING, NAME)				\
+	((THING*) alloc_slab_bytes(SLAB, sizeof(THING), NAME))
+
+struct slab_stats {
+	const char *name;
+	size_t size;
+	uintmax_t live;		/* allocated now */
+	uintmax_t peak;		/* most allocated at once */
+	uintmax_t reserved;	/* carved from chunks */
+};
+
+/* fill in upto NR_STATS; return the number of slabs */
+unsigned slab_stats(struct slab_stats *stats, unsigned nr_stats);
+
 /*
  * Memory primitives, should only be used by libevent.
  */
@@ -52,6 +52,9 @@ enum rc_type {
 	RC_ENTERSECRET = 10,
 	RC_USERPROMPT = 11,
 
+	/* end of the replies to a batched message, see whack_stream_send() */
+	RC_WHACK_BATCH = 12,
+
 	RC_EXIT_FLOOR = 20,
 
 	/* improper request */
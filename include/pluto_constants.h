@@ -180,7 +180,10 @@ enum global_timer {
 	EVENT_RESET_LOG_LIMITER,	/* set rate limited log message count back to 0 */
 #define RESET_LOG_LIMITER_FREQUENCY	deltatime(secs_per_hour)
 
-#define GLOBAL_TIMER_ROOF (EVENT_RESET_LOG_LIMITER+1)
+	EVENT_SPI_POOL,			/* refill/expire pre-allocated SPIs */
+	EVENT_REDIRECT_LOAD,		/* send load to global-redirect-peers= */
+
+#define GLOBAL_TIMER_ROOF (EVENT_REDIRECT_LOAD+1)
 };
 
 /*
@@ -355,6 +358,7 @@ typedef enum {
 #define IPSEC_SA_DEFAULT_REPLAY_WINDOW 128 /* for Linux, requires 2.6.39+ */
 
 #define IKE_V2_OVERLAPPING_WINDOW_SIZE	1 /* our default for rfc 7296 # 2.3 */
+#define IKE_V2_MAX_WINDOW_SIZE		32 /* upper bound for ike-window= */
 
 #define PPK_ID_MAXLEN 64 /* fairly arbitrary */
 
@@ -60,6 +60,17 @@ void refcnt_init(const void *pointer, struct refcnt *refcnt,
 #define refcnt_alloc(THING, LOGGER, WHERE)				\
 	refcnt_overalloc(THING, /*extra*/0, LOGGER, WHERE)
 
+/* as above, but from SLAB; release with pfree_slab() */
+#define refcnt_slab_alloc(THING, SLAB, LOGGER, WHERE)			\
+	({								\
+		static const struct refcnt_base b_ = {			\
+			.what = #THING,					\
+		};							\
+		THING *t_ = alloc_slab_thing(SLAB, THING, #THING);	\
+		refcnt_init(t_, &t_->refcnt, &b_, LOGGER, WHERE);	\
+		t_;							\
+	})
+
 /* look at refcnt atomically */
 
 unsigned refcnt_peek_where(const void *pointer,
@@ -355,9 +355,32 @@ bool secret_pubkey_same(const struct secret *lhs,
 			const struct secret *rhs,
 			const struct logger *logger);
 
-extern void lsw_load_preshared_secrets(struct secret **psecrets, const char *secrets_file,
+/*
+ * The parsed ipsec.secrets and its includes.
+ *
+ * lsw_parse_secret_files() is thread safe; it parses the files,
+ * re-using the already parsed secrets of any file whose contents are
+ * unchanged since OLD was parsed (OLD must not be published until it
+ * returns).  lsw_publish_secret_files() then, under lock, replaces
+ * both PSECRETS and FILES.
+ */
+struct secret_files;
+struct secret_files *lsw_parse_secret_files(const struct secret_files *old,
+					    const char *secrets_file,
+					    struct logger *logger);
+void lsw_publish_secret_files(struct secret **psecrets,
+			      struct secret_files **files,
+			      struct secret_files **new_files,
+			      struct logger *logger);
+void lsw_free_secret_files(struct secret_files **files);
+
+extern void lsw_load_preshared_secrets(struct secret **psecrets,
+				       struct secret_files **files,
+				       const char *secrets_file,
+				       struct logger *logger);
+extern void lsw_free_preshared_secrets(struct secret **psecrets,
+				       struct secret_files **files,
 				       struct logger *logger);
-extern void lsw_free_preshared_secrets(struct secret **psecrets, struct logger *logger);
 
 extern struct secret *lsw_find_secret_by_id(struct secret *secrets,
 					    enum secret_kind kind,
@@ -133,6 +133,8 @@ enum whack_command {
 	/**/
 	WHACK_LISTEN,
 	WHACK_UNLISTEN,
+	/**/
+	WHACK_TAKEOVER,
 };
 
 /*
@@ -288,6 +290,9 @@ struct whack_message {
 					 * different .whack_add
 					 * semantics */
 	bool whack_async;
+	bool whack_batch;		/* more messages follow on the
+					 * same socket; see
+					 * whack_stream_send() */
 
 	/*
 	 * Command specific parameters.  Commands also share some
@@ -368,6 +373,7 @@ struct whack_message {
 #define wm_rekeyfuzz conn[END_ROOF].value[KWS_REKEYFUZZ]
 
 #define wm_replay_window conn[END_ROOF].value[KWS_REPLAY_WINDOW]
+#define wm_ike_window conn[END_ROOF].value[KWS_IKE_WINDOW]
 	deltatime_t retransmit_timeout;
 	/* milliseconds, not seconds!*/
 #define wm_retransmit_interval conn[END_ROOF].value[KWS_RETRANSMIT_INTERVAL]
@@ -581,6 +587,26 @@ int whack_send_msg(struct whack_message *msg, const char *ctlsocket,
 		   int usernamelen, int xauthpasslen,
 		   struct logger *logger);
 
+/*
+ * Send many messages (for instance, connections being added by
+ * addconn) over a single control socket.  Close returns the exit
+ * status and, for each message sent, its status; free them with
+ * free_whack_stream_statuses().
+ */
+struct whack_stream;
+struct whack_stream_status {
+	char *name;		/* the message's .name */
+	bool answered;		/* else pluto closed the socket first */
+	int status;		/* first RC_EXIT_FLOOR..RC_EXIT_ROOF, else 0 */
+};
+struct whack_stream *whack_stream_open(const char *ctlsocket, struct logger *logger);
+int whack_stream_send(struct whack_stream *ws, struct whack_message *msg,
+		      struct logger *logger);
+int whack_stream_close(struct whack_stream **ws,
+		       struct whack_stream_status **statuses, unsigned *nr_statuses,
+		       struct logger *logger);
+void free_whack_stream_statuses(struct whack_stream_status **statuses, unsigned nr_statuses);
+
 extern bool lsw_alias_cmp(const char *name, const char *aliases);
 
 extern unsigned whack_magic(void);
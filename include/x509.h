@@ -84,6 +84,7 @@ extern bool match_dn(asn1_t a, asn1_t b, int *wildcards,
 extern bool match_dn_any_order_wild(asn1_t a, asn1_t b, int *wildcards,
 				    struct verbose verbose);
 extern bool dn_has_wildcards(asn1_t dn);
+uintmax_t hash_dn(asn1_t dn);	/* ignores RDN order and case */
 extern err_t atodn(const char *src, chunk_t *dn);
 extern void free_generalNames(generalName_t *gn, bool free_name);
 extern void load_crls(void);
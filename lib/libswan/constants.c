@@ -2518,6 +2518,8 @@ static const char *global_timer_name[] = {
 	S(EVENT_CHECK_CRLS),
 	S(EVENT_FREE_ROOT_CERTS),
 	S(EVENT_RESET_LOG_LIMITER),
+	S(EVENT_SPI_POOL),
+	S(EVENT_REDIRECT_LOAD),
 #undef S
 };
 const struct enum_names global_timer_names = {
@@ -285,6 +285,13 @@ struct id clone_id(const struct id *src, const char *story)
 	return dst;
 }
 
+struct id share_id(const struct id *src)
+{
+	struct id dst = *src;
+	dst.scratch = NULL;
+	return dst;
+}
+
 void free_id_content(struct id *id)
 {
 	switch (id->kind) {
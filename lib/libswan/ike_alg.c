@@ -1398,6 +1398,74 @@ static void strip_nonfips(const struct ike_alg_type *type, struct logger *logger
 	type->algorithms->end = end;
 }
 
+/*
+ * Return an enabled algorithm built on ALG: a PRF using the hash ALG,
+ * or integrity using the PRF ALG.
+ */
+
+static const struct ike_alg *ike_alg_dependent(const struct ike_alg *alg)
+{
+	if (alg->type == &ike_alg_hash) {
+		FOR_EACH_IKE_ALGP(&ike_alg_prf, algp) {
+			if (prf_desc(*algp)->hasher == hash_desc(alg)) {
+				return *algp;
+			}
+		}
+	}
+	if (alg->type == &ike_alg_prf) {
+		FOR_EACH_IKE_ALGP(&ike_alg_integ, algp) {
+			if (integ_desc(*algp)->prf == prf_desc(alg)) {
+				return *algp;
+			}
+		}
+	}
+	return NULL;
+}
+
+static void remove_ike_alg(const struct ike_alg *alg)
+{
+	const struct ike_alg_type *type = alg->type;
+	const struct ike_alg **end = type->algorithms->start;
+	FOR_EACH_IKE_ALGP(type, algp) {
+		if (*algp != alg) {
+			*end++ = *algp;
+		}
+	}
+	type->algorithms->end = end;
+}
+
+static void disable_dependents(const struct ike_alg *alg,
+			       const struct ike_alg *failed,
+			       struct logger *logger)
+{
+	const struct ike_alg *dependent;
+	while ((dependent = ike_alg_dependent(alg)) != NULL) {
+		llog(RC_LOG, logger, "%s %s disabled; %s %s failed its self-test",
+		     dependent->type->story, dependent->fqn,
+		     failed->type->story, failed->fqn);
+		remove_ike_alg(dependent);
+		disable_dependents(dependent, failed, logger);
+	}
+}
+
+/*
+ * Remove ALG, and everything built on it, from the algorithm tables.
+ *
+ * Nothing else may be looking at the tables.
+ */
+
+void disable_ike_alg(const struct ike_alg *alg, struct logger *logger)
+{
+	if (!ike_alg_is_valid(alg)) {
+		/* already went with something it was built on */
+		return;
+	}
+	llog(RC_LOG, logger, "%s %s disabled; self-test failed",
+	     alg->type->story, alg->fqn);
+	remove_ike_alg(alg);
+	disable_dependents(alg, alg, logger);
+}
+
 void init_ike_alg(struct logger *logger)
 {
 	bool fips = is_fips_mode();
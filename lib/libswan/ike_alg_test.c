@@ -13,7 +13,11 @@
  * for more details.
  */
 
+#include <pthread.h>	/* pthread.h must be first include file */
+
 #include "lswlog.h"
+#include "monotime.h"
+#include "fips_mode.h"
 #include "ike_alg.h"
 #include "ike_alg_encrypt.h"
 #include "ike_alg_prf.h"
@@ -23,34 +27,145 @@
 #include "ike_alg_test_gcm.h"
 #include "ike_alg_test_prf.h"
 
-#define TEST(TESTER, ALG, TESTS)					\
-	if (!ike_alg_is_valid(&(ALG).common)) {				\
-		llog(RC_LOG, logger,				\
-			    "skipping tests for disabled %s algorithm", \
-			    (ALG).common.fqn);				\
-	} else {							\
-		llog(RC_LOG, logger,				\
-			    "testing %s:", (ALG).common.fqn);		\
-		passert(TESTER(&ALG, TESTS, logger));				\
+/*
+ * Each algorithm's known-answer tests run on their own thread.
+ *
+ * A failure disables the algorithm being tested along with anything
+ * built on it; except in FIPS mode where it is fatal.
+ */
+
+struct ike_alg_test {
+	const struct ike_alg *alg;
+	bool (*run)(struct logger *logger);
+	struct logger *logger;
+	pthread_t thread;
+	bool skipped;
+	bool started;
+	bool ok;
+	deltatime_t time;
+};
+
+#define TESTER(TESTER, ALG, TESTS)				\
+	static bool run_##TESTS(struct logger *logger)		\
+	{							\
+		return TESTER(&ALG, TESTS, logger);		\
 	}
+#define TEST(ALG, TESTS) { .alg = &(ALG).common, .run = run_##TESTS, }
+
+#ifdef USE_CAMELLIA
+TESTER(test_cbc_vectors, ike_alg_encrypt_camellia_cbc, camellia_cbc_tests)
+#endif
+#ifdef USE_AES
+TESTER(test_gcm_vectors, ike_alg_encrypt_aes_gcm_16, aes_gcm_tests)
+TESTER(test_ctr_vectors, ike_alg_encrypt_aes_ctr,    aes_ctr_tests)
+TESTER(test_cbc_vectors, ike_alg_encrypt_aes_cbc,    aes_cbc_tests)
+#endif
+#ifdef USE_PRF_AES_XCBC
+TESTER(test_prf_vectors, ike_alg_prf_aes_xcbc,       aes_xcbc_prf_tests)
+#endif
+#ifdef USE_MD5
+TESTER(test_prf_vectors, ike_alg_prf_hmac_md5,       hmac_md5_prf_tests)
+#endif
+#ifdef USE_SHA1
+TESTER(test_kdf_vectors, ike_alg_prf_sha1,           hmac_sha1_kdf_tests)
+#endif
+
+static void *run_ike_alg_test(void *arg)
+{
+	struct ike_alg_test *test = arg;
+	monotime_t start = mononow();
+	test->ok = test->run(test->logger);
+	test->time = monotime_diff(mononow(), start);
+	return NULL;
+}
 
-void test_ike_alg(struct logger *logger)
+void test_ike_alg(const char *fail, struct logger *logger)
 {
+	struct ike_alg_test tests[] = {
 #ifdef USE_CAMELLIA
-	TEST(test_cbc_vectors, ike_alg_encrypt_camellia_cbc, camellia_cbc_tests);
+		TEST(ike_alg_encrypt_camellia_cbc, camellia_cbc_tests),
 #endif
 #ifdef USE_AES
-	TEST(test_gcm_vectors, ike_alg_encrypt_aes_gcm_16, aes_gcm_tests);
-	TEST(test_ctr_vectors, ike_alg_encrypt_aes_ctr,    aes_ctr_tests);
-	TEST(test_cbc_vectors, ike_alg_encrypt_aes_cbc,    aes_cbc_tests);
+		TEST(ike_alg_encrypt_aes_gcm_16, aes_gcm_tests),
+		TEST(ike_alg_encrypt_aes_ctr,    aes_ctr_tests),
+		TEST(ike_alg_encrypt_aes_cbc,    aes_cbc_tests),
 #endif
 #ifdef USE_PRF_AES_XCBC
-	TEST(test_prf_vectors, ike_alg_prf_aes_xcbc,       aes_xcbc_prf_tests);
+		TEST(ike_alg_prf_aes_xcbc,       aes_xcbc_prf_tests),
 #endif
 #ifdef USE_MD5
-	TEST(test_prf_vectors, ike_alg_prf_hmac_md5,       hmac_md5_prf_tests);
+		TEST(ike_alg_prf_hmac_md5,       hmac_md5_prf_tests),
 #endif
 #ifdef USE_SHA1
-	TEST(test_kdf_vectors, ike_alg_prf_sha1,           hmac_sha1_kdf_tests);
+		TEST(ike_alg_prf_sha1,           hmac_sha1_kdf_tests),
 #endif
+	};
+
+	monotime_t start = mononow();
+
+	for (unsigned i = 0; i < elemsof(tests); i++) {
+		struct ike_alg_test *test = &tests[i];
+		if (!ike_alg_is_valid(test->alg)) {
+			test->skipped = true;
+			continue;
+		}
+		test->logger = logger;
+		int e = pthread_create(&test->thread, NULL, run_ike_alg_test, test);
+		if (e == 0) {
+			test->started = true;
+		} else {
+			/* run it here */
+			run_ike_alg_test(test);
+		}
+	}
+
+	/*
+	 * The tests read the algorithm tables; wait for all of them
+	 * before disabling anything.
+	 */
+	for (unsigned i = 0; i < elemsof(tests); i++) {
+		struct ike_alg_test *test = &tests[i];
+		if (test->started) {
+			pthread_join(test->thread, NULL);
+		}
+	}
+
+	/*
+	 * For testing, pretend that the named algorithm's test
+	 * failed.
+	 */
+	bool failed = false;
+	for (unsigned i = 0; fail != NULL && i < elemsof(tests); i++) {
+		struct ike_alg_test *test = &tests[i];
+		if (!test->skipped && strcaseeq(test->alg->fqn, fail)) {
+			test->ok = false;
+			failed = true;
+		}
+	}
+	if (fail != NULL && !failed) {
+		llog(RC_LOG, logger, "no self-test for %s algorithm to fail", fail);
+	}
+
+	/* report in table order */
+	for (unsigned i = 0; i < elemsof(tests); i++) {
+		struct ike_alg_test *test = &tests[i];
+		if (test->skipped) {
+			llog(RC_LOG, logger,
+			     "skipping tests for disabled %s algorithm",
+			     test->alg->fqn);
+			continue;
+		}
+		deltatime_buf db;
+		llog(RC_LOG, logger, "testing %s: %s in %ss",
+		     test->alg->fqn, (test->ok ? "passed" : "FAILED"),
+		     str_deltatime(test->time, &db));
+		if (!test->ok) {
+			passert(!is_fips_mode());
+			disable_ike_alg(test->alg, logger);
+		}
+	}
+
+	deltatime_buf db;
+	ldbg(logger, "algorithm self-tests took %ss",
+	     str_deltatime(monotime_diff(mononow(), start), &db));
 }
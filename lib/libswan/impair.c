@@ -317,6 +317,8 @@ struct impairment impairments[] = {
 
 	B(ignore_soft_expire, "ignore kernel soft expire events"),
 	B(ignore_hard_expire, "ignore kernel hard expire events"),
+	B(xfrm_event_overflow, "drop XFRM events and resynchronize, as if the kernel reported ENOBUFS"),
+	B(xfrm_event_duplicate, "process each XFRM event twice"),
 
 	E(force_v2_auth_method, ikev2_auth_method_names,
 	  "force the use of the specified IKEv2 AUTH method"),
@@ -0,0 +1,553 @@
+/* Libreswan compiled config file cache (confcache.c)
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>		/* for PATH_MAX */
+#include <fcntl.h>		/* for open() */
+#include <unistd.h>		/* for close() */
+#include <sys/mman.h>		/* for mmap() */
+#include <sys/stat.h>		/* for fstat() */
+
+#include "ipsecconf/confcache.h"
+#include "ipsecconf/confread.h"
+#include "ipsecconf/config_setup.h"
+#include "ipsecconf/parser.h"	/* for struct ipsec_conf_sources */
+#include "lswcdefs.h"		/* for FOR_EACH_THING() */
+#include "lswalloc.h"
+#include "lswlog.h"
+#include "lswversion.h"
+
+/*
+ * The file, in native byte order, is:
+ *
+ *   header
+ *   uint32_t sources[nr_sources]		string offsets
+ *   uint32_t dirs[nr_dirs]			string offsets
+ *   struct cached_value setup[CONFIG_SETUP_KEYWORD_ROOF]
+ *   struct cached_conn conns[nr_conns]		[0] is %default
+ *   char strings[]
+ *
+ * String references are offset+1 into STRINGS with 0 being NULL.
+ *
+ * Since the records use the in-memory keyword numbering, the
+ * libreswan version and record sizes are folded into the key.
+ */
+
+#define CONFCACHE_MAGIC "LSWCONF"
+#define CONFCACHE_VERSION 1
+
+struct cached_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t nr_sources;
+	uint32_t nr_dirs;
+	uint32_t unused;
+	uint64_t key;
+	uint64_t size;
+	uint64_t nr_conns;
+	uint64_t sources;
+	uint64_t dirs;
+	uint64_t setup;
+	uint64_t conns;
+	uint64_t strings;
+};
+
+struct cached_value {
+	uint32_t set;
+	uint32_t string;
+	int64_t option;
+	int64_t deltatime;	/* microseconds */
+	uint64_t deltatime_is_set;
+};
+
+struct cached_conn {
+	uint32_t name;
+	uint32_t state;
+	uint32_t shunt[SHUNT_KIND_ROOF];
+	struct cached_value values[CONFIG_CONN_KEYWORD_ROOF];
+	struct cached_value end[END_ROOF][CONFIG_CONN_KEYWORD_ROOF];
+};
+
+#define ALIGN8(N) (((N) + 7) & ~(uint64_t)7)
+
+/*
+ * FNV-1a; this is detecting change, not tampering.
+ */
+
+static void hash_bytes(uint64_t *key, const void *ptr, size_t len)
+{
+	const uint8_t *bytes = ptr;
+	for (size_t i = 0; i < len; i++) {
+		*key ^= bytes[i];
+		*key *= UINT64_C(0x100000001b3);
+	}
+}
+
+#define hash_thing(KEY, THING) hash_bytes(KEY, &(THING), sizeof(THING))
+
+static bool hash_stat(uint64_t *key, const char *name, struct logger *logger)
+{
+	struct stat st;
+	if (stat(name, &st) < 0) {
+		ldbg(logger, "confcache: stat(%s) failed: %s", name, strerror(errno));
+		return false;
+	}
+	hash_thing(key, st.st_dev);
+	hash_thing(key, st.st_ino);
+	hash_thing(key, st.st_size);
+	hash_thing(key, st.st_mtim.tv_sec);
+	hash_thing(key, st.st_mtim.tv_nsec);
+	return true;
+}
+
+/*
+ * An include directory; catches a new file matching an include glob.
+ */
+
+static bool hash_dir(uint64_t *key, const char *name, struct logger *logger)
+{
+	hash_bytes(key, name, strlen(name) + 1);
+	return hash_stat(key, name, logger);
+}
+
+static bool hash_source(uint64_t *key, const char *name, struct logger *logger)
+{
+	hash_bytes(key, name, strlen(name) + 1);
+
+	if (!hash_stat(key, name, logger)) {
+		return false;
+	}
+
+	/* the contents */
+	FILE *f = fopen(name, "r");
+	if (f == NULL) {
+		ldbg(logger, "confcache: fopen(%s) failed: %s", name, strerror(errno));
+		return false;
+	}
+	char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+		hash_bytes(key, buf, n);
+	}
+	bool ok = !ferror(f);
+	fclose(f);
+	return ok;
+}
+
+static void hash_prologue(uint64_t *key)
+{
+	*key = UINT64_C(0xcbf29ce484222325);
+	const char *version = ipsec_version_string();
+	hash_bytes(key, version, strlen(version) + 1);
+	uint64_t sizes[] = {
+		sizeof(struct cached_header),
+		sizeof(struct cached_value),
+		sizeof(struct cached_conn),
+		CONFIG_SETUP_KEYWORD_ROOF,
+	};
+	hash_thing(key, sizes);
+}
+
+/*
+ * Load.
+ */
+
+struct cache {
+	const uint8_t *ptr;
+	uint64_t size;
+	const struct cached_header *header;
+	const char *strings;
+	uint64_t strings_size;
+};
+
+static bool cache_string(const struct cache *cache, uint32_t ref, char **string)
+{
+	if (ref == 0) {
+		*string = NULL;
+		return true;
+	}
+	if (ref > cache->strings_size) {
+		return false;
+	}
+	/* strings[] is NUL terminated, see below */
+	*string = clone_str(cache->strings + ref - 1, "confcache string");
+	return true;
+}
+
+static bool cache_value(const struct cache *cache,
+			const struct cached_value *cv,
+			struct keyword_value *kv)
+{
+	kv->set = cv->set;
+	kv->option = cv->option;
+	if (cv->deltatime_is_set) {
+		kv->deltatime = deltatime_from_microseconds(cv->deltatime);
+	}
+	return cache_string(cache, cv->string, &kv->string);
+}
+
+static bool cache_conn(const struct cache *cache,
+		       const struct cached_conn *cc,
+		       struct starter_conn *conn)
+{
+	conn->end[LEFT_END].leftright = "left";
+	conn->end[RIGHT_END].leftright = "right";
+	conn->state = cc->state;
+	for (unsigned i = 0; i < elemsof(conn->shunt); i++) {
+		conn->shunt[i] = cc->shunt[i];
+	}
+	bool ok = cache_string(cache, cc->name, &conn->name);
+	for (unsigned kw = 0; kw < elemsof(conn->values); kw++) {
+		ok &= cache_value(cache, &cc->values[kw], &conn->values[kw]);
+		FOR_EACH_THING(end, LEFT_END, RIGHT_END) {
+			ok &= cache_value(cache, &cc->end[end][kw],
+					  &conn->end[end].values[kw]);
+		}
+	}
+	return ok;
+}
+
+static bool cache_region(const struct cache *cache, uint64_t offset,
+			 uint64_t count, size_t size)
+{
+	return (offset % (size < 8 ? size : 8) == 0 &&
+		offset <= cache->size &&
+		count <= (cache->size - offset) / size);
+}
+
+static bool cache_valid(struct cache *cache, const char *file, struct logger *logger)
+{
+	if (cache->size < sizeof(struct cached_header)) {
+		return false;
+	}
+	const struct cached_header *h = cache->header = (const void *)cache->ptr;
+	if (memcmp(h->magic, CONFCACHE_MAGIC, sizeof(h->magic)) != 0 ||
+	    h->version != CONFCACHE_VERSION ||
+	    h->size != cache->size) {
+		ldbg(logger, "confcache: bad header");
+		return false;
+	}
+
+	if (!cache_region(cache, h->sources, h->nr_sources, sizeof(uint32_t)) ||
+	    !cache_region(cache, h->dirs, h->nr_dirs, sizeof(uint32_t)) ||
+	    !cache_region(cache, h->setup, CONFIG_SETUP_KEYWORD_ROOF, sizeof(struct cached_value)) ||
+	    !cache_region(cache, h->conns, h->nr_conns, sizeof(struct cached_conn)) ||
+	    h->nr_conns == 0 ||
+	    h->strings >= cache->size) {
+		ldbg(logger, "confcache: bad offsets");
+		return false;
+	}
+
+	cache->strings = (const char *)cache->ptr + h->strings;
+	cache->strings_size = cache->size - h->strings;
+	if (cache->strings[cache->strings_size - 1] != '\0') {
+		ldbg(logger, "confcache: strings not terminated");
+		return false;
+	}
+
+	/* the first source is FILE */
+	const uint32_t *sources = (const void *)(cache->ptr + h->sources);
+	if (h->nr_sources == 0 ||
+	    sources[0] == 0 || sources[0] > cache->strings_size ||
+	    !streq(cache->strings + sources[0] - 1, file)) {
+		ldbg(logger, "confcache: not for %s", file);
+		return false;
+	}
+
+	uint64_t key;
+	hash_prologue(&key);
+	for (unsigned i = 0; i < h->nr_sources; i++) {
+		if (sources[i] == 0 || sources[i] > cache->strings_size) {
+			return false;
+		}
+		if (!hash_source(&key, cache->strings + sources[i] - 1, logger)) {
+			return false;
+		}
+	}
+	const uint32_t *dirs = (const void *)(cache->ptr + h->dirs);
+	for (unsigned i = 0; i < h->nr_dirs; i++) {
+		if (dirs[i] == 0 || dirs[i] > cache->strings_size) {
+			return false;
+		}
+		if (!hash_dir(&key, cache->strings + dirs[i] - 1, logger)) {
+			return false;
+		}
+	}
+	if (key != h->key) {
+		ldbg(logger, "confcache: stale, sources changed");
+		return false;
+	}
+
+	return true;
+}
+
+struct starter_config *confcache_load(const char *cachefile,
+				      const char *file,
+				      struct logger *logger)
+{
+	int fd = open(cachefile, O_RDONLY|O_CLOEXEC);
+	if (fd < 0) {
+		ldbg(logger, "confcache: open(%s) failed: %s", cachefile, strerror(errno));
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) < 0 || st.st_size == 0) {
+		close(fd);
+		return NULL;
+	}
+
+	void *ptr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (ptr == MAP_FAILED) {
+		ldbg(logger, "confcache: mmap(%s) failed: %s", cachefile, strerror(errno));
+		return NULL;
+	}
+
+	struct cache cache = {
+		.ptr = ptr,
+		.size = st.st_size,
+	};
+
+	struct starter_config *cfg = NULL;
+	if (cache_valid(&cache, file, logger)) {
+		const struct cached_header *h = cache.header;
+		const struct cached_conn *conns = (const void *)(cache.ptr + h->conns);
+		const struct cached_value *setup = (const void *)(cache.ptr + h->setup);
+
+		cfg = alloc_thing(struct starter_config, "starter_config cfg");
+		TAILQ_INIT(&cfg->conns);
+
+		bool ok = cache_conn(&cache, &conns[0], &cfg->conn_default);
+		for (unsigned i = 1; ok && i < h->nr_conns; i++) {
+			struct starter_conn *conn = alloc_thing(struct starter_conn, "confcache starter_conn");
+			TAILQ_INSERT_TAIL(&cfg->conns, conn, link);
+			ok = cache_conn(&cache, &conns[i], conn);
+		}
+
+		for (unsigned kw = 1; ok && kw < CONFIG_SETUP_KEYWORD_ROOF; kw++) {
+			struct keyword_value kv = {0};
+			ok = cache_value(&cache, &setup[kw], &kv);
+			update_setup_keyword_value(kw, &kv);
+			pfreeany(kv.string);
+		}
+
+		if (!ok) {
+			ldbg(logger, "confcache: corrupt string reference");
+			confread_free(cfg);
+			cfg = NULL;
+		} else {
+			ldbg(logger, "confcache: loaded %ju connections from %s",
+			     (uintmax_t)h->nr_conns - 1, cachefile);
+		}
+	}
+
+	munmap(ptr, st.st_size);
+	return cfg;
+}
+
+/*
+ * Save.
+ */
+
+struct strings {
+	char *ptr;
+	size_t len;
+	size_t size;
+};
+
+static uint32_t save_string(struct strings *strings, const char *string)
+{
+	if (string == NULL) {
+		return 0;
+	}
+	size_t len = strlen(string) + 1;
+	if (strings->len + len > strings->size) {
+		size_t size = (strings->size + len) * 2;
+		realloc_bytes((void**)&strings->ptr, strings->size, size, "confcache strings");
+		strings->size = size;
+	}
+	memcpy(strings->ptr + strings->len, string, len);
+	strings->len += len;
+	return strings->len - len + 1;
+}
+
+static void save_value(struct strings *strings, struct cached_value *cv,
+		       const struct keyword_value *kv)
+{
+	cv->set = kv->set;
+	cv->string = save_string(strings, kv->string);
+	cv->option = kv->option;
+	cv->deltatime_is_set = kv->deltatime.is_set;
+	if (kv->deltatime.is_set) {
+		cv->deltatime = microseconds_from_deltatime(kv->deltatime);
+	}
+}
+
+static void save_conn(struct strings *strings, struct cached_conn *cc,
+		      const struct starter_conn *conn)
+{
+	cc->name = save_string(strings, conn->name);
+	cc->state = conn->state;
+	for (unsigned i = 0; i < elemsof(conn->shunt); i++) {
+		cc->shunt[i] = conn->shunt[i];
+	}
+	for (unsigned kw = 0; kw < elemsof(conn->values); kw++) {
+		save_value(strings, &cc->values[kw], &conn->values[kw]);
+		FOR_EACH_THING(end, LEFT_END, RIGHT_END) {
+			save_value(strings, &cc->end[end][kw],
+				   &conn->end[end].values[kw]);
+		}
+	}
+}
+
+static bool write_all(int fd, const void *ptr, size_t len)
+{
+	return (len == 0 || write(fd, ptr, len) == (ssize_t)len);
+}
+
+void confcache_save(const char *cachefile,
+		    const struct starter_config *cfg,
+		    const struct ipsec_conf *ipsec_conf,
+		    struct logger *logger)
+{
+	/*
+	 * Only cache a clean load; otherwise errors go unreported
+	 * the next time round.
+	 */
+	unsigned nr_conns = 1; /* %default */
+	const struct starter_conn *conn;
+	TAILQ_FOREACH(conn, &cfg->conns, link) {
+		if (conn->state != STATE_LOADED) {
+			ldbg(logger, "confcache: not saving, conn %s did not load", conn->name);
+			return;
+		}
+		nr_conns++;
+	}
+
+	struct strings strings = {0};
+	uint64_t key;
+	hash_prologue(&key);
+
+	unsigned nr_sources = 0;
+	const struct ipsec_conf_source *source;
+	TAILQ_FOREACH(source, &ipsec_conf->sources, next) {
+		nr_sources++;
+	}
+	unsigned nr_dirs = 0;
+	TAILQ_FOREACH(source, &ipsec_conf->include_dirs, next) {
+		nr_dirs++;
+	}
+	/* +1 as nr_dirs can be zero */
+	uint32_t *refs = alloc_things(uint32_t, nr_sources + nr_dirs + 1, "confcache sources");
+	unsigned r = 0;
+	TAILQ_FOREACH(source, &ipsec_conf->sources, next) {
+		if (streq(source->name, "-") ||
+		    !hash_source(&key, source->name, logger)) {
+			ldbg(logger, "confcache: not saving, can't hash %s", source->name);
+			pfree(refs);
+			pfreeany(strings.ptr);
+			return;
+		}
+		refs[r++] = save_string(&strings, source->name);
+	}
+	TAILQ_FOREACH(source, &ipsec_conf->include_dirs, next) {
+		if (!hash_dir(&key, source->name, logger)) {
+			ldbg(logger, "confcache: not saving, can't hash %s", source->name);
+			pfree(refs);
+			pfreeany(strings.ptr);
+			return;
+		}
+		refs[r++] = save_string(&strings, source->name);
+	}
+
+	const struct config_setup *oco = config_setup_singleton();
+	struct cached_value *setup = alloc_things(struct cached_value,
+						  CONFIG_SETUP_KEYWORD_ROOF,
+						  "confcache setup");
+	for (unsigned kw = 0; kw < CONFIG_SETUP_KEYWORD_ROOF; kw++) {
+		save_value(&strings, &setup[kw], &oco->values[kw]);
+	}
+
+	struct cached_conn *conns = alloc_things(struct cached_conn, nr_conns,
+						 "confcache conns");
+	save_conn(&strings, &conns[0], &cfg->conn_default);
+	unsigned c = 1;
+	TAILQ_FOREACH(conn, &cfg->conns, link) {
+		save_conn(&strings, &conns[c++], conn);
+	}
+
+	struct cached_header header = {
+		.magic = CONFCACHE_MAGIC,
+		.version = CONFCACHE_VERSION,
+		.key = key,
+		.nr_sources = nr_sources,
+		.nr_dirs = nr_dirs,
+		.nr_conns = nr_conns,
+	};
+	header.sources = ALIGN8(sizeof(header));
+	header.dirs = header.sources + nr_sources * sizeof(uint32_t);
+	header.setup = ALIGN8(header.dirs + nr_dirs * sizeof(uint32_t));
+	header.conns = ALIGN8(header.setup + CONFIG_SETUP_KEYWORD_ROOF * sizeof(struct cached_value));
+	header.strings = header.conns + nr_conns * sizeof(struct cached_conn);
+	header.size = header.strings + strings.len;
+
+	/*
+	 * Write to a temporary and then rename so that a reader
+	 * never sees a partial file.
+	 */
+	static const uint8_t zeros[8];
+	char tmp[PATH_MAX];
+	int n = snprintf(tmp, sizeof(tmp), "%s.tmp", cachefile);
+	if (n < 0 || (size_t)n >= sizeof(tmp)) {
+		llog(RC_LOG, logger, "confcache: '%s' is too long", cachefile);
+		pfree(refs);
+		pfree(setup);
+		pfree(conns);
+		pfreeany(strings.ptr);
+		return;
+	}
+	int fd = open(tmp, O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0600);
+	if (fd < 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "confcache: could not create '%s': ", tmp);
+	} else if (!write_all(fd, &header, sizeof(header)) ||
+		   !write_all(fd, zeros, header.sources - sizeof(header)) ||
+		   !write_all(fd, refs, (nr_sources + nr_dirs) * sizeof(uint32_t)) ||
+		   !write_all(fd, zeros, header.setup - (header.dirs + nr_dirs * sizeof(uint32_t))) ||
+		   !write_all(fd, setup, CONFIG_SETUP_KEYWORD_ROOF * sizeof(struct cached_value)) ||
+		   !write_all(fd, zeros, header.conns - (header.setup + CONFIG_SETUP_KEYWORD_ROOF * sizeof(struct cached_value))) ||
+		   !write_all(fd, conns, nr_conns * sizeof(struct cached_conn)) ||
+		   !write_all(fd, strings.ptr, strings.len)) {
+		llog_errno(RC_LOG, logger, errno,
+			   "confcache: could not write '%s': ", tmp);
+		close(fd);
+		unlink(tmp);
+	} else if (close(fd) < 0 || rename(tmp, cachefile) < 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "confcache: could not save '%s': ", cachefile);
+		unlink(tmp);
+	} else {
+		ldbg(logger, "confcache: saved %u connections to %s",
+		     nr_conns - 1, cachefile);
+	}
+
+	pfree(conns);
+	pfree(setup);
+	pfree(refs);
+	pfreeany(strings.ptr);
+}
@@ -193,6 +193,7 @@ static const struct keyword_def config_conn_keyword[] = {
   K("rekeymargin",  LEMPTY,  kt_seconds,  KNCF_REKEYMARGIN),
   K("rekeyfuzz",  LEMPTY,  kt_string,  KWS_REKEYFUZZ),
   K("replay-window",  LEMPTY,  kt_string,  KWS_REPLAY_WINDOW),
+  K("ike-window",  LEMPTY,  kt_string,  KWS_IKE_WINDOW),
   K("ikelifetime",  LEMPTY,  kt_seconds,  KNCF_IKELIFETIME),
   K("failureshunt",  LEMPTY,  kt_sparse_name,  KNCF_FAILURESHUNT, .sparse_names = &failure_shunt_names),
   K("negotiationshunt",  LEMPTY,  kt_sparse_name,  KNCF_NEGOTIATIONSHUNT, .sparse_names = &negotiation_shunt_names),
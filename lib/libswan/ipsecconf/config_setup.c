@@ -80,6 +80,22 @@ void update_setup_option(enum config_setup_keyword kw, uintmax_t option)
 	kv->set = k_set;
 }
 
+/*
+ * Restore a value verbatim, including .set (used when loading a
+ * compiled config).
+ */
+
+void update_setup_keyword_value(enum config_setup_keyword kw,
+				const struct keyword_value *value)
+{
+	config_setup_singleton();
+	passert(kw < elemsof(config_setup.values));
+	struct keyword_value *kv = &config_setup.values[kw];
+	pfreeany(kv->string);
+	*kv = *value;
+	kv->string = clone_str(value->string, "kv");
+}
+
 const struct config_setup *config_setup_singleton(void)
 {
 	if (!config_setup_is_set) {
@@ -451,6 +467,10 @@ static const struct keyword_def config_setup_keyword[] = {
 
   K("global-redirect", kt_sparse_name, KBF_GLOBAL_REDIRECT, .sparse_names = &global_redirect_names),
   K("global-redirect-to", kt_string, KSF_GLOBAL_REDIRECT_TO),
+  K("global-redirect-load", kt_unsigned, KBF_GLOBAL_REDIRECT_LOAD),
+  K("global-redirect-capacity", kt_unsigned, KBF_GLOBAL_REDIRECT_CAPACITY),
+  K("global-redirect-peers", kt_string, KSF_GLOBAL_REDIRECT_PEERS),
+  K("global-redirect-load-socket", kt_string, KSF_GLOBAL_REDIRECT_LOAD_SOCKET),
 
   K("crl-strict",  kt_sparse_name,  KYN_CRL_STRICT, .sparse_names = &yn_option_names),
   K("crlcheckinterval",  kt_seconds,  KBF_CRL_CHECKINTERVAL),
@@ -477,6 +497,11 @@ static const struct keyword_def config_setup_keyword[] = {
   K("ddos-mode",  kt_sparse_name,  KBF_DDOS_MODE, .sparse_names = &ddos_mode_names),
   K("ddos-ike-threshold",  kt_unsigned,  KBF_DDOS_IKE_THRESHOLD),
   K("max-halfopen-ike",  kt_unsigned,  KBF_MAX_HALFOPEN_IKE),
+  K("initiate-rate",  kt_unsigned,  KBF_INITIATE_RATE),
+  K("rekey-rate",  kt_unsigned,  KBF_REKEY_RATE),
+  K("warm-restart",  kt_sparse_name,  KYN_WARM_RESTART, .sparse_names = &yn_option_names),
+  K("replicate-to",  kt_string,  KSF_REPLICATE_TO),
+  K("replicate-from",  kt_string,  KSF_REPLICATE_FROM),
 
   K("ike-socket-bufsize",  kt_unsigned,  KBF_IKE_SOCKET_BUFSIZE),
   K("ike-socket-errqueue",  kt_sparse_name,  KYN_IKE_SOCKET_ERRQUEUE, .sparse_names = &yn_option_names),
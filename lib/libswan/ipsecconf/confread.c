@@ -42,6 +42,7 @@
 #include "ip_cidr.h"
 #include "ttodata.h"
 #include "ipsecconf/config_setup.h"
+#include "ipsecconf/confcache.h"
 
 #include "ipsecconf/parser.h"
 #include "ipsecconf/confread.h"
@@ -405,10 +406,11 @@ static struct starter_conn *alloc_add_conn(struct starter_config *cfg, const cha
 	return conn;
 }
 
-struct starter_config *confread_load(const char *file,
-				     bool setuponly,
-				     struct logger *logger,
-				     unsigned verbosity)
+static struct starter_config *load_ipsec_conf(const char *file,
+					      bool setuponly,
+					      const char *cachefile,
+					      struct logger *logger,
+					      unsigned verbosity)
 {
 	check_ipsec_conf_keywords(logger);
 
@@ -440,10 +442,38 @@ struct starter_config *confread_load(const char *file,
 		}
 	}
 
+	if (cachefile != NULL) {
+		confcache_save(cachefile, cfg, ipsec_conf, logger);
+	}
+
 	pfree_ipsec_conf(&ipsec_conf);
 	return cfg;
 }
 
+struct starter_config *confread_load(const char *file,
+				     bool setuponly,
+				     struct logger *logger,
+				     unsigned verbosity)
+{
+	return load_ipsec_conf(file, setuponly, /*cachefile*/NULL,
+			       logger, verbosity);
+}
+
+struct starter_config *confread_load_cached(const char *file,
+					    const char *cachefile,
+					    struct logger *logger,
+					    unsigned verbosity)
+{
+	struct starter_config *cfg = confcache_load(cachefile, file, logger);
+	if (cfg != NULL) {
+		ldbg(logger, "using compiled config '%s' for '%s'", cachefile, file);
+		return cfg;
+	}
+
+	return load_ipsec_conf(file, /*setuponly*/false, cachefile,
+			       logger, verbosity);
+}
+
 bool parse_ipsec_conf_config_conn(struct starter_config *cfg,
 				  struct ipsec_conf *cfgp,
 				  struct logger *logger)
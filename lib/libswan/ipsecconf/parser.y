@@ -27,6 +27,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <sys/stat.h>
 #define YYDEBUG 1
 
 #include "deltatime.h"
@@ -41,6 +42,7 @@
 #include "lmod.h"
 #include "sparse_names.h"
 #include "lswalloc.h"
+#include "lswglob.h"
 
 #define YYERROR_VERBOSE
 #define ERRSTRING_LEN	256
@@ -280,6 +282,7 @@ struct ipsec_conf *alloc_ipsec_conf(void)
 	TAILQ_INIT(&cfgp->config_setup);
 	TAILQ_INIT(&cfgp->sections);
 	TAILQ_INIT(&cfgp->sources);
+	TAILQ_INIT(&cfgp->include_dirs);
 	return cfgp;
 }
 
@@ -456,6 +459,96 @@ const char *add_ipsec_conf_source(struct ipsec_conf *cfg, const char *name)
 	return source->name;
 }
 
+static void add_include_dir(struct ipsec_conf *cfg, const char *dir)
+{
+	struct ipsec_conf_source *source;
+	TAILQ_FOREACH(source, &cfg->include_dirs, next) {
+		if (streq(source->name, dir)) {
+			return;
+		}
+	}
+
+	source = alloc_thing(struct ipsec_conf_source, __func__);
+	source->name = clone_str(dir, __func__);
+	TAILQ_INSERT_TAIL(&cfg->include_dirs, source, next);
+}
+
+struct lswglob_context {
+	struct ipsec_conf *cfg;
+};
+
+static void include_dir_callback(unsigned count, char **dirs,
+				 struct lswglob_context *context,
+				 struct logger *logger UNUSED)
+{
+	for (unsigned i = 0; i < count; i++) {
+		struct stat st;
+		if (stat(dirs[i], &st) == 0 && S_ISDIR(st.st_mode)) {
+			add_include_dir(context->cfg, dirs[i]);
+		}
+	}
+}
+
+/*
+ * Record the directories that the include PATTERN is globbed in so
+ * that a file appearing there can be noticed.  Like
+ * scanner_include(), a relative pattern is resolved against the
+ * current directory (recorded as an absolute path), and a directory
+ * part containing wildcards is itself globbed (and its parent
+ * recorded).
+ */
+
+void add_ipsec_conf_include_dir(struct ipsec_conf *cfg, const char *pattern,
+				struct logger *logger)
+{
+	const char *slash = strrchr(pattern, '/');
+	char *dir = (slash == NULL ? clone_str(".", __func__) :
+		     slash == pattern ? clone_str("/", __func__) :
+		     clone_bytes(pattern, slash - pattern + 1, __func__));
+	if (slash != NULL && slash != pattern) {
+		dir[slash - pattern] = '\0';
+	}
+
+	if (dir[0] != '/') {
+		char cwd[PATH_MAX];
+		if (getcwd(cwd, sizeof(cwd)) == NULL) {
+			llog_errno(RC_LOG, logger, errno,
+				   "include directory '%s' not recorded, getcwd() failed: ", dir);
+			pfree(dir);
+			return;
+		}
+		char *abs = (streq(dir, ".") ? clone_str(cwd, __func__) :
+			     alloc_printf("%s/%s", cwd, dir));
+		pfree(dir);
+		dir = abs;
+	}
+
+	if (strpbrk(dir, "*?[") == NULL) {
+		add_include_dir(cfg, dir);
+		pfree(dir);
+		return;
+	}
+
+	/* e.g., /etc/ipsec.d/<asterisk>/ipsec.conf */
+	add_ipsec_conf_include_dir(cfg, dir, logger);
+	struct lswglob_context context = {
+		.cfg = cfg,
+	};
+	lswglob(dir, "ipsec.conf", include_dir_callback, &context, logger);
+	pfree(dir);
+}
+
+static void pfree_ipsec_conf_sources(struct ipsec_conf_sources *sources)
+{
+	/* keep deleting the first entry */
+	struct ipsec_conf_source *source;
+	while ((source = TAILQ_FIRST(sources)) != NULL) {
+		TAILQ_REMOVE(sources, source, next);
+		pfreeany(source->name);
+		pfreeany(source);
+	}
+}
+
 void pfree_ipsec_conf(struct ipsec_conf **cfgp)
 {
 	if ((*cfgp) != NULL) {
@@ -471,13 +564,8 @@ void pfree_ipsec_conf(struct ipsec_conf **cfgp)
 			pfree(section);
 		}
 
-		/* keep deleting the first entry */
-		struct ipsec_conf_source *source;
-		while ((source = TAILQ_FIRST(&cfg->sources)) != NULL) {
-			TAILQ_REMOVE(&cfg->sources, source, next);
-			pfreeany(source->name);
-			pfreeany(source);
-		}
+		pfree_ipsec_conf_sources(&cfg->sources);
+		pfree_ipsec_conf_sources(&cfg->include_dirs);
 
 		pfreeany(*cfgp);
 	}
@@ -32,6 +32,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <time.h>
+#include <fcntl.h>		/* for open() */
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -68,9 +69,6 @@ struct fld {
 	ssize_t offset;
 };
 
-static void process_secrets_file(struct file_lex_position *flp,
-				 struct secret **psecrets, const char *file_pat);
-
 struct secret {
 	enum secret_kind kind;
 	/*
@@ -697,8 +695,99 @@ static void add_secret(struct secret **slist,
 	unlock_certs_and_keys(story, logger);
 }
 
+/*
+ * ipsec.secrets, and each file it includes, is parsed into a struct
+ * secret_file.  Its records are kept in read order as a sequence of
+ * items: either a run of secrets or an include.
+ *
+ * Parsing can be done off the main thread (see
+ * lsw_parse_secret_files()).  A file whose contents hash the same as
+ * at the last load isn't re-parsed, instead its runs are borrowed
+ * from the previous load.  lsw_publish_secret_files() then threads
+ * the runs into the single SECRETS list that the lookup functions
+ * walk.
+ */
+
+struct secret_file_item {
+	char *include;			/* pattern, or NULL */
+	unsigned nr_files;		/* include: glob()ed files */
+	struct secret_file **files;
+	struct secret *secrets;		/* run: newest first */
+	struct secret *last;		/* run: oldest */
+};
+
+struct secret_file {
+	char *name;
+	uint8_t hash[32];		/* SHA2_256 of the contents */
+	bool ok;			/* contents were hashed */
+	bool borrowed;			/* runs belong to .old */
+	bool published;			/* runs are in the list */
+	struct secret_file *old;
+	unsigned nr_items;
+	struct secret_file_item *items;
+	struct secret_file *next;	/* in discovery order */
+	struct secret_file *queue;
+};
+
+struct secret_files {
+	struct secret_file *files;
+	struct secret_file *root;	/* not a real file */
+	struct secret *head;		/* list as published */
+	/* parse */
+	const struct secret_files *old;
+	struct secret_file *queue;
+	struct secret_file **tail;
+	struct logger *logger;
+};
+
+static void free_secret(struct secret *s)
+{
+	struct id_list *i, *ni;
+	for (i = s->ids; i != NULL; i = ni) {
+		ni = i->next;	/* grab before freeing i */
+		free_id_content(&i->id);
+		pfree(i);
+	}
+	switch (s->kind) {
+	case SECRET_PSK:
+		pfreeany(s->u.preshared);
+		break;
+	case SECRET_PPK:
+		pfreeany(s->u.ppk);
+		break;
+	case SECRET_XAUTH:
+		pfreeany(s->u.preshared);
+		break;
+	case SECRET_RSA:
+	case SECRET_ECDSA:
+	case SECRET_EDDSA:
+		secret_pubkey_stuff_delref(&s->u.pubkey, HERE);
+		break;
+	default:
+		bad_case(s->kind);
+	}
+	pfree(s);
+}
+
+static void free_secret_run(struct secret_file_item *item)
+{
+	struct secret *s = item->secrets;
+	while (s != NULL) {
+		struct secret *ns = (s == item->last ? NULL : s->next);
+		free_secret(s);
+		s = ns;
+	}
+	item->secrets = item->last = NULL;
+}
+
+static struct secret_file_item *add_secret_file_item(struct secret_file *file)
+{
+	realloc_things(file->items, file->nr_items, file->nr_items + 1, "secret file items");
+	return &file->items[file->nr_items++];
+}
+
 static void process_secret(struct file_lex_position *flp,
-			   struct secret **psecrets, struct secret *s)
+			   struct secret_file *file, struct secret *s)
 {
 	diag_t ugh = NULL;
 
@@ -750,16 +839,23 @@ static void process_secret(struct file_lex_position *flp,
 	}
 
 	if (flushline(flp, "expected record boundary in key")) {
-		/* gauntlet has been run: install new secret */
-		add_secret(psecrets, s, "process_secret", flp->logger);
+		/*
+		 * Gauntlet has been run: add the new secret to the
+		 * file's current run.
+		 */
+		struct secret_file_item *run =
+			(file->nr_items > 0 && file->items[file->nr_items - 1].include == NULL ?
+			 &file->items[file->nr_items - 1] : add_secret_file_item(file));
+		if (run->last == NULL) {
+			run->last = s;
+		}
+		add_secret(&run->secrets, s, "process_secret", flp->logger);
 	}
 }
 
 static void process_secret_records(struct file_lex_position *flp,
-				   struct secret **psecrets)
+				   struct secret_file *file)
 {
-	/* const struct secret *secret = *psecrets; */
-
 	/* read records from ipsec.secrets and load them into our table */
 	for (;; ) {
 		flushline(flp, NULL);	/* silently ditch leftovers, if any */
@@ -817,7 +913,9 @@ static void process_secret_records(struct file_lex_position *flp,
 			memcpy(p, flp->tok, flp->cur - flp->tok + 1);
 			shift(flp);	/* move to Record Boundary, we hope */
 			if (flushline(flp, "ignoring malformed INCLUDE -- expected Record Boundary after filename")) {
-				process_secrets_file(flp, psecrets, fn);
+				/* glob()ed, and parsed, later */
+				struct secret_file_item *include = add_secret_file_item(file);
+				include->include = clone_str(fn, "secrets include");
 				flp->tok = NULL;	/* redundant? */
 			}
 		} else {
@@ -836,7 +934,7 @@ static void process_secret_records(struct file_lex_position *flp,
 				if (tokeq(flp, ":")) {
 					/* found key part */
 					shift(flp);	/* eat ":" */
-					process_secret(flp, psecrets, s);
+					process_secret(flp, file, s);
 					break;
 				}
 
@@ -892,49 +990,322 @@ static void process_secret_records(struct file_lex_position *flp,
 	}
 }
 
+/*
+ * Find, or add and queue for parsing, NAME.
+ */
+
+static struct secret_file *secret_file_by_name(struct secret_files *files,
+					       const char *name)
+{
+	for (struct secret_file *file = files->files; file != NULL; file = file->next) {
+		if (streq(file->name, name)) {
+			return file;
+		}
+	}
+
+	struct secret_file *file = alloc_thing(struct secret_file, "secret file");
+	file->name = clone_str(name, "secret file name");
+	file->next = files->files;
+	files->files = file;
+	*files->tail = file;
+	files->tail = &file->queue;
+	return file;
+}
+
 struct lswglob_context {
-	struct file_lex_position *oflp;
-	struct secret **psecrets;
+	struct secret_files *files;
+	struct secret_file_item *include;
 };
 
-static void process_secret_files(unsigned count, char **files,
-				 struct lswglob_context *context,
-				 struct logger *logger UNUSED)
+static void glob_secret_files(unsigned count, char **names,
+			      struct lswglob_context *context,
+			      struct logger *logger UNUSED)
 {
+	struct secret_file_item *include = context->include;
+	include->files = alloc_things(struct secret_file *, count, "secret include files");
 	for (unsigned i = 0; i < count; i++) {
-		const char *file = files[i];
+		include->files[include->nr_files++] =
+			secret_file_by_name(context->files, names[i]);
+	}
+}
+
+static void glob_secret_file_includes(struct secret_files *files,
+				      struct secret_file *file)
+{
+	for (unsigned i = 0; i < file->nr_items; i++) {
+		struct secret_file_item *include = &file->items[i];
+		if (include->include == NULL) {
+			continue;
+		}
+		struct lswglob_context context = {
+			.files = files,
+			.include = include,
+		};
+		if (!lswglob(include->include, "secrets", glob_secret_files,
+			     &context, files->logger)) {
+			llog(RC_LOG, files->logger,
+			     "no secrets filename matched \"%s\"", include->include);
+		}
+	}
+}
+
+static const struct secret_file *old_secret_file(const struct secret_files *old,
+						 const char *name)
+{
+	if (old == NULL) {
+		return NULL;
+	}
+	for (const struct secret_file *file = old->files; file != NULL; file = file->next) {
+		if (streq(file->name, name)) {
+			return file;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Hash the contents, and not stat(), as a file rewritten within the
+ * same timestamp, or put back with its old mtime, must be re-parsed.
+ */
+
+static bool hash_secret_file(struct secret_file *file, struct logger *logger)
+{
+	int fd = open(file->name, O_RDONLY|O_CLOEXEC);
+	if (fd < 0) {
+		llog_errno(ERROR_STREAM, logger, errno,
+			   "could not open \"%s\": ", file->name);
+		return false;
+	}
+
+	struct crypt_hash *hash = crypt_hash_init("secrets file",
+						  &ike_alg_hash_sha2_256,
+						  logger);
+	uint8_t buf[4096];
+	ssize_t n;
+	while ((n = read(fd, buf, sizeof(buf))) > 0) {
+		crypt_hash_digest_bytes(hash, "contents", buf, n);
+	}
+	if (n < 0) {
+		llog_errno(ERROR_STREAM, logger, errno,
+			   "could not read \"%s\": ", file->name);
+	}
+	close(fd);
+
+	/* always finish, so that the hash is released */
+	PASSERT(logger, ike_alg_hash_sha2_256.hash_digest_size == sizeof(file->hash));
+	crypt_hash_final_bytes(&hash, file->hash, sizeof(file->hash));
+	return (n == 0);
+}
+
+static void load_secret_file(struct secret_files *files,
+			     struct secret_file *file)
+{
+	if (!hash_secret_file(file, files->logger)) {
+		return;
+	}
+	file->ok = true;
+
+	const struct secret_file *o = old_secret_file(files->old, file->name);
+	if (o != NULL && o->ok &&
+	    memeq(o->hash, file->hash, sizeof(file->hash))) {
+		ldbg(files->logger, "secrets from \"%s\" are unchanged", file->name);
+		file->borrowed = true;
+		file->old = DISCARD_CONST(struct secret_file *, o);
+		file->nr_items = o->nr_items;
+		file->items = alloc_things(struct secret_file_item, o->nr_items, "secret file items");
+		for (unsigned i = 0; i < o->nr_items; i++) {
+			file->items[i].include = clone_str(o->items[i].include, "secrets include");
+			file->items[i].secrets = o->items[i].secrets;
+			file->items[i].last = o->items[i].last;
+		}
+	} else {
+		struct file_lex_position oflp = {
+			.logger = files->logger,
+		};
 		struct file_lex_position *flp = NULL;
-		if (lexopen(&flp, file, false, context->oflp)) {
-			llog(RC_LOG, flp->logger,
-			     "loading secrets from \"%s\"", file);
-			flushline(flp, "file starts with indentation (continuation notation)");
-			process_secret_records(flp, context->psecrets);
-			lexclose(&flp);
+		if (!lexopen(&flp, file->name, false, &oflp)) {
+			file->ok = false;
+			return;
+		}
+		llog(RC_LOG, flp->logger, "loading secrets from \"%s\"", file->name);
+		flushline(flp, "file starts with indentation (continuation notation)");
+		process_secret_records(flp, file);
+		lexclose(&flp);
+	}
+
+	glob_secret_file_includes(files, file);
+}
+
+struct secret_files *lsw_parse_secret_files(const struct secret_files *old,
+					    const char *secrets_file,
+					    struct logger *logger)
+{
+	struct secret_files *files = alloc_thing(struct secret_files, "secret files");
+	files->logger = logger;
+	files->old = old;
+	files->tail = &files->queue;
+
+	/*
+	 * The root is a pretend file containing a single include of
+	 * SECRETS_FILE.
+	 */
+	files->root = alloc_thing(struct secret_file, "secret files root");
+	struct secret_file_item *include = add_secret_file_item(files->root);
+	include->include = clone_str(secrets_file, "secrets include");
+	glob_secret_file_includes(files, files->root);
+
+	/* parsing a file queues the files it includes */
+	while (files->queue != NULL) {
+		struct secret_file *file = files->queue;
+		files->queue = file->queue;
+		if (files->queue == NULL) {
+			files->tail = &files->queue;
+		}
+		load_secret_file(files, file);
+	}
+
+	files->old = NULL;
+	files->logger = NULL;
+	return files;
+}
+
+static void free_secret_file(struct secret_file **filep)
+{
+	struct secret_file *file = *filep;
+	for (unsigned i = 0; i < file->nr_items; i++) {
+		struct secret_file_item *item = &file->items[i];
+		pfreeany(item->include);
+		pfreeany(item->files);
+		if (!file->borrowed && !file->published) {
+			free_secret_run(item);
 		}
 	}
+	pfreeany(file->items);
+	pfreeany(file->name);
+	pfree(file);
+	*filep = NULL;
 }
 
-static void process_secrets_file(struct file_lex_position *oflp,
-				 struct secret **psecrets, const char *file_pat)
+/*
+ * Free FILES; when .published its secrets were freed along with the
+ * list.
+ */
+
+void lsw_free_secret_files(struct secret_files **filesp)
 {
-	if (oflp->depth > 10) {
-		llog(RC_LOG, oflp->logger,
-			    "preshared secrets file \"%s\" nested too deeply",
-			    file_pat);
+	struct secret_files *files = *filesp;
+	if (files == NULL) {
 		return;
 	}
+	while (files->files != NULL) {
+		struct secret_file *file = files->files;
+		files->files = file->next;
+		free_secret_file(&file);
+	}
+	free_secret_file(&files->root);
+	pfree(files);
+	*filesp = NULL;
+}
 
-	struct lswglob_context context = {
-		.oflp = oflp,
-		.psecrets = psecrets,
-	};
-	if (!lswglob(file_pat, "secrets", process_secret_files,
-		     &context, oflp->logger)) {
-		llog(RC_LOG, oflp->logger, "no secrets filename matched \"%s\"", file_pat);
+/*
+ * Thread FILE's runs onto the front of HEAD, in read order so that,
+ * as before, the newest secret is first.
+ */
+
+static void link_secret_file(struct secret_file *file, unsigned depth,
+			     struct secret **head, struct logger *logger)
+{
+	if (depth > 10) {
+		llog(RC_LOG, logger,
+		     "preshared secrets file \"%s\" nested too deeply",
+		     file->name);
+		return;
+	}
+	if (file->published) {
+		ldbg(logger, "secrets file \"%s\" already included", file->name);
+		return;
+	}
+	file->published = true;
+
+	for (unsigned i = 0; i < file->nr_items; i++) {
+		struct secret_file_item *item = &file->items[i];
+		if (item->include != NULL) {
+			for (unsigned f = 0; f < item->nr_files; f++) {
+				link_secret_file(item->files[f], depth + 1, head, logger);
+			}
+		} else if (item->secrets != NULL) {
+			item->last->next = *head;
+			*head = item->secrets;
+		}
+	}
+}
+
+void lsw_publish_secret_files(struct secret **psecrets,
+			      struct secret_files **filesp,
+			      struct secret_files **new_filesp,
+			      struct logger *logger)
+{
+	struct secret_files *old = *filesp;
+	struct secret_files *new = *new_filesp;
+	*new_filesp = NULL;
+
+	lock_certs_and_keys("publish_secret_files", logger);
+
+	/*
+	 * Secrets added since the last publish (private keys loaded
+	 * from NSS) are in front of the old list; forget them.
+	 */
+	struct secret *end = (old == NULL ? NULL : old->head);
+	for (struct secret *s = *psecrets; s != NULL && s != end; ) {
+		struct secret *ns = s->next;
+		free_secret(s);
+		s = ns;
+	}
+
+	/* take ownership of any unchanged runs */
+	for (struct secret_file *file = new->files; file != NULL; file = file->next) {
+		if (file->borrowed) {
+			for (unsigned i = 0; i < file->old->nr_items; i++) {
+				file->old->items[i].secrets = NULL;
+				file->old->items[i].last = NULL;
+			}
+			file->old = NULL;
+			file->borrowed = false;
+		}
+	}
+
+	/* what's left of old isn't in the new list */
+	if (old != NULL) {
+		for (struct secret_file *file = old->files; file != NULL; file = file->next) {
+			for (unsigned i = 0; i < file->nr_items; i++) {
+				free_secret_run(&file->items[i]);
+			}
+		}
+		lsw_free_secret_files(&old);
+	}
+
+	/* thread the runs; drop any that didn't get used */
+	struct secret *head = NULL;
+	link_secret_file(new->root, 0, &head, logger);
+	for (struct secret_file *file = new->files; file != NULL; file = file->next) {
+		if (!file->published) {
+			for (unsigned i = 0; i < file->nr_items; i++) {
+				free_secret_run(&file->items[i]);
+			}
+			file->published = true;
+		}
 	}
+
+	new->head = head;
+	*psecrets = head;
+	*filesp = new;
+
+	unlock_certs_and_keys("publish_secret_files", logger);
 }
 
-void lsw_free_preshared_secrets(struct secret **psecrets, struct logger *logger)
+void lsw_free_preshared_secrets(struct secret **psecrets,
+				struct secret_files **filesp,
+				struct logger *logger)
 {
 	lock_certs_and_keys("free_preshared_secrets", logger);
 
@@ -944,49 +1315,25 @@ void lsw_free_preshared_secrets(struct secret **psecrets, struct logger *logger)
 		llog(RC_LOG, logger, "forgetting secrets");
 
 		for (s = *psecrets; s != NULL; s = ns) {
-			struct id_list *i, *ni;
-
 			ns = s->next;	/* grab before freeing s */
-			for (i = s->ids; i != NULL; i = ni) {
-				ni = i->next;	/* grab before freeing i */
-				free_id_content(&i->id);
-				pfree(i);
-			}
-			switch (s->kind) {
-			case SECRET_PSK:
-				pfreeany(s->u.preshared);
-				break;
-			case SECRET_PPK:
-				pfreeany(s->u.ppk);
-				break;
-			case SECRET_XAUTH:
-				pfreeany(s->u.preshared);
-				break;
-			case SECRET_RSA:
-			case SECRET_ECDSA:
-			case SECRET_EDDSA:
-				secret_pubkey_stuff_delref(&s->u.pubkey, HERE);
-				break;
-			default:
-				bad_case(s->kind);
-			}
-			pfree(s);
+			free_secret(s);
 		}
 		*psecrets = NULL;
 	}
 
+	/* its secrets were all in the list */
+	lsw_free_secret_files(filesp);
+
 	unlock_certs_and_keys("free_preshared_secrets", logger);
 }
 
-void lsw_load_preshared_secrets(struct secret **psecrets, const char *secrets_file,
+void lsw_load_preshared_secrets(struct secret **psecrets,
+				struct secret_files **filesp,
+				const char *secrets_file,
 				struct logger *logger)
 {
-	lsw_free_preshared_secrets(psecrets, logger);
-	struct file_lex_position flp = {
-		.logger = logger,
-		.depth = 0,
-	};
-	process_secrets_file(&flp, psecrets, secrets_file);
+	struct secret_files *new = lsw_parse_secret_files(*filesp, secrets_file, logger);
+	lsw_publish_secret_files(psecrets, filesp, &new, logger);
 }
 
 struct pubkey *pubkey_addref_where(struct pubkey *pk, where_t where)
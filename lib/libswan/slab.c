@@ -0,0 +1,213 @@
+/* Slab allocator, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#include <pthread.h>	/* pthread.h must be first include file */
+#include <stdlib.h>
+#include <string.h>
+
+#include "lswalloc.h"
+#include "passert.h"
+#include "lswlog.h"		/* for global_logger */
+
+/*
+ * Each slab has a free list protected by a mutex, and each thread
+ * has a small cache of free objects for each slab.
+ *
+ * Allocating pops the calling thread's cache; when that is empty a
+ * batch is moved across from the slab's free list, and when that is
+ * empty a new chunk is carved up.
+ *
+ * Freeing pushes onto the calling thread's cache (the object may have
+ * been allocated by another thread); when that grows too large a
+ * batch is moved back to the slab's free list.
+ *
+ * Objects sitting in the cache of a thread that exits are lost.  The
+ * only threads are pluto's long-lived helpers, so that doesn't
+ * happen.
+ */
+
+#define MAX_SLABS 16
+#define SLAB_CHUNK_OBJECTS 64
+#define SLAB_CACHE_BATCH 16
+
+struct free_object {
+	struct free_object *next;
+};
+
+struct slab_private {
+	unsigned index;
+	size_t object_size;	/* rounded up */
+	pthread_mutex_t mutex;
+	struct free_object *free;
+	unsigned nr_free;
+	/* atomic */
+	uintmax_t live;
+	uintmax_t peak;
+	uintmax_t reserved;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	unsigned nr_slabs;
+	struct slab *slabs[MAX_SLABS];
+	struct slab_private private[MAX_SLABS];
+} slabs = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static __thread struct slab_cache {
+	struct free_object *head;
+	unsigned count;
+} slab_caches[MAX_SLABS];
+
+static struct slab_private *slab_private(struct slab *slab)
+{
+	struct slab_private *p = __atomic_load_n(&slab->private, __ATOMIC_ACQUIRE);
+	if (p != NULL) {
+		return p;
+	}
+
+	pthread_mutex_lock(&slabs.mutex);
+	if (slab->private == NULL) {
+		passert(slabs.nr_slabs < MAX_SLABS);
+		unsigned index = slabs.nr_slabs++;
+		p = &slabs.private[index];
+		p->index = index;
+		/* big enough for the free list; aligned for anything */
+		size_t align = sizeof(long double);
+		size_t size = (slab->size < sizeof(struct free_object) ?
+			       sizeof(struct free_object) : slab->size);
+		p->object_size = (size + align - 1) / align * align;
+		pthread_mutex_init(&p->mutex, NULL);
+		slabs.slabs[index] = slab;
+		__atomic_store_n(&slab->private, p, __ATOMIC_RELEASE);
+	}
+	p = slab->private;
+	pthread_mutex_unlock(&slabs.mutex);
+	return p;
+}
+
+static void count_alloc(struct slab_private *p)
+{
+	uintmax_t live = __atomic_add_fetch(&p->live, 1, __ATOMIC_RELAXED);
+	uintmax_t peak = __atomic_load_n(&p->peak, __ATOMIC_RELAXED);
+	while (live > peak &&
+	       !__atomic_compare_exchange_n(&p->peak, &peak, live, /*weak*/true,
+					    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		/* PEAK updated; retry */
+	}
+}
+
+/* with P->MUTEX held */
+static void carve_chunk(struct slab_private *p, const char *name)
+{
+	char *chunk = malloc(p->object_size * SLAB_CHUNK_OBJECTS);
+	if (chunk == NULL) {
+		llog_passert(&global_logger, HERE,
+			     "unable to allocate %zu byte slab chunk for %s",
+			     p->object_size * SLAB_CHUNK_OBJECTS, name);
+	}
+	for (unsigned i = 0; i < SLAB_CHUNK_OBJECTS; i++) {
+		struct free_object *o = (struct free_object *)(chunk + i * p->object_size);
+		o->next = p->free;
+		p->free = o;
+	}
+	p->nr_free += SLAB_CHUNK_OBJECTS;
+	__atomic_add_fetch(&p->reserved, SLAB_CHUNK_OBJECTS, __ATOMIC_RELAXED);
+}
+
+void *alloc_slab_bytes(struct slab *slab, size_t size, const char *name)
+{
+	passert(size <= slab->size);
+	struct slab_private *p = slab_private(slab);
+	count_alloc(p);
+
+	if (leak_detective) {
+		return alloc_bytes(slab->size, name);
+	}
+
+	struct slab_cache *cache = &slab_caches[p->index];
+	if (cache->head == NULL) {
+		pthread_mutex_lock(&p->mutex);
+		if (p->free == NULL) {
+			carve_chunk(p, slab->name);
+		}
+		while (p->free != NULL && cache->count < SLAB_CACHE_BATCH) {
+			struct free_object *o = p->free;
+			p->free = o->next;
+			p->nr_free--;
+			o->next = cache->head;
+			cache->head = o;
+			cache->count++;
+		}
+		pthread_mutex_unlock(&p->mutex);
+	}
+
+	struct free_object *o = cache->head;
+	cache->head = o->next;
+	cache->count--;
+	memset(o, 0, p->object_size);
+	return o;
+}
+
+void pfree_slab(struct slab *slab, void *ptr)
+{
+	passert(ptr != NULL);
+	struct slab_private *p = slab->private;
+	passert(p != NULL);
+	__atomic_sub_fetch(&p->live, 1, __ATOMIC_RELAXED);
+
+	if (leak_detective) {
+		pfree(ptr);
+		return;
+	}
+
+	struct slab_cache *cache = &slab_caches[p->index];
+	struct free_object *o = ptr;
+	o->next = cache->head;
+	cache->head = o;
+	cache->count++;
+
+	if (cache->count > 2 * SLAB_CACHE_BATCH) {
+		pthread_mutex_lock(&p->mutex);
+		while (cache->count > SLAB_CACHE_BATCH) {
+			struct free_object *f = cache->head;
+			cache->head = f->next;
+			cache->count--;
+			f->next = p->free;
+			p->free = f;
+			p->nr_free++;
+		}
+		pthread_mutex_unlock(&p->mutex);
+	}
+}
+
+unsigned slab_stats(struct slab_stats *stats, unsigned nr_stats)
+{
+	pthread_mutex_lock(&slabs.mutex);
+	unsigned nr_slabs = slabs.nr_slabs;
+	for (unsigned i = 0; i < nr_slabs && i < nr_stats; i++) {
+		const struct slab_private *p = &slabs.private[i];
+		stats[i] = (struct slab_stats) {
+			.name = slabs.slabs[i]->name,
+			.size = p->object_size,
+			.live = __atomic_load_n(&p->live, __ATOMIC_RELAXED),
+			.peak = __atomic_load_n(&p->peak, __ATOMIC_RELAXED),
+			.reserved = __atomic_load_n(&p->reserved, __ATOMIC_RELAXED),
+		};
+	}
+	pthread_mutex_unlock(&slabs.mutex);
+	return nr_slabs;
+}
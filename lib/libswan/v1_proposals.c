@@ -281,6 +281,7 @@ bool v1_proposals_parse_str(struct proposal_parser *parser,
 	}
 
 	shunk_t prop_ptr = alg_str;
+	bool parsed = false;
 	do {
 		/* find the next proposal */
 		shunk_t proposal = shunk_token(&prop_ptr, NULL, ",");
@@ -289,9 +290,23 @@ bool v1_proposals_parse_str(struct proposal_parser *parser,
 		if (!parse_ikev1_proposal(parser, proposals, scratch_proposal, proposal, verbose)) {
 			free_proposal(&scratch_proposal);
 			vassert(parser->diag != NULL);
-			return false;
+			if (!default_proposals(proposals)) {
+				return false;
+			}
+			/* see v2_proposals_parse_str() */
+			vdbg("skipping default proposal "PRI_SHUNK": %s",
+			     pri_shunk(proposal), str_diag(parser->diag));
+			pfree_diag(&parser->diag);
+			continue;
 		}
 		free_proposal(&scratch_proposal);
+		parsed = true;
 	} while (prop_ptr.ptr != NULL);
+
+	if (!parsed) {
+		proposal_error(parser, "%s default proposals only use disabled algorithms",
+			       parser->protocol->name);
+		return false;
+	}
 	return true;
 }
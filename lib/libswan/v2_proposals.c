@@ -48,6 +48,12 @@ static void merge_algorithms(struct proposal_parser *parser,
 	}
 
 	for (const struct ike_alg **alg = defaults; (*alg) != NULL; alg++) {
+		if (!ike_alg_is_valid(*alg)) {
+			/* for instance, failed its self-test */
+			vdbg("skipping disabled default %s %s",
+			     (*alg)->type->story, (*alg)->fqn);
+			continue;
+		}
 		append_proposal_transform(parser, proposal,
 					  transform_type, *alg, 0,
 					  verbose);
@@ -182,6 +188,7 @@ bool v2_proposals_parse_str(struct proposal_parser *parser,
 		return false;
 	}
 
+	bool parsed = false;
 	do {
 		/* find the next proposal */
 		shunk_t raw_proposal = shunk_token(&input, NULL, ",");
@@ -189,7 +196,18 @@ bool v2_proposals_parse_str(struct proposal_parser *parser,
 		if (!parse_ikev2_proposal(parser, proposal, raw_proposal, verbose)) {
 			vassert(parser->diag != NULL);
 			free_proposal(&proposal);
-			return false;
+			if (!default_proposals(proposals)) {
+				return false;
+			}
+			/*
+			 * A default proposal can use an algorithm
+			 * that was disabled, for instance by a
+			 * failed self-test; skip it.
+			 */
+			vdbg("skipping default proposal "PRI_SHUNK": %s",
+			     pri_shunk(raw_proposal), str_diag(parser->diag));
+			pfree_diag(&parser->diag);
+			continue;
 		}
 		/*
 		 * XXX: should check that the proposal hasn't ended up
@@ -197,6 +215,13 @@ bool v2_proposals_parse_str(struct proposal_parser *parser,
 		 */
 		vassert(parser->diag == NULL);
 		append_proposal(parser, proposals, &proposal, verbose);
+		parsed = true;
 	} while (input.ptr != NULL);
+
+	if (!parsed) {
+		proposal_error(parser, "%s default proposals only use disabled algorithms",
+			       parser->protocol->name);
+		return false;
+	}
 	return true;
 }
@@ -28,10 +28,13 @@
 #include <errno.h>
 #include <stdlib.h>		/* for exit() */
 #include <sys/un.h>		/* struct sockaddr_un;! */
+#include <sys/socket.h>		/* for shutdown() */
+#include <poll.h>
 
 #include "whack.h"
 #include "lsw_socket.h"
 #include "lswlog.h"
+#include "lswalloc.h"
 
 static int whack_get_value(char *buf, size_t bufsize)
 {
@@ -100,164 +103,201 @@ static void whack_send_reply(int sock, const char *buf, ssize_t len, struct logg
 	}
 }
 
-static int whack_read_reply(int sock,
-			    char xauthusername[MAX_XAUTH_USERNAME_LEN],
-			    char xauthpass[XAUTH_MAX_PASS_LENGTH],
-			    int usernamelen,
-			    int xauthpasslen,
-			    struct logger *logger)
-{
+/*
+ * Reply from pluto; lines are accumulated in BUF so that it can be
+ * read incrementally (see whack_stream_send()).
+ */
+
+struct whack_reply {
+	int sock;
+	char *xauthusername;
+	char *xauthpass;
+	int usernamelen;
+	int xauthpasslen;
 	char buf[4097]; /* arbitrary limit on log line length */
-	char *be = buf;
-	int exit_status = 0;
+	char *be;
+	int exit_status;
+	/* whack_stream_send(); the message being answered */
+	struct {
+		struct whack_stream_status *list;
+		unsigned sent;
+		unsigned answered;
+		int status;
+	} batch;
+};
+
+/*
+ * Do one read() and process any complete lines.  Return false once
+ * pluto has closed its end.
+ */
+
+static bool whack_read_reply_lines(struct whack_reply *reply, struct logger *logger)
+{
+	char *buf = reply->buf;
+	char *ls = buf;
+	ssize_t rl = read(reply->sock, reply->be, (buf + sizeof(reply->buf) - 1) - reply->be);
+
+	if (rl < 0) {
+		llog_errno(ERROR_STREAM, logger, errno, "read() failed: ");
+		exit(RC_WHACK_PROBLEM);
+	}
+
+	if (rl == 0) {
+		if (reply->be != buf) {
+			llog(ERROR_STREAM, logger,
+			     "last line from pluto too long or unterminated");
+		}
+		return false;
+	}
+
+	reply->be += rl;
+	*reply->be = '\0';
 
 	for (;; ) {
-		char *ls = buf;
-		ssize_t rl = read(sock, be, (buf + sizeof(buf) - 1) - be);
+		char *le = strchr(ls, '\n');
 
-		if (rl < 0) {
-			llog_errno(ERROR_STREAM, logger, errno, "read() failed: ");
+		if (le == NULL) {
+			/* move last, partial line to start of buffer */
+			memmove(buf, ls, reply->be - ls);
+			reply->be -= ls - buf;
+			break;
+		}
+		le++;	/* include NL in line */
+
+		/*
+		 * figure out prefix number and how it should
+		 * affect our exit status and printing
+		 */
+		char *lpe = NULL; /* line-prefix-end */
+		unsigned long s = strtoul(ls, &lpe, 10);
+		if (lpe == ls || *lpe != ' ') {
+			/* includes embedded NL, see above */
+			llog(ERROR_STREAM, logger,
+			     "log line missing NNN prefix: %*s", (int)(le - ls), ls);
 			exit(RC_WHACK_PROBLEM);
 		}
 
-		if (rl == 0) {
-			if (be != buf) {
-				llog(ERROR_STREAM, logger,
-				     "last line from pluto too long or unterminated");
+		ls = lpe + 1; /* skip NNN_ */
+
+		if (s == RC_WHACK_BATCH) {
+			/* pluto is done with the oldest batched message */
+			if (reply->batch.answered < reply->batch.sent) {
+				struct whack_stream_status *status =
+					&reply->batch.list[reply->batch.answered++];
+				status->answered = true;
+				status->status = reply->batch.status;
 			}
-			break;
+			reply->batch.status = 0;
+			ls = le;
+			continue;
 		}
 
-		be += rl;
-		*be = '\0';
+		if (write(STDOUT_FILENO, ls, le - ls) == -1) {
+			int e = errno;
+			llog_errno(RC_LOG, logger, e, "write() failed, and ignored");
+		}
 
-		for (;; ) {
-			char *le = strchr(ls, '\n');
+		/*
+		 * figure out prefix number and how it should affect
+		 * our exit status
+		 */
 
-			if (le == NULL) {
-				/* move last, partial line to start of buffer */
-				memmove(buf, ls, be - ls);
-				be -= ls - buf;
-				break;
-			}
-			le++;	/* include NL in line */
+		switch (s) {
 
-			/*
-			 * figure out prefix number and how it should
-			 * affect our exit status and printing
-			 */
-			char *lpe = NULL; /* line-prefix-end */
-			unsigned long s = strtoul(ls, &lpe, 10);
-			if (lpe == ls || *lpe != ' ') {
-				/* includes embedded NL, see above */
+		case RC_ENTERSECRET:
+			if (reply->xauthpass == NULL) {
 				llog(ERROR_STREAM, logger,
-				     "log line missing NNN prefix: %*s", (int)(le - ls), ls);
+				     "unexpected request for xauth password");
 				exit(RC_WHACK_PROBLEM);
 			}
+			if (reply->xauthpasslen == 0) {
+				reply->xauthpasslen =
+					whack_get_secret(reply->xauthpass,
+							 XAUTH_MAX_PASS_LENGTH);
+			}
+			if (reply->xauthpasslen > XAUTH_MAX_PASS_LENGTH) {
+				/*
+				 * for input >= 128,
+				 * xauthpasslen would be 129
+				 */
+				reply->xauthpasslen =
+					XAUTH_MAX_PASS_LENGTH;
+				llog(ERROR_STREAM, logger,
+				     "xauth password cannot be >= %d chars",
+				     XAUTH_MAX_PASS_LENGTH);
+			}
+			whack_send_reply(reply->sock, reply->xauthpass,
+					 reply->xauthpasslen, logger);
+			break;
 
-			ls = lpe + 1; /* skip NNN_ */
-
-			if (write(STDOUT_FILENO, ls, le - ls) == -1) {
-				int e = errno;
-				llog_errno(RC_LOG, logger, e, "write() failed, and ignored");
+		case RC_USERPROMPT:
+			if (reply->xauthusername == NULL) {
+				llog(ERROR_STREAM, logger,
+				     "unexpected request for xauth username");
+				exit(RC_WHACK_PROBLEM);
 			}
+			if (reply->usernamelen == 0) {
+				reply->usernamelen =
+					whack_get_value(reply->xauthusername,
+							MAX_XAUTH_USERNAME_LEN);
+			}
+			if (reply->usernamelen > MAX_XAUTH_USERNAME_LEN) {
+				/*
+				 * for input >= 128,
+				 * useramelen would be 129
+				 */
+				reply->usernamelen = MAX_XAUTH_USERNAME_LEN;
+				llog(ERROR_STREAM, logger,
+				     "username cannot be >= %d chars",
+				     MAX_XAUTH_USERNAME_LEN);
+			}
+			whack_send_reply(reply->sock, reply->xauthusername,
+					 reply->usernamelen, logger);
 
+			break;
+
+		default:
 			/*
-			 * figure out prefix number and how it should affect
-			 * our exit status
+			 * Only RC_ codes between
+			 * RC_EXIT_FLOOR (RC_DUPNAME) and
+			 * RC_EXIT_ROOF are errors.
+			 *
+			 * The exit status is sticky so that
+			 * incidental logs don't clear or
+			 * change it.
 			 */
-
-			switch (s) {
-
-			case RC_ENTERSECRET:
-				if (xauthpass == NULL) {
-					llog(ERROR_STREAM, logger,
-					     "unexpected request for xauth password");
-					exit(RC_WHACK_PROBLEM);
-				}
-				if (xauthpasslen == 0) {
-					xauthpasslen =
-						whack_get_secret(xauthpass,
-								 XAUTH_MAX_PASS_LENGTH);
-				}
-				if (xauthpasslen > XAUTH_MAX_PASS_LENGTH) {
-					/*
-					 * for input >= 128,
-					 * xauthpasslen would be 129
-					 */
-					xauthpasslen =
-						XAUTH_MAX_PASS_LENGTH;
-					llog(ERROR_STREAM, logger,
-					     "xauth password cannot be >= %d chars",
-					     XAUTH_MAX_PASS_LENGTH);
-				}
-				whack_send_reply(sock, xauthpass, xauthpasslen, logger);
-				break;
-
-			case RC_USERPROMPT:
-				if (xauthusername == NULL) {
-					llog(ERROR_STREAM, logger,
-					     "unexpected request for xauth username");
-					exit(RC_WHACK_PROBLEM);
-				}
-				if (usernamelen == 0) {
-					usernamelen = whack_get_value(xauthusername,
-								      MAX_XAUTH_USERNAME_LEN);
+			if (s >= RC_EXIT_FLOOR && s < RC_EXIT_ROOF) {
+				if (reply->exit_status == 0) {
+					reply->exit_status = s;
 				}
-				if (usernamelen > MAX_XAUTH_USERNAME_LEN) {
-					/*
-					 * for input >= 128,
-					 * useramelen would be 129
-					 */
-					usernamelen = MAX_XAUTH_USERNAME_LEN;
-					llog(ERROR_STREAM, logger,
-					     "username cannot be >= %d chars",
-					     MAX_XAUTH_USERNAME_LEN);
+				if (reply->batch.status == 0) {
+					reply->batch.status = s;
 				}
-				whack_send_reply(sock, xauthusername, usernamelen, logger);
-
-				break;
-
-			default:
-				/*
-				 * Only RC_ codes between
-				 * RC_EXIT_FLOOR (RC_DUPNAME) and
-				 * RC_EXIT_ROOF are errors.
-				 *
-				 * The exit status is sticky so that
-				 * incidental logs don't clear or
-				 * change it.
-				 */
-				if (exit_status == 0 && s >= RC_EXIT_FLOOR && s < RC_EXIT_ROOF) {
-					exit_status = s;
-				}
-				break;
 			}
-
-			ls = le;
+			break;
 		}
+
+		ls = le;
 	}
-	return exit_status;
+	return true;
 }
 
-int whack_send_msg(struct whack_message *msg, const char *ctlsocket,
-		   char xauthusername[MAX_XAUTH_USERNAME_LEN],
-		   char xauthpass[XAUTH_MAX_PASS_LENGTH],
-		   int usernamelen, int xauthpasslen,
-		   struct logger *logger)
+static void init_whack_reply(struct whack_reply *reply, int sock,
+			     char *xauthusername, char *xauthpass,
+			     int usernamelen, int xauthpasslen)
 {
-	struct sockaddr_un ctl_addr = {
-		.sun_family = AF_UNIX,
-		.sun_path  = DEFAULT_CTL_SOCKET,
-#ifdef USE_SOCKADDR_LEN
-		.sun_len = sizeof(struct sockaddr_un),
-#endif
-	};
-
-	/* copy socket location */
-
-	fill_and_terminate(ctl_addr.sun_path, ctlsocket, sizeof(ctl_addr.sun_path));
+	reply->sock = sock;
+	reply->xauthusername = xauthusername;
+	reply->xauthpass = xauthpass;
+	reply->usernamelen = usernamelen;
+	reply->xauthpasslen = xauthpasslen;
+	reply->be = reply->buf;
+	reply->exit_status = 0;
+	zero(&reply->batch);
+}
 
+static ssize_t whack_pack_msg(struct whack_message *msg, struct logger *logger)
+{
 	/*  Pack strings */
 
 	struct whackpacker wp = {
@@ -273,7 +313,22 @@ int whack_send_msg(struct whack_message *msg, const char *ctlsocket,
 		return -1;
 	}
 
-	ssize_t len = wp.str_next - (unsigned char *)msg;
+	return wp.str_next - (unsigned char *)msg;
+}
+
+static int whack_connect(const char *ctlsocket, struct logger *logger)
+{
+	struct sockaddr_un ctl_addr = {
+		.sun_family = AF_UNIX,
+		.sun_path  = DEFAULT_CTL_SOCKET,
+#ifdef USE_SOCKADDR_LEN
+		.sun_len = sizeof(struct sockaddr_un),
+#endif
+	};
+
+	/* copy socket location */
+
+	fill_and_terminate(ctl_addr.sun_path, ctlsocket, sizeof(ctl_addr.sun_path));
 
 	/* Connect to pluto ctl */
 
@@ -312,6 +367,22 @@ int whack_send_msg(struct whack_message *msg, const char *ctlsocket,
 		exit(RC_WHACK_PROBLEM);
 	}
 
+	return sock;
+}
+
+int whack_send_msg(struct whack_message *msg, const char *ctlsocket,
+		   char xauthusername[MAX_XAUTH_USERNAME_LEN],
+		   char xauthpass[XAUTH_MAX_PASS_LENGTH],
+		   int usernamelen, int xauthpasslen,
+		   struct logger *logger)
+{
+	ssize_t len = whack_pack_msg(msg, logger);
+	if (len < 0) {
+		return -1;
+	}
+
+	int sock = whack_connect(ctlsocket, logger);
+
 	/* Send message */
 #if 0
 	const ssize_t min = 856;
@@ -331,8 +402,120 @@ int whack_send_msg(struct whack_message *msg, const char *ctlsocket,
 	}
 
 	/* read reply (possibly send further messages) */
-	int ret = whack_read_reply(sock, xauthusername, xauthpass, usernamelen, xauthpasslen, logger);
+	struct whack_reply reply;
+	init_whack_reply(&reply, sock, xauthusername, xauthpass,
+			 usernamelen, xauthpasslen);
+	while (whack_read_reply_lines(&reply, logger));
 	close(sock);
 
-	return ret;
+	return reply.exit_status;
+}
+
+/*
+ * Send a stream of messages over a single control socket.
+ *
+ * Each message is flagged .whack_batch so that pluto keeps reading
+ * until whack_stream_close() shuts down the write side.  Since pluto
+ * replies as it goes, poll() for both directions and drain replies
+ * while waiting to write; otherwise both ends could block on full
+ * socket buffers.
+ *
+ * Pluto ends the replies to each message with an RC_WHACK_BATCH
+ * record; that is used to work out each message's status.
+ */
+
+struct whack_stream {
+	struct whack_reply reply;
+	bool eof;
+};
+
+struct whack_stream *whack_stream_open(const char *ctlsocket, struct logger *logger)
+{
+	struct whack_stream *ws = alloc_thing(struct whack_stream, "whack stream");
+	int sock = whack_connect(ctlsocket, logger);
+	init_whack_reply(&ws->reply, sock, NULL, NULL, 0, 0);
+	return ws;
+}
+
+int whack_stream_send(struct whack_stream *ws, struct whack_message *msg,
+		      struct logger *logger)
+{
+	msg->whack_batch = true;
+	/* packing turns .name into an offset */
+	const char *name = (msg->name == NULL ? "" : msg->name);
+	ssize_t len = whack_pack_msg(msg, logger);
+	if (len < 0) {
+		return -1;
+	}
+
+	while (true) {
+		if (ws->eof) {
+			llog(ERROR_STREAM, logger, "pluto closed the control socket");
+			return -1;
+		}
+		struct pollfd pfd = {
+			.fd = ws->reply.sock,
+			.events = POLLIN | POLLOUT,
+		};
+		if (poll(&pfd, 1, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			llog_errno(ERROR_STREAM, logger, errno, "poll(pluto_ctl) failed: ");
+			exit(RC_WHACK_PROBLEM);
+		}
+		if (pfd.revents & (POLLIN | POLLHUP)) {
+			ws->eof = !whack_read_reply_lines(&ws->reply, logger);
+			continue;
+		}
+		if (pfd.revents & POLLOUT) {
+			if (write(ws->reply.sock, msg, len) != len) {
+				llog_errno(ERROR_STREAM, logger, errno, "write(pluto_ctl) failed: ");
+				exit(RC_WHACK_PROBLEM);
+			}
+			struct whack_reply *reply = &ws->reply;
+			realloc_things(reply->batch.list, reply->batch.sent,
+				       reply->batch.sent + 1, "whack stream statuses");
+			reply->batch.list[reply->batch.sent++] = (struct whack_stream_status) {
+				.name = clone_str(name, "whack stream name"),
+			};
+			return 0;
+		}
+		/* i.e., POLLERR or POLLNVAL; polling again would spin */
+		llog(ERROR_STREAM, logger, "poll(pluto_ctl) failed: revents 0x%x",
+		     (unsigned)pfd.revents);
+		exit(RC_WHACK_PROBLEM);
+	}
+}
+
+int whack_stream_close(struct whack_stream **wsp,
+		       struct whack_stream_status **statuses, unsigned *nr_statuses,
+		       struct logger *logger)
+{
+	struct whack_stream *ws = *wsp;
+	*wsp = NULL;
+
+	/* tell pluto there's nothing more; then wait for it to finish */
+	if (!ws->eof && shutdown(ws->reply.sock, SHUT_WR) < 0) {
+		llog_errno(ERROR_STREAM, logger, errno, "shutdown(pluto_ctl) failed: ");
+	}
+	while (!ws->eof) {
+		ws->eof = !whack_read_reply_lines(&ws->reply, logger);
+	}
+	close(ws->reply.sock);
+
+	/* messages pluto didn't get to stay !answered */
+	*statuses = ws->reply.batch.list;
+	*nr_statuses = ws->reply.batch.sent;
+	int exit_status = ws->reply.exit_status;
+	pfree(ws);
+	return exit_status;
+}
+
+void free_whack_stream_statuses(struct whack_stream_status **statuses, unsigned nr_statuses)
+{
+	for (unsigned i = 0; i < nr_statuses; i++) {
+		pfree((*statuses)[i].name);
+	}
+	pfreeany(*statuses);
 }
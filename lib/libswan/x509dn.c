@@ -203,6 +203,161 @@ static err_t get_next_rdn(asn1_t *rdn,	/* input/output */
 	return NULL;
 }
 
+/*
+ * A DN broken down, once, into its attributes (which point into the
+ * DN's bytes).  A multi-valued RDN has several attributes.
+ */
+
+#define MAX_DN_ATTRIBUTES 32
+
+struct dn_attribute {
+	asn1_t oid;
+	enum asn1_type type;
+	asn1_t value;
+};
+
+struct parsed_dn {
+	unsigned nr_rdns;
+	struct {
+		unsigned first;
+		unsigned count;
+	} rdns[MAX_DN_ATTRIBUTES];
+	unsigned nr_attributes;
+	struct dn_attribute attributes[MAX_DN_ATTRIBUTES];
+};
+
+static err_t parse_dn_attributes(asn1_t dn, struct parsed_dn *p)
+{
+	asn1_t rdn;
+	asn1_t attribute;
+	bool more;
+
+	p->nr_rdns = 0;
+	p->nr_attributes = 0;
+	RETURN_IF_ERR(init_rdn(dn, &rdn, &attribute, &more));
+
+	while (more) {
+		if (p->nr_attributes >= MAX_DN_ATTRIBUTES) {
+			return "DN has too many attributes";
+		}
+		/* when ATTRIBUTE is empty, get_next_rdn() starts a new RDN */
+		if (attribute.len == 0) {
+			p->rdns[p->nr_rdns].first = p->nr_attributes;
+			p->rdns[p->nr_rdns].count = 0;
+			p->nr_rdns++;
+		}
+		struct dn_attribute *a = &p->attributes[p->nr_attributes++];
+		asn1_t value_ber;
+		RETURN_IF_ERR(get_next_rdn(&rdn, &attribute, &a->oid,
+					   &value_ber, &a->type, &a->value,
+					   &more));
+		p->rdns[p->nr_rdns - 1].count++;
+	}
+
+	return NULL;
+}
+
+static bool is_wildcard_value(asn1_t value)
+{
+	return (value.len == 1 && *(const char *)value.ptr == '*');
+}
+
+/*
+ * Compare the values of two attributes with the same OID.
+ */
+
+static bool match_dn_value(asn1_t oid,
+			   enum asn1_type type_a, asn1_t value_a,
+			   enum asn1_type type_b, asn1_t value_b)
+{
+	if (value_a.len != value_b.len)
+		return false;	/* lengths must match */
+
+	/*
+	 * If the two types treat the high bit differently
+	 * or if ASN1_PRINTABLESTRING is involved,
+	 * we must forbid the high bit.
+	 */
+	if (type_a != type_b ||
+	    type_a == ASN1_PRINTABLESTRING) {
+		uint8_t or = 0x00;
+		for (size_t i = 0; i != value_a.len; i++) {
+			or |= ((const uint8_t*)value_a.ptr)[i];
+			or |= ((const uint8_t*)value_b.ptr)[i];
+		}
+		if (or & 0x80)
+			return false;
+	}
+
+	/*
+	 * even though the types may differ, we assume that
+	 * their bits can be compared.
+	 */
+
+	/* cheap match, as if case matters */
+	if (memeq(value_a.ptr, value_b.ptr, value_a.len))
+		return true;
+
+	/*
+	 * printableStrings and email RDNs require comparison
+	 * ignoring case.
+	 * We do require that the types match.
+	 * Forbid NUL in such strings.
+	 */
+
+	if ((type_a == ASN1_PRINTABLESTRING ||
+	     (type_a == ASN1_IA5STRING &&
+	      known_oid(oid) == OID_PKCS9_EMAIL)) &&
+	    strncaseeq((char *)value_a.ptr,
+		       (char *)value_b.ptr, value_b.len) &&
+	    memchr(value_a.ptr, '\0', value_a.len) == NULL) {
+		return true;	/* component match */
+	}
+
+	return false;	/* not a match */
+}
+
+/*
+ * A hash of the DN that ignores the order of its RDNs (and of the
+ * attributes within each RDN) and the case of its values.  DNs that
+ * same_dn() considers equal, or that have the same RDNs in a
+ * different order, have the same hash.
+ *
+ * When the DN can't be parsed, its bytes are hashed.
+ */
+
+uintmax_t hash_dn(asn1_t dn)
+{
+	/* FNV-1a */
+	const uintmax_t basis = UINTMAX_C(14695981039346656037);
+	const uintmax_t prime = UINTMAX_C(1099511628211);
+
+	struct parsed_dn p;
+	if (parse_dn_attributes(dn, &p) != NULL) {
+		uintmax_t h = basis;
+		for (size_t i = 0; i < dn.len; i++) {
+			h = (h ^ ((const uint8_t *)dn.ptr)[i]) * prime;
+		}
+		return h;
+	}
+
+	/* combine attribute hashes with +, so order doesn't matter */
+	uintmax_t hash = p.nr_attributes;
+	for (unsigned i = 0; i < p.nr_attributes; i++) {
+		const struct dn_attribute *a = &p.attributes[i];
+		uintmax_t h = basis;
+		for (size_t j = 0; j < a->oid.len; j++) {
+			h = (h ^ ((const uint8_t *)a->oid.ptr)[j]) * prime;
+		}
+		for (size_t j = 0; j < a->value.len; j++) {
+			uint8_t c = ((const uint8_t *)a->value.ptr)[j];
+			h = (h ^ (uint8_t)char_tolower(c)) * prime;
+		}
+		hash += h;
+	}
+	return hash;
+}
+
 /*
  * Count the number of wildcard RDNs in a distinguished name; -1 signifies error.
  */
@@ -937,57 +1092,16 @@ bool match_dn(asn1_t a, asn1_t b, int *wildcards, struct verbose verbose)
 		/* does rdn_b contain a wildcard? */
 		/* ??? this does not care whether types match.  Should it? */
 		if (wildcards != NULL &&
-		    value_content_b.len == 1 &&
-		    *(const char *)value_content_b.ptr == '*') {
+		    is_wildcard_value(value_content_b)) {
 			(*wildcards)++;
 			continue;
 		}
 
-		if (value_content_a.len != value_content_b.len)
-			return false;	/* lengths must match */
-
-		/*
-		 * If the two types treat the high bit differently
-		 * or if ASN1_PRINTABLESTRING is involved,
-		 * we must forbid the high bit.
-		 */
-		if (value_type_a != value_type_b ||
-		    value_type_a == ASN1_PRINTABLESTRING) {
-			uint8_t or = 0x00;
-			for (size_t i = 0; i != value_content_a.len; i++) {
-				or |= ((const uint8_t*)value_content_a.ptr)[i];
-				or |= ((const uint8_t*)value_content_b.ptr)[i];
-			}
-			if (or & 0x80)
-				return false;
+		if (!match_dn_value(oid_a,
+				    value_type_a, value_content_a,
+				    value_type_b, value_content_b)) {
+			return false;	/* not a match */
 		}
-
-		/*
-		 * even though the types may differ, we assume that
-		 * their bits can be compared.
-		 */
-
-		/* cheap match, as if case matters */
-		if (memeq(value_content_a.ptr, value_content_b.ptr, value_content_a.len))
-			continue;
-
-		/*
-		 * printableStrings and email RDNs require comparison
-		 * ignoring case.
-		 * We do require that the types match.
-		 * Forbid NUL in such strings.
-		 */
-
-		if ((value_type_a == ASN1_PRINTABLESTRING ||
-		     (value_type_a == ASN1_IA5STRING &&
-		      known_oid(oid_a) == OID_PKCS9_EMAIL)) &&
-		    strncaseeq((char *)value_content_a.ptr,
-				(char *)value_content_b.ptr, value_content_b.len) &&
-		    memchr(value_content_a.ptr, '\0', a.len) == NULL)
-		{
-			continue;	/* component match */
-		}
-		return false;	/* not a match */
 	}
 
 	/* both DNs must have same number of RDNs */
@@ -1058,8 +1172,8 @@ static bool match_rdn(const CERTRDN *const rdn_a, const CERTRDN *const rdn_b, bo
 	return matched > 0 && matched == ava_num;
 }
 
-static bool match_dn_unordered(asn1_t a, asn1_t b, int *const wildcards,
-			       struct verbose verbose)
+static bool match_dn_unordered_nss(asn1_t a, asn1_t b, int *const wildcards,
+				   struct verbose verbose)
 {
 	dn_buf a_dnbuf = { "", };
 	dn_buf b_dnbuf = { "", };
@@ -1125,6 +1239,84 @@ static bool match_dn_unordered(asn1_t a, asn1_t b, int *const wildcards,
 	return ok;
 }
 
+/*
+ * Same as match_rdn() but using the parsed DNs.
+ */
+
+static bool match_parsed_rdn(const struct parsed_dn *a, unsigned rdn_a,
+			     const struct parsed_dn *b, unsigned rdn_b,
+			     bool *has_wild)
+{
+	unsigned matched = 0;
+	const struct dn_attribute *a_first = &a->attributes[a->rdns[rdn_a].first];
+	const struct dn_attribute *a_roof = a_first + a->rdns[rdn_a].count;
+	const struct dn_attribute *b_first = &b->attributes[b->rdns[rdn_b].first];
+	const struct dn_attribute *b_roof = b_first + b->rdns[rdn_b].count;
+
+	for (const struct dn_attribute *ava_b = b_first; ava_b < b_roof; ava_b++) {
+		for (const struct dn_attribute *ava_a = a_first; ava_a < a_roof; ava_a++) {
+			if (!hunk_eq(ava_a->oid, ava_b->oid)) {
+				continue;
+			}
+			if (has_wild != NULL && is_wildcard_value(ava_b->value)) {
+				*has_wild = true;
+				matched++;
+				break;
+			}
+			if (match_dn_value(ava_a->oid,
+					   ava_a->type, ava_a->value,
+					   ava_b->type, ava_b->value)) {
+				matched++;
+				break;
+			}
+		}
+	}
+
+	return matched > 0 && matched == b->rdns[rdn_b].count;
+}
+
+/*
+ * Every RDN in B must match an RDN in A, in any order.
+ *
+ * The DNs are broken down once into their attributes and then
+ * compared directly; only when that fails (for instance, a DN with
+ * too many attributes) is the comparison handed off to NSS.
+ */
+
+static bool match_dn_unordered(asn1_t a, asn1_t b, int *const wildcards,
+			       struct verbose verbose)
+{
+	struct parsed_dn pa, pb;
+	err_t ua = parse_dn_attributes(a, &pa);
+	err_t ub = (ua == NULL ? parse_dn_attributes(b, &pb) : NULL);
+	if (ua != NULL || ub != NULL) {
+		vdbg("%s() %s; using NSS", __func__, (ua != NULL ? ua : ub));
+		return match_dn_unordered_nss(a, b, wildcards, verbose);
+	}
+
+	unsigned matched = 0;
+	for (unsigned rb = 0; rb < pb.nr_rdns; rb++) {
+		for (unsigned ra = 0; ra < pa.nr_rdns; ra++) {
+			bool has_wild = false;
+			if (match_parsed_rdn(&pa, ra, &pb, rb,
+					     wildcards != NULL ? &has_wild : NULL)) {
+				matched++;
+				if (wildcards != NULL && has_wild)
+					(*wildcards)++;
+				break;
+			}
+		}
+	}
+
+	bool ok = (matched > 0 && matched == pb.nr_rdns);
+	vdbg("%s() matched: %u, rdn_num: %u, wildcards: %d; %s",
+	     __func__, matched, pb.nr_rdns,
+	     (wildcards ? *wildcards : -1),
+	     bool_str(ok));
+
+	return ok;
+}
+
 bool match_dn_any_order_wild(asn1_t a, asn1_t b, int *wildcards,
 			     struct verbose verbose)
 {
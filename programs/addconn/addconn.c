@@ -298,6 +298,7 @@ enum opt {
 	OPT_CHECKCONFIG,
 	OPT_NOEXPORT,
 	OPT_NAME,
+	OPT_CONFIGCACHE,
 };
 
 const struct option optarg_options[] =
@@ -309,6 +310,7 @@ const struct option optarg_options[] =
 
 	HEADING_OPT("  Load alternate 'ipsec.conf' file:"),
 	{ OPT("config", "<ipsec.conf>"), required_argument, NULL, OPT_CONFIG, },
+	{ OPT("configcache", "<file>"), required_argument, NULL, OPT_CONFIGCACHE, },
 
 	HEADING_OPT("  Display more details:"),
 	{ OPT("debug", "help|<debug-flags>"), optional_argument, NULL, OPT_DEBUG, },
@@ -363,6 +365,7 @@ int main(int argc, char *argv[])
 		listall = false;
 	bool opt_liststack = false;
 	const char *configfile = NULL;
+	const char *configcache = NULL;
 	int exit_status = 0;
 	const char *ctlsocket = DEFAULT_CTL_SOCKET;
 	const char *name = NULL;
@@ -420,6 +423,10 @@ int main(int argc, char *argv[])
 			configfile = optarg;
 			continue;
 
+		case OPT_CONFIGCACHE:
+			configcache = optarg;
+			continue;
+
 		case OPT_CTLSOCKET:
 			ctlsocket = optarg;
 			continue;
@@ -497,6 +504,13 @@ int main(int argc, char *argv[])
 			llog(RC_LOG, logger, "parsing config arguments failed");
 			exit(3);
 		}
+	} else if (configcache != NULL && configsetup.name == NULL) {
+		/* use, or update, the compiled config */
+		cfg = confread_load_cached(configfile, configcache, logger, verbose);
+		if (cfg == NULL) {
+			llog(RC_LOG, logger, "loading config file '%s' failed", configfile);
+			exit(3);
+		}
 	} else {
 		cfg = confread_load(configfile, (configsetup.name != NULL), logger, verbose);
 		if (cfg == NULL) {
@@ -546,6 +560,13 @@ int main(int argc, char *argv[])
 		if (verbose > 0)
 			printf("  Step #1: Loading auto=add, auto=keep, auto=route, auto=up and auto=start connections\n");
 
+		/*
+		 * Send all the connections down a single control
+		 * socket; pluto defers orienting them until the
+		 * stream is closed.  The socket is only opened once
+		 * there's something to send.
+		 */
+		struct whack_stream *ws = NULL;
 		struct starter_conn *conn = NULL;
 		TAILQ_FOREACH(conn, &cfg->conns, link) {
 			enum autostart autostart = conn->values[KNCF_AUTO].option;
@@ -571,7 +592,36 @@ int main(int argc, char *argv[])
 				printf("    %s\n", conn->name);
 			}
 
-			starter_whack_add_conn(ctlsocket, conn, logger);
+			if (ws == NULL) {
+				ws = whack_stream_open(ctlsocket, logger);
+			}
+			int status = starter_whack_stream_add_conn(ws, conn, logger);
+			if (status != 0) {
+				llog(ERROR_STREAM, logger, "sending conn %s to pluto failed", conn->name);
+				exit_status = status;
+			}
+		}
+		if (ws != NULL) {
+			/* pluto's verdict; don't lose earlier failures */
+			struct whack_stream_status *statuses = NULL;
+			unsigned nr_statuses = 0;
+			int status = whack_stream_close(&ws, &statuses, &nr_statuses, logger);
+			for (unsigned i = 0; i < nr_statuses; i++) {
+				const struct whack_stream_status *s = &statuses[i];
+				if (!s->answered) {
+					llog(ERROR_STREAM, logger, "conn %s: pluto did not reply", s->name);
+					if (status == 0) {
+						status = RC_WHACK_PROBLEM;
+					}
+				} else if (s->status != 0) {
+					llog(ERROR_STREAM, logger, "conn %s: pluto failed with status %d",
+					     s->name, s->status);
+				}
+			}
+			free_whack_stream_statuses(&statuses, nr_statuses);
+			if (status != 0) {
+				exit_status = status;
+			}
 		}
 
 		/*
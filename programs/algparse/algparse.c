@@ -12,6 +12,7 @@
 
 static bool test_proposals = false;
 static bool test_algs = false;
+static const char *fail_alg = NULL;
 static bool verbose = false;
 static bool debug = false;
 static enum ike_version ike_version = IKEv2;
@@ -612,6 +613,7 @@ static void usage(void)
 		"\n"
 		"    -tp: run the proposal testsuite\n"
 		"    -ta: also run the algorithm testsuite\n"
+		"    -fail <algorithm>: with -ta, force <algorithm>'s test to fail\n"
 		"\n"
 		"Additional options:\n"
 		"\n"
@@ -672,6 +674,12 @@ int main(int argc, char *argv[])
 			test_proposals = true;
 		} else if (streq(arg, "ta")) {
 			test_algs = true;
+		} else if (streq(arg, "fail")) {
+			fail_alg = *++argp;
+			if (fail_alg == NULL) {
+				fprintf(stderr, "missing algorithm to fail\n");
+				exit(ERROR);
+			}
 		} else if (streq(arg, "v1") || streq(arg, "ikev1")) {
 			ike_version = IKEv1;
 		} else if (streq(arg, "v2") || streq(arg, "ikev2")) {
@@ -733,7 +741,7 @@ int main(int argc, char *argv[])
 	}
 
 	if (test_algs) {
-		test_ike_alg(logger);
+		test_ike_alg(fail_alg, logger);
 	}
 
 	if (*argp) {
@@ -0,0 +1,1408 @@
+/* warm-restart checkpoint, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include "lswalloc.h"
+#include "lswnss.h"		/* for lsw_nss_get_authenticated_slot() */
+#include "lswversion.h"		/* for ipsec_version_code() */
+#include "ipsecconf/config_setup.h"
+
+#include "defs.h"
+#include "log.h"
+#include "show.h"
+#include "state.h"
+#include "connections.h"
+#include "orient.h"
+#include "iface.h"
+#include "server.h"		/* for schedule_timeout() */
+#include "timer.h"
+#include "hash_table.h"		/* for hash_bytes() */
+#include "crypt_symkey.h"
+#include "crypt_dh.h"		/* for extract_ikev2_ike_keys() */
+#include "kernel.h"		/* for get_ipsec_traffic() reserve_ipsec_spi() */
+#include "kernel_ops.h"		/* for kernel_ops_del_ipsec_spi() */
+#include "routing.h"
+#include "ipsec_doi.h"		/* for jam_child_sa_details() */
+#include "ikev2.h"		/* for struct v2_transition */
+#include "ikev2_states.h"
+#include "ikev2_msgid.h"
+#include "ikev2_parent.h"	/* for v2_ike_sa_established() */
+#include "ikev2_child.h"	/* for llog_v2_child_sa_established() */
+#include "ikev2_delete.h"	/* for submit_v2_delete_exchange() */
+#include "pluto_stats.h"	/* for pstat_sa_established() */
+#include "rekey_smoothing.h"	/* for book_rekey() */
+#include "checkpoint.h"
+
+#define CHECKPOINT_SWEEP_SECONDS 60
+
+/* adds up to 15 bytes; see wrapped_bound() */
+#define KEK_MECHANISM CKM_AES_KEY_WRAP_PAD
+
+/*
+ * The mapped checkpoint being restored, indexed by connection name.
+ */
+
+#define NO_RECORD UINT32_MAX
+
+enum restore_state {
+	RESTORE_PENDING,
+	RESTORE_ADOPTED,
+	RESTORE_DISCARDED,
+};
+
+struct restore_ike {
+	const struct checkpoint_ike *rec;
+	const char *name;
+	shunk_t keymat;			/* wrapped */
+	unsigned first_child;
+	unsigned nr_children;
+	enum restore_state state;
+	so_serial_t serialno;		/* once adopted */
+	bool lost_child;
+	unsigned next;			/* in bucket */
+};
+
+struct restore_child {
+	const struct checkpoint_child *rec;
+	const char *name;
+	const char *selectors;
+	shunk_t keymat;			/* wrapped inbound+outbound */
+	enum restore_state state;
+	unsigned next;			/* in bucket */
+};
+
+static struct {
+	bool enabled;
+	char *path;
+	PK11SymKey *kek;		/* in the NSS DB */
+	bool kek_found;			/* looked for */
+	/* restoring */
+	PK11SymKey *unwrap_kek;		/* the image was saved with */
+	uint8_t *map;
+	size_t size;
+	bool mapped;			/* else heap */
+	bool install;			/* else update the kernel's SAs */
+	const char *story;
+	int64_t now;			/* realtime milliseconds */
+	unsigned nr_ike;
+	struct restore_ike *ike;
+	unsigned nr_child;
+	struct restore_child *child;
+	unsigned nr_buckets;		/* power of 2 */
+	unsigned *ike_buckets;
+	unsigned *child_buckets;
+	unsigned pending;		/* IKE and Child SAs */
+	struct timeout *sweep;
+	/* stats */
+	uintmax_t adopted_ike;
+	uintmax_t adopted_child;
+	uintmax_t discarded_child;
+} checkpoint;
+
+static unsigned bucket(const char *name)
+{
+	hash_t hash = hash_bytes(name, strlen(name), zero_hash);
+	return hash.hash & (checkpoint.nr_buckets - 1);
+}
+
+size_t checkpoint_align(size_t size)
+{
+	return (size + CHECKPOINT_ALIGN - 1) / CHECKPOINT_ALIGN * CHECKPOINT_ALIGN;
+}
+
+static int64_t realnow_ms(void)
+{
+	return milliseconds_from_deltatime(realtime_diff(realnow(), realtime(0)));
+}
+
+/*
+ * Save.
+ */
+
+struct cursor {
+	uint8_t *ptr;
+	uint8_t *end;
+};
+
+static void *put(struct cursor *cursor, const void *bytes, size_t len)
+{
+	passert(cursor->ptr + len <= cursor->end);
+	void *start = cursor->ptr;
+	if (bytes != NULL) {
+		memcpy(cursor->ptr, bytes, len);
+	}
+	cursor->ptr += len;
+	return start;
+}
+
+/* absolute, so that records saved at different times can be mixed */
+
+static void put_timers(struct checkpoint_timers *timers, const struct state *st)
+{
+	monotime_t now = mononow();
+	int64_t now_ms = realnow_ms();
+	const struct state_event *lifetime = st_v2_lifetime_event(st);
+	timers->inception = seconds_from(st->st_inception.rt);
+	timers->rekey_at = (st->st_v2_rekey_event == NULL ? -1 :
+			    now_ms + milliseconds_from_deltatime(monotime_diff(st->st_v2_rekey_event->ev_time, now)));
+	timers->lifetime_at = now_ms + milliseconds_from_deltatime(monotime_diff(lifetime->ev_time, now));
+	timers->lifetime_type = lifetime->ev_type;
+}
+
+/*
+ * Keying material is wrapped by the KEK so that it is never written
+ * in the clear.
+ */
+
+static size_t wrapped_bound(size_t len)
+{
+	return (len + 7) / 8 * 8 + 8;
+}
+
+static bool put_keymat(struct cursor *cursor, PK11SymKey *keymat, PK11SymKey *kek,
+		       uint32_t *wrapped_len, struct logger *logger)
+{
+	if (kek == NULL || keymat == NULL) {
+		return false;
+	}
+
+	/* the key being wrapped must share the KEK's slot */
+	PK11SymKey *slot_key;
+	{
+		PK11SlotInfo *slot = PK11_GetSlotFromKey(kek);
+		slot_key = PK11_MoveSymKey(slot, CKA_UNWRAP, 0, 0, keymat);
+		PK11_FreeSlot(slot); /* reference counted */
+	}
+	if (slot_key == NULL) {
+		return false;
+	}
+	symkey_newref(logger, "slot-key", slot_key);
+
+	SECItem wrapped = same_bytes_as_secitem(cursor->ptr, cursor->end - cursor->ptr,
+						siBuffer);
+	SECStatus status = PK11_WrapSymKey(KEK_MECHANISM, NULL, kek, slot_key, &wrapped);
+	symkey_delref(logger, "slot-key", &slot_key);
+	if (status != SECSuccess) {
+		return false;
+	}
+	put(cursor, NULL, wrapped.len);
+	*wrapped_len = wrapped.len;
+	return true;
+}
+
+static void append_ike_key(PK11SymKey **keymat, PK11SymKey *key, struct logger *logger)
+{
+	if (key != NULL) {
+		append_symkey_symkey(keymat, key, logger);
+	}
+}
+
+/* same order as extract_ikev2_ike_keys() */
+
+static PK11SymKey *ike_keymat(struct ike_sa *ike)
+{
+	struct logger *logger = ike->sa.logger;
+	PK11SymKey *keymat = symkey_addref(logger, "keymat", ike->sa.st_skey_d_nss);
+	append_ike_key(&keymat, ike->sa.st_skey_ai_nss, logger);
+	append_ike_key(&keymat, ike->sa.st_skey_ar_nss, logger);
+	append_ike_key(&keymat, ike->sa.st_skey_ei_nss, logger);
+	append_symkey_hunk("keymat", &keymat, ike->sa.st_skey_initiator_salt, logger);
+	append_ike_key(&keymat, ike->sa.st_skey_er_nss, logger);
+	append_symkey_hunk("keymat", &keymat, ike->sa.st_skey_responder_salt, logger);
+	append_ike_key(&keymat, ike->sa.st_skey_pi_nss, logger);
+	append_ike_key(&keymat, ike->sa.st_skey_pr_nss, logger);
+	return keymat;
+}
+
+/*
+ * The header records a check value for the KEK (the start of a known
+ * key wrapped by it) so that a reader holding a different KEK is
+ * caught up front.
+ */
+
+static void kek_check(PK11SymKey *kek, uint8_t check[CHECKPOINT_KEK_CHECK_SIZE],
+		      struct logger *logger)
+{
+	static const uint8_t known[16];
+	uint8_t wrapped[sizeof(known) + 8];
+	struct cursor cursor = {
+		.ptr = wrapped,
+		.end = wrapped + sizeof(wrapped),
+	};
+	uint32_t wrapped_len;
+	PK11SymKey *key = symkey_from_bytes("known", known, sizeof(known), logger);
+	if (put_keymat(&cursor, key, kek, &wrapped_len, logger)) {
+		memcpy(check, wrapped, CHECKPOINT_KEK_CHECK_SIZE);
+	} else {
+		memset(check, 0, CHECKPOINT_KEK_CHECK_SIZE);
+	}
+	symkey_delref(logger, "known", &key);
+}
+
+void checkpoint_init_header(struct checkpoint_header *header, PK11SymKey *kek,
+			    struct logger *logger)
+{
+	*header = (struct checkpoint_header) {
+		.version = CHECKPOINT_VERSION,
+		.saved = seconds_from(realnow().rt),
+	};
+	memcpy(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic));
+	jam_str(header->build, sizeof(header->build), ipsec_version_code());
+	kek_check(kek, header->kek_check, logger);
+}
+
+const char *checkpoint_check_header(const struct checkpoint_header *header,
+				    PK11SymKey *kek, struct logger *logger)
+{
+	if (memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) != 0 ||
+	    header->version != CHECKPOINT_VERSION) {
+		return "not a checkpoint";
+	}
+	if (memchr(header->build, '\0', sizeof(header->build)) == NULL ||
+	    !streq(header->build, ipsec_version_code())) {
+		return "saved by a different build";
+	}
+	uint8_t check[CHECKPOINT_KEK_CHECK_SIZE];
+	kek_check(kek, check, logger);
+	if (memcmp(check, header->kek_check, sizeof(check)) != 0) {
+		return "wrapped using a different key-wrapping key";
+	}
+	return NULL;
+}
+
+/* C's selectors; saved, and then compared when restoring */
+
+static size_t selectors_bound(const struct connection *c)
+{
+	return c->child.spds.len * (sizeof(selector_pair_buf) + sizeof("[] ")) + 1;
+}
+
+static void jam_checkpoint_selectors(struct jambuf *buf, const struct connection *c)
+{
+	const char *sep = "";
+	FOR_EACH_ITEM(spd, &c->child.spds) {
+		jam_string(buf, sep);
+		jam_string(buf, "[");
+		jam_selector_pair(buf, &spd->local->client, &spd->remote->client);
+		jam_string(buf, "]");
+		sep = " ";
+	}
+}
+
+static bool can_save_ike(struct ike_sa *ike)
+{
+	const struct connection *c = ike->sa.st_connection;
+	return (IS_IKE_SA_ESTABLISHED(&ike->sa) &&
+		is_permanent(c) &&
+		!is_labeled(c) &&
+		ike->sa.st_iface_endpoint->io->protocol != &ip_protocol_tcp &&
+		st_v2_lifetime_event(&ike->sa) != NULL);
+}
+
+/* the checkpoint is only saved between exchanges */
+
+static bool ike_quiescent(struct ike_sa *ike)
+{
+	return (!v2_msgid_request_outstanding(ike) &&
+		ike->sa.st_v2_msgid_windows.responder.wip < 0);
+}
+
+static bool can_save_child(struct child_sa *child)
+{
+	const struct connection *c = child->sa.st_connection;
+	const struct ipsec_proto_info *proto_info = outer_ipsec_proto_info(child);
+	return (IS_CHILD_SA_ESTABLISHED(&child->sa) &&
+		is_permanent(c) &&
+		child->sa.st_ipcomp.protocol == NULL &&
+		proto_info != NULL &&
+		proto_info->inbound.installed &&
+		proto_info->outbound.installed &&
+		st_v2_lifetime_event(&child->sa) != NULL);
+}
+
+static size_t child_bound(struct child_sa *child)
+{
+	const struct connection *c = child->sa.st_connection;
+	const struct ipsec_proto_info *proto_info = outer_ipsec_proto_info(child);
+	return checkpoint_align(sizeof(struct checkpoint_child) +
+			    strlen(c->name) + 1 +
+			    selectors_bound(c) +
+			    wrapped_bound(proto_info->inbound.keymat.len +
+					  proto_info->outbound.keymat.len));
+}
+
+static size_t ike_bound(struct ike_sa *ike)
+{
+	return checkpoint_align(sizeof(struct checkpoint_ike) +
+			    strlen(ike->sa.st_connection->name) + 1 +
+			    wrapped_bound(nr_ikev2_ike_keymat_bytes(&ike->sa)));
+}
+
+/* returns false, with the cursor unchanged, when the keys can't be wrapped */
+
+static bool save_child(struct cursor *cursor, unsigned ike_index,
+		       struct child_sa *child, PK11SymKey *kek, struct logger *logger)
+{
+	uint8_t *start = cursor->ptr;
+	const struct connection *c = child->sa.st_connection;
+	const struct ipsec_proto_info *proto_info = outer_ipsec_proto_info(child);
+	const struct trans_attrs *ta = &proto_info->trans_attrs;
+
+	struct checkpoint_child *rec = put(cursor, NULL, sizeof(*rec));
+	*rec = (struct checkpoint_child) {
+		.record.type = CHECKPOINT_CHILD,
+		.ike = ike_index,
+		.sa_role = child->sa.st_sa_role,
+		.flags = ((ta->esn_enabled ? CHILD_ESN : 0) |
+			  (child->sa.st_seen_esp_tfc_padding_not_supported ? CHILD_NO_TFC : 0) |
+			  (child->sa.st_seen_and_use_iptfs ? CHILD_IPTFS : 0)),
+		.ipproto = proto_info->protocol->ipproto,
+		.kernel_mode = child->sa.st_kernel_mode,
+		.reqid = c->child.reqid,
+		.ike_spis = child->sa.st_ike_spis,
+		.encrypt = (ta->ta_encrypt != NULL ? ta->ta_encrypt->ikev2_alg_id : 0),
+		.keylen = ta->enckeylen,
+		.integ = (ta->ta_integ != NULL ? ta->ta_integ->ikev2_alg_id : 0),
+		.inbound_spi = proto_info->inbound.spi,
+		.outbound_spi = proto_info->outbound.spi,
+		.local = c->local->host.addr,
+		.remote = endpoint_address(child->sa.st_remote_endpoint),
+		.name_len = strlen(c->name) + 1,
+		.inbound_len = proto_info->inbound.keymat.len,
+		.outbound_len = proto_info->outbound.keymat.len,
+	};
+	put_timers(&rec->timers, &child->sa);
+
+	put(cursor, c->name, rec->name_len);
+
+	struct jambuf buf = array_as_jambuf((char *)cursor->ptr, selectors_bound(c));
+	jam_checkpoint_selectors(&buf, c);
+	rec->selectors_len = jambuf_as_shunk(&buf).len + 1;
+	put(cursor, NULL, rec->selectors_len);
+
+	PK11SymKey *keymat = symkey_from_hunk("keymat", proto_info->inbound.keymat, logger);
+	append_symkey_hunk("keymat", &keymat, proto_info->outbound.keymat, logger);
+	bool ok = put_keymat(cursor, keymat, kek, &rec->wrapped_len, logger);
+	symkey_delref(logger, "keymat", &keymat);
+	if (!ok) {
+		llog(RC_LOG, child->sa.logger,
+		     "unable to wrap Child SA keys; not checkpointed");
+		memset(start, 0, cursor->ptr - start);
+		cursor->ptr = start;
+		return false;
+	}
+
+	cursor->ptr = start + checkpoint_align(cursor->ptr - start);
+	rec->record.size = cursor->ptr - start;
+	return true;
+}
+
+/* returns false, with the cursor unchanged, when the keys can't be wrapped */
+
+static bool save_ike(struct cursor *cursor, struct ike_sa *ike,
+		     PK11SymKey *kek, struct logger *logger)
+{
+	uint8_t *start = cursor->ptr;
+	const struct trans_attrs *ta = &ike->sa.st_oakley;
+	const struct connection *c = ike->sa.st_connection;
+	const struct v2_msgid_windows *windows = &ike->sa.st_v2_msgid_windows;
+
+	struct checkpoint_ike *rec = put(cursor, NULL, sizeof(*rec));
+	*rec = (struct checkpoint_ike) {
+		.record.type = CHECKPOINT_IKE,
+		.sa_role = ike->sa.st_sa_role,
+		.flags = ((ike->sa.st_v2_ike_fragmentation_enabled ? IKE_FRAGMENTATION : 0) |
+			  (ike->sa.st_seen_redirect_sup ? IKE_REDIRECT_SUP : 0) |
+			  (ike->sa.st_sent_redirect ? IKE_SENT_REDIRECT : 0) |
+			  (ike->sa.st_ikev2_anon ? IKE_ANON : 0) |
+			  (ike->sa.hidden_variables.st_nated_host ? IKE_NATED_HOST : 0) |
+			  (ike->sa.hidden_variables.st_nated_peer ? IKE_NATED_PEER : 0)),
+		.encrypt = ta->ta_encrypt->ikev2_alg_id,
+		.keylen = ta->enckeylen,
+		.prf = ta->ta_prf->ikev2_alg_id,
+		.integ = (ta->ta_integ != NULL ? ta->ta_integ->ikev2_alg_id : 0),
+		.kem = (ta->ta_dh != NULL ? ta->ta_dh->ikev2_alg_id : 0),
+		.spis = ike->sa.st_ike_spis,
+		.local = ike->sa.st_iface_endpoint->local_endpoint,
+		.remote = ike->sa.st_remote_endpoint,
+		.msgid = {
+			windows->initiator.sent,
+			windows->initiator.recv,
+			windows->responder.sent,
+			windows->responder.recv,
+		},
+		.nat_traversal = ike->sa.hidden_variables.st_nat_traversal,
+		.name_len = strlen(c->name) + 1,
+		.keymat_len = nr_ikev2_ike_keymat_bytes(&ike->sa),
+	};
+	put_timers(&rec->timers, &ike->sa);
+
+	put(cursor, c->name, rec->name_len);
+
+	PK11SymKey *keymat = ike_keymat(ike);
+	bool ok = (sizeof_symkey(keymat) == rec->keymat_len &&
+		   put_keymat(cursor, keymat, kek, &rec->wrapped_len, logger));
+	symkey_delref(logger, "keymat", &keymat);
+	if (!ok) {
+		llog(RC_LOG, ike->sa.logger,
+		     "unable to wrap IKE SA keys; not checkpointed");
+		memset(start, 0, cursor->ptr - start);
+		cursor->ptr = start;
+		return false;
+	}
+
+	cursor->ptr = start + checkpoint_align(cursor->ptr - start);
+	rec->record.size = cursor->ptr - start;
+	return true;
+}
+
+size_t checkpoint_ike_bound(struct ike_sa *ike)
+{
+	return (can_save_ike(ike) ? ike_bound(ike) : 0);
+}
+
+size_t checkpoint_save_ike(uint8_t *buf, size_t len, struct ike_sa *ike,
+			   PK11SymKey *kek, struct logger *logger)
+{
+	if (!can_save_ike(ike)) {
+		return 0;
+	}
+	struct cursor cursor = {
+		.ptr = buf,
+		.end = buf + len,
+	};
+	return (save_ike(&cursor, ike, kek, logger) ? (size_t)(cursor.ptr - buf) : 0);
+}
+
+size_t checkpoint_child_bound(struct child_sa *child)
+{
+	return (can_save_child(child) ? child_bound(child) : 0);
+}
+
+size_t checkpoint_save_child(uint8_t *buf, size_t len, unsigned ike_index,
+			     struct child_sa *child,
+			     PK11SymKey *kek, struct logger *logger)
+{
+	if (!can_save_child(child)) {
+		return 0;
+	}
+	struct cursor cursor = {
+		.ptr = buf,
+		.end = buf + len,
+	};
+	return (save_child(&cursor, ike_index, child, kek, logger) ?
+		(size_t)(cursor.ptr - buf) : 0);
+}
+
+static bool write_checkpoint(int fd, size_t bound, struct logger *logger)
+{
+	if (ftruncate(fd, bound) != 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "warm-restart: unable to size %s: ", checkpoint.path);
+		return false;
+	}
+
+	uint8_t *map = mmap(NULL, bound, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		llog_errno(RC_LOG, logger, errno,
+			   "warm-restart: unable to map %s: ", checkpoint.path);
+		return false;
+	}
+
+	struct cursor cursor = {
+		.ptr = map,
+		.end = map + bound,
+	};
+	struct checkpoint_header *header = put(&cursor, NULL, checkpoint_align(sizeof(*header)));
+	checkpoint_init_header(header, checkpoint.kek, logger);
+
+	struct state_filter sf = {
+		.ike_version = IKEv2,
+		.search = {
+			.order = OLD2NEW,
+			.verbose.logger = logger,
+			.where = HERE,
+		},
+	};
+	while (next_state(&sf)) {
+		if (!IS_IKE_SA(sf.st)) {
+			continue;
+		}
+		struct ike_sa *ike = pexpect_ike_sa(sf.st);
+		if (!can_save_ike(ike) ||
+		    !ike_quiescent(ike) ||
+		    !save_ike(&cursor, ike, checkpoint.kek, logger)) {
+			continue;
+		}
+		unsigned ike_index = header->nr_ike++;
+		struct state_filter cf = {
+			.clonedfrom = ike->sa.st_serialno,
+			.search = {
+				.order = OLD2NEW,
+				.verbose.logger = logger,
+				.where = HERE,
+			},
+		};
+		while (next_state(&cf)) {
+			struct child_sa *child = pexpect_child_sa(cf.st);
+			if (child != NULL && can_save_child(child) &&
+			    save_child(&cursor, ike_index, child, checkpoint.kek, logger)) {
+				header->nr_child++;
+			}
+		}
+	}
+
+	size_t size = cursor.ptr - map;
+	header->size = size;
+
+	if (munmap(map, bound) != 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "warm-restart: unable to unmap %s: ", checkpoint.path);
+		return false;
+	}
+	if (ftruncate(fd, size) != 0 || fsync(fd) != 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "warm-restart: unable to write %s: ", checkpoint.path);
+		return false;
+	}
+
+	llog(RC_LOG, logger, "warm-restart: saved %u IKE SAs and %u Child SAs to %s",
+	     header->nr_ike, header->nr_child, checkpoint.path);
+	return true;
+}
+
+void save_checkpoint(struct logger *logger)
+{
+	if (!checkpoint.enabled) {
+		return;
+	}
+	if (checkpoint.kek == NULL) {
+		llog(RC_LOG, logger,
+		     "warm-restart: no key-wrapping key \"%s\"; not saving",
+		     CHECKPOINT_KEK_NICKNAME);
+		return;
+	}
+
+	/* upper bound on the file's size */
+	size_t bound = checkpoint_align(sizeof(struct checkpoint_header));
+	struct state_filter sf = {
+		.ike_version = IKEv2,
+		.search = {
+			.order = OLD2NEW,
+			.verbose.logger = logger,
+			.where = HERE,
+		},
+	};
+	while (next_state(&sf)) {
+		if (IS_IKE_SA(sf.st)) {
+			struct ike_sa *ike = pexpect_ike_sa(sf.st);
+			if (can_save_ike(ike) && ike_quiescent(ike)) {
+				bound += ike_bound(ike);
+			}
+		} else {
+			struct child_sa *child = pexpect_child_sa(sf.st);
+			if (child != NULL && can_save_child(child)) {
+				bound += child_bound(child);
+			}
+		}
+	}
+
+	char *tmp = alloc_printf("%s.tmp", checkpoint.path);
+	unlink(tmp);
+	/* contains keys */
+	int fd = open(tmp, O_RDWR|O_CREAT|O_EXCL|O_CLOEXEC, S_IRUSR|S_IWUSR);
+	if (fd < 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "warm-restart: unable to create %s: ", tmp);
+		pfree(tmp);
+		return;
+	}
+
+	bool ok = write_checkpoint(fd, bound, logger);
+	close(fd);
+	if (ok && rename(tmp, checkpoint.path) != 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "warm-restart: unable to rename %s: ", tmp);
+		ok = false;
+	}
+	if (!ok) {
+		unlink(tmp);
+	}
+	pfree(tmp);
+}
+
+/*
+ * Restore.
+ */
+
+static void discard_child(struct restore_child *rc, struct logger *logger)
+{
+	if (rc->state != RESTORE_PENDING) {
+		return;
+	}
+	const struct checkpoint_child *rec = rc->rec;
+	if (!checkpoint.install) {
+		const struct ip_protocol *protocol = protocol_from_ipproto(rec->ipproto);
+		/* inbound then outbound */
+		kernel_ops_del_ipsec_spi(rec->inbound_spi, protocol,
+					 &rec->remote, &rec->local, logger);
+		kernel_ops_del_ipsec_spi(rec->outbound_spi, protocol,
+					 &rec->local, &rec->remote, logger);
+	}
+	rc->state = RESTORE_DISCARDED;
+	checkpoint.discarded_child++;
+	checkpoint.pending--;
+	checkpoint.ike[rec->ike].lost_child = true;
+}
+
+static void unmap_checkpoint(void)
+{
+	if (checkpoint.map == NULL) {
+		return;
+	}
+	/* wipe the keys */
+	memset(checkpoint.map, 0, checkpoint.size);
+	if (checkpoint.mapped) {
+		munmap(checkpoint.map, checkpoint.size);
+	} else {
+		pfree(checkpoint.map);
+	}
+	checkpoint.map = NULL;
+	checkpoint.size = 0;
+	pfreeany(checkpoint.ike);
+	pfreeany(checkpoint.child);
+	pfreeany(checkpoint.ike_buckets);
+	pfreeany(checkpoint.child_buckets);
+	checkpoint.unwrap_kek = NULL;
+	checkpoint.nr_ike = checkpoint.nr_child = 0;
+	checkpoint.nr_buckets = 0;
+	destroy_timeout(&checkpoint.sweep);
+}
+
+/*
+ * Anything still pending is deleted; as are restored IKE SAs that
+ * lost a Child SA (so that the peer re-negotiates).
+ */
+
+static void finish_checkpoint(struct logger *logger)
+{
+	for (unsigned c = 0; c < checkpoint.nr_child; c++) {
+		struct restore_child *rc = &checkpoint.child[c];
+		if (rc->state == RESTORE_PENDING) {
+			llog(RC_LOG, logger,
+			     "%s: Child SA for \"%s\" not re-adopted; deleting",
+			     checkpoint.story, rc->name);
+			discard_child(rc, logger);
+		}
+	}
+	for (unsigned i = 0; i < checkpoint.nr_ike; i++) {
+		struct restore_ike *ri = &checkpoint.ike[i];
+		if (ri->state != RESTORE_ADOPTED || !ri->lost_child) {
+			continue;
+		}
+		struct ike_sa *ike = ike_sa_by_serialno(ri->serialno);
+		if (ike != NULL) {
+			llog(RC_LOG, ike->sa.logger,
+			     "%s: deleting IKE SA that lost a Child SA",
+			     checkpoint.story);
+			submit_v2_delete_exchange(ike, NULL);
+		}
+	}
+	llog(RC_LOG, logger,
+	     "%s: re-adopted %ju IKE SAs and %ju Child SAs; discarded %ju Child SAs",
+	     checkpoint.story, checkpoint.adopted_ike, checkpoint.adopted_child, checkpoint.discarded_child);
+	unmap_checkpoint();
+}
+
+static void sweep_checkpoint(void *arg UNUSED, const struct timer_event *event)
+{
+	destroy_timeout(&checkpoint.sweep);
+	finish_checkpoint(event->logger);
+}
+
+static deltatime_t remaining(int64_t at)
+{
+	return deltatime_max(deltatime_from_milliseconds(at - checkpoint.now),
+			     deltatime(0));
+}
+
+static bool expired(const struct checkpoint_timers *timers)
+{
+	return deltatime_cmp(remaining(timers->lifetime_at), <=, deltatime(0));
+}
+
+static void restore_timers(struct state *st, const struct checkpoint_timers *timers)
+{
+	st->st_inception = realtime(timers->inception);
+	deltatime_t lifetime = remaining(timers->lifetime_at);
+	if (timers->rekey_at >= 0) {
+		deltatime_t rekey = remaining(timers->rekey_at);
+		st->st_replace_margin = deltatime_sub(lifetime, rekey);
+		if (checkpoint.install && IS_CHILD_SA(st)) {
+			/* the kernel's sequence numbers start again */
+			event_schedule(EVENT_v2_REKEY, deltatime(0), st);
+		} else {
+			event_schedule(EVENT_v2_REKEY, rekey, st);
+			st->st_v2_rekey_event->ev_rekey_booked =
+				book_rekey(st->st_v2_rekey_event->ev_time);
+		}
+	}
+	event_schedule(timers->lifetime_type, lifetime, st);
+}
+
+/* returns NULL when WRAPPED doesn't unwrap to LEN bytes */
+
+static PK11SymKey *unwrap_keymat(shunk_t wrapped, size_t len, struct logger *logger)
+{
+	SECItem item = same_shunk_as_secitem(wrapped, siBuffer);
+	PK11SymKey *keymat = PK11_UnwrapSymKey(checkpoint.unwrap_kek, KEK_MECHANISM, NULL, &item,
+					       CKM_EXTRACT_KEY_FROM_KEY, CKA_DERIVE, 0);
+	if (keymat == NULL) {
+		return NULL;
+	}
+	symkey_newref(logger, "keymat", keymat);
+	if (sizeof_symkey(keymat) != len) {
+		symkey_delref(logger, "keymat", &keymat);
+	}
+	return keymat;
+}
+
+static struct connection *permanent_connection(const char *name, struct logger *logger)
+{
+	struct connection_filter cq = {
+		.name = name,
+		.kind = CK_PERMANENT,
+		.ike_version = IKEv2,
+		.search = {
+			.order = OLD2NEW,
+			.verbose.logger = logger,
+			.where = HERE,
+		},
+	};
+	return (next_connection(&cq) ? cq.c : NULL);
+}
+
+static const char *restore_child_sa(struct restore_child *rc, struct ike_sa *ike,
+				    struct connection *c)
+{
+	const struct checkpoint_child *rec = rc->rec;
+	struct logger *logger = ike->sa.logger;
+
+	if (!oriented(c)) {
+		return "connection is not oriented";
+	}
+	if (rec->reqid != c->child.reqid) {
+		return "reqid changed";
+	}
+
+	size_t bound = selectors_bound(c);
+	char *selectors = alloc_bytes(bound, "checkpoint selectors");
+	struct jambuf buf = array_as_jambuf(selectors, bound);
+	jam_checkpoint_selectors(&buf, c);
+	bool same = streq(selectors, rc->selectors);
+	pfree(selectors);
+	if (!same) {
+		return "traffic selectors changed";
+	}
+
+	const struct ip_protocol *protocol = protocol_from_ipproto(rec->ipproto);
+	if (protocol != &ip_protocol_esp && protocol != &ip_protocol_ah) {
+		return "unknown protocol";
+	}
+	name_buf nb;
+	const struct encrypt_desc *encrypt = (rec->encrypt == 0 ? NULL :
+					      ikev2_encrypt_desc(rec->encrypt, &nb));
+	const struct integ_desc *integ = ikev2_integ_desc(rec->integ, &nb);
+	if ((rec->encrypt != 0 && encrypt == NULL) ||
+	    (rec->integ != 0 && integ == NULL)) {
+		return "algorithm no longer supported";
+	}
+	size_t keymat_len = ((integ != NULL ? integ->integ_keymat_size : 0) +
+			     BYTES_FOR_BITS(rec->keylen) +
+			     (encrypt != NULL ? encrypt->salt_size : 0));
+	if (rec->inbound_len != keymat_len || rec->outbound_len != keymat_len) {
+		return "keying material has the wrong size";
+	}
+
+	PK11SymKey *keymat = unwrap_keymat(rc->keymat, 2 * keymat_len, logger);
+	if (keymat == NULL) {
+		return "unable to unwrap keying material";
+	}
+	chunk_t bytes = chunk_from_symkey("keymat", keymat, logger);
+	symkey_delref(logger, "keymat", &keymat);
+
+	struct child_sa *child = new_v2_child_sa(c, ike, CHILD_SA, rec->sa_role,
+						 STATE_V2_NEW_CHILD_R0);
+	child->sa.st_restored = !checkpoint.install;
+	child->sa.st_kernel_mode = rec->kernel_mode;
+	child->sa.st_seen_esp_tfc_padding_not_supported = (rec->flags & CHILD_NO_TFC);
+	child->sa.st_seen_and_use_iptfs = (rec->flags & CHILD_IPTFS);
+
+	struct ipsec_proto_info *proto_info = (protocol == &ip_protocol_esp ?
+					       &child->sa.st_esp : &child->sa.st_ah);
+	proto_info->protocol = protocol;
+	proto_info->trans_attrs.ta_encrypt = encrypt;
+	proto_info->trans_attrs.enckeylen = rec->keylen;
+	proto_info->trans_attrs.ta_integ = integ;
+	proto_info->trans_attrs.esn_enabled = (rec->flags & CHILD_ESN);
+	proto_info->inbound.spi = rec->inbound_spi;
+	proto_info->outbound.spi = rec->outbound_spi;
+	proto_info->inbound.keymat = clone_bytes_as_chunk(bytes.ptr, keymat_len, "inbound keymat");
+	proto_info->outbound.keymat = clone_bytes_as_chunk(bytes.ptr + keymat_len, keymat_len,
+							   "outbound keymat");
+	memset(bytes.ptr, 0, bytes.len);
+	free_chunk_content(&bytes);
+	proto_info->inbound.last_used =
+	proto_info->outbound.last_used =
+		realnow();
+
+	if (checkpoint.install) {
+		/* the inbound SA is then updated, as if negotiated */
+		if (!reserve_ipsec_spi(c, protocol, rec->inbound_spi, logger)) {
+			delete_child_sa(&child);
+			return "unable to reserve the inbound SPI";
+		}
+	} else if (!get_ipsec_traffic(child, proto_info, DIRECTION_INBOUND) ||
+		   !get_ipsec_traffic(child, proto_info, DIRECTION_OUTBOUND)) {
+		/* no longer in the kernel */
+		delete_child_sa(&child);
+		return "kernel IPsec SA is missing";
+	}
+
+	/* updates the kernel's SAs in place */
+	rc->state = RESTORE_ADOPTED;
+	checkpoint.pending--;
+	if (!connection_establish_child(ike, child, HERE)) {
+		connection_teardown_child(&child, REASON_DELETED, HERE);
+		rc->state = RESTORE_DISCARDED;
+		checkpoint.discarded_child++;
+		checkpoint.ike[rec->ike].lost_child = true;
+		return "unable to install kernel state";
+	}
+
+	PEXPECT(logger, child->sa.st_v2_transition->to == &state_v2_ESTABLISHED_CHILD_SA);
+	change_v2_state(&child->sa);
+	pstat_sa_established(&child->sa);
+	LLOG_JAMBUF(RC_LOG, child->sa.logger, buf) {
+		jam_string(buf, "restored Child SA using ");
+		jam_so(buf, child->sa.st_clonedfrom);
+		jam_string(buf, "; IPsec ");
+		jam_enum_human(buf, &kernel_mode_names, child->sa.st_kernel_mode);
+		jam_string(buf, " ");
+		jam_string(buf, rc->selectors);
+		jam_child_sa_details(buf, &child->sa);
+	}
+	restore_timers(&child->sa, &rec->timers);
+	if (dpd_active_locally(c)) {
+		deltatime_t delay = deltatime_max(c->config->dpd.delay,
+						  deltatime(MIN_LIVENESS));
+		event_schedule(EVENT_v2_LIVENESS, delay, &child->sa);
+	}
+	checkpoint.adopted_child++;
+	return NULL;
+}
+
+static void restore_child(struct restore_child *rc, struct connection *c,
+			  struct logger *logger)
+{
+	if (rc->state != RESTORE_PENDING) {
+		return;
+	}
+	const struct restore_ike *ri = &checkpoint.ike[rc->rec->ike];
+	struct ike_sa *ike = (ri->state == RESTORE_ADOPTED ?
+			      ike_sa_by_serialno(ri->serialno) : NULL);
+	const char *why = (ike == NULL ? "IKE SA is gone" :
+			   expired(&rc->rec->timers) ? "lifetime expired" :
+			   restore_child_sa(rc, ike, c));
+	if (why != NULL) {
+		llog(RC_LOG, c->logger, "%s: Child SA not re-adopted, %s",
+		     checkpoint.story, why);
+		discard_child(rc, logger);
+	}
+}
+
+static const char *restore_ike_sa(struct restore_ike *ri, struct connection *c,
+				  struct logger *logger)
+{
+	const struct checkpoint_ike *rec = ri->rec;
+
+	if (!oriented(c)) {
+		return "connection is not oriented";
+	}
+	if (expired(&rec->timers)) {
+		return "lifetime expired";
+	}
+	if (find_v2_ike_sa(&rec->spis, rec->sa_role) != NULL) {
+		return "IKE SA already exists";
+	}
+
+	name_buf nb;
+	struct trans_attrs ta = {
+		.ta_encrypt = ikev2_encrypt_desc(rec->encrypt, &nb),
+		.enckeylen = rec->keylen,
+		.ta_prf = ikev2_prf_desc(rec->prf, &nb),
+		.ta_integ = (rec->integ == 0 ? NULL : ikev2_integ_desc(rec->integ, &nb)),
+		.ta_dh = (rec->kem == 0 ? NULL : ikev2_kem_desc(rec->kem, &nb)),
+	};
+	if (ta.ta_encrypt == NULL || ta.ta_prf == NULL ||
+	    (rec->integ != 0 && ta.ta_integ == NULL) ||
+	    (rec->kem != 0 && ta.ta_dh == NULL)) {
+		return "algorithm no longer supported";
+	}
+
+	size_t keymat_len = ikev2_ike_keymat_bytes(&ta);
+	if (keymat_len != rec->keymat_len) {
+		return "keying material has the wrong size";
+	}
+
+	struct iface_endpoint *ifp = find_iface_endpoint_by_local_endpoint(rec->local);
+	if (ifp == NULL) {
+		return "interface is gone";
+	}
+
+	PK11SymKey *keymat = unwrap_keymat(ri->keymat, keymat_len, logger);
+	if (keymat == NULL) {
+		return "unable to unwrap keying material";
+	}
+
+	struct ike_sa *ike = new_v2_ike_sa_restored(c, rec->sa_role, ifp, rec->remote,
+						    &rec->spis, (rec->flags & IKE_ANON));
+	ike->sa.st_oakley = ta;
+
+	extract_ikev2_ike_keys(&ike->sa, keymat);
+	symkey_delref(ike->sa.logger, "keymat", &keymat);
+
+	struct v2_msgid_windows *windows = &ike->sa.st_v2_msgid_windows;
+	windows->initiator.sent = rec->msgid[0];
+	windows->initiator.recv = rec->msgid[1];
+	windows->responder.sent = rec->msgid[2];
+	windows->responder.recv = rec->msgid[3];
+	/* a replicated request may still be outstanding; abandon it */
+	windows->initiator.recv = max(windows->initiator.recv, windows->initiator.sent);
+	windows->last_sent = windows->last_recv = mononow();
+
+	ike->sa.st_v2_ike_fragmentation_enabled = (rec->flags & IKE_FRAGMENTATION);
+	ike->sa.st_seen_redirect_sup = (rec->flags & IKE_REDIRECT_SUP);
+	ike->sa.st_sent_redirect = (rec->flags & IKE_SENT_REDIRECT);
+	ike->sa.hidden_variables.st_nated_host = (rec->flags & IKE_NATED_HOST);
+	ike->sa.hidden_variables.st_nated_peer = (rec->flags & IKE_NATED_PEER);
+	ike->sa.hidden_variables.st_nat_traversal = rec->nat_traversal;
+
+	v2_ike_sa_established(ike, HERE);
+	restore_timers(&ike->sa, &rec->timers);
+	llog(RC_LOG, ike->sa.logger, "restored IKE SA");
+
+	ri->state = RESTORE_ADOPTED;
+	ri->serialno = ike->sa.st_serialno;
+	checkpoint.adopted_ike++;
+	checkpoint.pending--;
+
+	/* Child SAs of already loaded connections */
+	for (unsigned i = 0; i < ri->nr_children; i++) {
+		struct restore_child *rc = &checkpoint.child[ri->first_child + i];
+		struct connection *cc = (streq(rc->name, c->name) ? c :
+					 permanent_connection(rc->name, logger));
+		if (cc != NULL) {
+			restore_child(rc, cc, logger);
+		}
+	}
+	return NULL;
+}
+
+void restore_checkpoint(struct connection *c, struct logger *logger)
+{
+	if (checkpoint.map == NULL ||
+	    !is_permanent(c) ||
+	    c->config->ike_version != IKEv2) {
+		return;
+	}
+
+	/*
+	 * Until pluto is listening there are no interfaces to orient
+	 * to; check_orientations() calls back once there are.
+	 */
+	if (!oriented(c)) {
+		ldbg(c->logger, "%s: connection not yet oriented", checkpoint.story);
+		return;
+	}
+
+	unsigned b = bucket(c->name);
+	for (unsigned i = checkpoint.ike_buckets[b]; i != NO_RECORD;
+	     i = checkpoint.ike[i].next) {
+		struct restore_ike *ri = &checkpoint.ike[i];
+		if (ri->state != RESTORE_PENDING || !streq(ri->name, c->name)) {
+			continue;
+		}
+		const char *why = restore_ike_sa(ri, c, logger);
+		if (why != NULL) {
+			llog(RC_LOG, c->logger, "%s: IKE SA not re-adopted, %s",
+			     checkpoint.story, why);
+			ri->state = RESTORE_DISCARDED;
+			checkpoint.pending--;
+			for (unsigned ci = 0; ci < ri->nr_children; ci++) {
+				discard_child(&checkpoint.child[ri->first_child + ci], logger);
+			}
+		}
+	}
+
+	/* Child SAs whose IKE SA was restored earlier */
+	for (unsigned i = checkpoint.child_buckets[b]; i != NO_RECORD;
+	     i = checkpoint.child[i].next) {
+		struct restore_child *rc = &checkpoint.child[i];
+		if (streq(rc->name, c->name)) {
+			restore_child(rc, c, logger);
+		}
+	}
+
+	if (checkpoint.pending == 0) {
+		finish_checkpoint(logger);
+	}
+}
+
+bool checkpoint_has_child_sas(void)
+{
+	return (checkpoint.map != NULL && checkpoint.pending > 0);
+}
+
+static bool valid_timers(const struct checkpoint_timers *timers)
+{
+	return (timers->lifetime_type == EVENT_v2_REPLACE ||
+		timers->lifetime_type == EVENT_v2_EXPIRE);
+}
+
+static const char *index_checkpoint(struct logger *logger)
+{
+	const struct checkpoint_header *header = (const void *)checkpoint.map;
+	if (checkpoint.size < sizeof(*header)) {
+		return "not a checkpoint";
+	}
+	const char *why = checkpoint_check_header(header, checkpoint.unwrap_kek, logger);
+	if (why != NULL) {
+		return why;
+	}
+	if (header->size != checkpoint.size) {
+		return "truncated";
+	}
+
+	checkpoint.ike = alloc_things(struct restore_ike, header->nr_ike, "checkpoint ike");
+	checkpoint.child = alloc_things(struct restore_child, header->nr_child, "checkpoint child");
+
+	const uint8_t *end = checkpoint.map + checkpoint.size;
+	const uint8_t *ptr = checkpoint.map + checkpoint_align(sizeof(*header));
+	while (ptr < end) {
+		const struct checkpoint_record *record = (const void *)ptr;
+		if ((size_t)(end - ptr) < sizeof(*record) ||
+		    record->size % CHECKPOINT_ALIGN != 0 ||
+		    record->size > (size_t)(end - ptr)) {
+			return "corrupt record";
+		}
+		switch (record->type) {
+		case CHECKPOINT_IKE:
+		{
+			const struct checkpoint_ike *rec = (const void *)ptr;
+			const char *name = (const char *)(rec + 1);
+			if (record->size < sizeof(*rec) ||
+			    checkpoint.nr_ike >= header->nr_ike ||
+			    sizeof(*rec) + rec->name_len + rec->wrapped_len > record->size ||
+			    rec->name_len == 0 || name[rec->name_len - 1] != '\0' ||
+			    !valid_timers(&rec->timers)) {
+				return "corrupt IKE record";
+			}
+			checkpoint.ike[checkpoint.nr_ike++] = (struct restore_ike) {
+				.rec = rec,
+				.name = name,
+				.keymat = shunk2(name + rec->name_len, rec->wrapped_len),
+				.first_child = checkpoint.nr_child,
+				.next = NO_RECORD,
+			};
+			break;
+		}
+		case CHECKPOINT_CHILD:
+		{
+			const struct checkpoint_child *rec = (const void *)ptr;
+			const char *name = (const char *)(rec + 1);
+			if (record->size < sizeof(*rec) ||
+			    checkpoint.nr_child >= header->nr_child ||
+			    rec->ike + 1 != checkpoint.nr_ike ||
+			    (sizeof(*rec) + rec->name_len + rec->selectors_len +
+			     rec->wrapped_len) > record->size ||
+			    rec->name_len == 0 || name[rec->name_len - 1] != '\0' ||
+			    rec->selectors_len == 0 ||
+			    name[rec->name_len + rec->selectors_len - 1] != '\0' ||
+			    !valid_timers(&rec->timers)) {
+				return "corrupt Child record";
+			}
+			checkpoint.child[checkpoint.nr_child++] = (struct restore_child) {
+				.rec = rec,
+				.name = name,
+				.selectors = name + rec->name_len,
+				.keymat = shunk2(name + rec->name_len + rec->selectors_len,
+						 rec->wrapped_len),
+				.next = NO_RECORD,
+			};
+			checkpoint.ike[rec->ike].nr_children++;
+			break;
+		}
+		default:
+			return "unknown record";
+		}
+		ptr += record->size;
+	}
+	if (checkpoint.nr_ike != header->nr_ike ||
+	    checkpoint.nr_child != header->nr_child) {
+		return "record count mismatch";
+	}
+
+	checkpoint.nr_buckets = 16;
+	while (checkpoint.nr_buckets < checkpoint.nr_ike + checkpoint.nr_child) {
+		checkpoint.nr_buckets <<= 1;
+	}
+	checkpoint.ike_buckets = alloc_things(unsigned, checkpoint.nr_buckets, "checkpoint ike buckets");
+	checkpoint.child_buckets = alloc_things(unsigned, checkpoint.nr_buckets, "checkpoint child buckets");
+	for (unsigned b = 0; b < checkpoint.nr_buckets; b++) {
+		checkpoint.ike_buckets[b] = checkpoint.child_buckets[b] = NO_RECORD;
+	}
+	/* prepend in reverse, so each chain is in file order */
+	for (unsigned i = checkpoint.nr_ike; i-- > 0; ) {
+		unsigned b = bucket(checkpoint.ike[i].name);
+		checkpoint.ike[i].next = checkpoint.ike_buckets[b];
+		checkpoint.ike_buckets[b] = i;
+	}
+	for (unsigned i = checkpoint.nr_child; i-- > 0; ) {
+		unsigned b = bucket(checkpoint.child[i].name);
+		checkpoint.child[i].next = checkpoint.child_buckets[b];
+		checkpoint.child_buckets[b] = i;
+	}
+
+	checkpoint.pending = checkpoint.nr_ike + checkpoint.nr_child;
+	checkpoint.now = realnow_ms();
+	return NULL;
+}
+
+/*
+ * Find the key-wrapping key in the NSS DB, creating it the first
+ * time.  Replication uses it too, so the active and standby need the
+ * same NSS DB (or a copy of it).
+ */
+
+static PK11SymKey *find_kek(struct logger *logger)
+{
+	PK11SlotInfo *slot = lsw_nss_get_authenticated_slot(logger);
+	if (slot == NULL) {
+		return NULL;
+	}
+	void *password_context = lsw_nss_get_password_context(logger);
+
+	/* returns a list; keep the first */
+	PK11SymKey *kek = PK11_ListFixedKeysInSlot(slot, (char *)CHECKPOINT_KEK_NICKNAME,
+						   password_context);
+	for (PK11SymKey *next = (kek == NULL ? NULL : PK11_GetNextSymKey(kek));
+	     next != NULL; ) {
+		PK11SymKey *tmp = next;
+		next = PK11_GetNextSymKey(tmp);
+		PK11_FreeSymKey(tmp);
+	}
+
+	if (kek == NULL) {
+		kek = PK11_TokenKeyGenWithFlags(slot, CKM_AES_KEY_GEN, NULL, 256 / 8, NULL,
+						CKF_WRAP | CKF_UNWRAP,
+						(PK11_ATTR_TOKEN |
+						 PK11_ATTR_PRIVATE |
+						 PK11_ATTR_SENSITIVE),
+						password_context);
+		if (kek == NULL) {
+			llog_nss_error(RC_LOG, logger,
+				       "warm-restart: unable to create key-wrapping key \"%s\"",
+				       CHECKPOINT_KEK_NICKNAME);
+		} else if (PK11_SetSymKeyNickname(kek, CHECKPOINT_KEK_NICKNAME) != SECSuccess) {
+			llog_nss_error(RC_LOG, logger,
+				       "warm-restart: unable to name key-wrapping key \"%s\"",
+				       CHECKPOINT_KEK_NICKNAME);
+			PK11_DeleteTokenSymKey(kek);
+			PK11_FreeSymKey(kek);
+			kek = NULL;
+		} else {
+			llog(RC_LOG, logger,
+			     "warm-restart: created key-wrapping key \"%s\" in the NSS DB",
+			     CHECKPOINT_KEK_NICKNAME);
+		}
+	}
+	PK11_FreeSlot(slot); /* reference counted */
+
+	if (kek != NULL) {
+		symkey_newref(logger, "kek", kek);
+	}
+	return kek;
+}
+
+PK11SymKey *checkpoint_kek(struct logger *logger)
+{
+	if (!checkpoint.kek_found) {
+		checkpoint.kek = find_kek(logger);
+		checkpoint.kek_found = true;
+	}
+	return checkpoint.kek;
+}
+
+void init_checkpoint(const struct config_setup *oco, struct logger *logger)
+{
+	checkpoint.enabled = config_setup_yn(oco, KYN_WARM_RESTART);
+	if (!checkpoint.enabled) {
+		return;
+	}
+	checkpoint.path = alloc_printf("%s/pluto.checkpoint",
+				       config_setup_string(oco, KSF_RUNDIR));
+	checkpoint_kek(logger);
+
+	int fd = open(checkpoint.path, O_RDWR|O_CLOEXEC);
+	if (fd < 0) {
+		if (errno != ENOENT) {
+			llog_errno(RC_LOG, logger, errno,
+				   "warm-restart: unable to open %s: ", checkpoint.path);
+		}
+		return;
+	}
+
+	/* read once */
+	unlink(checkpoint.path);
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "warm-restart: unable to stat %s: ", checkpoint.path);
+		close(fd);
+		return;
+	}
+	if (st.st_uid != geteuid() || (st.st_mode & (S_IRWXG|S_IRWXO)) != 0) {
+		llog(RC_LOG, logger,
+		     "warm-restart: ignoring %s, not private to this user", checkpoint.path);
+		close(fd);
+		return;
+	}
+	if (st.st_size == 0) {
+		close(fd);
+		return;
+	}
+
+	if (checkpoint.kek == NULL) {
+		llog(RC_LOG, logger,
+		     "warm-restart: ignoring %s, no key-wrapping key", checkpoint.path);
+		close(fd);
+		return;
+	}
+
+	checkpoint.story = "warm-restart";
+	checkpoint.unwrap_kek = checkpoint.kek;
+	checkpoint.install = false;
+	checkpoint.mapped = true;
+	checkpoint.size = st.st_size;
+	checkpoint.map = mmap(NULL, checkpoint.size, PROT_READ|PROT_WRITE,
+			      MAP_SHARED, fd, 0);
+	close(fd);
+	if (checkpoint.map == MAP_FAILED) {
+		llog_errno(RC_LOG, logger, errno,
+			   "warm-restart: unable to map %s: ", checkpoint.path);
+		checkpoint.map = NULL;
+		checkpoint.size = 0;
+		return;
+	}
+
+	const char *why = index_checkpoint(logger);
+	if (why != NULL) {
+		llog(RC_LOG, logger, "warm-restart: ignoring %s, %s", checkpoint.path, why);
+		unmap_checkpoint();
+		return;
+	}
+
+	const struct checkpoint_header *header = (const void *)checkpoint.map;
+	deltatime_t downtime = deltatime_max(realtime_diff(realnow(), realtime(header->saved)),
+					     deltatime(0));
+	deltatime_buf db;
+	llog(RC_LOG, logger,
+	     "warm-restart: %u IKE SAs and %u Child SAs to re-adopt (down for %s seconds)",
+	     checkpoint.nr_ike, checkpoint.nr_child, str_deltatime(downtime, &db));
+	schedule_timeout("warm-restart", &checkpoint.sweep,
+			 deltatime(CHECKPOINT_SWEEP_SECONDS),
+			 sweep_checkpoint, NULL);
+}
+
+bool adopt_checkpoint(uint8_t *image, size_t size, PK11SymKey *kek,
+		      struct logger *logger)
+{
+	if (checkpoint.map != NULL) {
+		llog(RC_LOG, logger, "takeover: warm-restart still in progress");
+		memset(image, 0, size);
+		pfree(image);
+		return false;
+	}
+
+	checkpoint.story = "takeover";
+	checkpoint.unwrap_kek = kek;
+	checkpoint.install = true;
+	checkpoint.mapped = false;
+	checkpoint.map = image;
+	checkpoint.size = size;
+	const char *why = index_checkpoint(logger);
+	if (why != NULL) {
+		llog_pexpect(logger, HERE, "takeover: %s", why);
+		unmap_checkpoint();
+		return false;
+	}
+
+	llog(RC_LOG, logger, "takeover: %u IKE SAs and %u Child SAs to adopt",
+	     checkpoint.nr_ike, checkpoint.nr_child);
+	schedule_timeout("takeover", &checkpoint.sweep,
+			 deltatime(CHECKPOINT_SWEEP_SECONDS),
+			 sweep_checkpoint, NULL);
+
+	/* connections added later are handled by connection_added() */
+	struct connection_filter cq = {
+		.kind = CK_PERMANENT,
+		.ike_version = IKEv2,
+		.search = {
+			.order = OLD2NEW,
+			.verbose.logger = logger,
+			.where = HERE,
+		},
+	};
+	while (checkpoint.map != NULL && next_connection(&cq)) {
+		restore_checkpoint(cq.c, logger);
+	}
+	return true;
+}
+
+void free_checkpoint(struct logger *logger)
+{
+	unmap_checkpoint();
+	symkey_delref(logger, "kek", &checkpoint.kek);
+	checkpoint.kek_found = false;
+	pfreeany(checkpoint.path);
+	checkpoint.enabled = false;
+}
+
+void show_checkpoint_status(struct show *s)
+{
+	show(s, "config.setup.warm_restart=%s", bool_str(checkpoint.enabled));
+	show(s, "current.warm_restart.pending=%u", (checkpoint.map == NULL ? 0 : checkpoint.pending));
+	show(s, "total.warm_restart.adopted.ike=%ju", checkpoint.adopted_ike);
+	show(s, "total.warm_restart.adopted.child=%ju", checkpoint.adopted_child);
+	show(s, "total.warm_restart.discarded.child=%ju", checkpoint.discarded_child);
+}
@@ -0,0 +1,215 @@
+/* warm-restart checkpoint, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <pk11pub.h>
+
+#include "ike_spi.h"
+#include "ip_endpoint.h"
+#include "ip_address.h"
+#include "ipsec_spi.h"
+
+struct config_setup;
+struct connection;
+struct logger;
+struct show;
+struct ike_sa;
+struct child_sa;
+
+/*
+ * With config-setup's warm-restart=yes, "ipsec whack --shutdown
+ * --leave-state" saves the established IKEv2 IKE and Child SAs
+ * (SPIs, keys, message IDs, selectors and lifetimes) to
+ * $rundir/pluto.checkpoint.
+ *
+ * On the next start, init_checkpoint() maps and then removes the
+ * file, and restore_checkpoint(), called once each connection is
+ * added and oriented, re-adopts that connection's SAs; the kernel's
+ * IPsec SAs, left in place by init_kernel(), are updated rather than
+ * re-created.  Anything not re-adopted within a minute is deleted.
+ *
+ * The keys are never written in the clear: they are wrapped using a
+ * key kept in the NSS DB under CHECKPOINT_KEK_NICKNAME (created on
+ * first use, which is why warm-restart and replication open the DB
+ * read-write).  checkpoint_kek() returns it, or NULL.
+ */
+
+#define CHECKPOINT_KEK_NICKNAME "pluto-checkpoint"
+
+void init_checkpoint(const struct config_setup *oco, struct logger *logger);
+PK11SymKey *checkpoint_kek(struct logger *logger);
+bool checkpoint_has_child_sas(void);
+void restore_checkpoint(struct connection *c, struct logger *logger);
+void save_checkpoint(struct logger *logger);
+void free_checkpoint(struct logger *logger);
+void show_checkpoint_status(struct show *s);
+
+/*
+ * The records, also streamed to a standby by replication.c.
+ *
+ * A checkpoint is a header followed by variable length records,
+ * each 8-byte aligned.  An IKE record is followed by the records of
+ * its Child SAs.
+ *
+ * The values are raw structures; they are only ever read by the same
+ * build (see .build).
+ *
+ * Keying material is wrapped (CKM_AES_KEY_WRAP_PAD) using the KEK
+ * passed to checkpoint_save_{ike,child}(); the header's .kek_check
+ * identifies that KEK.
+ */
+
+#define CHECKPOINT_MAGIC "pluto-checkpoint"	/* 16 characters */
+#define CHECKPOINT_VERSION 3
+#define CHECKPOINT_ALIGN 8
+#define CHECKPOINT_KEK_CHECK_SIZE 8
+
+struct checkpoint_header {
+	char magic[16];
+	uint32_t version;
+	uint32_t nr_ike;
+	uint32_t nr_child;
+	uint32_t size;			/* of checkpoint */
+	int64_t saved;			/* realtime seconds */
+	char build[64];			/* ipsec_version_code() */
+	uint8_t kek_check[CHECKPOINT_KEK_CHECK_SIZE];
+};
+
+enum checkpoint_type {
+	CHECKPOINT_IKE = 1,
+	CHECKPOINT_CHILD = 2,
+	/* replication only */
+	CHECKPOINT_MSGID = 3,
+	CHECKPOINT_DELETE_IKE = 4,
+	CHECKPOINT_DELETE_CHILD = 5,
+};
+
+struct checkpoint_record {
+	uint32_t type;
+	uint32_t size;			/* including this */
+};
+
+struct checkpoint_timers {
+	int64_t inception;		/* realtime seconds */
+	int64_t rekey_at;		/* realtime milliseconds; -1 when none */
+	int64_t lifetime_at;		/* realtime milliseconds */
+	uint32_t lifetime_type;		/* EVENT_v2_REPLACE or EVENT_v2_EXPIRE */
+	uint32_t pad;
+};
+
+#define IKE_FRAGMENTATION	(1 << 0)
+#define IKE_REDIRECT_SUP	(1 << 1)
+#define IKE_SENT_REDIRECT	(1 << 2)
+#define IKE_ANON		(1 << 3)
+#define IKE_NATED_HOST		(1 << 4)
+#define IKE_NATED_PEER		(1 << 5)
+
+struct checkpoint_ike {
+	struct checkpoint_record record;
+	uint32_t sa_role;
+	uint32_t flags;
+	uint16_t encrypt, keylen, prf, integ, kem, pad;
+	ike_spis_t spis;
+	ip_endpoint local;
+	ip_endpoint remote;
+	int64_t msgid[4];		/* initiator sent/recv, responder sent/recv */
+	uint64_t nat_traversal;
+	struct checkpoint_timers timers;
+	uint32_t name_len;		/* including NUL */
+	uint32_t keymat_len;		/* unwrapped */
+	uint32_t wrapped_len;
+	uint32_t pad2;
+	/* followed by: name, wrapped keymat */
+};
+
+#define CHILD_ESN		(1 << 0)
+#define CHILD_NO_TFC		(1 << 1)
+#define CHILD_IPTFS		(1 << 2)
+
+struct checkpoint_child {
+	struct checkpoint_record record;
+	uint32_t ike;			/* index of IKE record */
+	uint32_t sa_role;
+	uint32_t flags;
+	uint32_t ipproto;		/* ESP or AH */
+	uint32_t kernel_mode;
+	uint32_t reqid;
+	uint16_t encrypt, keylen, integ, pad;
+	ike_spis_t ike_spis;		/* of IKE SA */
+	ipsec_spi_t inbound_spi;
+	ipsec_spi_t outbound_spi;
+	ip_address local;
+	ip_address remote;
+	struct checkpoint_timers timers;
+	uint32_t name_len;		/* including NUL */
+	uint32_t selectors_len;		/* including NUL */
+	uint32_t inbound_len;		/* unwrapped */
+	uint32_t outbound_len;		/* unwrapped */
+	uint32_t wrapped_len;
+	uint32_t pad2;
+	/* followed by: name, selectors, wrapped inbound+outbound keymat */
+};
+
+struct checkpoint_msgid {
+	struct checkpoint_record record;
+	ike_spis_t spis;
+	int64_t msgid[4];		/* as for checkpoint_ike */
+};
+
+struct checkpoint_delete_ike {
+	struct checkpoint_record record;
+	ike_spis_t spis;
+};
+
+struct checkpoint_delete_child {
+	struct checkpoint_record record;
+	uint32_t ipproto;
+	ipsec_spi_t inbound_spi;
+};
+
+size_t checkpoint_align(size_t size);
+void checkpoint_init_header(struct checkpoint_header *header, PK11SymKey *kek,
+			    struct logger *logger);
+const char *checkpoint_check_header(const struct checkpoint_header *header,
+				    PK11SymKey *kek, struct logger *logger);
+
+/*
+ * Encode a single record into BUF (which must be at least
+ * checkpoint_{ike,child}_bound() bytes); returns the record's size,
+ * or 0 when the SA can't be saved.
+ */
+
+size_t checkpoint_ike_bound(struct ike_sa *ike);
+size_t checkpoint_save_ike(uint8_t *buf, size_t len, struct ike_sa *ike,
+			   PK11SymKey *kek, struct logger *logger);
+size_t checkpoint_child_bound(struct child_sa *child);
+size_t checkpoint_save_child(uint8_t *buf, size_t len, unsigned ike_index,
+			     struct child_sa *child,
+			     PK11SymKey *kek, struct logger *logger);
+
+/*
+ * Adopt IMAGE, a checkpoint assembled by a standby and wrapped using
+ * KEK, installing its SAs into the kernel.  Takes ownership of IMAGE.
+ */
+
+bool adopt_checkpoint(uint8_t *image, size_t size, PK11SymKey *kek,
+		      struct logger *logger);
+
+#endif
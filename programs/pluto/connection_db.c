@@ -22,6 +22,7 @@
 #include "virtual_ip.h"		/* for virtual_ip_addref() */
 #include "orient.h"
 #include "iface.h"
+#include "x509.h"		/* for hash_dn() */
 
 /*
  * A table hashed by serialno.
@@ -58,7 +59,16 @@ struct connection *connection_by_serialno(co_serial_t serialno)
 static hash_t hash_connection_that_id(const struct id *id)
 {
 	hash_t hash = zero_hash;
-	if (id->kind != ID_NONE) {
+	if (id->kind == ID_DER_ASN1_DN) {
+		/*
+		 * Use the DN's canonical hash so that DNs that
+		 * same_id() considers equal, but are encoded
+		 * differently, land in the same bucket.
+		 */
+		uintmax_t dn_hash = hash_dn(id->name);
+		hash = hash_thing(id->kind, hash);
+		hash = hash_thing(dn_hash, hash);
+	} else if (id->kind != ID_NONE) {
 		shunk_t body;
 		enum ike_id_type type = id_to_payload(id, &unset_address/*ignored*/, &body);
 		hash = hash_thing(type, hash);
@@ -130,7 +140,83 @@ static hash_t hash_connection_host_pair(const struct connection *c)
 
 HASH_TABLE(connection, host_pair, , STATE_TABLE_SIZE);
 
-REHASH_DB_ENTRY(connection, host_pair, );
+/*
+ * Unoriented hash tables.
+ *
+ * An unoriented connection is waiting for one of its end's addresses
+ * to appear on an interface.  Hash each end by that address so that,
+ * when an interface comes or goes, only the connections waiting for
+ * its address need to be re-oriented.
+ *
+ * Oriented connections, and ends without an address, aren't waiting
+ * for anything; spread them by serialno so that they don't all pile
+ * up in one bucket.
+ */
+
+static hash_t hash_unoriented_end(const struct connection *c, enum end end)
+{
+	const ip_address *addr = &c->end[end].host.addr;
+	if (oriented(c) || !address_is_specified(*addr)) {
+		return hash_thing(c->serialno, zero_hash);
+	}
+	return hash_hunk(address_as_shunk(addr), zero_hash);
+}
+
+static hash_t hash_connection_unoriented_left(const struct connection *c)
+{
+	return hash_unoriented_end(c, LEFT_END);
+}
+
+HASH_TABLE(connection, unoriented_left, , STATE_TABLE_SIZE);
+
+static hash_t hash_connection_unoriented_right(const struct connection *c)
+{
+	return hash_unoriented_end(c, RIGHT_END);
+}
+
+HASH_TABLE(connection, unoriented_right, , STATE_TABLE_SIZE);
+
+/*
+ * Both the host-pair and unoriented hashes depend on the
+ * connection's orientation so always rehash them together.
+ */
+
+void connection_db_rehash_host_pair(struct connection *c)
+{
+	FOR_EACH_THING(table,
+		       &connection_host_pair_hash_table,
+		       &connection_unoriented_left_hash_table,
+		       &connection_unoriented_right_hash_table) {
+		del_hash_table_entry(table, c);
+		add_hash_table_entry(table, c);
+	}
+}
+
+/*
+ * Name and base-name hash tables.
+ *
+ * Both are fixed when the connection is allocated so, unlike the
+ * above, there's no need to rehash.
+ */
+
+static hash_t hash_name(const char *name)
+{
+	return hash_bytes(name, strlen(name), zero_hash);
+}
+
+static hash_t hash_connection_name(char *const *name)
+{
+	return hash_name(*name);
+}
+
+HASH_TABLE(connection, name, .name, STATE_TABLE_SIZE);
+
+static hash_t hash_connection_base_name(char *const *base_name)
+{
+	return hash_name(*base_name);
+}
+
+HASH_TABLE(connection, base_name, .base_name, STATE_TABLE_SIZE);
 
 /*
  * Maintain the contents of the hash tables.
@@ -140,7 +226,93 @@ HASH_DB(connection,
 	&connection_clonedfrom_hash_table,
 	&connection_serialno_hash_table,
 	&connection_that_id_hash_table,
-	&connection_host_pair_hash_table);
+	&connection_host_pair_hash_table,
+	&connection_unoriented_left_hash_table,
+	&connection_unoriented_right_hash_table,
+	&connection_name_hash_table,
+	&connection_base_name_hash_table);
+
+/*
+ * Alias multimap.
+ *
+ * A root connection's connalias= is a list of names and any one of
+ * them can be used to find the connection.  Since a list entry can
+ * only be on one list, each alias gets its own entry (whose data
+ * points back at the connection) and that is inserted into the
+ * alias's bucket.
+ *
+ * Because the entries point at the connection, next_connection() can
+ * walk an alias bucket just like any other hash bucket.
+ */
+
+LIST_INFO(connection, connection_db_entries.aliases,
+	  connection_alias_info, jam_connection);
+
+static struct list_head connection_alias_buckets[STATE_TABLE_SIZE];
+
+static struct list_head *connection_alias_bucket(shunk_t alias)
+{
+	hash_t hash = hash_hunk(alias, zero_hash);
+	return &connection_alias_buckets[hash.hash % elemsof(connection_alias_buckets)];
+}
+
+void connection_alias_db_init(struct logger *logger)
+{
+	ldbg(logger, "initialize %s multimap", connection_alias_info.name);
+	FOR_EACH_ELEMENT(bucket, connection_alias_buckets) {
+		*bucket = (struct list_head) INIT_LIST_HEAD(bucket, &connection_alias_info);
+	}
+}
+
+void connection_alias_db_add(struct connection *c)
+{
+	/* only root connections are found by alias */
+	if (c->root_config == NULL || c->config->connalias == NULL) {
+		return;
+	}
+
+	PASSERT(c->logger, c->connection_db_entries.aliases.entry == NULL);
+	struct shunks *aliases = ttoshunks(shunk1(c->config->connalias),
+					   " \t", EAT_EMPTY_SHUNKS); /* must free */
+	c->connection_db_entries.aliases.entry =
+		alloc_things(struct list_entry, aliases->len, "connection aliases");
+	c->connection_db_entries.aliases.len = aliases->len;
+
+	for (unsigned i = 0; i < aliases->len; i++) {
+		struct list_entry *entry = &c->connection_db_entries.aliases.entry[i];
+		init_list_entry(&connection_alias_info, c, entry);
+		/*
+		 * When two aliases land in the same bucket (say
+		 * "a a"), leave the later entry detached so that the
+		 * connection is only found once.
+		 */
+		struct list_head *bucket = connection_alias_bucket(aliases->item[i]);
+		bool dup = false;
+		for (unsigned j = 0; j < i; j++) {
+			if (connection_alias_bucket(aliases->item[j]) == bucket) {
+				dup = true;
+				break;
+			}
+		}
+		if (!dup) {
+			insert_list_entry(bucket, entry);
+		}
+	}
+
+	pfree(aliases);
+}
+
+void connection_alias_db_del(struct connection *c)
+{
+	for (unsigned i = 0; i < c->connection_db_entries.aliases.len; i++) {
+		struct list_entry *entry = &c->connection_db_entries.aliases.entry[i];
+		if (!detached_list_entry(entry)) {
+			remove_list_entry(entry);
+		}
+	}
+	pfreeany(c->connection_db_entries.aliases.entry);
+	c->connection_db_entries.aliases.len = 0;
+}
 
 /*
  * See also {new2old,old2new}_state()
@@ -164,6 +336,39 @@ static struct list_head *connection_filter_head(struct connection_filter *filter
 		return hash_table_bucket(&connection_clonedfrom_hash_table, hash);
 	}
 
+	if (filter->unoriented.addr != NULL) {
+		address_buf ab;
+		vdbg("FOR_EACH_CONNECTION[unoriented.%s=%s].... in "PRI_WHERE,
+		     (filter->unoriented.end == LEFT_END ? "left" : "right"),
+		     str_address(filter->unoriented.addr, &ab),
+		     pri_where(filter->search.where));
+		hash_t hash = hash_hunk(address_as_shunk(filter->unoriented.addr), zero_hash);
+		return hash_table_bucket((filter->unoriented.end == LEFT_END ?
+					  &connection_unoriented_left_hash_table :
+					  &connection_unoriented_right_hash_table),
+					 hash);
+	}
+
+	if (filter->name != NULL) {
+		vdbg("FOR_EACH_CONNECTION[name=%s].... in "PRI_WHERE,
+		     filter->name, pri_where(filter->search.where));
+		hash_t hash = hash_name(filter->name);
+		return hash_table_bucket(&connection_name_hash_table, hash);
+	}
+
+	if (filter->base_name != NULL) {
+		vdbg("FOR_EACH_CONNECTION[base_name=%s].... in "PRI_WHERE,
+		     filter->base_name, pri_where(filter->search.where));
+		hash_t hash = hash_name(filter->base_name);
+		return hash_table_bucket(&connection_base_name_hash_table, hash);
+	}
+
+	if (filter->alias_root != NULL) {
+		vdbg("FOR_EACH_CONNECTION[alias_root=%s].... in "PRI_WHERE,
+		     filter->alias_root, pri_where(filter->search.where));
+		return connection_alias_bucket(shunk1(filter->alias_root));
+	}
+
 	if (filter->host_pair.local != NULL) {
 		passert(filter->host_pair.remote != NULL);
 		address_buf lb, rb;
@@ -260,6 +465,15 @@ static bool matches_connection_filter(struct connection *c,
 			PEXPECT_WHERE(c->logger, filter->search.where, is_template(c));
 		}
 	}
+	if (filter->unoriented.addr != NULL) {
+		if (oriented(c)) {
+			return false;
+		}
+		if (!address_eq_address(c->end[filter->unoriented.end].host.addr,
+					*filter->unoriented.addr)) {
+			return false;
+		}
+	}
 
 	return true; /* sure */
 }
@@ -29,4 +29,9 @@ void connection_db_init_connection(struct connection *c);
 void connection_db_add(struct connection *c);
 void connection_db_del(struct connection *c);
 
+/* connalias= multimap; only root connections are entered */
+void connection_alias_db_init(struct logger *logger);
+void connection_alias_db_add(struct connection *c);
+void connection_alias_db_del(struct connection *c);
+
 #endif
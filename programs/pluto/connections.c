@@ -109,9 +109,13 @@
 #include "defaultroute.h"
 #include "ipsecconf/config_setup.h"
 #include "extract.h"
+#include "checkpoint.h"		/* for restore_checkpoint() */
+#include "rcv_whack.h"			/* for whack_batch_add_connection() */
 
 static void discard_connection(struct connection **cp, bool connection_valid, where_t where);
 
+static struct slab connection_slab = SLAB(struct connection, "connection");
+
 void vdbg_connection(const struct connection *c,
 		     struct verbose verbose, where_t where,
 		     const char *message, ...)
@@ -475,6 +479,7 @@ static void discard_connection(struct connection **cp, bool connection_valid, wh
 	if (connection_valid) {
 		connection_db_del(c);
 	}
+	connection_alias_db_del(c);
 	discard_connection_spds(c);
 
 	/*
@@ -488,6 +493,8 @@ static void discard_connection(struct connection **cp, bool connection_valid, wh
 		pfree_list(&end->child.selectors.accepted);
 	}
 
+	bool shared_base_name = (c->clonedfrom != NULL &&
+				 c->base_name == c->clonedfrom->base_name);
 	connection_delref(&c->clonedfrom, logger);
 
 	iface_endpoint_delref(&c->revival.local);
@@ -526,6 +533,7 @@ static void discard_connection(struct connection **cp, bool connection_valid, wh
 			/* ike/host */
 			free_chunk_content(&end->host.ca);
 			pfreeany(end->host.ckaid);
+			secret_pubkey_stuff_delref(&end->host.private_key, HERE);
 			pfreeany(end->host.xauth.username);
 			pfreeany(end->host.host.name);
 			pfreeany(end->host.nexthop.name);
@@ -545,10 +553,12 @@ static void discard_connection(struct connection **cp, bool connection_valid, wh
 	}
 
 	/* connection's final gasp; need's c->name */
-	pfreeany(c->base_name);
+	if (!shared_base_name) {
+		pfreeany(c->base_name);
+	}
 	pfreeany(c->name);
 	free_logger(&logger, where);
-	pfree(c);
+	pfree_slab(&connection_slab, c);
 }
 
 ip_port end_host_port(const struct host_end *this, const struct host_end *that)
@@ -842,6 +852,8 @@ diag_t add_end_cert_and_preload_private_key(CERTCertificate *cert,
 	}
 
 	host_end_config->cert.nss_cert = cert;
+	/* any cached private key is for the old certificate (--rereadcerts) */
+	secret_pubkey_stuff_delref(&host_end_config->private_key, HERE);
 
 	/*
 	 * If no CA is defined, use issuer as default; but only when
@@ -1172,11 +1184,17 @@ struct connection *alloc_connection(const char *name,
 				    struct logger *logger,
 				    where_t where)
 {
-	struct connection *c = refcnt_alloc(struct connection, logger, where);
+	struct connection *c = refcnt_slab_alloc(struct connection, &connection_slab, logger, where);
 	const struct config *config = (t != NULL ? t->config : root_config);
 
-	/* before alloc_logger(); can't use C */
-	c->base_name = clone_str(name, __func__);
+	/*
+	 * Before alloc_logger(); can't use C.
+	 *
+	 * An instance shares its template's base name (C holds a
+	 * reference to T).
+	 */
+	c->base_name = (t != NULL && streq(name, t->base_name) ? t->base_name :
+			clone_str(name, __func__));
 
 	/* before alloc_logger(); can't use C */
 	c->name = alloc_connection_prefix(name, t);
@@ -1258,6 +1276,43 @@ struct connection *alloc_connection(const char *name,
 	return c;
 }
 
+size_t connection_footprint(const struct connection *c)
+{
+	size_t size = sizeof(*c) + sizeof(*c->logger);
+	size += strlen(c->name) + 1;
+	if (c->clonedfrom == NULL || c->base_name != c->clonedfrom->base_name) {
+		size += strlen(c->base_name) + 1;
+	}
+	size += c->child.spds.len * sizeof(struct spd);
+	size += c->child.sec_label.len;
+	size += c->connection_db_entries.aliases.len * sizeof(struct list_entry);
+	FOR_EACH_ELEMENT(end, c->end) {
+		if (end->host.id.scratch != NULL) {
+			size += end->host.id.name.len;
+		}
+		size += end->child.selectors.accepted.len * sizeof(ip_selector);
+	}
+	return size;
+}
+
+size_t connection_shared_footprint(const struct connection *c)
+{
+	if (c->clonedfrom == NULL) {
+		return 0;
+	}
+	/* the template's config is only referenced */
+	size_t size = sizeof(*c->config);
+	if (c->base_name == c->clonedfrom->base_name) {
+		size += strlen(c->base_name) + 1;
+	}
+	FOR_EACH_ELEMENT(end, c->end) {
+		if (end->host.id.scratch == NULL) {
+			size += end->host.id.name.len;
+		}
+	}
+	return size;
+}
+
 const struct ike_info ikev1_info = {
 	.version = IKEv1,
 	.version_name = "IKEv1",
@@ -1342,12 +1397,6 @@ diag_t add_connection(const struct whack_message *wm, struct logger *logger)
 		llog(RC_LOG, c->logger, "connection is using multiple %s", tss);
 	}
 
-	LLOG_JAMBUF(RC_LOG, c->logger, buf) {
-		jam_string(buf, "added");
-		jam_string(buf, " ");
-		jam_orientation(buf, c, /*oriented_details*/false);
-	}
-
 	policy_buf pb;
 	ldbg(c->logger,
 	     "ike_life: %jd; ipsec_life: %jds; rekey_margin: %jds; rekey_fuzz: %lu%%; replay_window: %ju; policy: %s ipsec_max_bytes: %ju ipsec_max_packets %ju",
@@ -1359,10 +1408,36 @@ diag_t add_connection(const struct whack_message *wm, struct logger *logger)
 	     str_connection_policies(c, &pb),
 	     c->config->sa_ipsec_max_bytes,
 	     c->config->sa_ipsec_max_packets);
+
+	if (wm->whack_batch) {
+		/* connection_added() once the batch is oriented */
+		whack_batch_add_connection(c);
+	} else {
+		connection_added(c);
+	}
+
 	release_whack(c->logger, HERE);
 	return NULL;
 }
 
+/*
+ * Log the just added connection and, after a warm restart, re-adopt
+ * its SAs.  Both need the connection oriented so, for a whack batch,
+ * this waits until the batch has been oriented.
+ */
+
+void connection_added(struct connection *c)
+{
+	LLOG_JAMBUF(RC_LOG, c->logger, buf) {
+		jam_string(buf, "added");
+		jam_string(buf, " ");
+		jam_orientation(buf, c, /*oriented_details*/false);
+	}
+
+	/* re-adopt this connection's SAs after a warm restart */
+	restore_checkpoint(c, c->logger);
+}
+
 static connection_priority_t max_prefix_len(struct connection_end *end)
 {
 	int len = 0;
@@ -68,6 +68,7 @@
 #include "whack.h"
 
 struct kernel_acquire;
+struct secret_pubkey_stuff;
 
 /*
  * Fast access to a connection.
@@ -110,6 +111,14 @@ struct host_end_config {
 	chunk_t ca;			/* CA distinguished name of the end certificate's issuer */
 	ckaid_t *ckaid;
 
+	/*
+	 * Counted reference to the private key matching .cert or
+	 * .ckaid, filled in by get_local_private_key(); released
+	 * whenever the secrets are reloaded or freed, or .cert is
+	 * replaced.
+	 */
+	struct secret_pubkey_stuff *private_key;
+
 	/*
 	 * How to handle CP packets (or MODECFG packets in IKEv1).
 	 */
@@ -910,6 +919,15 @@ struct connection {
 		struct list_entry that_id;
 		struct list_entry clonedfrom;
 		struct list_entry host_pair;
+		struct list_entry unoriented_left;
+		struct list_entry unoriented_right;
+		struct list_entry name;
+		struct list_entry base_name;
+		/* one per connalias=; see connection_alias_db_add() */
+		struct {
+			unsigned len;
+			struct list_entry *entry;
+		} aliases;
 	} connection_db_entries;
 
 	struct pending *pending;
@@ -942,6 +960,7 @@ extern bool same_peer_ids(const struct connection *c,
 			  const struct connection *d);
 
 diag_t add_connection(const struct whack_message *wm, struct logger *logger);
+void connection_added(struct connection *c);
 
 bool resolve_connection_hosts_from_configs(struct connection *c,
 					   struct verbose verbose);
@@ -1054,6 +1073,15 @@ struct connection_filter {
 		const ip_address *const local;
 		const ip_address *const remote;
 	} host_pair;
+	/*
+	 * unoriented: matches !oriented() connections that are
+	 * waiting for ADDR to appear on an interface so that END can
+	 * become local.
+	 */
+	const struct {
+		const enum end end;
+		const ip_address *const addr;
+	} unoriented;
 
 	/*
 	 * Current result (can be safely deleted).
@@ -1168,6 +1196,22 @@ struct connection *alloc_connection(const char *name,
 				    struct logger *logger,
 				    where_t where);
 
+/*
+ * Approximate number of bytes owned by C (shared template data and
+ * slab rounding isn't included); see whack_showstats.
+ *
+ * An instance is still a full struct connection: only the template's
+ * struct config, base name and unchanged IDs are shared.  The rest
+ * (ends, SPDs, routing, events, logger) is per-instance state that is
+ * updated in place.
+ *
+ * connection_shared_footprint() is the number of bytes C references
+ * but doesn't own.
+ */
+
+size_t connection_footprint(const struct connection *c);
+size_t connection_shared_footprint(const struct connection *c);
+
 /*
  * Three types of labels.
  */
@@ -35,6 +35,7 @@
 
 struct kem_desc;
 struct state;
+struct trans_attrs;
 struct msg_digest;
 struct logger;
 struct ike_sa;
@@ -83,6 +84,7 @@ void calc_v2_ike_keymat(struct state *larval_ike,
 			PK11SymKey *skeyseed,
 			const ike_spis_t *ike_spis);
 size_t nr_ikev2_ike_keymat_bytes(struct state *st);
+size_t ikev2_ike_keymat_bytes(const struct trans_attrs *ta);
 void extract_ikev2_ike_keys(struct state *larval_sa,
 			    PK11SymKey *keymat);
 
@@ -57,9 +57,16 @@ void calc_v2_ike_keymat(struct state *st,
 
 size_t nr_ikev2_ike_keymat_bytes(struct state *st)
 {
-	const struct encrypt_desc *cipher = st->st_oakley.ta_encrypt;
-	const struct prf_desc *prf = st->st_oakley.ta_prf;
-	const struct integ_desc *integ = st->st_oakley.ta_integ;
+	return ikev2_ike_keymat_bytes(&st->st_oakley);
+}
+
+/* also called by helpers */
+
+size_t ikev2_ike_keymat_bytes(const struct trans_attrs *ta)
+{
+	const struct encrypt_desc *cipher = ta->ta_encrypt;
+	const struct prf_desc *prf = ta->ta_prf;
+	const struct integ_desc *integ = ta->ta_integ;
 
 	/* need to know how many bits to generate */
 	/* SK_d needs PRF hasher key bytes */
@@ -70,7 +77,7 @@ size_t nr_ikev2_ike_keymat_bytes(struct state *st)
 
  	int skd_size = prf->prf_key_size;
  	int integ_size = integ != NULL ? integ->integ_keymat_size : 0;
-	size_t key_size = st->st_oakley.enckeylen / BITS_IN_BYTE;
+	size_t key_size = ta->enckeylen / BITS_IN_BYTE;
 	size_t salt_size = cipher->salt_size;
  	int skp_size = prf->prf_key_size;
 
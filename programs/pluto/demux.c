@@ -58,6 +58,7 @@
 #include "crypto.h"
 #include "ike_alg.h"
 #include "log.h"
+#include "reply_cache.h"
 #include "demux.h"      /* needs packet.h */
 #include "ikev1.h"
 #include "ikev2.h"
@@ -93,6 +94,14 @@ static callback_cb handle_md_event;		/* type assertion */
 
 void process_md(struct msg_digest *md)
 {
+	/*
+	 * Re-transmit of a request that was recently answered?  Send
+	 * the recorded response before doing any parsing.
+	 */
+	if (resend_cached_reply(md)) {
+		return;
+	}
+
 	struct pbs_in packet_pbs = pbs_in_from_shunk(HUNK_AS_SHUNK(&md->packet), "packet");
 	diag_t d = pbs_in_struct(&packet_pbs, &isakmp_hdr_desc,
 				 &md->hdr, sizeof(md->hdr),
@@ -119,6 +119,7 @@ enum v2_pd {
 	PD_v2N_REDIRECTED_FROM,
 	PD_v2N_REDIRECT_SUPPORTED,
 	PD_v2N_REKEY_SA,
+	PD_v2N_SET_WINDOW_SIZE,
 	PD_v2N_SIGNATURE_HASH_ALGORITHMS,
 	PD_v2N_SINGLE_PAIR_REQUIRED,
 	PD_v2N_TS_UNACCEPTABLE,
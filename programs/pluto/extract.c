@@ -4132,8 +4132,26 @@ diag_t extract_connection(const struct whack_message *wm,
 
 	c->redirect.attempt = 0;
 
-	/* non configurable */
-	config->ike_window = IKE_V2_OVERLAPPING_WINDOW_SIZE;
+	/*
+	 * RFC 7296 2.3: the number of overlapping requests this end
+	 * will accept (advertised using SET_WINDOW_SIZE) and, when
+	 * the peer agrees, send.
+	 */
+	{
+		diag_t d;
+		config->ike_window =
+			extract_uintmax("", "", "ike-window",
+					wm->wm_ike_window,
+					(struct range) {
+						.value_when_unset = IKE_V2_OVERLAPPING_WINDOW_SIZE,
+						.limit.min = 1,
+						.limit.max = IKE_V2_MAX_WINDOW_SIZE,
+					},
+					wm, &d, verbose);
+		if (d != NULL) {
+			return d;
+		}
+	}
 
 	/*
 	 * Extract the child configuration and save it.
@@ -4278,6 +4296,7 @@ diag_t extract_connection(const struct whack_message *wm,
 	 * the database first.
 	 */
 	connection_db_add(c);
+	connection_alias_db_add(c);
 	vdbg_connection(c, verbose, HERE, "extracted");
 
 	/*
@@ -4307,9 +4326,15 @@ diag_t extract_connection(const struct whack_message *wm,
 	 * tables are updated.
 	 *
 	 * This function holds the just allocated reference.
+	 *
+	 * When more connections follow on the same whack socket
+	 * (addconn --autoall), orientation is left to a single pass
+	 * once the batch ends; see whack_batch_add_connection().
 	 */
 	vassert(!oriented(c));
-	orient(c, verbose.logger);
+	if (!wm->whack_batch) {
+		orient(c, verbose.logger);
+	}
 
 	if (verbose.debug) {
 		VDBG_log("oriented; maybe");
@@ -321,6 +321,30 @@ static void free_dead_ifaces(struct verbose verbose)
 		}
 	}
 
+	/*
+	 * Save the addresses of interfaces that are coming and going;
+	 * once the dead have been released they are used to find the
+	 * connections that need re-orienting.
+	 */
+	unsigned nr_changed = 0;
+	ip_address *changed = NULL;
+	if (some_dead || some_new) {
+		struct iface_device *ifd;
+		FOR_EACH_LIST_ENTRY_OLD2NEW(ifd, &interface_dev) {
+			if (ifd->ifd_change != IFD_KEEP) {
+				nr_changed++;
+			}
+		}
+		changed = alloc_things(ip_address, nr_changed, "changed interface addresses");
+		unsigned i = 0;
+		FOR_EACH_LIST_ENTRY_OLD2NEW(ifd, &interface_dev) {
+			if (ifd->ifd_change != IFD_KEEP) {
+				changed[i++] = ifd->local_address;
+			}
+		}
+		vassert(i == nr_changed);
+	}
+
 	/*
 	 * Now go through and remove any reference to the dead
 	 * interfaces either in the interface list or in oriented
@@ -357,16 +381,20 @@ static void free_dead_ifaces(struct verbose verbose)
 	}
 
 	/*
-	 * Finally go through all connections and see if any can
-	 * re-orient.
+	 * Finally go through the connections waiting on the changed
+	 * addresses and see if any can re-orient.
 	 *
 	 * For instance, a connection with its interface deleted may
 	 * be able to orient to an existing or new interface.
 	 */
 	if (some_dead || some_new) {
-		vdbg("updating interfaces - checking orientation");
-		check_orientations(verbose.logger);
+		vdbg("updating interfaces - checking orientation of %u changed addresses",
+		     nr_changed);
+		for (unsigned i = 0; i < nr_changed; i++) {
+			check_orientations(&changed[i], /*log_oriented*/true, verbose.logger);
+		}
 	}
+	pfreeany(changed);
 }
 
 struct iface_endpoint *alloc_iface_endpoint(int fd,
@@ -47,6 +47,8 @@ struct iface_packet {
 	struct logger *logger; /*global*/
 };
 
+#define MAX_WRITE_PACKET_PIECES 3
+
 struct iface_io {
 	bool send_keepalive;
 	struct {
@@ -56,8 +58,14 @@ struct iface_io {
 	const struct ip_protocol *protocol;
 	struct msg_digest *(*read_packet)(struct iface_endpoint **ifp,
 					  struct logger *logger);
+	/*
+	 * Write the NR_PACKET pieces of PACKET[] as a single message
+	 * (scatter/gather, for instance a non-ESP marker followed by
+	 * the recorded IKE message).  NR_PACKET is at most
+	 * MAX_WRITE_PACKET_PIECES.
+	 */
 	ssize_t (*write_packet)(const struct iface_endpoint *ifp,
-				shunk_t packet,
+				const shunk_t *packet, unsigned nr_packet,
 				const ip_endpoint *remote_endpoint,
 				struct logger *logger);
 	void (*cleanup)(struct iface_endpoint *ifp, const struct logger *logger);
@@ -28,6 +28,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>		/* for read() */
+#include <sys/uio.h>		/* for writev() */
 
 #include <netinet/tcp.h>	/* for TCP_ULP (hopefully) */
 #ifndef TCP_ULP
@@ -359,7 +360,7 @@ static struct msg_digest *iketcp_read_packet(struct iface_endpoint **ifp,
 }
 
 static ssize_t iketcp_write_packet(const struct iface_endpoint *ifp,
-				   shunk_t packet,
+				   const shunk_t *packet, unsigned nr_packet,
 				   const ip_endpoint *remote_endpoint UNUSED,
 				   struct logger *logger)
 {
@@ -380,8 +381,18 @@ static ssize_t iketcp_write_packet(const struct iface_endpoint *ifp,
 				    ifp->fd, flags);
 		}
 	}
-	ssize_t wlen = write(ifp->fd, packet.ptr, packet.len);
-	ldbg_iketcp(logger, ifp, "wrote %zd of %zu bytes", wlen, packet.len);
+	struct iovec iov[MAX_WRITE_PACKET_PIECES];
+	passert(nr_packet <= elemsof(iov));
+	size_t len = 0;
+	for (unsigned i = 0; i < nr_packet; i++) {
+		iov[i] = (struct iovec) {
+			.iov_base = (void *)packet[i].ptr, /* discard const */
+			.iov_len = packet[i].len,
+		};
+		len += packet[i].len;
+	}
+	ssize_t wlen = writev(ifp->fd, iov, nr_packet);
+	ldbg_iketcp(logger, ifp, "wrote %zd of %zu bytes", wlen, len);
 	if (impair.tcp_use_blocking_write && flags >= 0) {
 		llog_iketcp(RC_LOG, logger, ifp, /*no-error*/0,
 			    "IMPAIR: restoring flags 0%o after write", flags);
@@ -25,6 +25,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>		/* MSG_ERRQUEUE if defined */
+#include <sys/uio.h>		/* for struct iovec */
 #include <netinet/udp.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -270,7 +271,7 @@ static uint32_t set_mark_out(const struct logger *logger, uint32_t mark, int fd)
 #endif
 
 static ssize_t udp_write_packet(const struct iface_endpoint *ifp,
-				shunk_t packet,
+				const shunk_t *packet, unsigned nr_packet,
 				const ip_endpoint *remote_endpoint,
 				struct logger *logger /*possibly*/UNUSED)
 {
@@ -288,7 +289,21 @@ static ssize_t udp_write_packet(const struct iface_endpoint *ifp,
 		old_mark = set_mark_out(logger, remote_endpoint->mark_out, ifp->fd);
 #endif
 
-	ssize_t ret = sendto(ifp->fd, packet.ptr, packet.len, 0, &remote_sa.sa.sa, remote_sa.len);
+	struct iovec iov[MAX_WRITE_PACKET_PIECES];
+	passert(nr_packet <= elemsof(iov));
+	for (unsigned i = 0; i < nr_packet; i++) {
+		iov[i] = (struct iovec) {
+			.iov_base = (void *)packet[i].ptr, /* discard const */
+			.iov_len = packet[i].len,
+		};
+	}
+	struct msghdr msg = {
+		.msg_name = &remote_sa.sa.sa,
+		.msg_namelen = remote_sa.len,
+		.msg_iov = iov,
+		.msg_iovlen = nr_packet,
+	};
+	ssize_t ret = sendmsg(ifp->fd, &msg, 0);
 
 #ifdef USE_XFRM_INTERFACE
 	if (remote_endpoint->mark_out > 0)
@@ -174,8 +174,8 @@
 #include "ikev1_notification.h"
 
 #include "pluto_stats.h"
+#include "reply_cache.h"
 
-static bool v1_state_busy(const struct state *st);
 static bool verbose_v1_state_busy(const struct state *st);
 
 struct ike_sa *find_v1_isakmp_sa(const ike_spis_t *ike_spis)
@@ -426,7 +426,7 @@ void ikev1_init_pbs_out_from_md_hdr(struct msg_digest *md, bool enc,
  * .FROM_STATE (which is derived from some convoluted magic) when
  * determining if the duplicate should or should not get a response.
  */
-static bool ikev1_duplicate(struct state *st, struct msg_digest *md)
+bool ikev1_duplicate(struct state *st, struct msg_digest *md)
 {
 	passert(st != NULL);
 	if (hunk_eq(st->st_v1_rpacket, md->packet)) {
@@ -456,6 +456,7 @@ static bool ikev1_duplicate(struct state *st, struct msg_digest *md)
 				     "retransmitting in response to duplicate packet; already %s",
 				     st->st_state->name);
 				resend_recorded_v1_ike_msg(st, "retransmit in response to duplicate");
+				cache_duplicate_request(md, st, md->hdr.isa_msgid);
 			} else {
 				llog(RC_LOG, st->logger,
 				     "discarding duplicate packet -- exhausted retransmission; already %s",
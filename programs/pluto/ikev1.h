@@ -85,6 +85,9 @@ void ISAKMP_SA_established(struct ike_sa *ike);
 
 struct ike_sa *find_v1_isakmp_sa(const ike_spis_t *ipe_spis);
 
+bool v1_state_busy(const struct state *st);
+bool ikev1_duplicate(struct state *st, struct msg_digest *md);
+
 extern struct pbs_out reply_stream;
 
 #endif
@@ -37,6 +37,7 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <limits.h>
+#include <pthread.h>		/* for crypt() mutex */
 
 #if defined(linux)
 /* is supposed to be in unistd.h, but it isn't on linux */
@@ -68,6 +69,8 @@
 #endif
 #include "crypto.h"
 #include "ike_alg.h"
+#include "server_pool.h"	/* for submit_task() */
+#include "xauth_passwd.h"
 #include "secrets.h"
 #include "ikev1.h"
 #include "ikev1_xauth.h"
@@ -1135,158 +1138,6 @@ static bool add_xauth_addresspool(struct connection *c,
 	return true;
 }
 
-/** Do authentication via /etc/ipsec.d/passwd file using MD5 passwords
- *
- * Structure is one entry per line.
- * Each line has fields separated by colons.
- * Empty lines and lines starting with # are ignored.
- * Whitespace is NOT ignored.
- *
- * Syntax of an entry:
- *	username:passwdhash[:connectioname[:addresspool]]
- *
- * If connectionname is present and not empty,
- * the entry only applies to connections with that name.
- * Otherwise the entry applies to all connections.
- *
- * Example creation of file with two entries (without connectionname):
- *	htpasswd -c -b /etc/ipsec.d/passwd road roadpass
- *	htpasswd -b /etc/ipsec.d/passwd home homepass
- *
- * NOTE: htpasswd on your system may create a crypt() incompatible hash
- * by default (i.e. a type id of $apr1$). To create a crypt() compatible
- * hash with htpasswd use the -d option.
- *
- * @return bool success
- */
-
-static bool do_file_authentication(struct ike_sa *ike, const char *name,
-				   const char *password, const char *connname)
-{
-	char line[1024]; /* we hope that this is more than enough */
-	int lineno = 0;
-	bool win = false;
-
-	char *pswdpath = alloc_printf("%s/passwd", config_setup_ipsecdir()); /* must free */
-
-	FILE *fp = fopen(pswdpath, "r");
-	if (fp == NULL) {
-		/* unable to open the password file */
-		llog(RC_LOG, ike->sa.logger,
-		     "XAUTH: unable to open password file (%s) for verification",
-		     pswdpath);
-		pfreeany(pswdpath);
-		return false;
-	}
-
-	llog(RC_LOG, ike->sa.logger, "XAUTH: password file (%s) open.", pswdpath);
-
-	/** simple stuff read in a line then go through positioning
-	 * userid, passwd and conniectionname at the beginning of each of the
-	 * memory locations of our real data and replace the ':' with '\0'
-	 */
-
-	while (fgets(line, sizeof(line), fp) != NULL) {
-		char *p;	/* current position */
-		char *userid;
-		char *passwdhash;
-		char *connectionname = NULL;
-		char *addresspool = NULL;
-		struct connection *c = ike->sa.st_connection;
-
-		lineno++;
-
-		/* strip final \n (optional: we accept a partial last line) */
-		p = strchr(line, '\n');
-		if (p != NULL)
-			*p = '\0';
-
-		/* ignore empty or comment line */
-		if (*line == '\0' || *line == '#')
-			continue;
-
-		/* get userid */
-		userid = line;
-		p = strchr(userid, ':');	/* find end */
-		if (p == NULL) {
-			/* no end: skip line */
-			llog(RC_LOG, ike->sa.logger,
-			     "XAUTH: %s:%d missing password hash field",
-			     pswdpath, lineno);
-			continue;
-		}
-
-		*p++ ='\0'; /* terminate string by overwriting : */
-
-		/* get password hash */
-		passwdhash = p;
-		p = strchr(passwdhash, ':'); /* find end */
-		if (p != NULL) {
-			/* optional connectionname */
-			*p++='\0';     /* terminate string by overwriting : */
-			connectionname = p;
-			p = strchr(connectionname, ':'); /* find end */
-			/* ??? any whitespace is included */
-		}
-
-		if (p != NULL) {
-			/* optional addresspool */
-			*p++ ='\0'; /* terminate connectionname string by overwriting : */
-			addresspool = p;
-		}
-
-		/* now connnectionname is terminated; set to NULL if empty */
-		if (connectionname != NULL && connectionname[0] == '\0')
-			connectionname = NULL;
-
-		ldbg(ike->sa.logger, "XAUTH: found user(%s/%s) pass(%s) connid(%s/%s) addresspool(%s)",
-		     userid, name, passwdhash,
-		     connectionname == NULL ? "" : connectionname,
-		     connname,
-		     addresspool == NULL ? "" : addresspool);
-
-		/* If connectionname is null, it applies to all connections */
-		if (streq(userid, name) &&
-		    (connectionname == NULL || streq(connectionname, connname)))
-		{
-			const char *cp;
-			/*
-			 * keep the passwords using whatever utilities
-			 * we have NOTE: crypt() may not be
-			 * thread-safe
-			 */
-			cp = crypt(password, passwdhash);
-			win = cp != NULL && streq(cp, passwdhash);
-
-			ldbgf(DBG_CRYPT, ike->sa.logger, "XAUTH: %s user(%s:%s) pass %s vs %s",
-			      win ? "success" : "failure",
-			      userid, connectionname, cp, passwdhash);
-
-			llog(RC_LOG, ike->sa.logger, "XAUTH: %s user(%s:%s) ",
-			     win ? "success" : "failure",
-			     userid, connectionname);
-
-			if (win) {
-				if (addresspool != NULL && addresspool[0] != '\0') {
-					/* ??? failure to add addresspool seems like a funny failure */
-					/* ??? should we then keep trying other entries? */
-					if (!add_xauth_addresspool(c, userid,
-								   addresspool,
-								   ike->sa.logger)) {
-						win = false;
-						continue;	/* try other entries */
-					}
-				}
-				break;	/* we have a winner */
-			}
-		}
-	}
-
-	fclose(fp);
-	pfreeany(pswdpath);
-	return win;
-}
-
 /*
  * Main authentication routine will then call the actual compiled-in
  * method to verify the user/password
@@ -1390,6 +1241,178 @@ static void xauth_immediate(const char *name, const struct ike_sa *ike,
 			xauth_immediate_callback, xic);
 }
 
+/** Do authentication via /etc/ipsec.d/passwd file using MD5 passwords
+ *
+ * Structure is one entry per line.
+ * Each line has fields separated by colons.
+ * Empty lines and lines starting with # are ignored.
+ * Whitespace is NOT ignored.
+ *
+ * Syntax of an entry:
+ *	username:passwdhash[:connectioname[:addresspool]]
+ *
+ * If connectionname is present and not empty,
+ * the entry only applies to connections with that name.
+ * Otherwise the entry applies to all connections.
+ *
+ * Example creation of file with two entries (without connectionname):
+ *	htpasswd -c -b /etc/ipsec.d/passwd road roadpass
+ *	htpasswd -b /etc/ipsec.d/passwd home homepass
+ *
+ * NOTE: htpasswd on your system may create a crypt() incompatible hash
+ * by default (i.e. a type id of $apr1$). To create a crypt() compatible
+ * hash with htpasswd use the -d option.
+ *
+ * The file is held in memory, indexed by username, see
+ * xauth_passwd.c.  The matching entries are copied into a task and
+ * a helper thread computes the (deliberately expensive) crypt() of
+ * each in turn, stopping at the first match.  Back on the main
+ * thread, the match wins unless its addresspool can't be installed,
+ * in which case the helper carries on from the next entry.
+ */
+
+struct task {
+	char *name;
+	char *password;
+	struct xauth_passwd_entry *entries;
+	unsigned nr_entries;
+	unsigned start;		/* first entry to try */
+	unsigned tried;		/* entries tried, up to and including any match */
+	bool matched;		/* entries[tried-1] matched */
+};
+
+static task_computer_fn xauth_file_computer; /* type check */
+static task_completed_cb xauth_file_completed; /* type check */
+static task_cleanup_cb xauth_file_cleanup; /* type check */
+
+static const struct task_handler xauth_file_handler = {
+	.name = "XAUTH password file",
+	.computer_fn = xauth_file_computer,
+	.completed_cb = xauth_file_completed,
+	.cleanup_cb = xauth_file_cleanup,
+};
+
+static void submit_xauth_file_authentication(struct ike_sa *ike,
+					     struct msg_digest *md,
+					     const char *name,
+					     const char *password,
+					     const char *connname)
+{
+	struct task task = {
+		.name = clone_str(name, "xauth file name"),
+		.password = clone_str(password, "xauth file password"),
+	};
+
+	if (!xauth_passwd_lookup(name, connname, &task.entries,
+				 &task.nr_entries, ike->sa.logger)) {
+		/* already logged; let the callback fail it */
+		PEXPECT(ike->sa.logger, task.nr_entries == 0);
+	}
+	submit_task(/*callback*/&ike->sa, /*task*/&ike->sa, md,
+		    /*detach_whack*/false,
+		    clone_thing(task, "xauth file task"),
+		    &xauth_file_handler, HERE);
+}
+
+static void xauth_file_computer(struct logger *logger UNUSED,
+				struct task *task,
+				int my_thread UNUSED)
+{
+#if defined(linux)
+	struct crypt_data *data = alloc_thing(struct crypt_data, "crypt data");
+#else
+	/* crypt() may not be thread-safe */
+	static pthread_mutex_t crypt_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+	task->matched = false;
+	for (unsigned e = task->start; e < task->nr_entries && !task->matched; e++) {
+		const char *passwdhash = task->entries[e].passwdhash;
+#if defined(linux)
+		const char *cp = crypt_r(task->password, passwdhash, data);
+		task->matched = (cp != NULL && streq(cp, passwdhash));
+#else
+		pthread_mutex_lock(&crypt_mutex);
+		const char *cp = crypt(task->password, passwdhash);
+		task->matched = (cp != NULL && streq(cp, passwdhash));
+		pthread_mutex_unlock(&crypt_mutex);
+#endif
+		task->tried = e + 1;
+	}
+
+#if defined(linux)
+	pfree(data);
+#endif
+}
+
+static stf_status xauth_file_completed(struct state *ike_sa,
+				       struct msg_digest *md,
+				       struct task *task)
+{
+	struct ike_sa *ike = pexpect_ike_sa(ike_sa);
+	if (ike == NULL) {
+		return STF_INTERNAL_ERROR;
+	}
+
+	bool win = false;
+	for (unsigned e = task->start; e < task->tried; e++) {
+		const struct xauth_passwd_entry *entry = &task->entries[e];
+		win = (task->matched && e + 1 == task->tried);
+
+		ldbgf(DBG_CRYPT, ike->sa.logger, "XAUTH: %s user(%s:%s) pass %s",
+		      win ? "success" : "failure",
+		      entry->userid, entry->connname, entry->passwdhash);
+
+		llog(RC_LOG, ike->sa.logger, "XAUTH: %s user(%s:%s) ",
+		     win ? "success" : "failure",
+		     entry->userid, entry->connname);
+
+		if (win) {
+			if (entry->addresspool != NULL) {
+				/* ??? failure to add addresspool seems like a funny failure */
+				/* ??? should we then keep trying other entries? */
+				if (!add_xauth_addresspool(ike->sa.st_connection,
+							   entry->userid,
+							   entry->addresspool,
+							   ike->sa.logger)) {
+					win = false;
+					break;	/* try other entries */
+				}
+			}
+		}
+	}
+
+	if (!win && task->matched && task->tried < task->nr_entries) {
+		/* addresspool failed; hand the rest back to the helper */
+		struct task *rest = clone_thing(*task, "xauth file task");
+		rest->start = task->tried;
+		rest->tried = rest->start;
+		/* now owned by REST */
+		task->name = NULL;
+		task->password = NULL;
+		task->entries = NULL;
+		task->nr_entries = 0;
+		submit_task(/*callback*/&ike->sa, /*task*/&ike->sa, md,
+			    /*detach_whack*/false, rest,
+			    &xauth_file_handler, HERE);
+		return STF_SUSPEND;
+	}
+
+	/* ikev1_xauth_callback() will log result */
+	return ikev1_xauth_callback(ike, md, task->name, win);
+}
+
+static void xauth_file_cleanup(struct task **task, struct logger *logger UNUSED)
+{
+	free_xauth_passwd_entries(&(*task)->entries, (*task)->nr_entries);
+	pfreeany((*task)->name);
+	if ((*task)->password != NULL) {
+		memset((*task)->password, 0, strlen((*task)->password));
+	}
+	pfreeany((*task)->password);
+	pfreeany(*task);
+}
+
 /** Launch an authentication prompt
  *
  * @param st State Structure
@@ -1438,9 +1461,8 @@ static void xauth_launch_authent(struct ike_sa *ike,
 		llog(RC_LOG, ike->sa.logger,
 		     "XAUTH: password file authentication method requested to authenticate user '%s'",
 		     arg_name);
-		bool success = do_file_authentication(ike, arg_name, arg_password,
-						      ike->sa.st_connection->base_name);
-		xauth_immediate(arg_name, ike, md, success);
+		submit_xauth_file_authentication(ike, md, arg_name, arg_password,
+						 ike->sa.st_connection->base_name);
 		break;
 
 	case XAUTHBY_ALWAYSOK:
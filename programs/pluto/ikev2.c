@@ -67,6 +67,7 @@
 #include "ikev2_message.h"	/* for ikev2_decrypt_msg() */
 #include "pluto_stats.h"
 #include "ikev2_msgid.h"
+#include "reply_cache.h"
 #include "ikev2_redirect.h"
 #include "ikev2_states.h"
 #include "ip_endpoint.h"
@@ -77,6 +78,7 @@
 #include "pending.h"		/* for release_pending_whacks() */
 #include "ikev2_host_pair.h"
 #include "ikev2_unsecured.h"
+#include "hash_table.h"		/* for hash_thing() */
 #include "ikev2_ike_sa_init.h"
 #include "ikev2_informational.h"
 #include "ikev2_create_child_sa.h"
@@ -461,6 +463,14 @@ static bool is_duplicate_request_msgid(struct ike_sa *ike,
 	pexpect(ike->sa.st_v2_msgid_windows.responder.recv ==
 		ike->sa.st_v2_msgid_windows.responder.sent);
 
+	/*
+	 * Find the response recorded for the request (with a window
+	 * of one, only the last response is kept).
+	 */
+	unsigned recv_frags = 0;
+	struct v2_outgoing_fragments *recorded_response =
+		v2_msgid_recorded_response(ike, msgid, &recv_frags);
+
 	/*
 	 * Is this request old?  Yes, drop it.
 	 *
@@ -468,8 +478,12 @@ static bool is_duplicate_request_msgid(struct ike_sa *ike,
 	 * then the message is too old and not worth a retransmit:
 	 * since a message with ID SENT was received, the initiator
 	 * must have received up to SENT-1 responses.
+	 *
+	 * Unless the window is larger than one, in which case the
+	 * initiator may still be waiting on earlier responses.
 	 */
-	if (msgid < ike->sa.st_v2_msgid_windows.responder.sent) {
+	if (msgid < ike->sa.st_v2_msgid_windows.responder.sent &&
+	    recorded_response == NULL) {
 		name_buf xb;
 		llog_sa(RC_LOG, ike,
 			"%s request has duplicate Message ID %jd but it is older than last response (%jd); message dropped",
@@ -534,7 +548,7 @@ static bool is_duplicate_request_msgid(struct ike_sa *ike,
 	 *
 	 * Lets hold our breath.
 	 */
-	if (msgid == ike->sa.st_v2_msgid_windows.responder.sent) {
+	if (msgid <= ike->sa.st_v2_msgid_windows.responder.sent) {
 		/*
 		 * XXX: should a local timer delete the last outgoing
 		 * message after a short while so that retransmits
@@ -546,12 +560,17 @@ static bool is_duplicate_request_msgid(struct ike_sa *ike,
 		 *   are allowed to forget the response after a
 		 *   timeout of several minutes.
 		 */
-		if (ike->sa.st_v2_msgid_windows.responder.outgoing_fragments == NULL) {
+		if (recorded_response == NULL) {
+			/*
+			 * Older than the window; for instance a
+			 * re-transmit that arrives after a further
+			 * exchange such as a rekey.
+			 */
 			name_buf xb;
-			llog_pexpect_v2_msgid(ike,
-					      "%s request has duplicate Message ID %jd but there is no saved message to retransmit; message dropped",
-					      str_enum_long(&ikev2_exchange_names, md->hdr.isa_xchg, &xb),
-					      msgid);
+			llog_sa(RC_LOG, ike,
+				"%s request has duplicate Message ID %jd but there is no saved message to retransmit; message dropped",
+				str_enum_short(&ikev2_exchange_names, md->hdr.isa_xchg, &xb),
+				msgid);
 			return true;
 		}
 
@@ -575,7 +594,7 @@ static bool is_duplicate_request_msgid(struct ike_sa *ike,
 
 		switch (md->hdr.isa_np) {
 		case ISAKMP_NEXT_v2SK:
-			if (ike->sa.st_v2_msgid_windows.responder.recv_frags > 0 &&
+			if (recv_frags > 0 &&
 			    md->hdr.isa_np == ISAKMP_NEXT_v2SKF) {
 				name_buf xb;
 				llog_sa(RC_LOG, ike,
@@ -591,7 +610,7 @@ static bool is_duplicate_request_msgid(struct ike_sa *ike,
 				msgid);
 			break;
 		case ISAKMP_NEXT_v2SKF:
-			if (ike->sa.st_v2_msgid_windows.responder.recv_frags == 0) {
+			if (recv_frags == 0) {
 				name_buf xb;
 				llog_sa(RC_LOG, ike,
 					"%s request fragment has duplicate Message ID %jd but original was not fragmented; message dropped",
@@ -610,13 +629,13 @@ static bool is_duplicate_request_msgid(struct ike_sa *ike,
 				pfree_diag(&d);
 				return true;
 			}
-			if (skf.isaskf_total != ike->sa.st_v2_msgid_windows.responder.recv_frags) {
+			if (skf.isaskf_total != recv_frags) {
 				name_buf xb;
 				dbg_v2_msgid(ike,
 					     "%s request fragment %u of %u has duplicate Message ID %jd but should have fragment total %u; message dropped",
 					     str_enum_short(&ikev2_exchange_names, md->hdr.isa_xchg, &xb),
 					     skf.isaskf_number, skf.isaskf_total, msgid,
-					     ike->sa.st_v2_msgid_windows.responder.recv_frags);
+					     recv_frags);
 				return true;
 			}
 			if (skf.isaskf_number != 1) {
@@ -644,7 +663,9 @@ static bool is_duplicate_request_msgid(struct ike_sa *ike,
 			return true;
 		}
 		}
-		send_recorded_v2_message(ike, ike->sa.st_v2_msgid_windows.responder.outgoing_fragments);
+		send_recorded_v2_message(ike, recorded_response);
+		/* further copies take the fast path */
+		cache_duplicate_request(md, &ike->sa, msgid);
 		return true;
 	}
 
@@ -680,6 +701,15 @@ static bool is_duplicate_request_msgid(struct ike_sa *ike,
 		return true;
 	}
 
+	/*
+	 * With a window larger than one, the request may be ahead of
+	 * the responder; once decrypted it is held.  Drop what can't
+	 * be held.
+	 */
+	if (v2_msgid_drop_early_request(ike, md)) {
+		return true;
+	}
+
 	/*
 	 * If the message is not a "duplicate", then what is it?
 	 * Following code gets to decide.
@@ -760,6 +790,17 @@ static bool is_duplicate_response(struct ike_sa *ike,
 		return true;
 	}
 
+	/*
+	 * With overlapping requests (RFC 7296 2.3) the response can
+	 * be for any of the outstanding requests; load it.
+	 */
+	if (v2_msgid_overlapping_requests(ike)) {
+		if (!v2_msgid_load_response(ike, md)) {
+			return true;
+		}
+		return PBAD(ike->sa.logger, ike->sa.st_v2_msgid_windows.initiator.exchange == NULL);
+	}
+
 	if (ike->sa.st_v2_msgid_windows.initiator.sent != msgid) {
 		/*
 		 * While there's an IKE SA matching the IKE SPIs,
@@ -1279,6 +1320,16 @@ static void process_packet_with_secured_ike_sa(struct msg_digest *md, struct ike
 		return;
 	}
 
+	/*
+	 * Now that it is known to be from the peer, a request that is
+	 * ahead of the responder can be held.
+	 */
+	if (v2_msg_role(protected_md) == MESSAGE_REQUEST &&
+	    v2_msgid_hold_request(ike, protected_md)) {
+		md_delref(&protected_md);
+		return;
+	}
+
 	process_protected_v2_message(ike, protected_md);
 	md_delref(&protected_md);
 }
@@ -1914,51 +1965,190 @@ bool v2_notification_fatal(v2_notification_t n)
 		n == v2N_UNSUPPORTED_CRITICAL_PAYLOAD);
 }
 
-bool already_has_larval_v2_child(struct ike_sa *ike, const struct connection *c)
+/*
+ * Each IKE SA indexes its larval (still being negotiated) Child SAs
+ * by connection so that already_has_larval_v2_child() doesn't need
+ * to walk all the children.
+ *
+ * As before, connections sharing a base name match; the key is a
+ * copy of the name, compared using streq(), so that it doesn't
+ * depend on instances sharing their template's string.  The table is
+ * open addressed (linear probing, power-of-two size, no tombstones)
+ * and is kept up-to-date by change_state(),
+ * connswitch_state_and_log(), update_sa_clonedfrom() and
+ * delete_state().
+ */
+
+struct v2_larval_child {
+	char *name;			/* base name; NULL when empty */
+	unsigned count;
+	so_serial_t latest;
+};
+
+struct v2_larval_children {
+	unsigned size;			/* power of two */
+	unsigned used;
+	struct v2_larval_child slot[];
+};
+
+#define V2_LARVAL_CHILDREN_MIN 8
+
+static bool is_v2_larval_child(const struct state *st)
 {
 	const lset_t pending_states = (LELEM(STATE_V2_NEW_CHILD_I1) |
 				       LELEM(STATE_V2_NEW_CHILD_I0) |
 				       LELEM(STATE_V2_NEW_CHILD_R0));
+	return (st->st_ike_version == IKEv2 &&
+		st->st_clonedfrom != SOS_NOBODY &&
+		LHAS(pending_states, st->st_state->kind));
+}
 
-	struct state_filter sf = {
-		.search = {
-			.order = OLD2NEW,
-			.verbose.logger = &global_logger,
-			.where = HERE,
-		},
-		.ike_version = IKEv2,
-		.ike_spis = &ike->sa.st_ike_spis,
-		/* only children */
-		.clonedfrom = ike->sa.st_serialno,
-	};
+static unsigned larval_home(const struct v2_larval_children *children,
+			    const char *name)
+{
+	return hash_hunk(shunk1(name), zero_hash).hash & (children->size - 1);
+}
 
-	while (next_state(&sf)) {
-		struct state *st = sf.st;
+static struct v2_larval_child *larval_slot(struct v2_larval_children *children,
+					   const char *name)
+{
+	unsigned mask = children->size - 1;
+	for (unsigned i = larval_home(children, name); ;
+	     i = (i + 1) & mask) {
+		struct v2_larval_child *slot = &children->slot[i];
+		if (slot->name == NULL || streq(slot->name, name)) {
+			return slot;
+		}
+	}
+}
 
-		/* larval child state? */
-		if (!LHAS(pending_states, st->st_state->kind)) {
-			continue;
+static struct v2_larval_children *alloc_v2_larval_children(unsigned size)
+{
+	struct v2_larval_children *children =
+		alloc_bytes(sizeof(struct v2_larval_children) +
+			    size * sizeof(struct v2_larval_child),
+			    "larval children");
+	children->size = size;
+	return children;
+}
+
+void add_v2_larval_child(struct state *st)
+{
+	if (!is_v2_larval_child(st)) {
+		return;
+	}
+	struct state *ike = state_by_serialno(st->st_clonedfrom);
+	if (ike == NULL) {
+		return;
+	}
+
+	struct v2_larval_children *children = ike->st_v2_larval_children;
+	if (children == NULL) {
+		children = alloc_v2_larval_children(V2_LARVAL_CHILDREN_MIN);
+	} else if ((children->used + 1) * 2 > children->size) {
+		/* keep it at most half full */
+		struct v2_larval_children *bigger =
+			alloc_v2_larval_children(children->size * 2);
+		for (unsigned i = 0; i < children->size; i++) {
+			const struct v2_larval_child *old = &children->slot[i];
+			if (old->name != NULL) {
+				*larval_slot(bigger, old->name) = *old;
+				bigger->used++;
+			}
 		}
-		/*
-		 * not an instance, but a connection?
-		 *
-		 * XXX: what is this trying to do?
-		 *
-		 * The below skips all connections (templates and
-		 * instances) except those that share their ancestry
-		 * with the SA's connection.  The log message would
-		 * suggest it is instead trying to find an existing
-		 * larval state for the connection?
-		 */
-		if (!streq(st->st_connection->base_name, c->base_name)) {
-			continue;
+		pfree(children);
+		children = bigger;
+	}
+	ike->st_v2_larval_children = children;
+
+	const char *name = st->st_connection->base_name;
+	struct v2_larval_child *slot = larval_slot(children, name);
+	if (slot->name == NULL) {
+		slot->name = clone_str(name, "larval child name");
+		children->used++;
+	}
+	slot->count++;
+	slot->latest = st->st_serialno;
+}
+
+void remove_v2_larval_child(struct state *st)
+{
+	if (!is_v2_larval_child(st)) {
+		return;
+	}
+	struct state *ike = state_by_serialno(st->st_clonedfrom);
+	if (ike == NULL || ike->st_v2_larval_children == NULL) {
+		return;
+	}
+
+	struct v2_larval_children *children = ike->st_v2_larval_children;
+	struct v2_larval_child *slot = larval_slot(children, st->st_connection->base_name);
+	if (PBAD(st->logger, slot->name == NULL || slot->count == 0)) {
+		return;
+	}
+	if (slot->latest == st->st_serialno) {
+		slot->latest = SOS_NOBODY;
+	}
+	if (--slot->count > 0) {
+		return;
+	}
+
+	/*
+	 * Empty the slot, then shift back any following entries that
+	 * probed past it.
+	 */
+	unsigned mask = children->size - 1;
+	unsigned hole = slot - children->slot;
+	pfree(children->slot[hole].name);
+	children->slot[hole] = (struct v2_larval_child) { .name = NULL, };
+	children->used--;
+	for (unsigned i = (hole + 1) & mask;
+	     children->slot[i].name != NULL;
+	     i = (i + 1) & mask) {
+		unsigned home = larval_home(children, children->slot[i].name);
+		/* can I move to the hole; is HOME cyclically outside (HOLE, I]? */
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			children->slot[hole] = children->slot[i];
+			children->slot[i] = (struct v2_larval_child) { .name = NULL, };
+			hole = i;
 		}
-		llog(RC_LOG, c->logger, "connection already has the pending Child SA negotiation "PRI_SO" using IKE SA "PRI_SO"",
-		     pri_so(st->st_serialno), pri_so(ike->sa.st_serialno));
-		return true;
 	}
+}
 
-	return false;
+void free_v2_larval_children(struct state *st)
+{
+	struct v2_larval_children *children = st->st_v2_larval_children;
+	if (children == NULL) {
+		return;
+	}
+	for (unsigned i = 0; i < children->size; i++) {
+		pfreeany(children->slot[i].name);
+	}
+	pfree(children);
+	st->st_v2_larval_children = NULL;
+}
+
+bool already_has_larval_v2_child(struct ike_sa *ike, const struct connection *c)
+{
+	struct v2_larval_children *children = ike->sa.st_v2_larval_children;
+	if (children == NULL) {
+		return false;
+	}
+
+	const struct v2_larval_child *slot = larval_slot(children, c->base_name);
+	if (slot->name == NULL) {
+		return false;
+	}
+
+	PEXPECT(c->logger, slot->count > 0);
+	if (slot->latest != SOS_NOBODY) {
+		llog(RC_LOG, c->logger, "connection already has the pending Child SA negotiation "PRI_SO" using IKE SA "PRI_SO"",
+		     pri_so(slot->latest), pri_so(ike->sa.st_serialno));
+	} else {
+		llog(RC_LOG, c->logger, "connection already has a pending Child SA negotiation using IKE SA "PRI_SO"",
+		     pri_so(ike->sa.st_serialno));
+	}
+	return true;
 }
 
 bool accept_v2_notification(v2_notification_t n,
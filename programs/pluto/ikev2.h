@@ -237,6 +237,9 @@ bool v2_accept_ke_for_proposal(struct ike_sa *ike,
 bool v2_notification_fatal(v2_notification_t n);
 
 bool already_has_larval_v2_child(struct ike_sa *ike, const struct connection *c);
+void add_v2_larval_child(struct state *st);
+void remove_v2_larval_child(struct state *st);
+void free_v2_larval_children(struct state *st);
 
 ikev2_llog_success_fn llog_success_ikev2_exchange_initiator;
 ikev2_llog_success_fn llog_success_ikev2_exchange_responder;
@@ -61,6 +61,7 @@
 #include "crypt_symkey.h"
 #include "ikev2_notification.h"
 #include "ikev2_ke.h"
+#include "replication.h"		/* for replicate_state() */
 
 static ikev2_llog_success_fn llog_success_initiate_v2_CREATE_CHILD_SA_child_request;
 static ikev2_llog_success_fn llog_success_ikev2_rekey_ike_request;
@@ -187,6 +188,8 @@ static void migrate_v2_child(struct ike_sa *from, struct child_sa *to,
 	 * state_by_ike_spis() to find children working.
 	 */
 	update_IKE_SPIs_of_sa(child, &to->sa.st_ike_spis);
+	/* the standby finds the IKE SA using the IKE SPIs */
+	replicate_state(&child->sa);
 }
 
 static void migrate_v2_children(struct ike_sa *from, struct child_sa *to)
@@ -53,6 +53,7 @@
 #include "ikev2_states.h"
 #include "ikev2_auth.h"
 #include "ikev2_notification.h"
+#include "ikev2_msgid.h"		/* for emit_v2N_SET_WINDOW_SIZE() */
 
 static ikev2_llog_success_fn llog_success_process_v2_IKE_AUTH_EAP_request;
 
@@ -538,6 +539,10 @@ static stf_status process_v2_IKE_AUTH_request_EAP_start_signature_continue(struc
 		}
 	}
 
+	if (!emit_v2N_SET_WINDOW_SIZE(ike, response.pbs)) {
+		return STF_INTERNAL_ERROR;
+	}
+
 	if (ike->sa.st_ppk_ike_auth_used) {
 		if (!emit_v2N(v2N_PPK_IDENTITY, response.pbs))
 			return STF_INTERNAL_ERROR;
@@ -77,6 +77,7 @@
 #include "peer_id.h"
 #include "ddos.h"
 #include "ikev2_nat.h"
+#include "ikev2_msgid.h"		/* for emit_v2N_SET_WINDOW_SIZE() */
 
 static ikev2_llog_success_fn llog_success_process_v2_IKE_AUTH_response;
 static ikev2_llog_success_fn llog_success_initiate_v2_IKE_AUTH_request;
@@ -314,6 +315,10 @@ stf_status initiate_v2_IKE_AUTH_request_signature_continue(struct ike_sa *ike,
 		}
 	}
 
+	if (!emit_v2N_SET_WINDOW_SIZE(ike, request.pbs)) {
+		return STF_INTERNAL_ERROR;
+	}
+
 	/* Notification payload for ticket request */
 	if (ike->sa.st_connection->config->session_resumption) {
 		llog(RC_LOG, ike->sa.logger, "asking for session resume ticket");
@@ -755,6 +760,8 @@ stf_status process_v2_IKE_AUTH_request_standard_payloads(struct ike_sa *ike, str
 
 	ike->sa.st_ike_seen_v2n_initial_contact = md->pd[PD_v2N_INITIAL_CONTACT] != NULL;
 
+	process_v2N_SET_WINDOW_SIZE(ike, md);
+
 	/*
 	 * Only RFC 8784 PPK mechanism here:
 	 *
@@ -1073,6 +1080,10 @@ static stf_status process_v2_IKE_AUTH_request_auth_signature_continue(struct ike
 			return STF_INTERNAL_ERROR;
 	}
 
+	if (!emit_v2N_SET_WINDOW_SIZE(ike, response.pbs)) {
+		return STF_INTERNAL_ERROR;
+	}
+
 	if (ike->sa.st_ppk_ike_auth_used) {
 		if (!emit_v2N(v2N_PPK_IDENTITY, response.pbs))
 			return STF_INTERNAL_ERROR;
@@ -1323,6 +1334,8 @@ static stf_status process_v2_IKE_AUTH_response_post_cert_decode(struct state *ik
 	ike->sa.st_v2_mobike.enabled =
 		accept_v2_notification(v2N_MOBIKE_SUPPORTED, ike->sa.logger, md, c->config->mobike);
 
+	process_v2N_SET_WINDOW_SIZE(ike, md);
+
 	return process_v2_IKE_AUTH_response_post_cert_child(ike, md);
 }
 
@@ -56,59 +56,80 @@
 #include "instantiate.h"
 #include "ikev2_notification.h"
 #include "rnd.h"
+#include "ikev2_helper.h"
 
 static bool skeyseed_v2_sr(struct ike_sa *ike,
 			   const ike_spis_t *new_spis,
 			   where_t where);
 static bool record_v2_IKE_SESSION_RESUME_request(struct ike_sa *ike);
 static bool emit_v2N_TICKET_OPAQUE(chunk_t ticket, struct pbs_out *pbs);
-static bool decrypt_ticket(struct pbs_in pbs, struct ike_sa *ike);
 
-static ke_and_nonce_cb process_v2_IKE_SESSION_RESUME_request_continue; /* type assertion */
+static ikev2_helper_fn process_v2_IKE_SESSION_RESUME_request_helper; /* type assertion */
+static ikev2_resume_fn process_v2_IKE_SESSION_RESUME_request_continue; /* type assertion */
+static ikev2_cleanup_fn cleanup_IKE_SESSION_RESUME_task; /* type assertion */
 static ke_and_nonce_cb initiate_v2_IKE_SESSION_RESUME_request_continue;	/* type assertion */
 static ikev2_state_transition_fn process_v2_IKE_SESSION_RESUME_response_v2N_TICKET_NACK;
 static ikev2_state_transition_fn process_v2_IKE_SESSION_RESUME_response_v2N_REDIRECT;
 static ikev2_state_transition_fn process_v2_IKE_SESSION_RESUME_request;	/* type assertion */
 static ikev2_state_transition_fn process_v2_IKE_SESSION_RESUME_response; /* type assertion */
 
+/*
+ * Tickets are issued using the current key (session_resume_magic)
+ * and accepted using any key still in the ring.  A ticket's lifetime
+ * is at most one refresh period so, with several keys, a ticket
+ * issued just before a refresh is still accepted well after it
+ * expires; rotating never NACKs a valid ticket.
+ *
+ * Tickets are encrypted on the main thread using .encrypt.
+ * Helpers decrypt using their own reference to .symkey.
+ */
+
+#define SESSION_RESUME_KEYS 4
+
 static unsigned session_resume_magic; /* current session resume key */
 static struct session_resume_key {
+	PK11SymKey *symkey;
+	uint32_t salt;
 	struct cipher_context *encrypt;
-	struct cipher_context *decrypt;
 	unsigned magic;
-} session_resume_keys[2];
+} session_resume_keys[SESSION_RESUME_KEYS];
 
 static void init_session_resume_key(struct session_resume_key *key,
 				    struct logger *logger)
 {
-	PK11SymKey *symkey = cipher_symkey("ike-session-resume",
-					   &ike_alg_encrypt_aes_gcm_16,
-					   128, logger, HERE);
+	key->symkey = cipher_symkey("ike-session-resume",
+				    &ike_alg_encrypt_aes_gcm_16,
+				    128, logger, HERE);
 
-	uint32_t salt = get_rnd_uintmax();
+	key->salt = get_rnd_uintmax();
 	key->encrypt = cipher_context_create(&ike_alg_encrypt_aes_gcm_16,
 					     ENCRYPT,
 					     FILL_WIRE_IV,
-					     symkey,
-					     THING_AS_SHUNK(salt),
-					     logger);
-	key->decrypt = cipher_context_create(&ike_alg_encrypt_aes_gcm_16,
-					     DECRYPT,
-					     USE_WIRE_IV,
-					     symkey,
-					     THING_AS_SHUNK(salt),
+					     key->symkey,
+					     THING_AS_SHUNK(key->salt),
 					     logger);
-	symkey_delref(logger, "symkey", &symkey);
 }
 
 static void destroy_session_resume_key(struct session_resume_key *key,
 					struct logger *logger)
 {
 	cipher_context_destroy(&key->encrypt, logger);
-	cipher_context_destroy(&key->decrypt, logger);
+	symkey_delref(logger, "session resume key", &key->symkey);
 	key->magic = 0;
 }
 
+/* can't trust MAGIC; returns NULL when the key is gone (or never was) */
+
+static const struct session_resume_key *session_resume_key(unsigned magic)
+{
+	const struct session_resume_key *key =
+		&session_resume_keys[magic % elemsof(session_resume_keys)];
+	if (key->magic == 0 || key->magic != magic) {
+		return NULL;
+	}
+	return key;
+}
+
 void refresh_v2_ike_session_resume(struct logger *logger)
 {
 	session_resume_magic++;
@@ -310,8 +331,11 @@ static bool ike_responder_to_ticket(const struct ike_sa *ike,
 {
 	zero(ticket);
 
-	unsigned key_nr = session_resume_magic % elemsof(session_resume_keys);
-	struct session_resume_key *key = &session_resume_keys[key_nr];
+	const struct session_resume_key *key = session_resume_key(session_resume_magic);
+	if (key == NULL) {
+		llog(RC_LOG, ike->sa.logger, "no session resume key");
+		return false;
+	}
 
 	llog(RC_LOG, ike->sa.logger, "using session resume key number %u",
 	     key->magic);
@@ -445,90 +469,121 @@ bool emit_v2N_TICKET_OPAQUE(chunk_t ticket, struct pbs_out *pbs)
 	return ret;
 }
 
-bool decrypt_ticket(struct pbs_in pbs, struct ike_sa *ike)
-{
-	diag_t d;
+/*
+ * The responder's IKE_SESSION_RESUME task: decrypt the ticket and
+ * then, from the old SK_d it contains, derive SKEYSEED and the new
+ * KEYMAT.  All done by a helper so that a flood of resuming peers
+ * doesn't stall the main thread.
+ */
+
+struct ikev2_task {
+	/* in */
 	struct ticket ticket;
+	PK11SymKey *symkey;
+	uint32_t salt;
+	chunk_t ni;
+	ike_spis_t ike_spis;
+	/* out */
+	bool resumed;
+	chunk_t nr;
+	size_t nr_keymat_bytes;
+	PK11SymKey *keymat;
+};
 
-	if (pbs_in_left(&pbs).len != sizeof(ticket)) {
-		llog(RC_LOG, ike->sa.logger, "invalid ticket: wrong length");
-		return false;
-	}
+static void cleanup_IKE_SESSION_RESUME_task(struct ikev2_task **task,
+					    struct logger *logger)
+{
+	symkey_delref(logger, "session resume key", &(*task)->symkey);
+	symkey_delref(logger, "keymat", &(*task)->keymat);
+	free_chunk_content(&(*task)->ni);
+	free_chunk_content(&(*task)->nr);
+	/* contains the old SK_d */
+	messupn(&(*task)->ticket, sizeof((*task)->ticket));
+	pfreeany(*task);
+}
 
-	d = pbs_in_thing(&pbs, ticket, "ticket");
-	if (d != NULL) {
-		llog(RC_LOG, ike->sa.logger, "invalid ticket: %s", str_diag(d));
-		pfree_diag(&d);
+static bool resume_ticket(struct ikev2_task *task, struct logger *logger)
+{
+	struct ticket *ticket = &task->ticket;
+	const struct encrypted *state = &ticket->secured.state;
+
+	if (!cipher_aead(&ike_alg_encrypt_aes_gcm_16,
+			 DECRYPT, USE_WIRE_IV,
+			 THING_AS_SHUNK(task->salt),
+			 THING_AS_CHUNK(ticket->iv),
+			 THING_AS_SHUNK(ticket->aad),
+			 THING_AS_CHUNK(ticket->secured),
+			 /*text-size*/sizeof(ticket->secured.state),
+			 /*tag-size*/sizeof(ticket->secured.tag),
+			 task->symkey, logger)) {
+		llog(RC_LOG, logger, "crypto failed");
 		return false;
 	}
 
-	/*
-	 * Basic sanity check; can't trust .aad.key.
-	 *
-	 * Just trying to avoid a decrypt, the check that matters is
-	 * .decrypt being non-NULL as initially not all the keys are
-	 * valid.
-	 */
-
-	unsigned key_nr = (ticket.aad.magic % elemsof(session_resume_keys));
-	struct session_resume_key *key = &session_resume_keys[key_nr];
-	if (ticket.aad.magic != key->magic) {
-		llog(RC_LOG, ike->sa.logger, "invalid ticket: bad magic number");
+	if (realtime_cmp(state->expiration, <, realnow())) {
+		realtime_buf rtb;
+		llog(RC_LOG, logger, "ticket expired %s",
+		     str_realtime(state->expiration, /*utc*/false, &rtb));
 		return false;
 	}
 
-	llog(RC_LOG, ike->sa.logger, "using session resume key %u",
-	     key->magic);
-
-	/* decrypt!?! */
-
-	if (!cipher_context_op_aead(key->decrypt,
-				    THING_AS_CHUNK(ticket.iv),
-				    THING_AS_SHUNK(ticket.aad),
-				    THING_AS_CHUNK(ticket.secured),
-				    /*text-size*/sizeof(ticket.secured.state),
-				    /*tag-size*/sizeof(ticket.secured.tag),
-				    ike->sa.logger)) {
-		llog(RC_LOG, ike->sa.logger, "crypto failed");
+	if (state->sk_d_old.len == 0 ||
+	    state->sk_d_old.len > sizeof(state->sk_d_old.ptr/*array*/)) {
+		llog(RC_LOG, logger, "invalid key length %zu",
+		     state->sk_d_old.len);
 		return false;
 	}
 
-	if (realtime_cmp(ticket.secured.state.expiration, <, realnow())) {
-		realtime_buf rtb;
-		llog(RC_LOG, ike->sa.logger, "ticket expired %s",
-		     str_realtime(ticket.secured.state.expiration, /*utc*/false, &rtb));
+	/*
+	 * Enough to size KEYMAT; the main thread re-validates the
+	 * proposal.
+	 */
+	name_buf eb, pb, ib;
+	struct trans_attrs ta = {
+		.ta_encrypt = ikev2_encrypt_desc(state->sr_encr, &eb),
+		.enckeylen = state->sr_enc_keylen,
+		.ta_prf = ikev2_prf_desc(state->sr_prf, &pb),
+		.ta_integ = ikev2_integ_desc(state->sr_integ, &ib),
+	};
+	if (ta.ta_encrypt == NULL || ta.ta_prf == NULL) {
+		llog(RC_LOG, logger, "ticket specifies an unsupported algorithm");
 		return false;
 	}
 
-	if (ticket.secured.state.sk_d_old.len == 0 ||
-	    ticket.secured.state.sk_d_old.len > sizeof(ticket.secured.state.sk_d_old.ptr/*array*/)) {
-		llog(RC_LOG, ike->sa.logger, "invalid key length %zu",
-		     ticket.secured.state.sk_d_old.len);
+	PK11SymKey *sk_d_old = symkey_from_hunk("sk_d_old", state->sk_d_old, logger);
+	if (sk_d_old == NULL) {
+		llog(RC_LOG, logger, "failed to re-animate peer's key");
 		return false;
 	}
 
-	/* this will be turned into D during IKE_AUTH */
-	PASSERT(ike->sa.logger, ike->sa.st_skey_d_nss == NULL);
+	task->nr = alloc_rnd_chunk(DEFAULT_NONCE_SIZE, "Nr");
 
-	ike->sa.st_skey_d_nss = symkey_from_hunk("sk_d_old",
-						 ticket.secured.state.sk_d_old,
-						 ike->sa.logger);
-	if (ike->sa.st_skey_d_nss == NULL) {
-		llog(RC_LOG, ike->sa.logger, "failed to re-animate peer's key");
+	PK11SymKey *skeyseed = ikev2_IKE_SESSION_RESUME_skeyseed(ta.ta_prf, sk_d_old,
+								 task->ni, task->nr,
+								 logger);
+	symkey_delref(logger, "sk_d_old", &sk_d_old);
+	if (skeyseed == NULL) {
+		llog(RC_LOG, logger, "SKEYSEED failed");
 		return false;
 	}
 
-	set_ikev2_accepted_proposal(ike,
-				    ticket.secured.state.sr_encr,
-				    ticket.secured.state.sr_prf,
-				    ticket.secured.state.sr_integ,
-				    ticket.secured.state.sr_kem,
-				    ticket.secured.state.sr_enc_keylen);
-
-	/* save what is needed */
-	ike->sa.st_v2_resume_session = clone_thing(ticket.secured.state.resume, __func__);
+	task->nr_keymat_bytes = ikev2_ike_keymat_bytes(&ta);
+	task->keymat = ikev2_ike_sa_keymat(ta.ta_prf, skeyseed,
+					   task->ni, task->nr,
+					   &task->ike_spis,
+					   task->nr_keymat_bytes,
+					   logger);
+	symkey_delref(logger, "skeyseed", &skeyseed);
+	return (task->keymat != NULL);
+}
 
-	return true;
+stf_status process_v2_IKE_SESSION_RESUME_request_helper(struct ikev2_task *task,
+							struct msg_digest *md UNUSED,
+							struct logger *logger)
+{
+	/* a bad ticket is NACKed by the main thread */
+	task->resumed = resume_ticket(task, logger);
+	return STF_OK;
 }
 
 bool record_v2_IKE_SESSION_RESUME_request(struct ike_sa *ike)
@@ -732,30 +787,44 @@ stf_status process_v2_IKE_SESSION_RESUME_request(struct ike_sa *ike,
 		return STF_FATAL;
 	}
 
+	struct ikev2_task task = {
+		.ike_spis = ike->sa.st_ike_spis,
+	};
+
 	struct pbs_in pbs = md->pd[PD_v2N_TICKET_OPAQUE]->pbs;
-	if(!decrypt_ticket(pbs, ike)) {
-		/* already logged */
+	if (pbs_in_left(&pbs).len != sizeof(task.ticket)) {
+		llog(RC_LOG, ike->sa.logger, "invalid ticket: wrong length");
+		pstats_ikev2_session_resume_failed++;
 		record_v2N_TICKET_NACK(ike, md);
 		return STF_FATAL;
 	}
 
-	if (PBAD(ike->sa.logger, ike->sa.st_v2_resume_session == NULL)) {
+	diag_t d = pbs_in_thing(&pbs, task.ticket, "ticket");
+	if (d != NULL) {
+		llog(RC_LOG, ike->sa.logger, "invalid ticket: %s", str_diag(d));
+		pfree_diag(&d);
+		pstats_ikev2_session_resume_failed++;
+		record_v2N_TICKET_NACK(ike, md);
 		return STF_FATAL;
 	}
 
 	/*
-	 * Convert what was accepted to internal form and apply some
-	 * basic validation.  If this somehow fails (it shouldn't but
-	 * ...), drop everything.
+	 * Basic sanity check; can't trust .aad.magic.
+	 *
+	 * Just trying to avoid a decrypt; the check that matters is
+	 * the decrypt.
 	 */
-	if (!ikev2_proposal_to_trans_attrs(ike->sa.st_v2_accepted_proposal,
-					   &ike->sa.st_oakley, ike->sa.logger)) {
-		llog_sa(RC_LOG, ike, "IKE responder accepted an unsupported algorithm");
-		/* STF_INTERNAL_ERROR doesn't delete ST */
+	const struct session_resume_key *key = session_resume_key(task.ticket.aad.magic);
+	if (key == NULL) {
+		llog(RC_LOG, ike->sa.logger, "invalid ticket: bad magic number");
+		pstats_ikev2_session_resume_failed++;
 		record_v2N_TICKET_NACK(ike, md);
 		return STF_FATAL;
 	}
 
+	llog(RC_LOG, ike->sa.logger, "using session resume key %u",
+	     key->magic);
+
 	/* Ni in */
 
 	if (!accept_v2_nonce(ike->sa.logger, md, &ike->sa.st_ni, "Ni")) {
@@ -769,30 +838,72 @@ stf_status process_v2_IKE_SESSION_RESUME_request(struct ike_sa *ike,
 		return STF_FATAL;
 	}
 
-	/* calculate the nonce and the KE */
-	submit_ke_and_nonce(/*callback*/&ike->sa, /*task*/&ike->sa, md,
-			    /*NO KE*/NULL,
-			    process_v2_IKE_SESSION_RESUME_request_continue,
-			    /*detach_whack*/false, HERE);
+	task.symkey = symkey_addref(ike->sa.logger, "session resume key", key->symkey);
+	task.salt = key->salt;
+	task.ni = clone_hunk_as_chunk(&ike->sa.st_ni, "Ni");
+
+	/* decrypt the ticket, generate Nr, calculate KEYMAT */
+	submit_ikev2_task(ike, md,
+			  clone_thing(task, "session resume task"),
+			  process_v2_IKE_SESSION_RESUME_request_helper,
+			  process_v2_IKE_SESSION_RESUME_request_continue,
+			  cleanup_IKE_SESSION_RESUME_task,
+			  HERE);
 	return STF_SUSPEND;
 }
 
-stf_status process_v2_IKE_SESSION_RESUME_request_continue(struct state *ike_st,
+stf_status process_v2_IKE_SESSION_RESUME_request_continue(struct ike_sa *ike,
 							  struct msg_digest *md,
-							  struct dh_local_secret *local_secret,
-							  chunk_t *nonce)
+							  struct ikev2_task *task)
 {
-	struct ike_sa *ike = pexpect_ike_sa(ike_st);
 	pexpect(ike->sa.st_sa_role == SA_RESPONDER);
 	pexpect(v2_msg_role(md) == MESSAGE_REQUEST); /* i.e., MD!=NULL */
 	pexpect(ike->sa.st_state == &state_v2_UNSECURED_R);
-	ldbg(ike->sa.logger, "%s() for "PRI_SO" %s: calculated ke+nonce, sending R1",
+	ldbg(ike->sa.logger, "%s() for "PRI_SO" %s: resumed ticket, sending R1",
 	     __func__, pri_so(ike->sa.st_serialno), ike->sa.st_state->name);
 
+	if (!task->resumed) {
+		/* already logged */
+		pstats_ikev2_session_resume_failed++;
+		record_v2N_TICKET_NACK(ike, md);
+		return STF_FATAL;
+	}
+
+	struct encrypted *state = &task->ticket.secured.state;
+
+	set_ikev2_accepted_proposal(ike,
+				    state->sr_encr,
+				    state->sr_prf,
+				    state->sr_integ,
+				    state->sr_kem,
+				    state->sr_enc_keylen);
+
+	/* save what is needed */
+	ike->sa.st_v2_resume_session = clone_thing(state->resume, __func__);
+
+	/*
+	 * Convert what was accepted to internal form and apply some
+	 * basic validation.  If this somehow fails (it shouldn't but
+	 * ...), drop everything.
+	 */
+	if (!ikev2_proposal_to_trans_attrs(ike->sa.st_v2_accepted_proposal,
+					   &ike->sa.st_oakley, ike->sa.logger)) {
+		llog_sa(RC_LOG, ike, "IKE responder accepted an unsupported algorithm");
+		pstats_ikev2_session_resume_failed++;
+		/* STF_INTERNAL_ERROR doesn't delete ST */
+		record_v2N_TICKET_NACK(ike, md);
+		return STF_FATAL;
+	}
+
+	/* the helper sized KEYMAT using the same algorithms */
+	if (PBAD(ike->sa.logger,
+		 nr_ikev2_ike_keymat_bytes(&ike->sa) != task->nr_keymat_bytes)) {
+		return STF_FATAL;
+	}
+
 	/* Nr generated */
 
-	PEXPECT(ike->sa.logger, local_secret == NULL);
-	unpack_nonce(&ike->sa.st_nr, nonce);
+	unpack_nonce(&ike->sa.st_nr, &task->nr);
 
 	/*
 	 * On the responder, the IKE SA is created with pre-populated
@@ -802,13 +913,12 @@ stf_status process_v2_IKE_SESSION_RESUME_request_continue(struct state *ike_st,
 	pexpect(!ike_spi_is_zero(&ike->sa.st_ike_spis.responder));
 	pexpect(!ike_spi_is_zero(&ike->sa.st_ike_spis.initiator));
 
-	if (!skeyseed_v2_sr(ike, &ike->sa.st_ike_spis, HERE)) {
-		return STF_FATAL;
-	}
+	extract_ikev2_ike_keys(&ike->sa, task->keymat);
 
 	/* hoot! */
 
 	passert(ike->sa.hidden_variables.st_skeyid_calculated);
+	pstats_ikev2_session_resume_completed++;
 
 	/* Record first packet for later checking of signature.  */
 	save_first_inbound_ikev2_packet("IKE_SESSION_RESUME request",
@@ -1303,26 +1303,22 @@ bool ikev2_decrypt_msg(struct ike_sa *ike, struct msg_digest *md)
  *
  */
 
-static bool encrypt_and_record_outbound_fragment(struct logger *logger,
-						 struct ike_sa *ike,
-						 const struct isakmp_hdr *hdr,
-						 enum next_payload_types_ikev2 unencrypted_payloads_type,
-						 shunk_t unencrypted_payloads,
-						 ptrdiff_t previous_to_sk_next_payload_offset,
-						 enum next_payload_types_ikev2 skf_np,
-						 struct v2_outgoing_fragments *fragments,
-						 shunk_t fragment,
-						 unsigned int number)
+static bool encrypt_outbound_fragment(struct logger *logger,
+				      struct ike_sa *ike,
+				      const struct isakmp_hdr *hdr,
+				      enum next_payload_types_ikev2 unencrypted_payloads_type,
+				      shunk_t unencrypted_payloads,
+				      ptrdiff_t previous_to_sk_next_payload_offset,
+				      enum next_payload_types_ikev2 skf_np,
+				      struct v2_outgoing_fragments *fragments,
+				      shunk_t fragment,
+				      unsigned int number,
+				      struct pbs_out *message_fragment)
 {
-	struct fragment_pbs_out message_fragment;
-	if (!open_fragment_pbs_out("fragment", &message_fragment, logger)) {
-		return false;
-	}
-
 	/* HDR out */
 
 	struct pbs_out body;
-	if (!pbs_out_struct(&message_fragment.pbs, (*hdr), &isakmp_hdr_desc, &body)) {
+	if (!pbs_out_struct(message_fragment, (*hdr), &isakmp_hdr_desc, &body)) {
 		return false;
 	}
 
@@ -1342,7 +1338,7 @@ static bool encrypt_and_record_outbound_fragment(struct logger *logger,
 		 * payloads.  Make certain it is zero.  When the SKF
 		 * header is emitted it will be set to SKF.
 		 */
-		next_payload_chain->loc = message_fragment.pbs.start + previous_to_sk_next_payload_offset;
+		next_payload_chain->loc = message_fragment->start + previous_to_sk_next_payload_offset;
 		next_payload_chain->name = "unencrypted Next Payload";
 		apply_fixup(logger, next_payload_chain, ISAKMP_NEXT_v2NONE);
 	}
@@ -1412,16 +1408,48 @@ static bool encrypt_and_record_outbound_fragment(struct logger *logger,
 	}
 
 	close_pbs_out(&body);
-	close_pbs_out(&message_fragment.pbs);
+	close_pbs_out(message_fragment);
 
 	if (!encrypt_v2SK_payload(&skf)) {
 		llog(RC_LOG, logger, "error encrypting fragment %u", number);
 		return false;
 	}
 
+	return true;
+}
+
+/*
+ * The fragment is built and encrypted in place, in a scratch buffer
+ * big enough for any fragment; only the bytes used are then
+ * recorded, and re-transmitted, as is.
+ */
+
+static bool encrypt_and_record_outbound_fragment(struct logger *logger,
+						 struct ike_sa *ike,
+						 const struct isakmp_hdr *hdr,
+						 enum next_payload_types_ikev2 unencrypted_payloads_type,
+						 shunk_t unencrypted_payloads,
+						 ptrdiff_t previous_to_sk_next_payload_offset,
+						 enum next_payload_types_ikev2 skf_np,
+						 struct v2_outgoing_fragments *fragments,
+						 shunk_t fragment,
+						 unsigned int number)
+{
+	/* see struct fragment_pbs_out */
+	uint8_t buffer[PMAX(MIN_MAX_UDP_DATA_v4, MIN_MAX_UDP_DATA_v6)];
+	struct pbs_out message_fragment = open_pbs_out("fragment", buffer, sizeof(buffer), logger);
+	if (!encrypt_outbound_fragment(logger, ike, hdr,
+				       unencrypted_payloads_type,
+				       unencrypted_payloads,
+				       previous_to_sk_next_payload_offset,
+				       skf_np, fragments, fragment, number,
+				       &message_fragment)) {
+		return false;
+	}
+
 	ldbg(ike->sa.logger, "recording fragment %u", number);
 	PASSERT(ike->sa.logger, number > 0);
-	fragments->item[number - 1] = clone_pbs_out_all(&message_fragment.pbs, "fragment");
+	fragments->item[number - 1] = clone_pbs_out_all(&message_fragment, "fragment");
 	return true;
 }
 
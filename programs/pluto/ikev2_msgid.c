@@ -21,6 +21,12 @@
 #include "ikev2_msgid.h"
 #include "log.h"
 #include "ikev2.h"		/* for complete_v2_state_transition() */
+#include "ikev2_send.h"		/* for send_recorded_v2_message() */
+#include "ikev2_notification.h"	/* for emit_v2N_bytes() */
+#include "ikev2_create_child_sa.h"
+#include "ikev2_delete.h"
+#include "ikev2_liveness.h"
+#include "replication.h"		/* for replicate_v2_msgid() */
 
 #define pexpect_v2_msgid(COND)			\
 	({								\
@@ -35,8 +41,11 @@
 	})
 
 static callback_cb initiate_next;		/* type assertion */
+static callback_cb process_held_message;	/* type assertion */
 
 static const struct v2_msgid_windows empty_v2_msgid_windows = {
+	.local_window = 1,
+	.peer_window = 1,
 	.initiator = {
 		.sent = -1,
 		.recv = -1,
@@ -218,6 +227,573 @@ static void dbg_msgid_update(const char *what,
 	}
 }
 
+/*
+ * RFC 7296 2.3.  Window Size for Overlapping Requests.
+ *
+ * The arrays are indexed by Message ID modulo IKE_V2_MAX_WINDOW_SIZE.
+ * Since neither window can be larger than that, live entries never
+ * collide.
+ *
+ * Initiator: .initiator only has room for one exchange (.exchange,
+ * .wip_sa, .dead_sa, .outgoing_fragments).  When a further request
+ * is initiated, the sent request loaded into .initiator is parked in
+ * .inflight[]; when a response arrives, the matching request is
+ * swapped back in.  That way the exchange code only ever sees the
+ * one exchange.  .initiator.recv is the last Message ID below which
+ * all responses have been processed.
+ *
+ * Responder: .responder only records the last response; earlier
+ * responses are moved to .responses[] so that a retransmitted
+ * request, anywhere in the window, can be answered.  Requests that
+ * arrive while the responder is busy, or ahead of a missing request,
+ * are held in .requests[] and processed in order.  A request is
+ * only held once it has been decrypted, so a forged message can't
+ * take the place of the real one.
+ */
+
+struct v2_msgid_overlap {
+	intmax_t active;	/* request loaded into .initiator; or -1 */
+	bool held_scheduled;	/* process_held_message() is pending */
+	struct v2_msgid_inflight {
+		intmax_t msgid;	/* -1 when unused */
+		const struct v2_exchange *exchange;
+		so_serial_t wip_sa;
+		so_serial_t dead_sa;
+		struct v2_outgoing_fragments *outgoing_fragments;
+		struct msg_digest *response;	/* arrived while busy */
+	} inflight[IKE_V2_MAX_WINDOW_SIZE];
+	struct v2_msgid_response {
+		intmax_t msgid;	/* -1 when unused */
+		unsigned recv_frags;
+		struct v2_outgoing_fragments *outgoing_fragments;
+	} responses[IKE_V2_MAX_WINDOW_SIZE];
+	struct msg_digest *requests[IKE_V2_MAX_WINDOW_SIZE];
+};
+
+static struct v2_msgid_overlap *alloc_overlap(struct ike_sa *ike)
+{
+	struct v2_msgid_windows *windows = &ike->sa.st_v2_msgid_windows;
+	if (windows->overlap == NULL) {
+		struct v2_msgid_overlap *overlap = alloc_thing(struct v2_msgid_overlap,
+							       "v2 msgid overlap");
+		overlap->active = -1;
+		FOR_EACH_ELEMENT(inflight, overlap->inflight) {
+			inflight->msgid = -1;
+		}
+		FOR_EACH_ELEMENT(response, overlap->responses) {
+			response->msgid = -1;
+		}
+		windows->overlap = overlap;
+	}
+	return windows->overlap;
+}
+
+static void discard_inflight(struct v2_msgid_inflight *inflight, struct logger *logger)
+{
+	free_v2_outgoing_fragments(&inflight->outgoing_fragments, logger);
+	md_delref(&inflight->response);
+	*inflight = (struct v2_msgid_inflight) {
+		.msgid = -1,
+	};
+}
+
+static void free_overlap(struct v2_msgid_overlap **overlap, struct logger *logger)
+{
+	if (*overlap == NULL) {
+		return;
+	}
+	FOR_EACH_ELEMENT(inflight, (*overlap)->inflight) {
+		discard_inflight(inflight, logger);
+	}
+	FOR_EACH_ELEMENT(response, (*overlap)->responses) {
+		free_v2_outgoing_fragments(&response->outgoing_fragments, logger);
+	}
+	FOR_EACH_ELEMENT(request, (*overlap)->requests) {
+		md_delref(request);
+	}
+	pfree(*overlap);
+	*overlap = NULL;
+}
+
+/*
+ * The number of requests this end can have outstanding.
+ */
+
+static intmax_t initiator_window(const struct ike_sa *ike)
+{
+	const struct v2_msgid_windows *windows = &ike->sa.st_v2_msgid_windows;
+	return min(windows->local_window, windows->peer_window);
+}
+
+bool v2_msgid_overlapping_requests(struct ike_sa *ike)
+{
+	return (ike->sa.st_v2_msgid_windows.overlap != NULL &&
+		initiator_window(ike) > 1);
+}
+
+/*
+ * Only exchanges that don't change the IKE SA itself can overlap;
+ * and then only with other such exchanges.
+ */
+
+static bool exchange_can_overlap(const struct v2_exchange *exchange)
+{
+	return (exchange == &v2_CREATE_CHILD_SA_new_child_exchange ||
+		exchange == &v2_CREATE_CHILD_SA_rekey_child_exchange ||
+		exchange == &v2_INFORMATIONAL_v2DELETE_exchange ||
+		exchange == &v2_INFORMATIONAL_liveness_exchange);
+}
+
+static bool can_overlap(struct ike_sa *ike, const struct v2_exchange *exchange)
+{
+	const struct v2_msgid_overlap *overlap = ike->sa.st_v2_msgid_windows.overlap;
+	if (!exchange_can_overlap(exchange)) {
+		return false;
+	}
+	if (overlap->active >= 0 &&
+	    !exchange_can_overlap(ike->sa.st_v2_msgid_windows.initiator.exchange)) {
+		return false;
+	}
+	FOR_EACH_ELEMENT(inflight, overlap->inflight) {
+		if (inflight->msgid >= 0 && !exchange_can_overlap(inflight->exchange)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void park_active_request(struct ike_sa *ike)
+{
+	struct v2_msgid_overlap *overlap = ike->sa.st_v2_msgid_windows.overlap;
+	struct v2_msgid_window *initiator = &ike->sa.st_v2_msgid_windows.initiator;
+	if (overlap == NULL || overlap->active < 0) {
+		return;
+	}
+
+	PEXPECT(ike->sa.logger, initiator->wip == -1);
+	struct v2_msgid_inflight *inflight =
+		&overlap->inflight[overlap->active % IKE_V2_MAX_WINDOW_SIZE];
+	if (inflight->msgid >= 0) {
+		llog_pexpect_v2_msgid(ike, "parking request %jd clobbers request %jd",
+				      overlap->active, inflight->msgid);
+		discard_inflight(inflight, ike->sa.logger);
+	}
+
+	dbg_v2_msgid(ike, "parking request %jd", overlap->active);
+	*inflight = (struct v2_msgid_inflight) {
+		.msgid = overlap->active,
+		.exchange = initiator->exchange,
+		.wip_sa = (initiator->wip_sa != NULL ? initiator->wip_sa->sa.st_serialno : SOS_NOBODY),
+		.dead_sa = initiator->dead_sa,
+		.outgoing_fragments = initiator->outgoing_fragments,
+	};
+	initiator->exchange = NULL;
+	initiator->wip_sa = NULL;
+	initiator->dead_sa = SOS_NOBODY;
+	initiator->outgoing_fragments = NULL;
+	overlap->active = -1;
+}
+
+static void unpark_request(struct ike_sa *ike, struct v2_msgid_inflight *inflight)
+{
+	struct v2_msgid_overlap *overlap = ike->sa.st_v2_msgid_windows.overlap;
+	struct v2_msgid_window *initiator = &ike->sa.st_v2_msgid_windows.initiator;
+
+	park_active_request(ike);
+	dbg_v2_msgid(ike, "loading request %jd", inflight->msgid);
+	free_v2_outgoing_fragments(&initiator->outgoing_fragments, ike->sa.logger);
+	initiator->outgoing_fragments = inflight->outgoing_fragments;
+	initiator->exchange = inflight->exchange;
+	/* the Child SA may have gone away while waiting */
+	initiator->wip_sa = child_sa_by_serialno(inflight->wip_sa);
+	initiator->dead_sa = inflight->dead_sa;
+	overlap->active = inflight->msgid;
+	inflight->outgoing_fragments = NULL;
+	discard_inflight(inflight, ike->sa.logger);
+}
+
+static bool requests_inflight(const struct v2_msgid_overlap *overlap)
+{
+	FOR_EACH_ELEMENT(inflight, overlap->inflight) {
+		if (inflight->msgid >= 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * Everything below the oldest parked request has been processed.
+ */
+
+static intmax_t inflight_floor(const struct v2_msgid_overlap *overlap, intmax_t sent)
+{
+	intmax_t recv = sent;
+	FOR_EACH_ELEMENT(inflight, overlap->inflight) {
+		if (inflight->msgid >= 0 && inflight->msgid <= recv) {
+			recv = inflight->msgid - 1;
+		}
+	}
+	return recv;
+}
+
+struct v2_outgoing_fragments *v2_msgid_inflight_request(struct ike_sa *ike)
+{
+	const struct v2_msgid_overlap *overlap = ike->sa.st_v2_msgid_windows.overlap;
+	if (overlap == NULL) {
+		return NULL;
+	}
+	FOR_EACH_ELEMENT(inflight, overlap->inflight) {
+		if (inflight->msgid >= 0 && inflight->outgoing_fragments != NULL) {
+			return inflight->outgoing_fragments;
+		}
+	}
+	return NULL;
+}
+
+void v2_msgid_retransmit_inflight(struct ike_sa *ike)
+{
+	const struct v2_msgid_overlap *overlap = ike->sa.st_v2_msgid_windows.overlap;
+	if (overlap == NULL) {
+		return;
+	}
+	FOR_EACH_ELEMENT(inflight, overlap->inflight) {
+		if (inflight->msgid >= 0 && inflight->outgoing_fragments != NULL) {
+			send_recorded_v2_message(ike, inflight->outgoing_fragments);
+		}
+	}
+}
+
+/*
+ * Move the last response into .responses[] before .responder is
+ * re-used for the next one.
+ */
+
+static void record_last_response(struct ike_sa *ike)
+{
+	struct v2_msgid_window *responder = &ike->sa.st_v2_msgid_windows.responder;
+	if (responder->sent < 0 || responder->outgoing_fragments == NULL) {
+		return;
+	}
+	struct v2_msgid_overlap *overlap = alloc_overlap(ike);
+	struct v2_msgid_response *response =
+		&overlap->responses[responder->sent % IKE_V2_MAX_WINDOW_SIZE];
+	free_v2_outgoing_fragments(&response->outgoing_fragments, ike->sa.logger);
+	*response = (struct v2_msgid_response) {
+		.msgid = responder->sent,
+		.recv_frags = responder->recv_frags,
+		.outgoing_fragments = responder->outgoing_fragments,
+	};
+	responder->outgoing_fragments = NULL;
+}
+
+struct v2_outgoing_fragments *v2_msgid_recorded_response(struct ike_sa *ike, intmax_t msgid,
+							 unsigned *recv_frags)
+{
+	struct v2_msgid_window *responder = &ike->sa.st_v2_msgid_windows.responder;
+	if (msgid == responder->sent && responder->outgoing_fragments != NULL) {
+		*recv_frags = responder->recv_frags;
+		return responder->outgoing_fragments;
+	}
+
+	/*
+	 * RFC 7296 2.3: the responder MUST remember each response
+	 * until it receives a request whose sequence number is
+	 * larger than or equal to the sequence number in the
+	 * response plus its window size.
+	 */
+	const struct v2_msgid_overlap *overlap = ike->sa.st_v2_msgid_windows.overlap;
+	intmax_t window = ike->sa.st_v2_msgid_windows.local_window;
+	if (overlap == NULL || msgid > responder->sent || msgid + window <= responder->sent) {
+		return NULL;
+	}
+	const struct v2_msgid_response *response =
+		&overlap->responses[msgid % IKE_V2_MAX_WINDOW_SIZE];
+	if (response->msgid != msgid) {
+		return NULL;
+	}
+	*recv_frags = response->recv_frags;
+	return response->outgoing_fragments;
+}
+
+bool v2_msgid_drop_early_request(struct ike_sa *ike, const struct msg_digest *md)
+{
+	const struct v2_msgid_window *responder = &ike->sa.st_v2_msgid_windows.responder;
+	intmax_t window = ike->sa.st_v2_msgid_windows.local_window;
+	intmax_t msgid = md->hdr.isa_msgid;
+
+	if (window <= 1 || msgid == responder->sent + 1) {
+		/* next in line, or nothing can be early */
+		return false;
+	}
+
+	if (msgid >= responder->sent + 1 + window) {
+		name_buf xb;
+		llog_sa(RC_LOG, ike,
+			"%s request with Message ID %jd is outside of the window (last response %jd, window %jd); message dropped",
+			str_enum_short(&ikev2_exchange_names, md->hdr.isa_xchg, &xb),
+			msgid, responder->sent, window);
+		return true;
+	}
+
+	/*
+	 * Fragments are accumulated in .responder so can't be held;
+	 * the peer will retransmit.
+	 */
+	if (md->hdr.isa_np != ISAKMP_NEXT_v2SK) {
+		dbg_v2_msgid(ike, "dropping early request fragment %jd", msgid);
+		return true;
+	}
+
+	return false;
+}
+
+bool v2_msgid_hold_request(struct ike_sa *ike, struct msg_digest *md)
+{
+	const struct v2_msgid_window *responder = &ike->sa.st_v2_msgid_windows.responder;
+	intmax_t window = ike->sa.st_v2_msgid_windows.local_window;
+	intmax_t msgid = md->hdr.isa_msgid;
+
+	if (window <= 1) {
+		return false;
+	}
+
+	if (msgid == responder->sent + 1 && responder->wip == -1) {
+		/* next in line */
+		return false;
+	}
+
+	struct v2_msgid_overlap *overlap = alloc_overlap(ike);
+	struct msg_digest **held = &overlap->requests[msgid % IKE_V2_MAX_WINDOW_SIZE];
+	if (*held != NULL) {
+		if ((*held)->hdr.isa_msgid == msgid) {
+			/* both decrypted, so both are from the peer */
+			dbg_v2_msgid(ike, "request %jd is already being held", msgid);
+			return true;
+		}
+		md_delref(held);
+	}
+	dbg_v2_msgid(ike, "holding request %jd", msgid);
+	*held = md_addref(md);
+	return true;
+}
+
+bool v2_msgid_load_response(struct ike_sa *ike, struct msg_digest *md)
+{
+	struct v2_msgid_overlap *overlap = ike->sa.st_v2_msgid_windows.overlap;
+	const struct v2_msgid_window *initiator = &ike->sa.st_v2_msgid_windows.initiator;
+	intmax_t msgid = md->hdr.isa_msgid;
+
+	if (msgid > initiator->sent) {
+		name_buf xb;
+		llog_sa(RC_LOG, ike,
+			"unexpected %s response with Message ID %jd (last sent was %jd); dropping packet",
+			str_enum_long(&ikev2_exchange_names, md->hdr.isa_xchg, &xb),
+			msgid, initiator->sent);
+		return false;
+	}
+
+	if (initiator->wip == msgid) {
+		name_buf xb;
+		dbg_v2_msgid(ike,
+			     "%s response with Message ID %jd is work-in-progress; dropping packet",
+			     str_enum_long(&ikev2_exchange_names, md->hdr.isa_xchg, &xb),
+			     msgid);
+		return false;
+	}
+
+	if (overlap->active == msgid) {
+		/* already loaded */
+		return (initiator->wip == -1);
+	}
+
+	struct v2_msgid_inflight *inflight = &overlap->inflight[msgid % IKE_V2_MAX_WINDOW_SIZE];
+	if (inflight->msgid != msgid) {
+		name_buf xb;
+		dbg_v2_msgid(ike, "%s response with Message ID %jd was already processed; dropping packet",
+			     str_enum_short(&ikev2_exchange_names, md->hdr.isa_xchg, &xb),
+			     msgid);
+		return false;
+	}
+
+	if (initiator->wip != -1) {
+		/*
+		 * The initiator is busy, either sending a new request
+		 * or processing an earlier response.  Hold on to the
+		 * response (but not fragments, they need the
+		 * initiator's fragment buffer).
+		 */
+		if (md->hdr.isa_np == ISAKMP_NEXT_v2SK) {
+			/*
+			 * Not yet decrypted, so it could be forged;
+			 * keep the latest so that the peer's
+			 * retransmit replaces a forgery.
+			 */
+			dbg_v2_msgid(ike, "holding response %jd as busy with %jd",
+				     msgid, initiator->wip);
+			md_delref(&inflight->response);
+			inflight->response = md_addref(md);
+		} else {
+			dbg_v2_msgid(ike, "dropping response %jd as busy with %jd",
+				     msgid, initiator->wip);
+		}
+		return false;
+	}
+
+	unpark_request(ike, inflight);
+	return true;
+}
+
+/*
+ * Process one held message; once it is finished,
+ * v2_msgid_schedule_next_initiator() will schedule the next.
+ */
+
+static void schedule_held_message(struct ike_sa *ike)
+{
+	struct v2_msgid_overlap *overlap = ike->sa.st_v2_msgid_windows.overlap;
+	if (overlap == NULL || overlap->held_scheduled) {
+		return;
+	}
+	const struct v2_msgid_window *responder = &ike->sa.st_v2_msgid_windows.responder;
+	const struct v2_msgid_window *initiator = &ike->sa.st_v2_msgid_windows.initiator;
+	bool held = false;
+	if (responder->wip == -1) {
+		intmax_t next = responder->sent + 1;
+		struct msg_digest *request = overlap->requests[next % IKE_V2_MAX_WINDOW_SIZE];
+		held |= (request != NULL && request->hdr.isa_msgid == next);
+	}
+	if (initiator->wip == -1) {
+		FOR_EACH_ELEMENT(inflight, overlap->inflight) {
+			held |= (inflight->msgid >= 0 && inflight->response != NULL);
+		}
+	}
+	if (held) {
+		overlap->held_scheduled = true;
+		schedule_callback("held message", deltatime(0),
+				  ike->sa.st_serialno,
+				  process_held_message, NULL,
+				  ike->sa.logger);
+	}
+}
+
+static void process_held_message(const char *story, struct state *ike_sa, void *context UNUSED)
+{
+	struct ike_sa *ike = pexpect_ike_sa(ike_sa);
+	if (ike == NULL) {
+		ldbg(&global_logger, "IKE SA with held messages disappeared (%s)", story);
+		return;
+	}
+
+	struct v2_msgid_overlap *overlap = ike->sa.st_v2_msgid_windows.overlap;
+	const struct v2_msgid_window *responder = &ike->sa.st_v2_msgid_windows.responder;
+	const struct v2_msgid_window *initiator = &ike->sa.st_v2_msgid_windows.initiator;
+	if (overlap == NULL) {
+		/* reset */
+		return;
+	}
+	overlap->held_scheduled = false;
+
+	struct msg_digest *md = NULL;
+	if (responder->wip == -1) {
+		intmax_t next = responder->sent + 1;
+		struct msg_digest **request = &overlap->requests[next % IKE_V2_MAX_WINDOW_SIZE];
+		if (*request != NULL && (*request)->hdr.isa_msgid == next) {
+			md = *request;
+			*request = NULL;
+		}
+	}
+	if (md == NULL && initiator->wip == -1) {
+		FOR_EACH_ELEMENT(inflight, overlap->inflight) {
+			if (inflight->msgid >= 0 && inflight->response != NULL) {
+				md = inflight->response;
+				inflight->response = NULL;
+				break;
+			}
+		}
+	}
+	if (md == NULL) {
+		return;
+	}
+
+	so_serial_t serialno = ike->sa.st_serialno;
+	if (v2_msg_role(md) == MESSAGE_REQUEST) {
+		/* already decrypted */
+		dbg_v2_msgid(ike, "processing held request %jd", (intmax_t)md->hdr.isa_msgid);
+		process_protected_v2_message(ike, md);
+	} else {
+		dbg_v2_msgid(ike, "processing held response %jd", (intmax_t)md->hdr.isa_msgid);
+		ikev2_process_packet(md);
+	}
+	md_delref(&md);
+
+	/* danger: processing may have deleted the IKE SA */
+	ike = ike_sa_by_serialno(serialno);
+	if (ike != NULL) {
+		schedule_held_message(ike);
+	}
+}
+
+/*
+ * RFC 7296 2.3:
+ *
+ *   The window size is normally a (possibly configurable) property
+ *   of a particular implementation, and is not related to congestion
+ *   control [...]  An endpoint MUST NOT exceed the peer's stated
+ *   window size for transmitted IKE requests.
+ */
+
+bool emit_v2N_SET_WINDOW_SIZE(struct ike_sa *ike, struct pbs_out *pbs)
+{
+	msgid_t window = ike->sa.st_connection->config->ike_window;
+	if (window <= 1) {
+		/* the default */
+		return true;
+	}
+	uint32_t nwindow = htonl(window);
+	if (!emit_v2N_bytes(v2N_SET_WINDOW_SIZE, &nwindow, sizeof(nwindow), pbs)) {
+		return false;
+	}
+	/* the peer can now overlap requests */
+	ike->sa.st_v2_msgid_windows.local_window = window;
+	if (initiator_window(ike) > 1) {
+		alloc_overlap(ike);
+	}
+	return true;
+}
+
+void process_v2N_SET_WINDOW_SIZE(struct ike_sa *ike, const struct msg_digest *md)
+{
+	const struct payload_digest *pd = md->pd[PD_v2N_SET_WINDOW_SIZE];
+	if (pd == NULL) {
+		return;
+	}
+
+	struct pbs_in pbs = pd->pbs;
+	shunk_t data = pbs_in_left(&pbs);
+	uint32_t nwindow;
+	if (data.len != sizeof(nwindow)) {
+		llog_sa(RC_LOG, ike,
+			"ignoring SET_WINDOW_SIZE notification containing %zu bytes",
+			data.len);
+		return;
+	}
+	memcpy(&nwindow, data.ptr, sizeof(nwindow));
+	uint32_t window = ntohl(nwindow);
+	if (window == 0) {
+		llog_sa(RC_LOG, ike, "ignoring SET_WINDOW_SIZE notification containing 0");
+		return;
+	}
+
+	ike->sa.st_v2_msgid_windows.peer_window = window;
+	intmax_t overlap = initiator_window(ike);
+	ldbg(ike->sa.logger, "peer window is %"PRIu32"; sending up to %jd requests",
+	     window, overlap);
+	if (overlap > 1) {
+		alloc_overlap(ike);
+	}
+}
+
 /*
  * Maintain or reset Message IDs.
  *
@@ -229,6 +805,7 @@ static void dbg_msgid_update(const char *what,
 void v2_msgid_init_ike(struct ike_sa *ike)
 {
 	const monotime_t now = mononow();
+	free_overlap(&ike->sa.st_v2_msgid_windows.overlap, ike->sa.logger);
 	const struct v2_msgid_windows old = ike->sa.st_v2_msgid_windows;
 	struct v2_msgid_windows *new = &ike->sa.st_v2_msgid_windows;
 	*new = empty_v2_msgid_windows;
@@ -253,6 +830,15 @@ void v2_msgid_start_record_n_send(struct ike_sa *ike, const struct v2_exchange *
 	intmax_t msgid = new->initiator.recv = old.initiator.sent;
 	new->initiator.wip = msgid + 1;
 	new->initiator.exchange = exchange;
+	/*
+	 * Any overlapping requests are also abandoned.
+	 */
+	if (new->overlap != NULL) {
+		FOR_EACH_ELEMENT(inflight, new->overlap->inflight) {
+			discard_inflight(inflight, ike->sa.logger);
+		}
+		new->overlap->active = -1;
+	}
 	dbg_msgid_update("initiator record'n'send", NO_MESSAGE, msgid, ike, &old);
 }
 
@@ -272,7 +858,11 @@ void v2_msgid_start(struct ike_sa *ike,
 	{
 		update_story = "initiator starting";
 		msgid = old.initiator.sent + 1;
-		pexpect_v2_msgid(old.initiator.recv+1 == msgid);
+		if (v2_msgid_overlapping_requests(ike)) {
+			pexpect_v2_msgid(old.initiator.recv < msgid);
+		} else {
+			pexpect_v2_msgid(old.initiator.recv+1 == msgid);
+		}
 		pexpect_v2_msgid(old.initiator.sent+1 == msgid);
 		pexpect_v2_msgid(old.initiator.wip == -1);
 		pexpect_v2_msgid(old.initiator.exchange == NULL);
@@ -290,6 +880,10 @@ void v2_msgid_start(struct ike_sa *ike,
 		pexpect_v2_msgid(old.responder.wip == -1);
 		pexpect_v2_msgid(old.responder.sent+1 == msgid);
 		pexpect_v2_msgid(old.responder.recv+1 == msgid);
+		if (ike->sa.st_v2_msgid_windows.local_window > 1) {
+			/* keep the last response for retransmits */
+			record_last_response(ike);
+		}
 		new->responder.wip = msgid;
 		event_schedule(EVENT_v2_TIMEOUT_RESPONDER, EVENT_CRYPTO_TIMEOUT_DELAY, &ike->sa);
 		break;
@@ -299,8 +893,13 @@ void v2_msgid_start(struct ike_sa *ike,
 		update_story = "initiator starting";
 		msgid = md->hdr.isa_msgid;
 		pexpect_v2_msgid(old.initiator.wip == -1);
-		pexpect_v2_msgid(old.initiator.sent == msgid);
-		pexpect_v2_msgid(old.initiator.recv+1 == msgid);
+		if (v2_msgid_overlapping_requests(ike)) {
+			pexpect_v2_msgid(old.initiator.sent >= msgid);
+			pexpect_v2_msgid(old.initiator.recv < msgid);
+		} else {
+			pexpect_v2_msgid(old.initiator.sent == msgid);
+			pexpect_v2_msgid(old.initiator.recv+1 == msgid);
+		}
 		pexpect_v2_msgid(old.initiator.exchange != NULL);
 		new->initiator.wip = msgid;
 		event_schedule(EVENT_v2_TIMEOUT_RESPONSE, EVENT_CRYPTO_TIMEOUT_DELAY, &ike->sa);
@@ -364,6 +963,10 @@ void v2_msgid_finish(struct ike_sa *ike, const struct msg_digest *md, where_t wh
 		update = &new->initiator;
 		new->initiator.wip = -1;
 		new->initiator.sent = msgid;
+		if (v2_msgid_overlapping_requests(ike)) {
+			/* parked when the next request is initiated */
+			new->overlap->active = msgid;
+		}
 		if (ike->sa.st_v2_retransmit_event == NULL) {
 			dbg_v2_msgid(ike, "scheduling EVENT_RETRANSMIT");
 			start_retransmits(&ike->sa);
@@ -424,6 +1027,22 @@ void v2_msgid_finish(struct ike_sa *ike, const struct msg_digest *md, where_t wh
 		dbg_v2_msgid(ike, "clearing EVENT_RETRANSMIT as response received");
 		clear_retransmits(&ike->sa);
 		event_delete(EVENT_v2_TIMEOUT_RESPONSE, &ike->sa);
+		/*
+		 * With overlapping requests, .recv only advances to
+		 * just below the oldest request still waiting on a
+		 * response; and they still need retransmitting.
+		 */
+		if (new->overlap != NULL && new->overlap->active >= 0) {
+			new->overlap->active = -1;
+			new->initiator.recv = inflight_floor(new->overlap, new->initiator.sent);
+			if (requests_inflight(new->overlap)) {
+				free_v2_outgoing_fragments(&new->initiator.outgoing_fragments,
+							   ike->sa.logger);
+				new->initiator.outgoing_fragments = NULL;
+				dbg_v2_msgid(ike, "restarting EVENT_RETRANSMIT for overlapping requests");
+				start_retransmits(&ike->sa);
+			}
+		}
 		break;
 	}
 	default:
@@ -433,6 +1052,7 @@ void v2_msgid_finish(struct ike_sa *ike, const struct msg_digest *md, where_t wh
 	/* should be backdated to when the message arrives? */
 	new->last_recv = update->last_recv = mononow(); /* close enough */
 	dbg_msgid_update(update_story, role, msgid, ike, &old);
+	replicate_v2_msgid(ike);
 }
 
 struct v2_msgid_pending {
@@ -451,6 +1071,7 @@ void v2_msgid_free(struct state *st)
 		*pp = tbd->next;
 		pfree(tbd);
 	}
+	free_overlap(&st->st_v2_msgid_windows.overlap, st->logger);
 }
 
 bool v2_msgid_request_outstanding(struct ike_sa *ike)
@@ -563,10 +1184,33 @@ static void initiate_next(const char *story, struct state *ike_sa, void *context
 
 	struct v2_msgid_window *initiator = &ike->sa.st_v2_msgid_windows.initiator;
 	for (intmax_t unack = (initiator->sent - initiator->recv);
-	     unack < ike->sa.st_connection->config->ike_window
+	     unack < initiator_window(ike)
 		     && ike->sa.st_v2_msgid_windows.pending_requests != NULL;
 	     unack++) {
 
+		/*
+		 * An overlapping request (RFC 7296 2.3) needs the
+		 * initiator to be idle (not sending or processing),
+		 * and all the exchanges to be ones that can overlap.
+		 * Once the current work finishes this is called
+		 * again.
+		 */
+		if (unack > 0) {
+			const struct v2_exchange *exchange =
+				ike->sa.st_v2_msgid_windows.pending_requests->exchange;
+			if (initiator->wip != -1) {
+				dbg_v2_msgid(ike, "overlapping %s blocked by work-in-progress (unack %jd)",
+					     exchange->name, unack);
+				return;
+			}
+			if (!can_overlap(ike, exchange)) {
+				dbg_v2_msgid(ike, "%s can not overlap outstanding requests (unack %jd)",
+					     exchange->name, unack);
+				return;
+			}
+			park_active_request(ike);
+		}
+
 		/*
 		 * Make an on-stack copy of the pending exchange, and
 		 * then release the allocated memory.
@@ -641,6 +1285,10 @@ void v2_msgid_schedule_next_initiator(struct ike_sa *ike)
 {
 	const struct v2_msgid_window *initiator = &ike->sa.st_v2_msgid_windows.initiator;
 	const struct v2_msgid_pending *pending = ike->sa.st_v2_msgid_windows.pending_requests;
+	/*
+	 * Messages that arrived while busy go first.
+	 */
+	schedule_held_message(ike);
 	/*
 	 * If there appears to be space and there's a pending
 	 * initiate, poke the IKE SA so it tries to initiate things.
@@ -648,7 +1296,7 @@ void v2_msgid_schedule_next_initiator(struct ike_sa *ike)
 	if (pending != NULL) {
 		/* if this returns NULL, that's ok; will log "LOST" */
 		intmax_t unack = (initiator->sent - initiator->recv);
-		if (unack < ike->sa.st_connection->config->ike_window) {
+		if (unack < initiator_window(ike)) {
 			dbg_v2_msgid(ike,
 				     "wakeing IKE SA for next initiator "PRI_SO", (unack %jd)",
 				     pri_so(pending->who_for), unack);
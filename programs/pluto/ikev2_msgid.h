@@ -24,6 +24,7 @@
 struct state;
 struct ike_sa;
 struct msg_digest;
+struct pbs_out;
 struct v2_transition;
 struct v2_transitions;
 struct v2_exchange;
@@ -116,6 +117,18 @@ struct v2_msgid_windows {
 	struct v2_msgid_window initiator;
 	struct v2_msgid_window responder;
 	struct v2_msgid_pending *pending_requests;
+	/*
+	 * RFC 7296 2.3.  Window Size for Overlapping Requests.
+	 *
+	 * .local_window is what this end sent in its SET_WINDOW_SIZE
+	 * notification, and .peer_window is from the peer's (1 when
+	 * there was none, as with a rekeyed IKE SA).  When either is
+	 * larger than one, .overlap tracks the additional outstanding
+	 * requests, recorded responses, and early requests.
+	 */
+	intmax_t local_window;
+	intmax_t peer_window;
+	struct v2_msgid_overlap *overlap;
 };
 
 void v2_msgid_init_ike(struct ike_sa *ike);
@@ -124,6 +137,50 @@ void v2_msgid_free(struct state *st);
 bool v2_msgid_request_outstanding(struct ike_sa *ike);
 bool v2_msgid_request_pending(struct ike_sa *ike);
 
+/*
+ * RFC 7296 2.3 SET_WINDOW_SIZE, sent and received during IKE_AUTH.
+ */
+
+bool emit_v2N_SET_WINDOW_SIZE(struct ike_sa *ike, struct pbs_out *pbs);
+void process_v2N_SET_WINDOW_SIZE(struct ike_sa *ike, const struct msg_digest *md);
+
+/*
+ * With a window larger than one, a request can arrive while the
+ * responder is still busy with an earlier request, and a response
+ * can be for any of the outstanding requests.
+ *
+ * v2_msgid_drop_early_request(), called before the request is
+ * decrypted, returns true when the request is too early to ever be
+ * held (it is outside of the window, or a fragment).
+ *
+ * v2_msgid_hold_request(), called once the request has been
+ * decrypted and so is known to be from the peer, returns true when
+ * the request was held (to be processed once the responder catches
+ * up).
+ *
+ * v2_msgid_load_response() returns true when the response's request
+ * was loaded into the initiator window ready for processing, and
+ * false when the response was held or dropped.
+ *
+ * v2_msgid_recorded_response() returns the response previously sent
+ * for MSGID (if it is still within the window) so that it can be
+ * retransmitted.
+ */
+
+bool v2_msgid_overlapping_requests(struct ike_sa *ike);
+bool v2_msgid_drop_early_request(struct ike_sa *ike, const struct msg_digest *md);
+bool v2_msgid_hold_request(struct ike_sa *ike, struct msg_digest *md);
+bool v2_msgid_load_response(struct ike_sa *ike, struct msg_digest *md);
+struct v2_outgoing_fragments *v2_msgid_recorded_response(struct ike_sa *ike, intmax_t msgid,
+							 unsigned *recv_frags);
+
+/*
+ * Retransmit the requests parked in the window; returns one of them
+ * (for logging) or NULL.
+ */
+struct v2_outgoing_fragments *v2_msgid_inflight_request(struct ike_sa *ike);
+void v2_msgid_retransmit_inflight(struct ike_sa *ike);
+
 /*
  * Processing has finished - recv's accepted or sent is on its way -
  * update window.{recv,sent} and wip.{initiator,responder}.
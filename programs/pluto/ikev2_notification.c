@@ -70,6 +70,7 @@ enum v2_pd v2_pd_from_notification(v2_notification_t n)
 	C(REDIRECTED_FROM);
 	C(REDIRECT_SUPPORTED);
 	C(REKEY_SA);
+	C(SET_WINDOW_SIZE);
 	C(SIGNATURE_HASH_ALGORITHMS);
 	C(SINGLE_PAIR_REQUIRED);
 	C(TS_UNACCEPTABLE);
@@ -96,6 +96,7 @@
 #include "ikev2_child.h"
 #include "ikev2_create_child_sa.h"	/* for ikev2_rekey_ike_start() */
 #include "rekeyfuzz.h"
+#include "rekey_smoothing.h"
 #include "ikev2_ike_sa_init.h"		/* for initiate_v2_IKE_SA_INIT_request() */
 #include "ikev2_states.h"
 
@@ -377,7 +378,14 @@ void schedule_v2_replace_event(struct state *st)
 			rekey_delay = lifetime;
 			marg = deltatime(0);
 		}
-		st->st_replace_margin = marg;
+
+		/*
+		 * Avoid seconds that already have their share of
+		 * rekeys, by moving this one earlier (by at most the
+		 * margin again).
+		 */
+		rekey_delay = smooth_rekey_delay(rekey_delay, marg, st->logger);
+		st->st_replace_margin = deltatime_sub(lifetime, rekey_delay);
 
 		/* Time to rekey/reauth; scheduled once during a state's lifetime.*/
 		deltatime_buf rdb, lb;
@@ -387,6 +395,8 @@ void schedule_v2_replace_event(struct state *st)
 		     str_deltatime(lifetime, &lb));
 		event_schedule(EVENT_v2_REKEY, rekey_delay, st);
 		pexpect(st->st_v2_rekey_event->ev_type == EVENT_v2_REKEY);
+		st->st_v2_rekey_event->ev_rekey_booked =
+			book_rekey(st->st_v2_rekey_event->ev_time);
 		story = "attempting re-key";
 
 		kind = EVENT_v2_REPLACE;
@@ -43,6 +43,7 @@
 #include "ikev2_notification.h"
 #include "show.h"
 #include "ddos.h"
+#include "redirect_load.h"
 
 static emit_v2_INFORMATIONAL_request_payload_fn add_redirect_payload; /* type check */
 
@@ -50,6 +51,13 @@ static enum global_redirect global_redirect; /* see config_setup.[hc] and init_g
 
 static struct redirect_dests global_dests = {0};
 
+/*
+ * Smooth weighted round-robin: each pick adds each destination's
+ * weight to its credit, picks the destination with the most credit,
+ * and then charges it the total; parallel to global_dests.splits.
+ */
+static intmax_t *global_dest_credit;
+
 static const char *global_redirect_to(void)
 {
 	if (global_dests.whole == NULL)
@@ -67,6 +75,7 @@ void free_redirect_dests(struct redirect_dests *dests)
 void free_global_redirect_dests(void)
 {
 	free_redirect_dests(&global_dests);
+	pfreeany(global_dest_credit);
 }
 
 bool set_redirect_dests(const char *rd_str, struct redirect_dests *dests)
@@ -96,7 +105,13 @@ bool set_redirect_dests(const char *rd_str, struct redirect_dests *dests)
 
 static bool set_global_redirect_dests(const char *grd_str)
 {
-	return set_redirect_dests(grd_str, &global_dests);
+	pfreeany(global_dest_credit);
+	if (!set_redirect_dests(grd_str, &global_dests)) {
+		return false;
+	}
+	global_dest_credit = alloc_things(intmax_t, global_dests.splits->len,
+					  "global redirect credit");
+	return true;
 }
 
 /*
@@ -115,6 +130,37 @@ shunk_t next_redirect_dest(struct redirect_dests *rl)
 	return rl->splits->item[rl->next++];
 }
 
+/*
+ * When the cluster members are exchanging load, favour those with
+ * the most spare capacity.  Should none have any, fall back to
+ * round-robin.
+ */
+
+static shunk_t next_global_redirect_dest(void)
+{
+	if (!redirect_load_weighted()) {
+		return next_redirect_dest(&global_dests);
+	}
+
+	intmax_t total = 0;
+	unsigned best = 0;
+	for (unsigned d = 0; d < global_dests.splits->len; d++) {
+		unsigned weight = redirect_dest_weight(global_dests.splits->item[d]);
+		global_dest_credit[d] += weight;
+		total += weight;
+		if (global_dest_credit[d] > global_dest_credit[best]) {
+			best = d;
+		}
+	}
+
+	if (total == 0) {
+		return next_redirect_dest(&global_dests);
+	}
+
+	global_dest_credit[best] -= total;
+	return global_dests.splits->item[best];
+}
+
 /*
  * Structure of REDIRECT Notify payload from RFC 5685.
  * The second part (Notification data) is interesting to us.
@@ -249,7 +295,9 @@ bool redirect_global(struct msg_digest *md)
 
 	/* if we don't support global redirection, no need to continue */
 	if (global_redirect == GLOBAL_REDIRECT_NO ||
-	    (global_redirect == GLOBAL_REDIRECT_AUTO && !require_ddos_cookies()))
+	    (global_redirect == GLOBAL_REDIRECT_AUTO &&
+	     !require_ddos_cookies() &&
+	     !redirect_load_exceeded()))
 		return false;
 
 	/*
@@ -280,7 +328,7 @@ bool redirect_global(struct msg_digest *md)
 		return true;
 	}
 
-	shunk_t dest = next_redirect_dest(&global_dests);
+	shunk_t dest = next_global_redirect_dest();
 	if (dest.len == 0) {
 		ldbg(logger, "no (meaningful) destination for global redirection has been specified");
 		pstats_ikev2_redirect_failed++;
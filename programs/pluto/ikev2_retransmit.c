@@ -36,6 +36,7 @@
 #include "routing.h"
 #include "revival.h"
 #include "terminate.h"
+#include "ikev2_msgid.h"
 
 /*
  * XXX: it is the IKE SA that is responsible for all retransmits.
@@ -88,6 +89,10 @@ void event_v2_retransmit(struct state *ike_sa, monotime_t now UNUSED)
 
 	struct v2_outgoing_fragments *fragments =
 		ike->sa.st_v2_msgid_windows.initiator.outgoing_fragments;
+	if (fragments == NULL) {
+		/* overlapping requests; the last response was processed */
+		fragments = v2_msgid_inflight_request(ike);
+	}
 	if (fragments == NULL) {
 		llog_pexpect(ike->sa.logger, HERE, "no fragments to send");
 		return;
@@ -99,7 +104,10 @@ void event_v2_retransmit(struct state *ike_sa, monotime_t now UNUSED)
 	switch (retransmit_action) {
 
 	case RETRANSMIT_YES:
-		send_recorded_v2_message(ike, fragments);
+		if (ike->sa.st_v2_msgid_windows.initiator.outgoing_fragments != NULL) {
+			send_recorded_v2_message(ike, ike->sa.st_v2_msgid_windows.initiator.outgoing_fragments);
+		}
+		v2_msgid_retransmit_inflight(ike);
 		return;
 
 	case RETRANSMIT_NO:
@@ -375,8 +375,8 @@ static void drip_inbound(const struct message *m, struct logger *logger)
 static void drip_outbound(const struct message *m, struct logger *logger)
 {
 	const struct iface_endpoint *interface = m->outbound.interface;
-	ssize_t wlen = interface->io->write_packet(interface,
-						   HUNK_AS_SHUNK(&m->body),
+	shunk_t body = HUNK_AS_SHUNK(&m->body);
+	ssize_t wlen = interface->io->write_packet(interface, &body, 1,
 						   &m->outbound.endpoint,
 						   logger);
 	if (wlen != (ssize_t)m->body.len) {
@@ -44,6 +44,7 @@
 #include "terminate.h"
 #include "ikev2_ike_session_resume.h"
 #include "ddos.h"
+#include "pacer.h"
 
 static bool initiate_connection_1_basics(struct connection *c,
 					 const char *remote_host,
@@ -107,6 +108,16 @@ static bool initiate_connection_1_basics(struct connection *c,
 		return false;
 	}
 
+	/*
+	 * auto=start after a warm restart re-adopted the Child SA;
+	 * don't negotiate a duplicate.
+	 */
+	struct child_sa *established = child_sa_by_serialno(c->established_child_sa);
+	if (background && established != NULL && established->sa.st_restored) {
+		llog(RC_LOG, c->logger, "already established by warm-restart");
+		return true;
+	}
+
 	threadtime_t inception = threadtime_start();
 	return initiate_connection_2_address(c, remote_host, background, inception);
 }
@@ -361,6 +372,14 @@ void initiate(struct connection *c,
 
 	if (ike == NULL) {
 
+		/*
+		 * Background initiates may need to wait their turn.
+		 */
+		if (!pace_initiate(c, policy, inception, sec_label,
+				   detach_whack, initiated_by, logger)) {
+			return;
+		}
+
 		/*
 		 * When overloaded constrain things to
 		 * non-opportunistic connections
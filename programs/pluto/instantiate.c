@@ -78,9 +78,15 @@ static struct connection *duplicate_connection(const char *name, struct connecti
 
 	c->iface = iface_addref(t->iface);
 
-	c->local->host.id = clone_id(&t->local->host.id, "unshare local connection id");
-	c->remote->host.id = clone_id((peer_id != NULL ? peer_id : &t->remote->host.id),
-				      "unshare remote connection id");
+	/*
+	 * Instances borrow the template's IDs (C holds a reference
+	 * to T so they out-live C); only a PEER_ID is copied.  When
+	 * the remote ID is later updated, replace_connection_that_id()
+	 * allocates a private copy.
+	 */
+	c->local->host.id = share_id(&t->local->host.id);
+	c->remote->host.id = (peer_id != NULL ? clone_id(peer_id, "unshare remote connection id") :
+			      share_id(&t->remote->host.id));
 
 	FOR_EACH_THING(end, LEFT_END, RIGHT_END) {
 		struct host_end *ce = &c->end[end].host;
@@ -305,7 +311,7 @@ static struct connection *instantiate(struct connection *t,
 
 	struct connection *d = duplicate_connection(t->base_name, t, peer_id, where);
 	PASSERT(d->logger, !streq(t->name, d->name));
-	PASSERT(d->logger, t->base_name != d->base_name); /* see duplicate_connection() */
+	PASSERT(d->logger, t->base_name == d->base_name); /* see alloc_connection() */
 
 	d->local->kind = d->remote->kind =
 		(is_labeled_template(t) ? CK_LABELED_PARENT :
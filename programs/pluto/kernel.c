@@ -86,6 +86,7 @@
 #include "updown.h"
 #include "pending.h"
 #include "terminate.h"
+#include "checkpoint.h"		/* for checkpoint_has_child_sas() */
 
 static deltatime_t pluto_expire_shunt_interval; /* see plutomain.c & config_setup.[hc] */
 static deltatime_t pluto_shunt_lifetime; /* see plutomain.c and config_setup.[hc] */
@@ -407,6 +408,29 @@ ipsec_spi_t get_ipsec_spi(const struct connection *c,
 					"SPI", logger);
 }
 
+/*
+ * Reserve exactly SPI (network order), for instance for an SA
+ * replicated from another pluto.  Returns false when it is taken.
+ */
+bool reserve_ipsec_spi(const struct connection *c,
+		       const struct ip_protocol *proto,
+		       ipsec_spi_t spi,
+		       struct logger *logger)
+{
+	passert(proto == &ip_protocol_ah || proto == &ip_protocol_esp);
+	if (kernel_ops->get_ipsec_spi == NULL) {
+		/* the SA is added, not updated */
+		return true;
+	}
+	return (kernel_ops_get_ipsec_spi(0,
+					 /*src*/&c->remote->host.addr,
+					 /*dst*/&c->local->host.addr,
+					 proto,
+					 get_proto_reqid(c->child.reqid, proto, logger),
+					 ntohl(spi), ntohl(spi),
+					 "reserved SPI", logger) == spi);
+}
+
 /* Generate Unique CPI numbers.
  * The result is returned as an SPI (4 bytes) in network order!
  * The real bits are in the nework-low-order 2 bytes.
@@ -1213,7 +1237,9 @@ static bool setup_half_kernel_state(struct child_sa *child, enum direction direc
 	/* Build an inbound or outbound SA */
 
 	struct connection *c = child->sa.st_connection;
-	bool replace = (direction == DIRECTION_INBOUND && (kernel_ops->get_ipsec_spi != NULL));
+	/* a restored SA is already in the kernel; update it in place */
+	bool replace = (child->sa.st_restored ||
+			(direction == DIRECTION_INBOUND && (kernel_ops->get_ipsec_spi != NULL)));
 
 	/* SPIs, saved for spigrouping or undoing, if necessary */
 	struct kernel_state said[EM_MAXRELSPIS];
@@ -2447,7 +2473,14 @@ void init_kernel(const struct config_setup *oco, struct logger *logger)
 	PASSERT(logger, kernel_ops->poke_holes != NULL);
 
 	kernel_ops->init(logger);
-	kernel_ops->flush(logger);
+	if (kernel_ops->flush_policies != NULL &&
+	    checkpoint_has_child_sas()) {
+		/* leave the IPsec SAs for the checkpoint to re-adopt */
+		llog(RC_LOG, logger, "warm-restart: keeping kernel IPsec SAs");
+		kernel_ops->flush_policies(logger);
+	} else {
+		kernel_ops->flush(logger);
+	}
 	/* after flush, else they get flushed! */
 	kernel_ops->poke_holes(logger);
 
@@ -233,6 +233,7 @@ struct kernel_ops {
 
 	void (*init)(struct logger *logger);
 	void (*flush)(struct logger *logger);
+	void (*flush_policies)(struct logger *logger);	/* optional; leaves SAs */
 	void (*poke_holes)(struct logger *logger);
 	void (*plug_holes)(struct logger *logger);
 	void (*shutdown)(struct logger *logger);
@@ -360,6 +361,10 @@ extern ipsec_spi_t get_ipsec_spi(const struct connection *c,
 				 struct logger *logger/*state*/);
 extern ipsec_spi_t get_ipsec_cpi(const struct connection *c,
 				 struct logger *logger/*state*/);
+bool reserve_ipsec_spi(const struct connection *c,
+		       const struct ip_protocol *proto,
+		       ipsec_spi_t spi,
+		       struct logger *logger/*state*/);
 
 bool unrouted_to_routed(struct connection *c, enum routing new_routing, where_t where);
 
@@ -37,6 +37,8 @@
 
 /* system headers */
 
+#define _GNU_SOURCE		/* for recvmmsg() */
+
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
@@ -115,6 +117,8 @@
 #include "sparse_names.h"
 #include "kernel_iface.h"
 #include "rnd.h" /* for get_rnd_bytes() */
+#include "log_limiter.h"
+#include "timer.h"		/* for schedule_oneshot_timer() */
 
 static void netlink_process_xfrm_messages(int fd, void *arg, struct logger *logger);
 static void netlink_process_rtm_messages(int fd, void *arg, struct logger *logger);
@@ -427,7 +431,7 @@ static void kernel_xfrm_init(struct logger *logger)
 	}
 }
 
-static void kernel_xfrm_flush(struct logger *logger)
+static void kernel_xfrm_flush_policies(struct logger *logger)
 {
 	struct nlm_resp rsp;
 	int recv_errno;
@@ -440,6 +444,14 @@ static void kernel_xfrm_flush(struct logger *logger)
 	sendrecv_xfrm_msg(&policy, NLMSG_ERROR, &rsp,
 			  "flush", "policy",
 			  &recv_errno, logger);
+}
+
+static void kernel_xfrm_flush(struct logger *logger)
+{
+	struct nlm_resp rsp;
+	int recv_errno;
+
+	kernel_xfrm_flush_policies(logger);
 
 	struct {
 		struct nlmsghdr n;
@@ -2168,6 +2180,204 @@ static const void *nlmsg_data(struct nlmsghdr *n, size_t size, struct logger *lo
 	return NLMSG_DATA(n);
 }
 
+static bool sec_label_from_xfrm(const struct xfrm_user_sec_ctx *xuctx,
+				shunk_t *sec_label,
+				struct logger *logger)
+{
+	/* length of text of label */
+	size_t len = xuctx->ctx_len;
+
+	ldbg(logger, "... xfrm xuctx: exttype=%d, len=%d, ctx_doi=%d, ctx_alg=%d, ctx_len=%zu",
+	     xuctx->exttype, xuctx->len,
+	     xuctx->ctx_doi, xuctx->ctx_alg,
+	     len);
+
+	if (xuctx->ctx_doi != XFRM_SC_DOI_LSM) {
+		llog(RC_LOG, logger,
+		     "Acquire message for unknown sec_label DOI %d; ignoring Acquire message",
+		     xuctx->ctx_doi);
+		return false;
+	}
+	if (xuctx->ctx_alg != XFRM_SC_ALG_SELINUX) {
+		llog(RC_LOG, logger,
+		     "Acquire message for unknown sec_label LSM %d; ignoring Acquire message",
+		     xuctx->ctx_alg);
+		return false;
+	}
+
+	/*
+	 * note: xuctx + 1 is tricky:
+	 * first byte after header
+	 */
+	*sec_label = shunk2(xuctx + 1, len);
+
+	err_t ugh = vet_seclabel(*sec_label);
+	if (ugh != NULL) {
+		llog(RC_LOG, logger,
+		     "received bad %s; ignoring Acquire message", ugh);
+		return false;
+	}
+
+	ldbg(logger, "%s() xuctx security context value: %.*s",
+	     __func__, (int)len,
+	     (const char *) (xuctx + 1));
+	return true;
+}
+
+/*
+ * Acquires are not acted on immediately.  Instead they are coalesced
+ * and then queued, and the queue is drained from a callback a few at
+ * a time.
+ *
+ * When the first packet of many flows hits a trap policy, the kernel
+ * can broadcast a burst of acquires, including repeats for the same
+ * selector pair (for instance when the larval state expires, or after
+ * a resync, below).  Initiating each one inline would stall the event
+ * loop for the entire burst and leave the netlink socket to overflow.
+ *
+ * Repeats of the same packet (selector pair) and sec_label seen within
+ * XFRM_ACQUIRE_COALESCE are dropped.  When the queue is full the
+ * acquire is dropped; the kernel will send another once its larval
+ * state expires.
+ */
+
+#define XFRM_ACQUIRE_QUEUE_SIZE 256
+#define XFRM_ACQUIRE_DRAIN_BATCH 32
+#define XFRM_ACQUIRE_RECENT 64
+#define XFRM_ACQUIRE_COALESCE deltatime(1)
+
+struct xfrm_acquire {
+	ip_packet packet;
+	chunk_t sec_label;
+	enum kernel_state_id state_id;
+	enum kernel_policy_id policy_id;
+};
+
+static struct {
+	struct xfrm_acquire queue[XFRM_ACQUIRE_QUEUE_SIZE];
+	unsigned head;
+	unsigned count;
+	bool drain_scheduled;
+	uintmax_t dropped;
+	struct {
+		ip_packet packet;
+		chunk_t sec_label;
+		monotime_t time;
+	} recent[XFRM_ACQUIRE_RECENT];
+	unsigned next_recent;
+	uint32_t last_seq;	/* of most recent kernel acquire */
+} xfrm_acquires;
+
+static bool same_acquire_packet(const ip_packet *l, const ip_packet *r)
+{
+	return (l->ip.version == r->ip.version &&
+		l->ipproto == r->ipproto &&
+		l->src.hport == r->src.hport &&
+		l->dst.hport == r->dst.hport &&
+		thingeq(l->src.bytes, r->src.bytes) &&
+		thingeq(l->dst.bytes, r->dst.bytes));
+}
+
+static bool recent_xfrm_acquire(const struct kernel_acquire *b)
+{
+	monotime_t now = mononow();
+	monotime_t cutoff = monotime_sub(now, XFRM_ACQUIRE_COALESCE);
+
+	FOR_EACH_ELEMENT(r, xfrm_acquires.recent) {
+		if (!r->packet.ip.is_set ||
+		    monotime_cmp(r->time, <, cutoff)) {
+			continue;
+		}
+		if (same_acquire_packet(&r->packet, &b->packet) &&
+		    hunk_eq(r->sec_label, b->sec_label)) {
+			return true;
+		}
+	}
+
+	/* remember it, replacing the oldest */
+	unsigned i = xfrm_acquires.next_recent++ % elemsof(xfrm_acquires.recent);
+	free_chunk_content(&xfrm_acquires.recent[i].sec_label);
+	xfrm_acquires.recent[i].packet = b->packet;
+	xfrm_acquires.recent[i].sec_label = clone_hunk_as_chunk(&b->sec_label, "recent acquire sec_label");
+	xfrm_acquires.recent[i].time = now;
+	return false;
+}
+
+static callback_cb drain_xfrm_acquires;	/* type assertion */
+
+static void drain_xfrm_acquires(const char *story UNUSED,
+				struct state *st UNUSED,
+				void *context UNUSED)
+{
+	struct logger *logger = &global_logger;
+	xfrm_acquires.drain_scheduled = false;
+
+	for (unsigned n = 0;
+	     n < XFRM_ACQUIRE_DRAIN_BATCH && xfrm_acquires.count > 0;
+	     n++) {
+		struct xfrm_acquire *a = &xfrm_acquires.queue[xfrm_acquires.head];
+		xfrm_acquires.head = (xfrm_acquires.head + 1) % elemsof(xfrm_acquires.queue);
+		xfrm_acquires.count--;
+
+		struct kernel_acquire b = {
+			.packet = a->packet,
+			.by_acquire = true,
+			.logger = logger,
+			.background = true, /* no whack so doesn't matter */
+			.sec_label = HUNK_AS_SHUNK(&a->sec_label),
+			.state_id = a->state_id,
+			.policy_id = a->policy_id,
+		};
+		initiate_ondemand(&b);
+		free_chunk_content(&a->sec_label);
+	}
+
+	if (xfrm_acquires.count > 0) {
+		ldbg(logger, "%s() %u acquires still queued", __func__, xfrm_acquires.count);
+		xfrm_acquires.drain_scheduled = true;
+		schedule_callback("draining xfrm acquires", deltatime(0), SOS_NOBODY,
+				  drain_xfrm_acquires, NULL, logger);
+	}
+}
+
+static void queue_xfrm_acquire(const struct kernel_acquire *b, struct logger *logger)
+{
+	if (recent_xfrm_acquire(b)) {
+		LDBGP_JAMBUF(DBG_BASE, logger, buf) {
+			jam_string(buf, "coalescing repeated ");
+			jam_kernel_acquire(buf, b);
+		}
+		return;
+	}
+
+	if (xfrm_acquires.count >= elemsof(xfrm_acquires.queue)) {
+		xfrm_acquires.dropped++;
+		limited_llog(logger, XFRM_ACQUIRE_LOG_LIMITER,
+			     "kernel: acquire queue full, dropping acquire (%ju dropped in total)",
+			     xfrm_acquires.dropped);
+		return;
+	}
+
+	unsigned tail = (xfrm_acquires.head + xfrm_acquires.count) % elemsof(xfrm_acquires.queue);
+	xfrm_acquires.queue[tail] = (struct xfrm_acquire) {
+		.packet = b->packet,
+		.sec_label = clone_hunk_as_chunk(&b->sec_label, "queued acquire sec_label"),
+		.state_id = b->state_id,
+		.policy_id = b->policy_id,
+	};
+	xfrm_acquires.count++;
+	LDBGP_JAMBUF(DBG_BASE, logger, buf) {
+		jam(buf, "queued (%u in queue) ", xfrm_acquires.count);
+		jam_kernel_acquire(buf, b);
+	}
+
+	if (!xfrm_acquires.drain_scheduled) {
+		xfrm_acquires.drain_scheduled = true;
+		schedule_callback("draining xfrm acquires", deltatime(0), SOS_NOBODY,
+				  drain_xfrm_acquires, NULL, logger);
+	}
+}
+
 static void netlink_acquire(struct nlmsghdr *n, struct logger *logger)
 {
 	/*
@@ -2296,46 +2506,10 @@ static void netlink_acquire(struct nlmsghdr *n, struct logger *logger)
 		}
 		case XFRMA_SEC_CTX:
 		{
-			struct xfrm_user_sec_ctx *xuctx = (struct xfrm_user_sec_ctx *) RTA_DATA(attr);
-			/* length of text of label */
-			size_t len = xuctx->ctx_len;
-
-			ldbg(logger, "... xfrm xuctx: exttype=%d, len=%d, ctx_doi=%d, ctx_alg=%d, ctx_len=%zu",
-			    xuctx->exttype, xuctx->len,
-			    xuctx->ctx_doi, xuctx->ctx_alg,
-			    len);
-
-			if (xuctx->ctx_doi != XFRM_SC_DOI_LSM) {
-				llog(RC_LOG, logger,
-				     "Acquire message for unknown sec_label DOI %d; ignoring Acquire message",
-				     xuctx->ctx_doi);
-				return;
-			}
-			if (xuctx->ctx_alg != XFRM_SC_ALG_SELINUX) {
-				llog(RC_LOG, logger,
-				     "Acquire message for unknown sec_label LSM %d; ignoring Acquire message",
-				     xuctx->ctx_alg);
-				return;
-			}
-
-			/*
-			 * note: xuctx + 1 is tricky:
-			 * first byte after header
-			 */
-			sec_label.ptr = (uint8_t *)(xuctx + 1);
-			sec_label.len = len;
-
-			err_t ugh = vet_seclabel(sec_label);
-
-			if (ugh != NULL) {
-				llog(RC_LOG, logger,
-					"received bad %s; ignoring Acquire message", ugh);
+			const struct xfrm_user_sec_ctx *xuctx = RTA_DATA(attr);
+			if (!sec_label_from_xfrm(xuctx, &sec_label, logger)) {
 				return;
 			}
-
-			ldbg(logger, "%s() xuctx security context value: %.*s",
-			     __func__, (int)len,
-			     (const char *) (xuctx + 1));
 			break;
 		}
 		default:
@@ -2357,7 +2531,8 @@ static void netlink_acquire(struct nlmsghdr *n, struct logger *logger)
 		.policy_id = acquire->policy.index,
 	};
 
-	initiate_ondemand(&b);
+	xfrm_acquires.last_seq = acquire->seq;
+	queue_xfrm_acquire(&b, logger);
 }
 
 static void netlink_shunt_expire(struct xfrm_userpolicy_info *pol,
@@ -2454,44 +2629,36 @@ static void process_addr_change(struct nlmsghdr *n, struct logger *logger)
 		rta = RTA_NEXT(rta, msg_size);
 	}
 }
-static void xfrm_kernel_sa_expire(struct nlmsghdr *n, struct logger *logger)
+static void xfrm_sa_expire(const struct xfrm_usersa_info *state, bool hard,
+			   struct logger *logger)
 {
-	struct xfrm_user_expire *ue = NLMSG_DATA(n);
-
-	if (n->nlmsg_len < NLMSG_LENGTH(sizeof(*ue))) {
-		llog(RC_LOG, logger,
-			"netlink_expire got message with length %zu < %zu bytes; ignore message",
-			(size_t) n->nlmsg_len, sizeof(*ue));
-		return;
-	}
-
-	const struct ip_info *afi = aftoinfo(ue->state.family);
+	const struct ip_info *afi = aftoinfo(state->family);
 	if (afi == NULL) {
 		llog(RC_LOG, logger,
 		     "kernel: XFRM_MSG_EXPIRE message malformed: family %u unknown",
-		     ue->state.family);
+		     state->family);
 		return;
 	}
 
-	ip_address src = address_from_xfrm(afi, &ue->state.saddr);
-	ip_address dst = address_from_xfrm(afi, &ue->state.id.daddr);
+	ip_address src = address_from_xfrm(afi, &state->saddr);
+	ip_address dst = address_from_xfrm(afi, &state->id.daddr);
 	address_buf srcb;
 	address_buf dstb;
-	ipsec_spi_t spi = ue->state.id.spi;
+	ipsec_spi_t spi = state->id.spi;
 	ldbg(logger, "%s() spi "PRI_IPSEC_SPI" src %s dst %s %s mode %u proto %d bytes %"PRIu64" packets %"PRIu64,
 	     __func__,
 	     pri_ipsec_spi(spi),
 	     str_address(&src, &srcb),
 	     str_address(&dst, &dstb),
-	     (ue->hard ? "hard" : "soft"),
-	     ue->state.mode,
-	     ue->state.id.proto,
+	     (hard ? "hard" : "soft"),
+	     state->mode,
+	     state->id.proto,
 	     /* XXX: on linux __u64 is either long, or long long
 	      * conflicting with either PRIu64 or %ll */
-	     (uint64_t) ue->state.curlft.bytes,
-	     (uint64_t) ue->state.curlft.packets);
+	     (uint64_t) state->curlft.bytes,
+	     (uint64_t) state->curlft.packets);
 
-	if (ue->hard) {
+	if (hard) {
 		if (impair.ignore_hard_expire) {
 			llog(RC_LOG, logger, "IMPAIR: suppressing a HARD EXPIRE event");
 			return;
@@ -2510,7 +2677,7 @@ static void xfrm_kernel_sa_expire(struct nlmsghdr *n, struct logger *logger)
 
 	/* convert IP protocol to IKE ID */
 	uint8_t protoid = PROTO_RESERVED;
-	switch (ue->state.id.proto) {
+	switch (state->id.proto) {
 	case  IPPROTO_ESP:
 		protoid = PROTO_IPSEC_ESP;
 		break;
@@ -2521,16 +2688,30 @@ static void xfrm_kernel_sa_expire(struct nlmsghdr *n, struct logger *logger)
 		protoid = PROTO_IPCOMP;
 		break;
 	default:
-		bad_case(ue->state.id.proto);
+		bad_case(state->id.proto);
 	}
 
 	handle_sa_expire(spi, protoid, dst,
-			 ue->hard, ue->state.curlft.bytes,
-			 ue->state.curlft.packets,
-			 ue->state.curlft.add_time,
+			 hard, state->curlft.bytes,
+			 state->curlft.packets,
+			 state->curlft.add_time,
 			 logger);
 }
 
+static void xfrm_kernel_sa_expire(struct nlmsghdr *n, struct logger *logger)
+{
+	struct xfrm_user_expire *ue = NLMSG_DATA(n);
+
+	if (n->nlmsg_len < NLMSG_LENGTH(sizeof(*ue))) {
+		llog(RC_LOG, logger,
+			"netlink_expire got message with length %zu < %zu bytes; ignore message",
+			(size_t) n->nlmsg_len, sizeof(*ue));
+		return;
+	}
+
+	xfrm_sa_expire(&ue->state, ue->hard, logger);
+}
+
 static void netlink_policy_expire(struct nlmsghdr *n, struct logger *logger)
 {
 	/*
@@ -2671,26 +2852,26 @@ static bool netlink_get(int fd,
 	return true;
 }
 
-static void netlink_xfrm_message_processor(struct nlm_resp *rsp, struct logger *logger)
+static void netlink_xfrm_message_processor(struct nlmsghdr *n, struct logger *logger)
 {
 	name_buf xfrmb;
 	ldbg(logger, "%s() got %s message with length %zu",
 	     __func__,
-	     str_sparse_long(&xfrm_type_names, rsp->n.nlmsg_type, &xfrmb),
-	     (size_t) rsp->n.nlmsg_len);
+	     str_sparse_long(&xfrm_type_names, n->nlmsg_type, &xfrmb),
+	     (size_t) n->nlmsg_len);
 
-	switch (rsp->n.nlmsg_type) {
+	switch (n->nlmsg_type) {
 
 	case XFRM_MSG_ACQUIRE:
-		netlink_acquire(&rsp->n, logger);
+		netlink_acquire(n, logger);
 		break;
 
 	case XFRM_MSG_EXPIRE: /* SA soft and hard limit */
-		xfrm_kernel_sa_expire(&rsp->n, logger);
+		xfrm_kernel_sa_expire(n, logger);
 		break;
 
 	case XFRM_MSG_POLEXPIRE:
-		netlink_policy_expire(&rsp->n, logger);
+		netlink_policy_expire(n, logger);
 		break;
 
 	default:
@@ -2725,10 +2906,375 @@ static void netlink_rtm_message_processor(struct nlm_resp *rsp, struct logger *l
 
 }
 
+/*
+ * Recover from an overflowed broadcast socket.
+ *
+ * When the kernel can't queue a broadcast it drops it and the next
+ * read fails with ENOBUFS; any number of acquires and expires have
+ * been lost.  Rebuild them from a dump of the kernel's SADB and then
+ * SPD:
+ *
+ * - a larval (SPI 0) state newer than the last acquire seen stands in
+ *   for an acquire that was lost (acquire sequence numbers only go
+ *   up)
+ *
+ * - a state at, or past, one of its lifetime limits stands in for an
+ *   expire that was lost (handle_sa_expire() ignores repeats)
+ *
+ * - an outbound policy at, or past, one of its lifetime limits stands
+ *   in for a policy expire that was lost (as with XFRM_MSG_POLEXPIRE,
+ *   a policy the kernel has already deleted is not acted on)
+ *
+ * The dumps are read from the event loop, a few datagrams at a time,
+ * so that a large SADB doesn't stall pluto.
+ */
+
+#define XFRM_RESYNC_BATCH 8
+
+static struct {
+	int fd;			/* -1 when idle */
+	struct fd_read_listener *listener;
+	uint32_t seq;
+	uint16_t dump;		/* XFRM_MSG_GETSA or XFRM_MSG_GETPOLICY */
+	unsigned entries;
+	bool again;		/* overflowed again during the dump */
+} xfrm_resync = {
+	.fd = -1,
+};
+
+static bool xfrm_lifetime_reached(const struct xfrm_lifetime_cfg *lft,
+				  const struct xfrm_lifetime_cur *cur,
+				  bool hard)
+{
+	uint64_t now = time(NULL);
+#define OVER(LIMIT, VALUE) ((LIMIT) != XFRM_INF && (VALUE) >= (LIMIT))
+#define AGED(SECONDS, SINCE) ((SECONDS) > 0 && (SINCE) > 0 && now >= (SINCE) + (SECONDS))
+	bool reached = (hard
+			? (OVER(lft->hard_byte_limit, cur->bytes) ||
+			   OVER(lft->hard_packet_limit, cur->packets) ||
+			   AGED(lft->hard_add_expires_seconds, cur->add_time) ||
+			   AGED(lft->hard_use_expires_seconds, cur->use_time))
+			: (OVER(lft->soft_byte_limit, cur->bytes) ||
+			   OVER(lft->soft_packet_limit, cur->packets) ||
+			   AGED(lft->soft_add_expires_seconds, cur->add_time) ||
+			   AGED(lft->soft_use_expires_seconds, cur->use_time)));
+#undef OVER
+#undef AGED
+	return reached;
+}
+
+static void xfrm_resync_sa(struct nlmsghdr *n, struct logger *logger)
+{
+	const struct xfrm_usersa_info *sa = /* insufficiently unaligned */
+		nlmsg_data(n, sizeof(*sa), logger, HERE);
+	if (sa == NULL) {
+		return;
+	}
+
+	if (sa->id.spi == 0) {
+		if (sa->seq <= xfrm_acquires.last_seq) {
+			/* acquire was seen; being or been handled */
+			return;
+		}
+
+		const struct ip_info *afi = aftoinfo(sa->sel.family);
+		if (afi == NULL ||
+		    sa->sel.prefixlen_s != afi->mask_cnt ||
+		    sa->sel.prefixlen_d != afi->mask_cnt) {
+			ldbg(logger, "%s() ignoring larval state seq %u with unexpected selector",
+			     __func__, (unsigned) sa->seq);
+			return;
+		}
+
+		shunk_t sec_label = NULL_HUNK;
+		struct rtattr *attr = (struct rtattr *)
+			((char*) NLMSG_DATA(n) + NLMSG_ALIGN(sizeof(*sa)));
+		size_t remaining = n->nlmsg_len - NLMSG_SPACE(sizeof(*sa));
+		while (RTA_OK(attr, remaining)) {
+			if (attr->rta_type == XFRMA_SEC_CTX &&
+			    !sec_label_from_xfrm(RTA_DATA(attr), &sec_label, logger)) {
+				return;
+			}
+			/* updates remaining too */
+			attr = RTA_NEXT(attr, remaining);
+		}
+
+		xfrm_acquires.last_seq = sa->seq;
+		struct kernel_acquire b = {
+			.packet = packet_from_xfrm_selector(afi, &sa->sel),
+			.by_acquire = true,
+			.logger = logger,
+			.background = true,
+			.sec_label = sec_label,
+			.state_id = sa->seq,
+		};
+		LLOG_JAMBUF(RC_LOG, logger, buf) {
+			jam_string(buf, "kernel: recovered lost ");
+			jam_kernel_acquire(buf, &b);
+		}
+		queue_xfrm_acquire(&b, logger);
+		return;
+	}
+
+	if (xfrm_lifetime_reached(&sa->lft, &sa->curlft, /*hard*/true)) {
+		xfrm_sa_expire(sa, /*hard*/true, logger);
+	} else if (xfrm_lifetime_reached(&sa->lft, &sa->curlft, /*hard*/false)) {
+		xfrm_sa_expire(sa, /*hard*/false, logger);
+	}
+}
+
+static void xfrm_resync_policy(struct nlmsghdr *n, struct logger *logger)
+{
+	const struct xfrm_userpolicy_info *pol = /* insufficiently unaligned */
+		nlmsg_data(n, sizeof(*pol), logger, HERE);
+	if (pol == NULL) {
+		return;
+	}
+
+	/* same as netlink_policy_expire() */
+	if (pol->dir != XFRM_POLICY_OUT) {
+		return;
+	}
+
+	if (xfrm_lifetime_reached(&pol->lft, &pol->curlft, /*hard*/true) ||
+	    xfrm_lifetime_reached(&pol->lft, &pol->curlft, /*hard*/false)) {
+		struct xfrm_userpolicy_info expired = *pol;
+		ldbg(logger, "%s() recovered lost policy expire: index %u",
+		     __func__, (unsigned) expired.index);
+		netlink_shunt_expire(&expired, logger);
+	}
+}
+
+static bool request_xfrm_dump(uint16_t type, struct logger *logger)
+{
+	static uint32_t seq;	/* STATIC */
+	struct nlmsghdr req = {
+		.nlmsg_len = NLMSG_LENGTH(0),
+		.nlmsg_type = type,
+		.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+		.nlmsg_seq = ++seq,
+	};
+
+	if (write(xfrm_resync.fd, &req, req.nlmsg_len) != (ssize_t) req.nlmsg_len) {
+		name_buf tb;
+		llog_errno(ERROR_STREAM, logger, errno,
+			   "kernel: write() of %s dump request failed: ",
+			   str_sparse_long(&xfrm_type_names, type, &tb));
+		return false;
+	}
+
+	xfrm_resync.seq = seq;
+	xfrm_resync.dump = type;
+	xfrm_resync.entries = 0;
+	return true;
+}
+
+static void start_xfrm_resync(struct logger *logger);
+
+static void stop_xfrm_resync(struct logger *logger)
+{
+	detach_fd_read_listener(&xfrm_resync.listener);
+	if (xfrm_resync.fd >= 0) {
+		close(xfrm_resync.fd);
+		xfrm_resync.fd = -1;
+	}
+	if (xfrm_resync.again) {
+		/* lost more events while dumping; go again */
+		xfrm_resync.again = false;
+		start_xfrm_resync(logger);
+	}
+}
+
+static void process_xfrm_resync(int fd, void *arg UNUSED, struct logger *logger)
+{
+	for (unsigned i = 0; i < XFRM_RESYNC_BATCH; i++) {
+		static struct nlm_resp buf[4];	/* STATIC; aligned */
+		ssize_t r = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+		if (r < 0) {
+			if (errno == EAGAIN || errno == EINTR) {
+				/* wait for the next event */
+				return;
+			}
+			llog_errno(ERROR_STREAM, logger, errno,
+				   "kernel: recv() of XFRM dump failed: ");
+			stop_xfrm_resync(logger);
+			return;
+		}
+
+		int len = r;
+		for (struct nlmsghdr *n = &buf[0].n; NLMSG_OK(n, len); n = NLMSG_NEXT(n, len)) {
+			if (n->nlmsg_seq != xfrm_resync.seq) {
+				continue;
+			}
+			switch (n->nlmsg_type) {
+			case NLMSG_DONE:
+			{
+				name_buf tb;
+				ldbg(logger, "%s() %s dump returned %u entries", __func__,
+				     str_sparse_long(&xfrm_type_names, xfrm_resync.dump, &tb),
+				     xfrm_resync.entries);
+				if (xfrm_resync.dump == XFRM_MSG_GETSA &&
+				    request_xfrm_dump(XFRM_MSG_GETPOLICY, logger)) {
+					/* wait for the policies */
+					return;
+				}
+				stop_xfrm_resync(logger);
+				return;
+			}
+			case NLMSG_ERROR:
+			{
+				const struct nlmsgerr *e = NLMSG_DATA(n);
+				name_buf tb;
+				llog_errno(ERROR_STREAM, logger, -e->error,
+					   "kernel: %s dump failed: ",
+					   str_sparse_long(&xfrm_type_names, xfrm_resync.dump, &tb));
+				stop_xfrm_resync(logger);
+				return;
+			}
+			case XFRM_MSG_NEWSA:
+				xfrm_resync.entries++;
+				xfrm_resync_sa(n, logger);
+				break;
+			case XFRM_MSG_NEWPOLICY:
+				xfrm_resync.entries++;
+				xfrm_resync_policy(n, logger);
+				break;
+			}
+		}
+
+		if (r == 0) {
+			stop_xfrm_resync(logger);
+			return;
+		}
+	}
+	/* more to read; the listener is called again */
+}
+
+static void start_xfrm_resync(struct logger *logger)
+{
+	llog(RC_LOG, logger,
+	     "kernel: XFRM event socket overflowed; resynchronizing acquires and expires from the kernel's SADB and SPD");
+
+	xfrm_resync.fd = cloexec_socket(AF_NETLINK, SOCK_DGRAM|SOCK_NONBLOCK, NETLINK_XFRM);
+	if (xfrm_resync.fd < 0) {
+		llog_errno(ERROR_STREAM, logger, errno,
+			   "kernel: socket() for XFRM dump failed: ");
+		return;
+	}
+
+	if (!request_xfrm_dump(XFRM_MSG_GETSA, logger)) {
+		stop_xfrm_resync(logger);
+		return;
+	}
+
+	attach_fd_read_listener(&xfrm_resync.listener, xfrm_resync.fd,
+				"xfrm resync", process_xfrm_resync, NULL);
+}
+
+static void xfrm_resync_after_overflow(struct logger *logger)
+{
+	if (xfrm_resync.fd >= 0) {
+		ldbg(logger, "%s() resync already in progress; will go again", __func__);
+		xfrm_resync.again = true;
+		return;
+	}
+	start_xfrm_resync(logger);
+}
+
+/*
+ * Read broadcast messages in batches: each recvmmsg() call pulls up to
+ * XFRM_BATCH datagrams (each of which can contain several messages)
+ * into one large buffer.  Keep going until the socket is empty.
+ */
+
+#define XFRM_BATCH 16
+
 static void netlink_process_xfrm_messages(int fd, void *arg UNUSED, struct logger *logger)
 {
+	static struct nlm_resp batch[XFRM_BATCH];	/* STATIC; large */
+	bool overflowed = false;
+
 	ldbg(logger, "kernel: %s() process messages", __func__);
-	do {} while (netlink_get(fd, netlink_xfrm_message_processor, logger));
+
+	while (true) {
+		struct sockaddr_nl addr[XFRM_BATCH];
+		struct iovec iov[XFRM_BATCH];
+		struct mmsghdr msgs[XFRM_BATCH];
+		zero(&msgs);
+		for (unsigned i = 0; i < XFRM_BATCH; i++) {
+			iov[i].iov_base = &batch[i];
+			iov[i].iov_len = sizeof(batch[i]);
+			msgs[i].msg_hdr.msg_iov = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_name = &addr[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(addr[i]);
+		}
+
+		int count = recvmmsg(fd, msgs, XFRM_BATCH, MSG_DONTWAIT, NULL);
+		if (count < 0) {
+			if (errno == EAGAIN) {
+				break;
+			}
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == ENOBUFS) {
+				/* messages were dropped; keep reading */
+				overflowed = true;
+				continue;
+			}
+			llog_errno(ERROR_STREAM, logger, errno,
+				   "kernel: recvmmsg() failed in %s: ", __func__);
+			break;
+		}
+
+		ldbg(logger, "%s() recvmmsg() returned %d datagrams", __func__, count);
+		for (int i = 0; i < count; i++) {
+			int len = msgs[i].msg_len;
+			if (LDBGP(DBG_TMI, logger)) {
+				LDBG_dump(logger, &batch[i], len);
+			}
+			if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+				llog(RC_LOG, logger,
+				     "kernel: %s() read truncated datagram; ignore datagram",
+				     __func__);
+				continue;
+			}
+			if (addr[i].nl_pid != 0) {
+				/* not for us: ignore */
+				ldbg(logger, "%s() ignoring message from process %u",
+				     __func__, addr[i].nl_pid);
+				continue;
+			}
+			if (impair.xfrm_event_overflow) {
+				llog(RC_LOG, logger,
+				     "IMPAIR: dropping XFRM event datagram as if the socket overflowed");
+				overflowed = true;
+				continue;
+			}
+			for (struct nlmsghdr *n = &batch[i].n; NLMSG_OK(n, len); n = NLMSG_NEXT(n, len)) {
+				netlink_xfrm_message_processor(n, logger);
+				if (impair.xfrm_event_duplicate) {
+					llog(RC_LOG, logger, "IMPAIR: processing XFRM event a second time");
+					netlink_xfrm_message_processor(n, logger);
+				}
+			}
+			if (len > 0) {
+				llog(RC_LOG, logger,
+				     "kernel: %s() datagram contained %d trailing bytes; ignore them",
+				     __func__, len);
+			}
+		}
+
+		if (count < XFRM_BATCH) {
+			/* drained */
+			break;
+		}
+	}
+
+	if (overflowed) {
+		xfrm_resync_after_overflow(logger);
+	}
 }
 
 static void netlink_process_rtm_messages(int fd, void *arg UNUSED, struct logger *logger)
@@ -2737,6 +3283,331 @@ static void netlink_process_rtm_messages(int fd, void *arg UNUSED, struct logger
 	do {} while (netlink_get(fd, netlink_rtm_message_processor, logger));
 }
 
+struct allocspi_req {
+	struct nlmsghdr n;
+	struct xfrm_userspi_info spi;
+	char data[MAX_NETLINK_DATA_SIZE];
+};
+
+static void init_allocspi_req(struct allocspi_req *req,
+			      const ip_address *src,
+			      const ip_address *dst,
+			      const struct ip_protocol *proto,
+			      reqid_t reqid,
+			      uintmax_t min, uintmax_t max)
+{
+	zero(req);
+	req->n.nlmsg_flags = NLM_F_REQUEST;
+	req->n.nlmsg_type = XFRM_MSG_ALLOCSPI;
+
+	req->spi.info.saddr = xfrm_from_address(src);
+	req->spi.info.id.daddr = xfrm_from_address(dst);
+	req->spi.info.mode = 0;/*transport mode*/
+	req->spi.info.reqid = reqid;
+	req->spi.info.id.proto = proto->ipproto;
+	req->spi.info.family = address_type(dst)->af;
+
+	req->n.nlmsg_len = NLMSG_ALIGN(NLMSG_LENGTH(sizeof(req->spi)));
+
+	req->spi.min = min;
+	req->spi.max = max;
+
+	if (xfrm_direction_supported != XFRM_DIR_SUP_NO) {
+		nl_addattr8(&req->n, sizeof(req->data), XFRMA_SA_DIR, XFRM_SA_DIR_IN);
+	}
+}
+
+/*
+ * Pool of pre-allocated inbound SPIs.
+ *
+ * Each XFRM_MSG_ALLOCSPI is a netlink round trip and, during an
+ * IKE_AUTH burst, they serialize behind each other.  Instead, for each
+ * (protocol, local address) that has needed an ESP or AH SPI, keep a
+ * small pool of larval SPIs reserved in the kernel.  The pool is
+ * refilled from a timer, in a batch, by writing all the
+ * XFRM_MSG_ALLOCSPI requests to a non-blocking socket; the replies
+ * are read from the event loop as they arrive.
+ *
+ * A larval SPI only lasts as long as the kernel's acquire lifetime
+ * (expire-lifetime=) so pooled SPIs older than a third of that are
+ * deleted, leaving the Child SA the remainder to finish.  A pool that
+ * goes unused for the full lifetime is released.
+ *
+ * The larval state's reqid and source address don't matter:
+ * XFRM_MSG_UPDSA replaces it by (destination, SPI, protocol).
+ */
+
+#define SPI_POOL_COUNT 16	/* (protocol, address) pairs */
+#define SPI_POOL_SIZE 16	/* SPIs per pool */
+#define SPI_POOL_LOW_WATER 4	/* refill when below */
+
+struct spi_pool {
+	const struct ip_protocol *proto;	/* NULL when unused */
+	ip_address dst;
+	monotime_t last_used;
+	/* outstanding XFRM_MSG_ALLOCSPI requests */
+	uint32_t first_seq;
+	unsigned pending;
+	monotime_t pending_since;
+	unsigned count;
+	struct {
+		ipsec_spi_t spi;
+		monotime_t allocated;
+	} spis[SPI_POOL_SIZE];		/* oldest first */
+};
+
+static struct {
+	struct spi_pool pools[SPI_POOL_COUNT];
+	int fd;
+	struct fd_read_listener *listener;
+	uint32_t seq;
+	bool timer_initialized;
+} spi_pools = {
+	.fd = NULL_FD,
+};
+
+static deltatime_t spi_pool_lifetime(void)
+{
+	const struct config_setup *oco = config_setup_singleton();
+	deltatime_t lifetime = config_setup_deltatime(oco, KBF_EXPIRE_LIFETIME);
+	return (lifetime.is_set ? lifetime : deltatime(30));
+}
+
+static void delete_pooled_spi(struct spi_pool *pool, unsigned i, struct logger *logger)
+{
+	xfrm_del_ipsec_spi(pool->spis[i].spi, pool->proto,
+			   &pool->dst, &pool->dst,
+			   "pooled SPI", logger);
+	pool->count--;
+	memmove(&pool->spis[i], &pool->spis[i + 1],
+		(pool->count - i) * sizeof(pool->spis[0]));
+}
+
+static struct spi_pool *spi_pool_by_seq(uint32_t seq)
+{
+	FOR_EACH_ELEMENT(pool, spi_pools.pools) {
+		if (pool->proto != NULL && pool->pending > 0 &&
+		    seq - pool->first_seq < pool->pending) {
+			return pool;
+		}
+	}
+	return NULL;
+}
+
+static void process_spi_pool_replies(int fd, void *arg UNUSED, struct logger *logger)
+{
+	while (true) {
+		struct nlm_resp rsp;
+		ssize_t r = recv(fd, &rsp, sizeof(rsp), MSG_DONTWAIT);
+		if (r < 0) {
+			if (errno != EAGAIN && errno != EINTR) {
+				llog_errno(ERROR_STREAM, logger, errno,
+					   "xfrm: recv() of pooled XFRM_MSG_ALLOCSPI replies failed: ");
+			}
+			return;
+		}
+
+		int len = r;
+		for (struct nlmsghdr *n = &rsp.n; NLMSG_OK(n, len); n = NLMSG_NEXT(n, len)) {
+			struct spi_pool *pool = spi_pool_by_seq(n->nlmsg_seq);
+			if (pool == NULL) {
+				/* pool released or given up on; the larval SPI expires */
+				ldbg(logger, "xfrm: ignoring late pooled XFRM_MSG_ALLOCSPI reply %u",
+				     (unsigned) n->nlmsg_seq);
+				continue;
+			}
+			if (n->nlmsg_type == NLMSG_ERROR) {
+				const struct nlmsgerr *e = NLMSG_DATA(n);
+				llog_errno(RC_LOG, logger, -e->error,
+					   "xfrm: pooled XFRM_MSG_ALLOCSPI failed: ");
+			} else {
+				const struct xfrm_usersa_info *sa = nlmsg_data(n, sizeof(*sa), logger, HERE);
+				if (sa != NULL && pool->count < SPI_POOL_SIZE) {
+					pool->spis[pool->count].spi = sa->id.spi;
+					pool->spis[pool->count].allocated = mononow();
+					pool->count++;
+				}
+			}
+			/* replies arrive in order */
+			pool->first_seq = n->nlmsg_seq + 1;
+			pool->pending--;
+			if (pool->pending == 0) {
+				address_buf ab;
+				ldbg(logger, "xfrm: SPI pool %s %s refilled to %u",
+				     pool->proto->name, str_address(&pool->dst, &ab), pool->count);
+			}
+		}
+	}
+}
+
+static void refill_spi_pool(struct spi_pool *pool, struct logger *logger)
+{
+	if (spi_pools.fd == NULL_FD) {
+		spi_pools.fd = cloexec_socket(AF_NETLINK, SOCK_DGRAM|SOCK_NONBLOCK, NETLINK_XFRM);
+		if (spi_pools.fd < 0) {
+			llog_errno(ERROR_STREAM, logger, errno,
+				   "xfrm: socket() for SPI pool failed: ");
+			spi_pools.fd = NULL_FD;
+			return;
+		}
+		attach_fd_read_listener(&spi_pools.listener, spi_pools.fd,
+					"xfrm SPI pool", process_spi_pool_replies, NULL);
+	}
+
+	if (pool->pending > 0) {
+		/* still waiting */
+		return;
+	}
+
+	unsigned want = SPI_POOL_SIZE - pool->count;
+	pool->first_seq = spi_pools.seq + 1;
+	pool->pending_since = mononow();
+	for (unsigned sent = 0; sent < want; sent++) {
+		struct allocspi_req req;
+		init_allocspi_req(&req, &pool->dst, &pool->dst, pool->proto,
+				  /*reqid*/0, IPSEC_DOI_SPI_OUR_MIN, 0xffffffffU);
+		req.n.nlmsg_seq = ++spi_pools.seq;
+		if (write(spi_pools.fd, &req, req.n.nlmsg_len) != (ssize_t) req.n.nlmsg_len) {
+			llog_errno(ERROR_STREAM, logger, errno,
+				   "xfrm: write() of pooled XFRM_MSG_ALLOCSPI failed: ");
+			break;
+		}
+		pool->pending++;
+	}
+
+	address_buf ab;
+	ldbg(logger, "xfrm: SPI pool %s %s holds %u; requested %u",
+	     pool->proto->name, str_address(&pool->dst, &ab),
+	     pool->count, pool->pending);
+}
+
+static global_timer_cb spi_pool_timer;	/* type assertion */
+
+static void spi_pool_timer(struct logger *logger)
+{
+	monotime_t now = mononow();
+	deltatime_t lifetime = spi_pool_lifetime();
+	monotime_t stale = monotime_sub(now, deltatime_scale(lifetime, 1, 3));
+	monotime_t idle = monotime_sub(now, lifetime);
+
+	bool rearm = false;
+	monotime_t next = monotime_epoch;
+	FOR_EACH_ELEMENT(pool, spi_pools.pools) {
+		if (pool->proto == NULL) {
+			continue;
+		}
+
+		/* oldest first */
+		while (pool->count > 0 &&
+		       monotime_cmp(pool->spis[0].allocated, <=, stale)) {
+			delete_pooled_spi(pool, 0, logger);
+		}
+
+		if (pool->pending > 0 &&
+		    monotime_cmp(pool->pending_since, <=, stale)) {
+			/* a reply was lost */
+			address_buf ab;
+			llog(RC_LOG, logger,
+			     "xfrm: SPI pool %s %s gave up waiting for %u XFRM_MSG_ALLOCSPI replies",
+			     pool->proto->name, str_address(&pool->dst, &ab), pool->pending);
+			pool->pending = 0;
+		}
+
+		if (monotime_cmp(pool->last_used, <, idle)) {
+			if (pool->count == 0 && pool->pending == 0) {
+				address_buf ab;
+				ldbg(logger, "xfrm: releasing idle SPI pool %s %s",
+				     pool->proto->name, str_address(&pool->dst, &ab));
+				zero(pool);
+				continue;
+			}
+		} else if (pool->count < SPI_POOL_SIZE) {
+			refill_spi_pool(pool, logger);
+		}
+
+		if (pool->count > 0) {
+			monotime_t expires = monotime_add(pool->spis[0].allocated,
+							  deltatime_scale(lifetime, 1, 3));
+			next = (rearm ? monotime_min(next, expires) : expires);
+		}
+		/* idle pools need another look, even when empty */
+		rearm = true;
+	}
+
+	if (rearm) {
+		if (monotime_cmp(next, <=, now)) {
+			next = monotime_add(now, lifetime);
+		}
+		schedule_oneshot_timer(EVENT_SPI_POOL, monotime_diff(next, now), logger);
+	}
+}
+
+static ipsec_spi_t take_pooled_spi(const ip_address *dst,
+				   const struct ip_protocol *proto,
+				   struct logger *logger)
+{
+	if (!spi_pools.timer_initialized) {
+		init_oneshot_timer(EVENT_SPI_POOL, spi_pool_timer, logger);
+		spi_pools.timer_initialized = true;
+	}
+
+	monotime_t now = mononow();
+	monotime_t stale = monotime_sub(now, deltatime_scale(spi_pool_lifetime(), 1, 3));
+
+	struct spi_pool *free_pool = NULL;
+	FOR_EACH_ELEMENT(pool, spi_pools.pools) {
+		if (pool->proto == NULL) {
+			free_pool = (free_pool == NULL ? pool : free_pool);
+			continue;
+		}
+		if (pool->proto != proto || !address_eq_address(pool->dst, *dst)) {
+			continue;
+		}
+
+		pool->last_used = now;
+		while (pool->count > 0 &&
+		       monotime_cmp(pool->spis[0].allocated, <=, stale)) {
+			delete_pooled_spi(pool, 0, logger);
+		}
+
+		ipsec_spi_t spi = 0;
+		if (pool->count > 0) {
+			spi = pool->spis[0].spi;
+			pool->count--;
+			memmove(&pool->spis[0], &pool->spis[1],
+				pool->count * sizeof(pool->spis[0]));
+		}
+		if (pool->count < SPI_POOL_LOW_WATER) {
+			schedule_oneshot_timer(EVENT_SPI_POOL, deltatime(0), logger);
+		}
+		return spi;
+	}
+
+	if (free_pool != NULL) {
+		*free_pool = (struct spi_pool) {
+			.proto = proto,
+			.dst = *dst,
+			.last_used = now,
+		};
+		schedule_oneshot_timer(EVENT_SPI_POOL, deltatime(0), logger);
+	}
+	return 0;
+}
+
+static void free_spi_pools(struct logger *logger)
+{
+	FOR_EACH_ELEMENT(pool, spi_pools.pools) {
+		while (pool->count > 0) {
+			delete_pooled_spi(pool, pool->count - 1, logger);
+		}
+	}
+	detach_fd_read_listener(&spi_pools.listener);
+	if (spi_pools.fd != NULL_FD) {
+		close(spi_pools.fd);
+		spi_pools.fd = NULL_FD;
+	}
+}
+
 static ipsec_spi_t xfrm_get_ipsec_spi(ipsec_spi_t avoid UNUSED,
 				      const ip_address *src,
 				      const ip_address *dst,
@@ -2746,33 +3617,20 @@ static ipsec_spi_t xfrm_get_ipsec_spi(ipsec_spi_t avoid UNUSED,
 				      const char *story,
 				      struct logger *logger)
 {
-	struct {
-		struct nlmsghdr n;
-		struct xfrm_userspi_info spi;
-		char data[MAX_NETLINK_DATA_SIZE];
-	} req;
-	struct nlm_resp rsp;
-
-	zero(&req);
-	req.n.nlmsg_flags = NLM_F_REQUEST;
-	req.n.nlmsg_type = XFRM_MSG_ALLOCSPI;
-
-	req.spi.info.saddr = xfrm_from_address(src);
-	req.spi.info.id.daddr = xfrm_from_address(dst);
-	req.spi.info.mode = 0;/*transport mode*/
-	req.spi.info.reqid = reqid;
-	req.spi.info.id.proto = proto->ipproto;
-	req.spi.info.family = address_type(src)->af;
-
-	req.n.nlmsg_len = NLMSG_ALIGN(NLMSG_LENGTH(sizeof(req.spi)));
-
-	req.spi.min = min;
-	req.spi.max = max;
-
-	if (xfrm_direction_supported != XFRM_DIR_SUP_NO) {
-		nl_addattr8(&req.n, sizeof(req.data), XFRMA_SA_DIR, XFRM_SA_DIR_IN);
+	if ((proto == &ip_protocol_esp || proto == &ip_protocol_ah) &&
+	    min == IPSEC_DOI_SPI_OUR_MIN && max == 0xffffffffU) {
+		ipsec_spi_t spi = take_pooled_spi(dst, proto, logger);
+		if (spi != 0) {
+			ldbg(logger, "xfrm: using pooled SPI "PRI_IPSEC_SPI" for %s",
+			     pri_ipsec_spi(spi), story);
+			return spi;
+		}
 	}
 
+	struct allocspi_req req;
+	struct nlm_resp rsp;
+	init_allocspi_req(&req, src, dst, proto, reqid, min, max);
+
 	int recv_errno;
 	if (!sendrecv_xfrm_msg(&req.n, XFRM_MSG_NEWSA, &rsp,
 			       "Get SPI", story,
@@ -3338,7 +4196,18 @@ static bool netlink_poke_ipsec_policy_hole(int fd, const struct ip_info *afi, st
 
 static void kernel_xfrm_shutdown(struct logger *logger)
 {
-	ldbg(logger, "%s() no-op", __func__);
+	free_spi_pools(logger);
+	xfrm_resync.again = false;
+	stop_xfrm_resync(logger);
+	ldbg(logger, "%s() discarding %u queued acquires", __func__, xfrm_acquires.count);
+	while (xfrm_acquires.count > 0) {
+		free_chunk_content(&xfrm_acquires.queue[xfrm_acquires.head].sec_label);
+		xfrm_acquires.head = (xfrm_acquires.head + 1) % elemsof(xfrm_acquires.queue);
+		xfrm_acquires.count--;
+	}
+	FOR_EACH_ELEMENT(r, xfrm_acquires.recent) {
+		free_chunk_content(&r->sec_label);
+	}
 }
 
 static const char *xfrm_protostack_names[] = { "xfrm", "netkey", NULL, };
@@ -3353,6 +4222,7 @@ const struct kernel_ops xfrm_kernel_ops = {
 
 	.init = kernel_xfrm_init,
 	.flush = kernel_xfrm_flush,
+	.flush_policies = kernel_xfrm_flush_policies,
 	.poke_holes = kernel_xfrm_poke_holes,
 	.plug_holes = kernel_xfrm_plug_holes,
 	.shutdown = kernel_xfrm_shutdown,
@@ -25,6 +25,7 @@
  *
  */
 
+#include <pthread.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -44,6 +45,7 @@
 #include "log.h"
 #include "whack.h"      /* for RC_LOG */
 #include "timer.h"
+#include "server.h"		/* for schedule_callback() */
 
 #include "pluto_x509.h"
 #include "nss_cert_load.h"
@@ -66,17 +68,159 @@
 #include "ike_alg_hash.h"
 #include "pluto_timing.h"
 #include "show.h"
+#include "pluto_stats.h"
 
 static struct secret *pluto_secrets = NULL;
+static struct secret_files *pluto_secret_files = NULL;
+
+static void forget_local_private_keys(struct logger *logger);
+
+/*
+ * Once there are secrets, reloading them is done on a separate
+ * thread with the result published, in one go, from the event loop.
+ * Until then lookups continue to use the old secrets.
+ *
+ * The thread is started by the first reload and then waits for the
+ * next one.
+ *
+ * The logger (and hence any whack) is held until the new secrets are
+ * published.
+ */
+
+static struct {
+	bool running;		/* reload requested, not yet published */
+	bool again;		/* reload requested while running */
+	bool started;		/* .thread exists */
+	bool stopping;
+	pthread_t thread;
+	pthread_mutex_t mutex;	/* for .running, .stopping and .result */
+	pthread_cond_t cond;
+	struct logger *logger;
+	struct secret_files *result;
+} secrets_reload = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER,
+};
+
+static callback_cb secrets_reloaded; /* type assertion */
+
+static void *secrets_reload_thread(void *arg UNUSED)
+{
+	pthread_mutex_lock(&secrets_reload.mutex);
+	while (true) {
+		if (secrets_reload.stopping) {
+			break;
+		}
+		if (!secrets_reload.running || secrets_reload.result != NULL) {
+			pthread_cond_wait(&secrets_reload.cond, &secrets_reload.mutex);
+			continue;
+		}
+		struct logger *logger = secrets_reload.logger;
+		pthread_mutex_unlock(&secrets_reload.mutex);
+		struct secret_files *result =
+			lsw_parse_secret_files(pluto_secret_files,
+					       config_setup_secretsfile(),
+					       logger);
+		pthread_mutex_lock(&secrets_reload.mutex);
+		secrets_reload.result = result;
+		schedule_callback("secrets reloaded", deltatime(0), SOS_NOBODY,
+				  secrets_reloaded, NULL, logger);
+	}
+	pthread_mutex_unlock(&secrets_reload.mutex);
+	return NULL;
+}
+
+static void start_secrets_reload(struct logger *logger)
+{
+	if (!secrets_reload.started) {
+		int e = pthread_create(&secrets_reload.thread, NULL,
+				       secrets_reload_thread, NULL);
+		if (e != 0) {
+			llog_errno(RC_LOG, logger, e,
+				   "creating secrets thread failed, reloading inline: ");
+			lsw_load_preshared_secrets(&pluto_secrets, &pluto_secret_files,
+						   config_setup_secretsfile(), logger);
+			forget_local_private_keys(logger);
+			return;
+		}
+		secrets_reload.started = true;
+	}
+
+	pthread_mutex_lock(&secrets_reload.mutex);
+	secrets_reload.running = true;
+	secrets_reload.again = false;
+	secrets_reload.logger = clone_logger(logger, HERE);
+	pthread_cond_signal(&secrets_reload.cond);
+	pthread_mutex_unlock(&secrets_reload.mutex);
+}
+
+static void secrets_reloaded(const char *story UNUSED,
+			     struct state *st UNUSED,
+			     void *context UNUSED)
+{
+	pthread_mutex_lock(&secrets_reload.mutex);
+	struct secret_files *result = secrets_reload.result;
+	secrets_reload.result = NULL;
+	bool running = secrets_reload.running;
+	secrets_reload.running = false;
+	pthread_mutex_unlock(&secrets_reload.mutex);
+
+	if (!running) {
+		/* shutdown beat us to it */
+		return;
+	}
+
+	lsw_publish_secret_files(&pluto_secrets, &pluto_secret_files,
+				 &result, secrets_reload.logger);
+	forget_local_private_keys(secrets_reload.logger);
+	llog(RC_LOG, secrets_reload.logger, "secrets reloaded");
+
+	struct logger *logger = secrets_reload.logger;
+	secrets_reload.logger = NULL;
+	if (secrets_reload.again) {
+		start_secrets_reload(logger);
+	}
+	free_logger(&logger, HERE);
+}
 
 void load_preshared_secrets(struct logger *logger)
 {
-	lsw_load_preshared_secrets(&pluto_secrets, config_setup_secretsfile(), logger);
+	if (secrets_reload.running) {
+		llog(RC_LOG, logger,
+		     "secrets are being reloaded, will reload again when done");
+		secrets_reload.again = true;
+		return;
+	}
+
+	if (pluto_secret_files == NULL) {
+		/* first time, wait */
+		lsw_load_preshared_secrets(&pluto_secrets, &pluto_secret_files,
+					   config_setup_secretsfile(), logger);
+		forget_local_private_keys(logger);
+		return;
+	}
+
+	start_secrets_reload(logger);
 }
 
 void free_preshared_secrets(struct logger *logger)
 {
-	lsw_free_preshared_secrets(&pluto_secrets, logger);
+	if (secrets_reload.started) {
+		/* lets any reload finish */
+		pthread_mutex_lock(&secrets_reload.mutex);
+		secrets_reload.stopping = true;
+		pthread_cond_signal(&secrets_reload.cond);
+		pthread_mutex_unlock(&secrets_reload.mutex);
+		pthread_join(secrets_reload.thread, NULL);
+		secrets_reload.started = false;
+	}
+	if (secrets_reload.running) {
+		secrets_reload.running = false;
+		lsw_free_secret_files(&secrets_reload.result);
+		free_logger(&secrets_reload.logger, HERE);
+	}
+	lsw_free_preshared_secrets(&pluto_secrets, &pluto_secret_files, logger);
+	forget_local_private_keys(logger);
 }
 
 struct secret_context {
@@ -650,9 +794,9 @@ const struct secret_ppk_stuff *get_ppk_stuff_by_id(shunk_t ppk_id, struct logger
  * indicated by a NULL pointer.
  */
 
-struct secret_pubkey_stuff *get_local_private_key(const struct connection *c,
-						  const struct pubkey_type *type,
-						  struct logger *logger)
+static struct secret_pubkey_stuff *find_local_private_key(const struct connection *c,
+							  const struct pubkey_type *type,
+							  struct logger *logger)
 {
 	/* is there a certificate assigned to this connection? */
 	if (c->local->host.config->cert.nss_cert != NULL) {
@@ -777,6 +921,88 @@ struct secret_pubkey_stuff *get_local_private_key(const struct connection *c,
 	return pks;
 }
 
+/*
+ * A key found using the certificate or CKAID depends only on the
+ * connection's config which is shared by the root connection and
+ * all its instances.  Stash a reference to it there so that further
+ * lookups don't go back to NSS and the secrets list.
+ */
+
+static struct host_end_config *root_local_host_config(const struct connection *c,
+						       struct logger *logger)
+{
+	const struct connection *root = c;
+	while (root->clonedfrom != NULL) {
+		root = root->clonedfrom;
+	}
+	if (PBAD(logger, root->root_config == NULL)) {
+		return NULL;
+	}
+	struct host_end_config *host = &root->root_config->end[c->local->config->index].host;
+	if (PBAD(logger, host != c->local->host.config)) {
+		return NULL;
+	}
+	return host;
+}
+
+struct secret_pubkey_stuff *get_local_private_key(const struct connection *c,
+						  const struct pubkey_type *type,
+						  struct logger *logger)
+{
+	logtime_t start = logtime_start(logger);
+	pstats_private_key_lookups++;
+
+	struct host_end_config *host = NULL;
+	if (c->local->host.config->cert.nss_cert != NULL ||
+	    c->local->host.config->ckaid != NULL) {
+		host = root_local_host_config(c, logger);
+	}
+
+	if (host != NULL &&
+	    host->private_key != NULL &&
+	    host->private_key->content.type == type) {
+		pstats_private_key_cached++;
+		logtime_stop(&start, "%s() found connection %s's %s private key in cache",
+			     __func__, c->name, type->name);
+		return host->private_key;
+	}
+
+	struct secret_pubkey_stuff *pks = find_local_private_key(c, type, logger);
+	if (host != NULL && pks != NULL) {
+		secret_pubkey_stuff_delref(&host->private_key, HERE);
+		host->private_key = secret_pubkey_stuff_addref(pks, HERE);
+	}
+	logtime_stop(&start, "%s() looked up connection %s's %s private key",
+		     __func__, c->name, type->name);
+	return pks;
+}
+
+/*
+ * The secrets were replaced or freed; drop the references
+ * get_local_private_key() stashed in each root connection's config.
+ */
+
+static void forget_local_private_keys(struct logger *logger)
+{
+	struct connection_filter cf = {
+		.search = {
+			.order = OLD2NEW,
+			.verbose.logger = logger,
+			.where = HERE,
+		},
+	};
+	while (next_connection(&cf)) {
+		struct config *config = cf.c->root_config;
+		if (config == NULL) {
+			/* instance; shares its root's config */
+			continue;
+		}
+		FOR_EACH_ELEMENT(end, config->end) {
+			secret_pubkey_stuff_delref(&end->host.private_key, HERE);
+		}
+	}
+}
+
 /*
  * public key machinery
  */
@@ -52,6 +52,10 @@ struct limiter log_limiters[LOG_LIMITER_ROOF] = {
 		.what = "payload errors",
 		.limit = RATE_LIMIT,
 	},
+	[XFRM_ACQUIRE_LOG_LIMITER] = {
+		.what = "dropped acquire",
+		.limit = RATE_LIMIT,
+	},
 };
 
 static unsigned log_limit(const struct limiter *limiter)
@@ -32,7 +32,8 @@ enum log_limiter {
 	CERTIFICATE_LOG_LIMITER,
 	MSG_ERRQUEUE_LOG_LIMITER,
 	PAYLOAD_ERRORS_LOG_LIMITER,
-#define LOG_LIMITER_ROOF (PAYLOAD_ERRORS_LOG_LIMITER+1)
+	XFRM_ACQUIRE_LOG_LIMITER,
+#define LOG_LIMITER_ROOF (XFRM_ACQUIRE_LOG_LIMITER+1)
 };
 
 /*
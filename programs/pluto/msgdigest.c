@@ -20,13 +20,15 @@
 #include "demux.h"      /* needs packet.h */
 #include "iface.h"
 
+static struct slab msg_digest_slab = SLAB(struct msg_digest, "msg_digest");
+
 struct msg_digest *alloc_md(struct iface_endpoint *ifp,
 			    const ip_endpoint *sender,
 			    const uint8_t *packet, size_t packet_len,
 			    where_t where)
 {
 	struct logger *logger = &global_logger;
-	struct msg_digest *md = refcnt_alloc(struct msg_digest, logger, where);
+	struct msg_digest *md = refcnt_slab_alloc(struct msg_digest, &msg_digest_slab, logger, where);
 	md->iface = iface_endpoint_addref_where(ifp, where);
 	md->sender = *sender;
 	md->logger = alloc_logger(md, &logger_message_vec,
@@ -61,6 +63,6 @@ void md_delref_where(struct msg_digest **mdp, where_t where)
 		free_chunk_content(&md->packet);
 		free_logger(&md->logger, where);
 		iface_endpoint_delref_where(&md->iface, where);
-		pfree(md);
+		pfree_slab(&msg_digest_slab, md);
 	}
 }
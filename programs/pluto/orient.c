@@ -36,6 +36,7 @@
 #include "initiate.h"
 #include "ipsec_interface.h"
 #include "addresspool.h"
+#include "checkpoint.h"		/* for restore_checkpoint() */
 
 static void terminate_and_disorient_connection(struct connection *c,
 					       where_t where)
@@ -421,38 +422,58 @@ bool orient(struct connection *c, const struct logger *logger)
 }
 
 /*
- * Adjust orientations of connections to reflect newly added
- * interfaces.
+ * Adjust orientations of connections to reflect an interface with
+ * LOCAL_ADDRESS being added or deleted.
+ *
+ * Only unoriented connections with an end waiting for LOCAL_ADDRESS
+ * can be affected (connections oriented to a deleted interface have
+ * already been disoriented) so just look at those.
+ *
+ * When LOG_ORIENTED, connections that become oriented are logged
+ * and, after a warm restart, their SAs are re-adopted (at startup
+ * connections can only orient once pluto is listening).  Whack
+ * batches leave both to connection_added().
  */
 
-void check_orientations(const struct logger *logger)
+void check_orientations(const ip_address *local_address,
+			bool log_oriented,
+			const struct logger *logger)
 {
-	/*
-	 * Try to orient unoriented connections by re-building the
-	 * unoriented connections list.
-	 *
-	 * The list is emptied, then as each connection fails to
-	 * orient it goes back on the list.
-	 */
-	struct connection_filter cq = {
-		.search = {
-			.order = OLD2NEW,
-			.verbose.logger = logger,
-			.where = HERE,
-		},
-	};
-	while (next_connection(&cq)) {
-		struct connection *c = cq.c;
-		/* just try */
-		bool was_oriented = oriented(c);
-		bool is_oriented = orient(c, logger);
-		/* log when it becomes oriented */
-		if (!was_oriented && is_oriented) {
-			whack_attach(c, logger);
-			LLOG_JAMBUF(RC_LOG, c->logger, buf) {
-				jam_orientation(buf, c, /*orientation_details*/true);
+	FOR_EACH_THING(end, LEFT_END, RIGHT_END) {
+		struct connection_filter cq = {
+			.unoriented = {
+				.end = end,
+				.addr = local_address,
+			},
+			.search = {
+				.order = OLD2NEW,
+				.verbose.logger = logger,
+				.where = HERE,
+			},
+		};
+		/*
+		 * Orienting rehashes the connection so take a
+		 * snapshot.
+		 */
+		while (all_connections(&cq)) {
+			struct connection *c = cq.c;
+			/* when both ends match, the left pass did it */
+			if (end == RIGHT_END &&
+			    address_eq_address(c->end[LEFT_END].host.addr, *local_address)) {
+				continue;
+			}
+			/* just try */
+			bool was_oriented = oriented(c);
+			bool is_oriented = orient(c, logger);
+			/* log when it becomes oriented */
+			if (log_oriented && !was_oriented && is_oriented) {
+				whack_attach(c, logger);
+				LLOG_JAMBUF(RC_LOG, c->logger, buf) {
+					jam_orientation(buf, c, /*orientation_details*/true);
+				}
+				restore_checkpoint(c, c->logger);
+				whack_detach(c, logger);
 			}
-			whack_detach(c, logger);
 		}
 	}
 }
@@ -19,6 +19,8 @@
 
 #include <stdbool.h>
 
+#include "ip_address.h"
+
 struct connection;
 
 bool oriented(const struct connection *c);
@@ -28,7 +30,9 @@ bool oriented(const struct connection *c);
  */
 bool orient(struct connection *c, const struct logger *logger);
 void disorient(struct connection *c);
-void check_orientations(const struct logger *logger);
+void check_orientations(const ip_address *local_address,
+			bool log_oriented,
+			const struct logger *logger);
 
 void jam_orientation(struct jambuf *buf, struct connection *c, bool oriented_details);
 
@@ -0,0 +1,371 @@
+/* initiation pacer, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#include "ipsecconf/config_setup.h"
+
+#include "defs.h"
+
+#include "log.h"
+#include "show.h"
+#include "server.h"		/* for schedule_timeout() */
+#include "connections.h"
+#include "orient.h"
+#include "initiate.h"
+#include "rnd.h"		/* for get_rnd_uintmax() */
+#include "pacer.h"
+
+/*
+ * The budget is a token bucket.  CREDIT is measured in millionths of
+ * an initiate; it accumulates at RATE initiates per second (i.e.,
+ * RATE per microsecond) up to one second's worth.
+ */
+
+#define INITIATE_COST 1000000
+
+/* highest priority first */
+enum pacer_queue {
+	PACE_ONDEMAND,
+	PACE_START,
+	PACE_REVIVAL,
+#define PACE_QUEUE_ROOF (PACE_REVIVAL+1)
+};
+
+static const char *pacer_queue_name[PACE_QUEUE_ROOF] = {
+	[PACE_ONDEMAND] = "ondemand",
+	[PACE_START] = "start",
+	[PACE_REVIVAL] = "revival",
+};
+
+struct pacer_entry {
+	struct pacer_entry *next;
+	struct connection *connection;
+	struct child_policy policy;
+	threadtime_t inception;
+	chunk_t sec_label;
+	bool detach_whack;
+	enum initiated_by initiated_by;
+};
+
+static struct {
+	unsigned rate;			/* per second; 0 is unlimited */
+	intmax_t credit;
+	monotime_t refilled;
+	struct timeout *timeout;
+	bool dispatching;
+	struct {
+		struct pacer_entry *head;
+		struct pacer_entry **tail;
+		unsigned depth;
+	} queue[PACE_QUEUE_ROOF];
+	uintmax_t admitted;
+	uintmax_t deferred;
+	uintmax_t dropped;
+} pacer;
+
+static void pacer_event(void *arg, const struct timer_event *event);
+
+static void refill(void)
+{
+	monotime_t now = mononow();
+	intmax_t us = microseconds_from_deltatime(monotime_diff(now, pacer.refilled));
+	pacer.refilled = now;
+	/* don't overflow */
+	if (us > 1000000) {
+		us = 1000000;
+	}
+	intmax_t max = (intmax_t)pacer.rate * INITIATE_COST;
+	pacer.credit += us * pacer.rate;
+	if (pacer.credit > max) {
+		pacer.credit = max;
+	}
+}
+
+static bool take_credit(void)
+{
+	if (pacer.credit < INITIATE_COST) {
+		return false;
+	}
+	pacer.credit -= INITIATE_COST;
+	return true;
+}
+
+static unsigned queued(void)
+{
+	unsigned depth = 0;
+	for (enum pacer_queue q = 0; q < PACE_QUEUE_ROOF; q++) {
+		depth += pacer.queue[q].depth;
+	}
+	return depth;
+}
+
+/*
+ * Wake up once there's credit for the next initiate; plus up to an
+ * initiate's worth of jitter so that a queue that is refilled in
+ * lockstep doesn't drain that way.
+ */
+
+static void schedule_pacer(void)
+{
+	if (pacer.timeout != NULL || queued() == 0) {
+		return;
+	}
+	intmax_t per_initiate = 1000000 / pacer.rate; /* us */
+	intmax_t wait = (pacer.credit >= INITIATE_COST ? 0 :
+			 (INITIATE_COST - pacer.credit) / pacer.rate);
+	intmax_t jitter = get_rnd_uintmax() % (per_initiate + 1);
+	schedule_timeout("pacer", &pacer.timeout,
+			 deltatime_from_microseconds(wait + jitter),
+			 pacer_event, NULL);
+}
+
+static void free_entry(struct pacer_entry **e)
+{
+	connection_delref(&(*e)->connection, &global_logger);
+	free_chunk_content(&(*e)->sec_label);
+	pfree(*e);
+	*e = NULL;
+}
+
+static struct pacer_entry *unlink_entry(enum pacer_queue q, struct pacer_entry **pe)
+{
+	struct pacer_entry *e = *pe;
+	*pe = e->next;
+	if (pacer.queue[q].tail == &e->next) {
+		pacer.queue[q].tail = pe;
+	}
+	pacer.queue[q].depth--;
+	return e;
+}
+
+static void append_entry(enum pacer_queue q, struct pacer_entry *e)
+{
+	if (pacer.queue[q].tail == NULL) {
+		pacer.queue[q].tail = &pacer.queue[q].head;
+	}
+	e->next = NULL;
+	*pacer.queue[q].tail = e;
+	pacer.queue[q].tail = &e->next;
+	pacer.queue[q].depth++;
+}
+
+static struct pacer_entry **find_entry(const struct connection *c, enum pacer_queue *q)
+{
+	for (*q = 0; *q < PACE_QUEUE_ROOF; (*q)++) {
+		for (struct pacer_entry **pe = &pacer.queue[*q].head;
+		     *pe != NULL; pe = &(*pe)->next) {
+			if ((*pe)->connection == c) {
+				return pe;
+			}
+		}
+	}
+	return NULL;
+}
+
+static void flush_entry(enum pacer_queue q, struct pacer_entry **pe,
+			struct logger *logger)
+{
+	if (pe != NULL) {
+		ldbg(logger, "pacer: flushing queued %s initiate",
+		     pacer_queue_name[q]);
+		struct pacer_entry *e = unlink_entry(q, pe);
+		free_entry(&e);
+	}
+}
+
+static void dispatch_entry(struct pacer_entry *e)
+{
+	struct connection *c = e->connection;
+	if (!oriented(c)) {
+		llog(RC_LOG, c->logger, "dropping paced initiate, connection is no longer oriented");
+		pacer.dropped++;
+		return;
+	}
+	ldbg(c->logger, "pacer: releasing %s initiate",
+	     str_enum_short(&initiated_by_names, e->initiated_by, &(name_buf){0}));
+	pacer.dispatching = true;
+	initiate(c, &e->policy, SOS_NOBODY, &e->inception,
+		 HUNK_AS_SHUNK(&e->sec_label), e->detach_whack, c->logger,
+		 e->initiated_by, HERE);
+	pacer.dispatching = false;
+}
+
+static void pacer_event(void *arg UNUSED, const struct timer_event *event UNUSED)
+{
+	destroy_timeout(&pacer.timeout);
+	refill();
+	for (enum pacer_queue q = 0; q < PACE_QUEUE_ROOF; q++) {
+		while (pacer.queue[q].head != NULL) {
+			if (!take_credit()) {
+				schedule_pacer();
+				return;
+			}
+			struct pacer_entry *e = unlink_entry(q, &pacer.queue[q].head);
+			pacer.admitted++;
+			dispatch_entry(e);
+			free_entry(&e);
+		}
+	}
+}
+
+bool pace_initiate(struct connection *c,
+		   const struct child_policy *policy,
+		   const threadtime_t *inception,
+		   shunk_t sec_label,
+		   bool detach_whack,
+		   enum initiated_by initiated_by,
+		   struct logger *logger)
+{
+	if (pacer.dispatching) {
+		/* already admitted */
+		return true;
+	}
+
+	if (pacer.rate == 0) {
+		pacer.admitted++;
+		return true;
+	}
+
+	enum pacer_queue q;
+	switch (initiated_by) {
+	case INITIATED_BY_ACQUIRE:
+		q = PACE_ONDEMAND;
+		break;
+	case INITIATED_BY_WHACK:
+		q = PACE_START;
+		break;
+	case INITIATED_BY_REVIVE:
+		q = PACE_REVIVAL;
+		break;
+	default:
+		q = PACE_QUEUE_ROOF;
+		break;
+	}
+
+	refill();
+
+	/*
+	 * An earlier, lower priority, initiate for the connection
+	 * may still be queued; when this one goes ahead it must be
+	 * flushed or the connection is initiated twice.
+	 */
+	enum pacer_queue old;
+	struct pacer_entry **pe = find_entry(c, &old);
+
+	if (q == PACE_QUEUE_ROOF ||
+	    (initiated_by == INITIATED_BY_WHACK && !detach_whack)) {
+		/* never delayed; but does use up the budget */
+		flush_entry(old, pe, logger);
+		take_credit();
+		pacer.admitted++;
+		return true;
+	}
+
+	/*
+	 * Only jump ahead when nothing of equal or higher priority is
+	 * waiting.
+	 */
+	bool waiting = false;
+	for (enum pacer_queue p = 0; p <= q; p++) {
+		waiting |= (pacer.queue[p].head != NULL);
+	}
+	if (!waiting && take_credit()) {
+		flush_entry(old, pe, logger);
+		pacer.admitted++;
+		return true;
+	}
+
+	if (pe != NULL) {
+		if (old <= q) {
+			ldbg(logger, "pacer: initiate already queued as %s",
+			     pacer_queue_name[old]);
+			return false;
+		}
+		/* promote */
+		struct pacer_entry *e = unlink_entry(old, pe);
+		append_entry(q, e);
+		ldbg(logger, "pacer: initiate promoted from %s to %s",
+		     pacer_queue_name[old], pacer_queue_name[q]);
+		return false;
+	}
+
+	struct pacer_entry *e = alloc_thing(struct pacer_entry, "pacer entry");
+	e->connection = connection_addref(c, &global_logger);
+	e->policy = *policy;
+	e->inception = *inception;
+	e->sec_label = clone_hunk_as_chunk(&sec_label, "pacer sec_label");
+	e->detach_whack = detach_whack;
+	e->initiated_by = initiated_by;
+	append_entry(q, e);
+	pacer.deferred++;
+
+	llog(RC_LOG, logger,
+	     "initiate-rate=%u exceeded, %s initiate queued behind %u others",
+	     pacer.rate, pacer_queue_name[q], queued() - 1);
+	schedule_pacer();
+	return false;
+}
+
+deltatime_t pace_revival_delay(deltatime_t delay)
+{
+	if (pacer.rate == 0) {
+		return delay;
+	}
+	intmax_t ms = milliseconds_from_deltatime(delay);
+	intmax_t jitter = get_rnd_uintmax() % (ms / 2 + 1);
+	return deltatime_from_milliseconds(ms + jitter);
+}
+
+void remove_connection_from_pacer(struct connection *c)
+{
+	enum pacer_queue q;
+	struct pacer_entry **pe = find_entry(c, &q);
+	flush_entry(q, pe, c->logger);
+}
+
+void init_pacer(const struct config_setup *oco, struct logger *logger)
+{
+	pacer.rate = config_setup_option(oco, KBF_INITIATE_RATE);
+	pacer.refilled = mononow();
+	pacer.credit = (intmax_t)pacer.rate * INITIATE_COST;
+	if (pacer.rate > 0) {
+		llog(RC_LOG, logger, "pacing new IKE SA initiates to %u per second",
+		     pacer.rate);
+	}
+}
+
+void free_pacer(struct logger *logger)
+{
+	destroy_timeout(&pacer.timeout);
+	for (enum pacer_queue q = 0; q < PACE_QUEUE_ROOF; q++) {
+		while (pacer.queue[q].head != NULL) {
+			struct pacer_entry *e = unlink_entry(q, &pacer.queue[q].head);
+			llog_pexpect(logger, HERE, "pacer: %s initiate still queued",
+				     pacer_queue_name[q]);
+			free_entry(&e);
+		}
+	}
+}
+
+void show_pacer_status(struct show *s)
+{
+	show(s, "config.setup.initiate_rate=%u", pacer.rate);
+	for (enum pacer_queue q = 0; q < PACE_QUEUE_ROOF; q++) {
+		show(s, "current.pacer.queued.%s=%u",
+		     pacer_queue_name[q], pacer.queue[q].depth);
+	}
+	show(s, "total.pacer.admitted=%ju", pacer.admitted);
+	show(s, "total.pacer.deferred=%ju", pacer.deferred);
+	show(s, "total.pacer.dropped=%ju", pacer.dropped);
+}
@@ -0,0 +1,64 @@
+/* initiation pacer, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#ifndef PACER_H
+#define PACER_H
+
+#include <stdbool.h>
+
+#include "shunk.h"
+#include "pluto_timing.h"	/* for threadtime_t */
+#include "deltatime.h"
+#include "initiated_by.h"
+
+struct connection;
+struct child_policy;
+struct config_setup;
+struct logger;
+struct show;
+
+/*
+ * Limit the rate at which new IKE SAs are initiated to
+ * config-setup's initiate-rate= per second (0, the default, means
+ * unlimited).
+ *
+ * Background initiates (on-demand, auto=start, and revivals) that
+ * exceed the rate are queued, by priority, and then released,
+ * with some jitter, as the budget allows.  Other initiates
+ * (foreground whack, rekey) are never delayed but do consume the
+ * budget.
+ *
+ * Returns true when the caller should go ahead and initiate; false
+ * when the initiate was queued.
+ */
+
+bool pace_initiate(struct connection *c,
+		   const struct child_policy *policy,
+		   const threadtime_t *inception,
+		   shunk_t sec_label,
+		   bool detach_whack,
+		   enum initiated_by initiated_by,
+		   struct logger *logger);
+
+/* with pacing enabled, add up to DELAY/2 to DELAY */
+deltatime_t pace_revival_delay(deltatime_t delay);
+
+void remove_connection_from_pacer(struct connection *c);
+
+void init_pacer(const struct config_setup *oco, struct logger *logger);
+void free_pacer(struct logger *logger);
+void show_pacer_status(struct show *s);
+
+#endif
@@ -18,6 +18,7 @@
  * for more details.
  */
 
+#include <pthread.h>	/* pthread.h must be first include file */
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
@@ -2103,6 +2104,308 @@ static void DBG_prefix_print_pbs_in_struct(const struct pbs_in *pbs,
 	LDBG_print_struct(&global_logger, label, level, struct_ptr, sd, len_meaningful);
 }
 
+/*
+ * Compiled struct decoders.
+ *
+ * The first time a struct_desc is parsed its field list is flattened
+ * into an array of ops with the offset, size and check already worked
+ * out; for single-byte enums the set of known values is expanded into
+ * a bitmap.  When debug-logging is off pbs_in_struct() runs the ops
+ * instead of interpreting the field list.
+ *
+ * The compiled decoder only handles the success path: it writes
+ * nothing but DEST until the whole struct has been accepted and, on
+ * anything unexpected, returns false leaving pbs_in_struct()'s
+ * interpreter to re-parse the struct and produce the diagnostic.
+ *
+ * Only decoding is compiled; encoding always interprets.  pluto
+ * --selftest runs check_struct_codecs() to compare the two decoders;
+ * the seed for the random inputs is logged so that a failure can be
+ * reproduced.
+ */
+
+enum codec_kind {
+	CODEC_ZERO,
+	CODEC_RAW,
+	CODEC_NUMBER,
+	CODEC_LENGTH,
+	CODEC_ENUM,
+	CODEC_ENUM_BITMAP,
+	CODEC_AF,
+	CODEC_LSET,
+};
+
+struct codec_op {
+	enum codec_kind kind;
+	unsigned offset;
+	unsigned size;
+	field_desc *fp;
+	uint32_t known[256 / 32];	/* CODEC_ENUM_BITMAP */
+};
+
+struct struct_codec {
+	struct_desc *sd;
+	struct struct_codec *next;
+	bool compiled;		/* else always interpret */
+	bool has_length;
+	unsigned nr_ops;
+	struct codec_op ops[];
+};
+
+#define STRUCT_CODEC_BUCKETS 64
+
+static struct {
+	pthread_mutex_t mutex;
+	struct struct_codec *buckets[STRUCT_CODEC_BUCKETS];
+} struct_codecs = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static unsigned struct_codec_bucket(struct_desc *sd)
+{
+	return ((uintptr_t)sd / sizeof(void*)) % STRUCT_CODEC_BUCKETS;
+}
+
+static struct struct_codec *find_struct_codec(struct_desc *sd)
+{
+	struct struct_codec *codec =
+		__atomic_load_n(&struct_codecs.buckets[struct_codec_bucket(sd)],
+				__ATOMIC_ACQUIRE);
+	for (; codec != NULL; codec = codec->next) {
+		if (codec->sd == sd) {
+			return codec;
+		}
+	}
+	return NULL;
+}
+
+static bool compile_field(struct codec_op *op, field_desc *fp)
+{
+	switch (fp->field_type) {
+	case ft_zig:
+		/* non-zero bytes are only logged */
+		op->kind = CODEC_ZERO;
+		return true;
+	case ft_raw:
+		op->kind = CODEC_RAW;
+		return true;
+	default:
+		break;
+	}
+
+	if (fp->size != 1 && fp->size != 2 && fp->size != 4) {
+		return false;
+	}
+
+	switch (fp->field_type) {
+	case ft_nat:
+	case ft_mnpc:
+	case ft_pnpc:
+	case ft_lss:
+	case ft_loose_enum:
+	case ft_loose_enum_enum:
+		op->kind = CODEC_NUMBER;
+		return true;
+	case ft_len:
+	case ft_lv:
+		op->kind = CODEC_LENGTH;
+		return true;
+	case ft_af_enum:
+	case ft_af_loose_enum:
+		op->kind = CODEC_AF;
+		return true;
+	case ft_lset:
+		op->kind = CODEC_LSET;
+		return true;
+	case ft_enum:
+		if (fp->size > 1) {
+			op->kind = CODEC_ENUM;
+			return true;
+		}
+		op->kind = CODEC_ENUM_BITMAP;
+		for (unsigned v = 0; v < 256; v++) {
+			name_buf b;
+			if (enum_long(fp->desc, v, &b)) {
+				op->known[v / 32] |= UINT32_C(1) << (v % 32);
+			}
+		}
+		return true;
+	default:
+		return false;
+	}
+}
+
+static struct struct_codec *struct_codec(struct_desc *sd)
+{
+	struct struct_codec *codec = find_struct_codec(sd);
+	if (codec != NULL) {
+		return codec;
+	}
+
+	pthread_mutex_lock(&struct_codecs.mutex);
+	codec = find_struct_codec(sd);
+	if (codec == NULL) {
+		unsigned nr_fields = 0;
+		for (field_desc *fp = sd->fields; fp->field_type != ft_end; fp++) {
+			nr_fields++;
+		}
+		codec = alloc_bytes(sizeof(*codec) + nr_fields * sizeof(codec->ops[0]),
+				    "struct codec");
+		codec->sd = sd;
+		codec->compiled = true;
+		unsigned offset = 0;
+		for (field_desc *fp = sd->fields; fp->field_type != ft_end; fp++) {
+			struct codec_op *op = &codec->ops[codec->nr_ops++];
+			op->offset = offset;
+			op->size = fp->size;
+			op->fp = fp;
+			if (!compile_field(op, fp)) {
+				codec->compiled = false;
+			}
+			if (op->kind == CODEC_LENGTH) {
+				codec->has_length = true;
+			}
+			offset += fp->size;
+		}
+		if (offset != sd->size) {
+			codec->compiled = false;
+		}
+		unsigned b = struct_codec_bucket(sd);
+		codec->next = struct_codecs.buckets[b];
+		__atomic_store_n(&struct_codecs.buckets[b], codec, __ATOMIC_RELEASE);
+	}
+	pthread_mutex_unlock(&struct_codecs.mutex);
+	return codec;
+}
+
+void free_struct_codecs(void)
+{
+	pthread_mutex_lock(&struct_codecs.mutex);
+	for (unsigned b = 0; b < STRUCT_CODEC_BUCKETS; b++) {
+		struct struct_codec *codec = struct_codecs.buckets[b];
+		while (codec != NULL) {
+			struct struct_codec *next = codec->next;
+			pfree(codec);
+			codec = next;
+		}
+		struct_codecs.buckets[b] = NULL;
+	}
+	pthread_mutex_unlock(&struct_codecs.mutex);
+}
+
+/*
+ * Caller has checked that INS contains SD->SIZE bytes.
+ */
+
+static bool decode_struct(struct pbs_in *ins, const struct struct_codec *codec,
+			  uint8_t *dest, struct pbs_in *obj_pbs)
+{
+	struct_desc *sd = codec->sd;
+	const uint8_t *cur = ins->cur;
+	const uint8_t *roof = cur + sd->size;
+	bool immediate = false;
+
+	for (const struct codec_op *op = codec->ops;
+	     op < codec->ops + codec->nr_ops; op++) {
+		const uint8_t *in = cur + op->offset;
+		uint8_t *out = dest + op->offset;
+
+		switch (op->kind) {
+		case CODEC_ZERO:
+			memset(out, 0, op->size);
+			continue;
+		case CODEC_RAW:
+			memcpy(out, in, op->size);
+			continue;
+		default:
+			break;
+		}
+
+		uint32_t n;
+		switch (op->size) {
+		case 1:
+			n = in[0];
+			break;
+		case 2:
+			n = ((uint32_t)in[0] << 8) | in[1];
+			break;
+		default: /* 4 */
+			n = (((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) |
+			     ((uint32_t)in[2] << 8) | in[3]);
+			break;
+		}
+
+		switch (op->kind) {
+		case CODEC_LENGTH:
+		{
+			size_t len = (op->fp->field_type == ft_len ? n :
+				      immediate ? sd->size :
+				      n + sd->size);
+			if (len < sd->size || pbs_left(ins) < len) {
+				return false;
+			}
+			roof = ins->cur + len;
+			break;
+		}
+		case CODEC_AF:
+		{
+			immediate = ((n & ISAKMP_ATTR_AF_MASK) == ISAKMP_ATTR_AF_TV);
+			name_buf b;
+			if (op->fp->field_type == ft_af_enum &&
+			    !enum_long(op->fp->desc, n, &b)) {
+				return false;
+			}
+			break;
+		}
+		case CODEC_ENUM_BITMAP:
+			if ((op->known[n / 32] & (UINT32_C(1) << (n % 32))) == 0) {
+				return false;
+			}
+			break;
+		case CODEC_ENUM:
+		{
+			name_buf b;
+			if (!enum_long(op->fp->desc, n, &b)) {
+				return false;
+			}
+			break;
+		}
+		case CODEC_LSET:
+			if (!test_lset(op->fp->desc, n)) {
+				return false;
+			}
+			break;
+		default:
+			break;
+		}
+
+		switch (op->size) {
+		case 1:
+			*(uint8_t *)out = n;
+			break;
+		case 2:
+			*(uint16_t *)out = n;
+			break;
+		default: /* 4 */
+			*(uint32_t *)out = n;
+			break;
+		}
+	}
+
+	if (obj_pbs != NULL) {
+		*obj_pbs = pbs_in_from_shunk(shunk2(ins->cur, roof - ins->cur), sd->name);
+		obj_pbs->cur = cur + sd->size; /* skip header */
+		obj_pbs->level = ins->level + 1;
+		obj_pbs->desc = sd;
+	}
+	ins->cur = roof;
+	return true;
+}
+
+static diag_t interpret_struct(struct pbs_in *ins, struct_desc *sd,
+			       void *dest_start, size_t dest_size,
+			       struct pbs_in *obj_pbs);
+
 /* "parse" a network struct into a host struct.
  *
  * This code assumes that the network and host structure
@@ -2131,6 +2434,41 @@ diag_t pbs_in_struct(struct pbs_in *ins, struct_desc *sd,
 	}
 
 	PASSERT(logger, dest_size >= sd->size);
+
+	if (!LDBGP(DBG_BASE, logger)) {
+		const struct struct_codec *codec = struct_codec(sd);
+		if (codec->compiled &&
+		    codec->has_length == (obj_pbs != NULL) &&
+		    decode_struct(ins, codec, dest_start, obj_pbs)) {
+			return NULL;
+		}
+		/* interpret; and when it fails, explain why */
+	}
+
+	diag_t d = interpret_struct(ins, sd, dest_start, dest_size, obj_pbs);
+	if (d != NULL) {
+		return d;
+	}
+
+	if (LDBGP(DBG_BASE, logger)) {
+		DBG_prefix_print_pbs_in_struct(ins, "parse ",
+					       dest_start, sd,
+					       true);
+	}
+	return NULL;
+}
+
+/*
+ * Caller has checked that INS contains SD->SIZE bytes and DEST_SIZE
+ * can hold them.
+ */
+
+static diag_t interpret_struct(struct pbs_in *ins, struct_desc *sd,
+			       void *dest_start, size_t dest_size,
+			       struct pbs_in *obj_pbs)
+{
+	const struct logger *logger = &global_logger;
+	const uint8_t *cur = ins->cur;
 	const uint8_t *roof = cur + sd->size; /* may be changed by a length field */
 	bool length_field_found = false;
 	uint8_t *dest = dest_start;
@@ -2321,14 +2659,244 @@ diag_t pbs_in_struct(struct pbs_in *ins, struct_desc *sd,
 		obj_pbs->desc = sd;
 	}
 	ins->cur = roof;
-	if (LDBGP(DBG_BASE, logger)) {
-		DBG_prefix_print_pbs_in_struct(ins, "parse ",
-					       dest_start, sd,
-					       true);
-	}
 	return NULL;
 }
 
+/*
+ * Check that the compiled decoders agree with interpret_struct().
+ *
+ * Both decoders are run over a corpus (every 1-byte value, and every
+ * value with the attribute-format bit set, in each field of an
+ * otherwise valid struct) and then over NR_RANDOM pseudo-random
+ * structs followed by some payload.  They must both accept or both
+ * reject and, when accepting, leave identical results.
+ */
+
+static struct_desc *const checked_struct_descs[] = {
+	&isakmp_hdr_desc,
+	&raw_isakmp_hdr_desc,
+	&isakmp_oakley_attribute_desc,
+	&isakmp_ipsec_attribute_desc,
+	&isakmp_xauth_attribute_desc,
+	&isakmp_sa_desc,
+	&ipsec_sit_desc,
+	&isakmp_proposal_desc,
+	&isakmp_isakmp_transform_desc,
+	&isakmp_ah_transform_desc,
+	&isakmp_esp_transform_desc,
+	&isakmp_ipcomp_transform_desc,
+	&isakmp_keyex_desc,
+	&isakmp_identification_desc,
+	&isakmp_ipsec_identification_desc,
+	&isakmp_ipsec_certificate_desc,
+	&isakmp_ipsec_cert_req_desc,
+	&isakmp_hash_desc,
+	&isakmp_signature_desc,
+	&isakmp_nonce_desc,
+	&isakmp_notification_desc,
+	&isakmp_delete_desc,
+	&isakmp_vendor_id_desc,
+	&isakmp_attr_desc,
+	&isakmp_nat_d,
+	&isakmp_nat_d_drafts,
+	&isakmp_nat_oa,
+	&isakmp_nat_oa_drafts,
+	&isakmp_ignore_desc,
+	&isakmp_ikefrag_desc,
+	&ikev2_generic_desc,
+	&ikev2_unknown_payload_desc,
+	&ikev2_sa_desc,
+	&ikev2_prop_desc,
+	&ikev2_trans_desc,
+	&ikev2_trans_attr_desc,
+	&ikev2_ke_desc,
+	&ikev2_id_i_desc,
+	&ikev2_id_r_desc,
+	&ikev2_ppk_id_desc,
+	&ikev2_cp_desc,
+	&ikev2_cp_attribute_desc,
+	&ikev2_certificate_desc,
+	&ikev2_certificate_req_desc,
+	&ikev2_auth_desc,
+	&ikev2_nonce_desc,
+	&ikev2_notify_desc,
+	&ikev2_delete_desc,
+	&ikev2_vendor_id_desc,
+	&ikev2_ts_i_desc,
+	&ikev2_ts_r_desc,
+	&ikev2_ts_header_desc,
+	&ikev2_ts_portrange_desc,
+	&ikev2_sk_desc,
+	&ikev2_eap_desc,
+	&eap_termination_desc,
+	&eap_tls_desc,
+	&ikev2_skf_desc,
+	&ikev2_redirect_desc,
+	&ikev2_suggested_kem_desc,
+	&ikev2_ticket_lifetime_desc,
+	&ikev2notify_ipcomp_data_desc,
+};
+
+#define CHECK_PAYLOAD 16	/* bytes after the struct */
+
+static void put_field(uint8_t *in, const struct codec_op *op, uint32_t n)
+{
+	for (unsigned i = op->size; i > 0; i--) {
+		in[op->offset + i - 1] = n;
+		n >>= 8;
+	}
+}
+
+static void check_struct_codec(const struct struct_codec *codec,
+			       const uint8_t *in, size_t len,
+			       struct logger *logger)
+{
+	struct_desc *sd = codec->sd;
+	/* uint32_t keeps the fields aligned */
+	uint32_t compiled[(sd->size + 3) / 4];
+	uint32_t interpreted[(sd->size + 3) / 4];
+	/* garbage, so that an unwritten byte shows up */
+	memset(compiled, 0xa5, sd->size);
+	memset(interpreted, 0x5a, sd->size);
+
+	struct pbs_in compiled_ins = pbs_in_from_shunk(shunk2(in, len), "compiled");
+	struct pbs_in compiled_obj = {0};
+	bool compiled_ok = decode_struct(&compiled_ins, codec, (uint8_t *)compiled,
+					 (codec->has_length ? &compiled_obj : NULL));
+
+	struct pbs_in interpreted_ins = pbs_in_from_shunk(shunk2(in, len), "interpreted");
+	struct pbs_in interpreted_obj = {0};
+	diag_t d = interpret_struct(&interpreted_ins, sd, interpreted, sd->size,
+				    (codec->has_length ? &interpreted_obj : NULL));
+	bool interpreted_ok = (d == NULL);
+	pfree_diag(&d);
+
+	if (compiled_ok != interpreted_ok) {
+		llog_passert(logger, HERE, "%s: compiled decoder %s but interpreter %s",
+			     sd->name,
+			     (compiled_ok ? "accepted" : "rejected"),
+			     (interpreted_ok ? "accepted" : "rejected"));
+	}
+	if (!compiled_ok) {
+		return;
+	}
+	if (!memeq(compiled, interpreted, sd->size)) {
+		llog_passert(logger, HERE, "%s: compiled decoder produced a different struct",
+			     sd->name);
+	}
+	if (compiled_ins.cur != interpreted_ins.cur) {
+		llog_passert(logger, HERE, "%s: compiled decoder consumed %td bytes, interpreter %td",
+			     sd->name,
+			     compiled_ins.cur - compiled_ins.start,
+			     interpreted_ins.cur - interpreted_ins.start);
+	}
+	if (codec->has_length &&
+	    (compiled_obj.start != interpreted_obj.start ||
+	     compiled_obj.cur != interpreted_obj.cur ||
+	     compiled_obj.roof != interpreted_obj.roof ||
+	     compiled_obj.level != interpreted_obj.level ||
+	     compiled_obj.desc != interpreted_obj.desc)) {
+		llog_passert(logger, HERE, "%s: compiled decoder produced a different body",
+			     sd->name);
+	}
+}
+
+void check_struct_codecs(unsigned nr_random, uint32_t seed, struct logger *logger)
+{
+	/* xorshift32 never leaves zero */
+	if (seed == 0) {
+		seed = 0x2545F491;
+	}
+	llog(RC_LOG, logger, "checking struct codecs using %u random inputs with seed %" PRIu32,
+	     nr_random, seed);
+
+	/*
+	 * The interpreter logs stray non-zero bytes when debugging;
+	 * the corpus is full of them.  Nothing else is running yet.
+	 */
+	lset_t debugging = cur_debugging;
+	cur_debugging = LEMPTY;
+
+	unsigned nr_checks = 0;
+
+	FOR_EACH_ELEMENT(sdp, checked_struct_descs) {
+		const struct struct_codec *codec = struct_codec(*sdp);
+		if (!codec->compiled) {
+			/* always interpreted */
+			continue;
+		}
+
+		size_t len = codec->sd->size + CHECK_PAYLOAD;
+		uint8_t in[len];
+
+		/*
+		 * Corpus: start with a struct that is all zero but
+		 * with the length covering the struct, then try each
+		 * value in each field.
+		 */
+		uint8_t base[len];
+		memset(base, 0, len);
+		for (unsigned i = 0; i < codec->nr_ops; i++) {
+			const struct codec_op *op = &codec->ops[i];
+			if (op->kind == CODEC_LENGTH && op->fp->field_type == ft_len) {
+				put_field(base, op, codec->sd->size);
+			}
+		}
+		check_struct_codec(codec, base, len, logger);
+		nr_checks++;
+
+		for (unsigned i = 0; i < codec->nr_ops; i++) {
+			const struct codec_op *op = &codec->ops[i];
+			for (unsigned af = 0; af < (op->size > 1 ? 2 : 1); af++) {
+				for (unsigned v = 0; v < 256; v++) {
+					memcpy(in, base, len);
+					put_field(in, op, v);
+					if (af) {
+						in[op->offset] |= 0x80; /* ISAKMP_ATTR_AF_TV */
+					}
+					check_struct_codec(codec, in, len, logger);
+					/* also with the payload cut short */
+					check_struct_codec(codec, in, codec->sd->size, logger);
+					nr_checks += 2;
+				}
+			}
+		}
+
+		memset(in, 0xff, len);
+		check_struct_codec(codec, in, len, logger);
+		nr_checks++;
+
+		/*
+		 * Random: any bytes, any payload length; half the
+		 * time make the length field plausible.
+		 */
+		for (unsigned r = 0; r < nr_random; r++) {
+			for (size_t i = 0; i < len; i++) {
+				/* xorshift32 */
+				seed ^= seed << 13;
+				seed ^= seed >> 17;
+				seed ^= seed << 5;
+				in[i] = seed;
+			}
+			size_t payload = seed % (CHECK_PAYLOAD + 1);
+			if (seed & 0x100) {
+				for (unsigned i = 0; i < codec->nr_ops; i++) {
+					const struct codec_op *op = &codec->ops[i];
+					if (op->kind == CODEC_LENGTH) {
+						put_field(in, op, ((op->fp->field_type == ft_len ? codec->sd->size : 0) +
+								   (seed >> 9) % (payload + 1)));
+					}
+				}
+			}
+			check_struct_codec(codec, in, codec->sd->size + payload, logger);
+			nr_checks++;
+		}
+	}
+
+	cur_debugging = debugging;
+	ldbg(logger, "struct codecs agree with the interpreter for %u inputs", nr_checks);
+}
+
 /* return first byte. If no byte return -1 */
 int pbs_peek_byte(const struct pbs_in *ins)
 {
@@ -240,6 +240,8 @@ struct pbs_in pbs_in_from_shunk(shunk_t shunk, const char *name); /* XXX: hackis
 diag_t pbs_in_struct(struct pbs_in *ins, struct_desc *sd,
 		     void *struct_ptr, size_t struct_size,
 		     struct pbs_in *obj_pbs) MUST_USE_RESULT;
+void free_struct_codecs(void);	/* compiled by pbs_in_struct() */
+void check_struct_codecs(unsigned nr_random, uint32_t seed, struct logger *logger);
 diag_t pbs_in_bytes(struct pbs_in *pbs, void *bytes, size_t len,
 		    const char *name) MUST_USE_RESULT;
 diag_t pbs_in_shunk(struct pbs_in *pbs, size_t len, shunk_t *shunk,
@@ -80,6 +80,7 @@ static void init_seccomp(uint32_t def_action, bool main, struct logger *logger)
 		LSW_SECCOMP_ADD(epoll_ctl);
 		LSW_SECCOMP_ADD(epoll_pwait);
 		LSW_SECCOMP_ADD(epoll_wait);
+		LSW_SECCOMP_ADD(eventfd2);
 		LSW_SECCOMP_ADD(execve);
 		LSW_SECCOMP_ADD(faccessat);
 #if SCMP_SYS(faccessat2)
@@ -120,6 +121,7 @@ static void init_seccomp(uint32_t def_action, bool main, struct logger *logger)
 		LSW_SECCOMP_ADD(readlink);
 		LSW_SECCOMP_ADD(readlinkat);
 		LSW_SECCOMP_ADD(recvfrom);
+		LSW_SECCOMP_ADD(recvmmsg);
 		LSW_SECCOMP_ADD(recvmsg);
 #if SCMP_SYS(rseq)
 		LSW_SECCOMP_ADD(rseq);
@@ -138,6 +140,7 @@ static void init_seccomp(uint32_t def_action, bool main, struct logger *logger)
 		LSW_SECCOMP_ADD(uname);
 		LSW_SECCOMP_ADD(unlink);
 		LSW_SECCOMP_ADD(unlinkat);
+		LSW_SECCOMP_ADD(writev);
 	}
 
 	/* common to pluto and helpers */
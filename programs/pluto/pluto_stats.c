@@ -47,6 +47,8 @@ unsigned long pstats_ikev1_completed;
 unsigned long pstats_ikev2_completed;
 unsigned long pstats_ikev2_redirect_failed;
 unsigned long pstats_ikev2_redirect_completed;
+unsigned long pstats_ikev2_session_resume_failed;
+unsigned long pstats_ikev2_session_resume_completed;
 unsigned long pstats_ikev1_encr[OAKLEY_ENCR_PSTATS_ROOF];
 unsigned long pstats_ikev2_encr[IKEv2_ENCR_PSTATS_ROOF];
 unsigned long pstats_ikev1_integ[OAKLEY_HASH_PSTATS_ROOF];
@@ -88,6 +90,9 @@ unsigned long pstats_pamauth_started;
 unsigned long pstats_pamauth_stopped;
 unsigned long pstats_pamauth_aborted;
 
+unsigned long pstats_private_key_lookups;
+unsigned long pstats_private_key_cached;
+
 /*
  * Anything <FLOOR or >= ROOF is counted as [ROOF].
  */
@@ -417,6 +422,8 @@ void whack_showstats(const struct whack_message *wm UNUSED, struct show *s)
 	show(s, "total.ike.ikev2.completed=%lu", pstats_ikev2_completed);
 	show(s, "total.ike.ikev2.redirect.completed=%lu", pstats_ikev2_redirect_completed);
 	show(s, "total.ike.ikev2.redirect.failed=%lu", pstats_ikev2_redirect_failed);
+	show(s, "total.ike.ikev2.session_resume.completed=%lu", pstats_ikev2_session_resume_completed);
+	show(s, "total.ike.ikev2.session_resume.failed=%lu", pstats_ikev2_session_resume_failed);
 	show(s, "total.ike.ikev1.established=%lu", pstats_ikev1_sa);
 	show(s, "total.ike.ikev1.failed=%lu", pstats_ikev1_fail);
 	show(s, "total.ike.ikev1.completed=%lu", pstats_ikev1_completed);
@@ -456,6 +463,9 @@ void whack_showstats(const struct whack_message *wm UNUSED, struct show *s)
 	show(s, "total.pamauth.stopped=%lu", pstats_pamauth_stopped);
 	show(s, "total.pamauth.aborted=%lu", pstats_pamauth_aborted);
 
+	show(s, "total.private_key.lookups=%lu", pstats_private_key_lookups);
+	show(s, "total.private_key.cached=%lu", pstats_private_key_cached);
+
 	show(s, "total.iketcp.client.started=%lu", pstats_iketcp_started[false]);
 	show(s, "total.iketcp.client.stopped=%lu", pstats_iketcp_stopped[false]);
 	show(s, "total.iketcp.client.aborted=%lu", pstats_iketcp_aborted[false]);
@@ -490,6 +500,39 @@ void whack_showstats(const struct whack_message *wm UNUSED, struct show *s)
 	show_pluto_stat(s, &pstats_ikev2_recv_notifies_e);
 	show_pluto_stat(s, &pstats_ikev2_sent_notifies_s);
 	show_pluto_stat(s, &pstats_ikev2_recv_notifies_s);
+
+	/* memory */
+	uintmax_t nr_instances = 0;
+	uintmax_t instance_bytes = 0;
+	uintmax_t shared_bytes = 0;
+	struct connection_filter cq = {
+		.search = {
+			.order = OLD2NEW,
+			.verbose.logger = show_logger(s),
+			.where = HERE,
+		},
+	};
+	while (next_connection(&cq)) {
+		if (is_instance(cq.c)) {
+			nr_instances++;
+			instance_bytes += connection_footprint(cq.c);
+			shared_bytes += connection_shared_footprint(cq.c);
+		}
+	}
+	show(s, "total.pluto.connection.instances=%ju", nr_instances);
+	show(s, "total.pluto.connection.instance.bytes=%ju", instance_bytes);
+	show(s, "total.pluto.connection.instance.bytes_per_instance=%ju",
+	     (nr_instances == 0 ? 0 : instance_bytes / nr_instances));
+	show(s, "total.pluto.connection.instance.shared_bytes=%ju", shared_bytes);
+
+	struct slab_stats slabs[16];
+	unsigned nr_slabs = slab_stats(slabs, elemsof(slabs));
+	for (unsigned i = 0; i < nr_slabs && i < elemsof(slabs); i++) {
+		show(s, "total.pluto.slab.%s.live=%ju", slabs[i].name, slabs[i].live);
+		show(s, "total.pluto.slab.%s.peak=%ju", slabs[i].name, slabs[i].peak);
+		show(s, "total.pluto.slab.%s.reserved=%ju", slabs[i].name, slabs[i].reserved);
+		show(s, "total.pluto.slab.%s.size=%zu", slabs[i].name, slabs[i].size);
+	}
 }
 
 void whack_clearstats(const struct whack_message *wm UNUSED, struct show *s)
@@ -501,6 +544,7 @@ void whack_clearstats(const struct whack_message *wm UNUSED, struct show *s)
 	pstats_ikev1_fail = pstats_ikev2_fail = 0;
 	pstats_ikev1_completed = pstats_ikev2_completed = 0;
 	pstats_ikev2_redirect_failed = pstats_ikev2_redirect_completed=0;
+	pstats_ikev2_session_resume_failed = pstats_ikev2_session_resume_completed = 0;
 
 	memset(pstats_sa_started, 0, sizeof pstats_sa_started);
 	memset(pstats_sa_finished, 0, sizeof pstats_sa_finished);
@@ -517,6 +561,7 @@ void whack_clearstats(const struct whack_message *wm UNUSED, struct show *s)
 	pstats_ipsec_esn = pstats_ipsec_tfc = 0;
 	pstats_ike_dpd_recv = pstats_ike_dpd_sent = pstats_ike_dpd_replied = 0;
 	pstats_pamauth_started = pstats_pamauth_stopped = pstats_pamauth_aborted = 0;
+	pstats_private_key_lookups = pstats_private_key_cached = 0;
 
 	memset(pstats_iketcp_started, 0, sizeof(pstats_iketcp_started));
 	memset(pstats_iketcp_stopped, 0, sizeof(pstats_iketcp_stopped));
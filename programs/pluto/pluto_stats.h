@@ -71,8 +71,13 @@ extern unsigned long pstats_pamauth_started;
 extern unsigned long pstats_pamauth_stopped;
 extern unsigned long pstats_pamauth_aborted;
 
+extern unsigned long pstats_private_key_lookups;	/* get_local_private_key() */
+extern unsigned long pstats_private_key_cached;
+
 extern unsigned long pstats_ikev2_redirect_failed;
 extern unsigned long pstats_ikev2_redirect_completed;
+extern unsigned long pstats_ikev2_session_resume_failed;
+extern unsigned long pstats_ikev2_session_resume_completed;
 
 extern void whack_showstats(const struct whack_message *wm, struct show *s);
 extern void whack_clearstats(const struct whack_message *wm, struct show *s);
@@ -39,6 +39,7 @@
 #include <unistd.h>	/* for unlink(), write(), close(), access(), et.al. */
 
 #include "optarg.h"
+#include "realtime.h"		/* for realnow() */
 #include "deltatime.h"
 #include "timescale.h"
 #include "lswversion.h"
@@ -69,6 +70,7 @@
 #include "root_certs.h"		/* for init_root_certs() */
 #include "ikev1_states.h"	/* for init_ikev1_states() */
 #include "ikev2_states.h"	/* for init_ikev2_states() */
+#include "packet.h"		/* for check_struct_codecs() */
 #include "crypt_symkey.h"	/* for init_crypt_symkey() */
 #include "ddns.h"		/* for init_ddns() */
 #include "x509_crl.h"		/* for free_crl_queue() */
@@ -82,6 +84,11 @@
 #include "ikev2_unsecured.h"	/* for pluto_drop_oppo_null; */
 #include "updown.h"		/* for pluto_dns_resolver; */
 #include "ddos.h"
+#include "pacer.h"		/* for init_pacer() */
+#include "rekey_smoothing.h"	/* for init_rekey_smoothing() */
+#include "checkpoint.h"		/* for init_checkpoint() */
+#include "replication.h"	/* for init_replication() */
+#include "redirect_load.h"	/* for init_redirect_load() */
 
 #ifndef IPSECDIR
 #define IPSECDIR "/etc/ipsec.d"
@@ -248,9 +255,14 @@ static void get_bsi_random(size_t nbytes, unsigned char *buf, struct logger *log
 	ldbg(logger, "read %zu bytes from /dev/random for NSS PRNG", nbytes);
 }
 
-static void pluto_init_nss(const char *nssdir, struct logger *logger)
+static void pluto_init_nss(const char *nssdir, const struct config_setup *oco,
+			   struct logger *logger)
 {
-	init_nss(nssdir, (struct nss_flags) { .open_readonly = true}, logger);
+	/* warm-restart and replication may need to create their key-wrapping key */
+	bool readonly = (!config_setup_yn(oco, KYN_WARM_RESTART) &&
+			 config_setup_string(oco, KSF_REPLICATE_TO) == NULL &&
+			 config_setup_string(oco, KSF_REPLICATE_FROM) == NULL);
+	init_nss(nssdir, (struct nss_flags) { .open_readonly = readonly, }, logger);
 	llog(RC_LOG, logger, "NSS crypto library initialized");
 }
 
@@ -1084,9 +1096,12 @@ int main(int argc, char **argv)
 	init_global_redirect(config_setup_option(oco, KBF_GLOBAL_REDIRECT),
 			     config_setup_string(oco, KSF_GLOBAL_REDIRECT_TO),
 			     logger);
+	init_redirect_load(oco, logger);
 
 	/* ddos */
 	init_ddos(oco, logger);
+	init_pacer(oco, logger);
+	init_rekey_smoothing(oco, logger);
 
 	/* listening et.al.? */
 	init_ifaces(oco, logger);
@@ -1309,9 +1324,10 @@ int main(int argc, char **argv)
 	init_states();
 	state_db_init(logger);
 	connection_db_init(logger);
+	connection_alias_db_init(logger);
 	spd_db_init(logger);
 
-	pluto_init_nss(config_setup_nssdir(), logger);
+	pluto_init_nss(config_setup_nssdir(), oco, logger);
 	init_seedbits(oco, logger);
 	init_demux(oco, logger);
 
@@ -1496,11 +1512,15 @@ int main(int argc, char **argv)
 	init_root_certs(logger);
 	init_secret_timer(logger);
 	init_ike_alg(logger);
-	test_ike_alg(logger);
+	test_ike_alg(NULL, logger);
 
 	init_vendorid(logger);
 
 	if (selftest_only) {
+		/* a different corpus each run */
+		realtime_t now = realnow();
+		check_struct_codecs(4096, (uint32_t)(now.rt.tv_sec ^ now.rt.tv_usec ^ getpid()),
+				    logger);
 		/*
 		 * skip pluto_exit()
 		 *
@@ -1513,7 +1533,10 @@ int main(int argc, char **argv)
 
 	start_server_helpers(config_setup_option(oco, KBF_NHELPERS), logger);
 
+	/* before init_kernel() flushes the kernel's SAs */
+	init_checkpoint(oco, logger);
 	init_kernel(oco, logger);
+	init_replication(oco, logger);
 
 #if defined(USE_LIBCURL) || defined(USE_LDAP)
 	bool crl_enabled = init_x509_crl_queue(logger);
@@ -1660,4 +1683,5 @@ void show_setup_plutomain(struct show *s)
 	show_x509_ocsp(s);
 
 	show_global_redirect(s);
+	show_redirect_load(s);
 }
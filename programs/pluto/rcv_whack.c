@@ -59,6 +59,7 @@
 
 #include "visit_connection.h"
 #include "whack_add.h"
+#include "orient.h"			/* for check_orientations() */
 #include "whack_briefconnectionstatus.h"
 #include "whack_connectionstatus.h"
 #include "whack_crash.h"
@@ -80,6 +81,7 @@
 #include "whack_suspend.h"
 #include "whack_trafficstatus.h"
 #include "whack_unroute.h"
+#include "replication.h"		/* for whack_takeover() */
 
 static void whack_unlisten(const struct whack_message *wm UNUSED, struct show *s)
 {
@@ -507,6 +509,11 @@ static void dispatch_command(const struct whack_message *const wm, struct show *
 			.name = "unlisten",
 			.op = whack_unlisten,
 		},
+		/**/
+		[WHACK_TAKEOVER] = {
+			.name = "takeover",
+			.op = whack_takeover,
+		},
 	};
 
 	struct logger *logger = show_logger(s);
@@ -608,7 +615,125 @@ static void whack_process(const struct whack_message *const m, struct show *s)
 	return;
 }
 
-static void whack_handle(struct fd *whackfd, struct logger *whack_logger);
+/*
+ * A whack batch (addconn --autoall) sends many messages, each
+ * flagged .whack_batch, down the one socket.  Each message is read
+ * as the socket becomes readable (so other events keep running)
+ * until addconn shuts down its end.  The replies to each message are
+ * ended with an RC_WHACK_BATCH record so that addconn can tell which
+ * connection failed.
+ *
+ * Connections added by the batch are left unoriented (see
+ * extract_connection()); once the batch ends they are oriented in a
+ * single pass over the interfaces, instead of the interface list
+ * being scanned for each connection, and then logged as added.
+ */
+
+struct whack_batch {
+	struct fd *whackfd;
+	struct logger logger;		/* with .whackfd[0] attached */
+	struct fd_read_listener *listener;
+	unsigned nr_messages;
+	struct {
+		unsigned len;
+		co_serial_t *list;
+	} added;
+	struct whack_batch *next;
+};
+
+static struct whack_batch *whack_batches;
+static struct whack_batch *current_whack_batch;	/* processing a message */
+
+static bool whack_handle_msg(struct fd *whackfd, struct logger *whack_logger,
+			     struct whack_batch **batch);
+
+void whack_batch_add_connection(struct connection *c)
+{
+	struct whack_batch *batch = current_whack_batch;
+	if (PBAD(c->logger, batch == NULL)) {
+		/* not reading a batch; orient it now */
+		orient(c, c->logger);
+		connection_added(c);
+		return;
+	}
+	realloc_things(batch->added.list, batch->added.len,
+		       batch->added.len + 1, "whack batch connections");
+	batch->added.list[batch->added.len++] = c->serialno;
+}
+
+static void whack_orient_batch(struct whack_batch *batch)
+{
+	for (struct iface_device *iface = next_iface_device(NULL);
+	     iface != NULL; iface = next_iface_device(iface)) {
+		check_orientations(&iface->local_address,
+				   /*log_oriented*/false, &batch->logger);
+	}
+
+	for (unsigned i = 0; i < batch->added.len; i++) {
+		/* could have been deleted by a later message */
+		struct connection *c = connection_by_serialno(batch->added.list[i]);
+		if (c == NULL) {
+			continue;
+		}
+		whack_attach(c, &batch->logger);
+		connection_added(c);
+		whack_detach(c, &batch->logger);
+	}
+}
+
+static void free_whack_batch(struct whack_batch **batchp)
+{
+	struct whack_batch *batch = *batchp;
+	*batchp = NULL;
+
+	for (struct whack_batch **pp = &whack_batches; *pp != NULL; pp = &(*pp)->next) {
+		if (*pp == batch) {
+			*pp = batch->next;
+			break;
+		}
+	}
+	detach_fd_read_listener(&batch->listener);
+	fd_delref(&batch->whackfd, &batch->logger);
+	pfreeany(batch->added.list);
+	pfree(batch);
+}
+
+static void whack_batch_cb(int fd UNUSED, void *arg, struct logger *logger UNUSED)
+{
+	threadtime_t start = threadtime_start();
+	struct whack_batch *batch = arg;
+	if (whack_handle_msg(batch->whackfd, &batch->logger, &batch)) {
+		batch->nr_messages++;
+	} else {
+		ldbg(&batch->logger, "whack batch of %u messages adding %u connections",
+		     batch->nr_messages, batch->added.len);
+		if (!exiting_pluto) {
+			whack_orient_batch(batch);
+		}
+		free_whack_batch(&batch);
+	}
+	threadtime_stop(&start, SOS_NOBODY, "whack batch");
+}
+
+static struct whack_batch *alloc_whack_batch(struct fd *whackfd,
+					     const struct logger *whack_logger)
+{
+	struct whack_batch *batch = alloc_thing(struct whack_batch, "whack batch");
+	batch->whackfd = fd_addref(whackfd, whack_logger);
+	batch->logger = *whack_logger;
+	batch->logger.whackfd[0] = batch->whackfd;
+	batch->next = whack_batches;
+	whack_batches = batch;
+	return batch;
+}
+
+void free_whack_batches(void)
+{
+	while (whack_batches != NULL) {
+		struct whack_batch *batch = whack_batches;
+		free_whack_batch(&batch);
+	}
+}
 
 void whack_handle_cb(int fd, void *arg UNUSED, struct logger *global_logger)
 {
@@ -632,7 +757,19 @@ void whack_handle_cb(int fd, void *arg UNUSED, struct logger *global_logger)
 		whack_logger.whackfd[0] = whackfd;
 		whack_logger.where = HERE;
 
-		whack_handle(whackfd, &whack_logger);
+		struct whack_batch *batch = NULL;
+		if (whack_handle_msg(whackfd, &whack_logger, &batch)) {
+			/* more to come; read them as they arrive */
+			batch->nr_messages = 1;
+			attach_fd_read_listener(&batch->listener, fd_raw(batch->whackfd),
+						"whack batch", whack_batch_cb, batch);
+		} else if (batch != NULL) {
+			/* batch of one */
+			if (!exiting_pluto) {
+				whack_orient_batch(batch);
+			}
+			free_whack_batch(&batch);
+		}
 
 		fd_delref(&whackfd, &whack_logger);
 	}
@@ -641,9 +778,14 @@ void whack_handle_cb(int fd, void *arg UNUSED, struct logger *global_logger)
 
 /*
  * Handle a whack request.
+ *
+ * Returns true when the message was part of a batch and more are
+ * expected; *BATCH is allocated by the first batched message.  For a
+ * batch, a zero length read is the end, not an error.
  */
 
-static void whack_handle(struct fd *whackfd, struct logger *whack_logger)
+static bool whack_handle_msg(struct fd *whackfd, struct logger *whack_logger,
+			     struct whack_batch **batch)
 {
 	/*
 	 * properly initialize msg - needed because short reads are
@@ -652,10 +794,13 @@ static void whack_handle(struct fd *whackfd, struct logger *whack_logger)
 	struct whack_message msg = {0};
 
 	ssize_t n = fd_read(whackfd, &msg, sizeof(msg));
+	if (n == 0 && *batch != NULL) {
+		return false;
+	}
 	if (n <= 0) {
 		llog_errno(ERROR_STREAM, whack_logger, -(int)n,
 			   "read() failed in whack_handle(): ");
-		return;
+		return false;
 	}
 
 	static uintmax_t msgnum;
@@ -678,7 +823,7 @@ static void whack_handle(struct fd *whackfd, struct logger *whack_logger)
 		pfree_diag(&d);
 		/* already logged */
 		whack_rc(RC_BADWHACKMESSAGE, whack_logger);
-		return; /* don't shutdown */
+		return false; /* don't shutdown */
 	}
 
 	/*
@@ -687,7 +832,7 @@ static void whack_handle(struct fd *whackfd, struct logger *whack_logger)
 
 	if (msg.basic.whack_shutdown) {
 		whack_shutdown(whack_logger, false);
-		return; /* force shutting down */
+		return false; /* force shutting down */
 	}
 
 	if (msg.basic.whack_status) {
@@ -695,10 +840,22 @@ static void whack_handle(struct fd *whackfd, struct logger *whack_logger)
 		whack_status(s, mononow());
 		free_show(&s);
 		/* bail early, but without complaint */
-		return; /* don't shutdown */
+		return false; /* don't shutdown */
+	}
+
+	/* a message without the flag ends the batch */
+	if (msg.whack_batch && *batch == NULL) {
+		*batch = alloc_whack_batch(whackfd, whack_logger);
 	}
 
 	struct show *s = alloc_show(whack_logger);
+	current_whack_batch = (msg.whack_batch ? *batch : NULL);
 	whack_process(&msg, s);
+	current_whack_batch = NULL;
 	free_show(&s);
+	if (msg.whack_batch) {
+		/* lets addconn tie the replies to this message */
+		whack_rc(RC_WHACK_BATCH, whack_logger);
+	}
+	return msg.whack_batch;
 }
@@ -19,7 +19,12 @@
 #define RCV_WHACK_H
 
 struct logger;
+struct connection;
 
 extern void whack_handle_cb(int fd, void *arg, struct logger *logger);
 
+/* connection added by a whack batch; see add_connection() */
+void whack_batch_add_connection(struct connection *c);
+void free_whack_batches(void);
+
 #endif
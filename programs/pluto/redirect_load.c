@@ -0,0 +1,403 @@
+/* load-aware global redirect, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#define _GNU_SOURCE		/* for struct ucred, SCM_CREDENTIALS */
+
+#include <sys/socket.h>
+#include <sys/stat.h>		/* for umask() */
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include "lswalloc.h"
+#include "ipsecconf/config_setup.h"
+
+#include "defs.h"
+#include "log.h"
+#include "show.h"
+#include "state.h"		/* for total_halfopen_ike() */
+#include "server.h"		/* for attach_fd_read_listener() */
+#include "server_pool.h"	/* for server_backlog() */
+#include "timer.h"		/* for enable_periodic_timer() */
+#include "redirect_load.h"
+
+/*
+ * Every REDIRECT_LOAD_REPORT_SECONDS each member sends "load <N>\n"
+ * from its own socket to each peer's socket.  The receiver
+ * identifies the sender by the path it sent from, and only believes
+ * senders running as the same user (SCM_CREDENTIALS); a report older
+ * than REDIRECT_LOAD_STALE_SECONDS is ignored.
+ *
+ * A destination's weight is its spare capacity (100 less its load);
+ * a destination without a current report is given
+ * REDIRECT_LOAD_UNKNOWN_WEIGHT.
+ */
+
+#define REDIRECT_LOAD_REPORT_SECONDS 1
+#define REDIRECT_LOAD_STALE_SECONDS 5
+#define REDIRECT_LOAD_UNKNOWN_WEIGHT 50
+#define REDIRECT_LOAD_BACKLOG_PER_HELPER 8
+#define REDIRECT_LOAD_MAX 999
+
+struct redirect_peer {
+	char *dest;			/* as in global-redirect-to= */
+	struct sockaddr_un sun;
+	unsigned load;
+	monotime_t reported;
+	uintmax_t reports;
+};
+
+static struct {
+	unsigned threshold;		/* percent; 0 disables */
+	uintmax_t capacity;		/* established IKE SAs; 0 ignores */
+	uintmax_t max_halfopen;
+	char *socket;
+	int fd;
+	struct fd_read_listener *listener;
+	struct redirect_peer *peers;
+	unsigned nr_peers;
+} redirect_load = {
+	.fd = -1,
+};
+
+static unsigned percent(uintmax_t n, uintmax_t d)
+{
+	if (d == 0) {
+		return 0;
+	}
+	uintmax_t p = n * 100 / d;
+	return (p > REDIRECT_LOAD_MAX ? REDIRECT_LOAD_MAX : p);
+}
+
+unsigned local_redirect_load(void)
+{
+	unsigned halfopen = percent(total_halfopen_ike(), redirect_load.max_halfopen);
+	unsigned backlog = percent(server_backlog(),
+				   server_nhelpers() * REDIRECT_LOAD_BACKLOG_PER_HELPER);
+	unsigned established = percent(total_established_ike(), redirect_load.capacity);
+	unsigned load = halfopen;
+	load = (backlog > load ? backlog : load);
+	load = (established > load ? established : load);
+	return load;
+}
+
+bool redirect_load_exceeded(void)
+{
+	return (redirect_load.threshold > 0 &&
+		local_redirect_load() >= redirect_load.threshold);
+}
+
+bool redirect_load_weighted(void)
+{
+	return (redirect_load.nr_peers > 0);
+}
+
+static bool peer_load(const struct redirect_peer *peer, unsigned *load)
+{
+	if (peer->reports == 0) {
+		return false;
+	}
+	deltatime_t age = monotime_diff(mononow(), peer->reported);
+	if (deltasecs(age) >= REDIRECT_LOAD_STALE_SECONDS) {
+		return false;
+	}
+	*load = peer->load;
+	return true;
+}
+
+unsigned redirect_dest_weight(shunk_t dest)
+{
+	for (unsigned p = 0; p < redirect_load.nr_peers; p++) {
+		const struct redirect_peer *peer = &redirect_load.peers[p];
+		if (hunk_streq(dest, peer->dest)) {
+			unsigned load;
+			if (!peer_load(peer, &load)) {
+				return REDIRECT_LOAD_UNKNOWN_WEIGHT;
+			}
+			return (load >= 100 ? 0 : 100 - load);
+		}
+	}
+	return REDIRECT_LOAD_UNKNOWN_WEIGHT;
+}
+
+static struct redirect_peer *find_peer(const struct sockaddr_un *from,
+				       socklen_t from_len)
+{
+	if (from_len <= offsetof(struct sockaddr_un, sun_path) ||
+	    from->sun_family != AF_UNIX) {
+		/* unbound sender */
+		return NULL;
+	}
+	/* the kernel needn't NUL terminate the path */
+	size_t len = strnlen(from->sun_path,
+			     from_len - offsetof(struct sockaddr_un, sun_path));
+	for (unsigned p = 0; p < redirect_load.nr_peers; p++) {
+		const char *path = redirect_load.peers[p].sun.sun_path;
+		if (strlen(path) == len && memeq(path, from->sun_path, len)) {
+			return &redirect_load.peers[p];
+		}
+	}
+	return NULL;
+}
+
+static void read_report(int fd, void *arg UNUSED, struct logger *logger)
+{
+	char buf[64];
+	struct sockaddr_un from;
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = sizeof(buf),
+	};
+	union {
+		struct cmsghdr align;
+		char buf[CMSG_SPACE(sizeof(struct ucred))];
+	} control;
+	struct msghdr msg = {
+		.msg_name = &from,
+		.msg_namelen = sizeof(from),
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+		.msg_control = &control,
+		.msg_controllen = sizeof(control),
+	};
+	ssize_t n = recvmsg(fd, &msg, MSG_DONTWAIT);
+	if (n < 0) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			llog_errno(RC_LOG, logger, errno,
+				   "global-redirect-load-socket: recvmsg failed: ");
+		}
+		return;
+	}
+
+	/* reports steer redirects; only pluto's user is believed */
+	const struct ucred *cred = NULL;
+	for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+	     cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		if (cmsg->cmsg_level == SOL_SOCKET &&
+		    cmsg->cmsg_type == SCM_CREDENTIALS &&
+		    cmsg->cmsg_len == CMSG_LEN(sizeof(struct ucred))) {
+			cred = (const struct ucred *)CMSG_DATA(cmsg);
+		}
+	}
+	if (cred == NULL) {
+		ldbg(logger, "global-redirect-load-socket: ignoring report without credentials");
+		return;
+	}
+	if (cred->uid != geteuid()) {
+		ldbg(logger, "global-redirect-load-socket: ignoring report from pid %d uid %u, expecting uid %u",
+		     (int)cred->pid, (unsigned)cred->uid, (unsigned)geteuid());
+		return;
+	}
+
+	/* only peers, identified by their socket, are believed */
+	struct redirect_peer *peer = find_peer(&from, msg.msg_namelen);
+	if (peer == NULL) {
+		ldbg(logger, "global-redirect-load-socket: ignoring report from unknown sender");
+		return;
+	}
+
+	shunk_t cursor = shunk2(buf, n);
+	shunk_t verb = shunk_token(&cursor, NULL, " ");
+	uintmax_t load;
+	if (!hunk_streq(verb, "load") ||
+	    shunk_to_uintmax(cursor, &cursor, 10, &load) != NULL ||
+	    !(cursor.len == 0 || hunk_streq(cursor, "\n"))) {
+		ldbg(logger, "global-redirect-load-socket: ignoring malformed report from %s",
+		     peer->dest);
+		return;
+	}
+
+	peer->load = (load > REDIRECT_LOAD_MAX ? REDIRECT_LOAD_MAX : load);
+	peer->reported = mononow();
+	peer->reports++;
+	ldbg(logger, "global-redirect-load-socket: %s reports load %u%%",
+	     peer->dest, peer->load);
+}
+
+static void send_reports(struct logger *logger)
+{
+	char report[32];
+	int len = snprintf(report, sizeof(report), "load %u\n", local_redirect_load());
+	for (unsigned p = 0; p < redirect_load.nr_peers; p++) {
+		const struct redirect_peer *peer = &redirect_load.peers[p];
+		/* a peer that isn't running is expected */
+		if (sendto(redirect_load.fd, report, len, MSG_DONTWAIT,
+			   (const struct sockaddr *)&peer->sun, sizeof(peer->sun)) < 0) {
+			ldbg(logger, "global-redirect-load-socket: report to %s failed: %s",
+			     peer->dest, strerror(errno));
+		}
+	}
+}
+
+static err_t fill_sockaddr_un(struct sockaddr_un *sun, shunk_t path)
+{
+	zero(sun);
+	if (path.len == 0 || ((const char *)path.ptr)[0] != '/') {
+		return "socket path must be absolute";
+	}
+	if (path.len >= sizeof(sun->sun_path)) {
+		return "socket path too long";
+	}
+	sun->sun_family = AF_UNIX;
+	memcpy(sun->sun_path, path.ptr, path.len);
+	return NULL;
+}
+
+/*
+ * DEST=PATH[, DEST=PATH ...]
+ */
+
+static err_t parse_peers(const char *peers, struct logger *logger)
+{
+	struct shunks *tokens = ttoshunks(shunk1(peers), ", ", EAT_EMPTY_SHUNKS);
+	redirect_load.peers = alloc_things(struct redirect_peer, tokens->len,
+					   "global-redirect-peers");
+	err_t e = NULL;
+	ITEMS_FOR_EACH(token, tokens) {
+		shunk_t path = *token;
+		char delim;
+		shunk_t dest = shunk_token(&path, &delim, "=");
+		if (delim != '=' || dest.len == 0) {
+			e = "expecting DESTINATION=PATH";
+			break;
+		}
+		struct redirect_peer *peer = &redirect_load.peers[redirect_load.nr_peers];
+		e = fill_sockaddr_un(&peer->sun, path);
+		if (e != NULL) {
+			break;
+		}
+		peer->dest = clone_hunk_as_string(&dest, "global-redirect-peers dest");
+		redirect_load.nr_peers++;
+		ldbg(logger, "global-redirect-peers: %s at %s", peer->dest, peer->sun.sun_path);
+	}
+	pfree(tokens);
+	return e;
+}
+
+void init_redirect_load(const struct config_setup *oco, struct logger *logger)
+{
+	redirect_load.max_halfopen = config_setup_option(oco, KBF_MAX_HALFOPEN_IKE);
+	redirect_load.capacity = config_setup_option(oco, KBF_GLOBAL_REDIRECT_CAPACITY);
+
+	uintmax_t threshold = config_setup_option(oco, KBF_GLOBAL_REDIRECT_LOAD);
+	if (threshold > 100) {
+		fatal(PLUTO_EXIT_FAIL, logger, /*no-errno*/0,
+		      "global-redirect-load=%ju invalid, must be a percentage", threshold);
+	}
+	redirect_load.threshold = threshold;
+
+	const char *peers = config_setup_string(oco, KSF_GLOBAL_REDIRECT_PEERS);
+	const char *socket_path = config_setup_string(oco, KSF_GLOBAL_REDIRECT_LOAD_SOCKET);
+
+	if (peers == NULL) {
+		if (socket_path != NULL) {
+			llog(WARNING_STREAM, logger,
+			     "ignoring global-redirect-load-socket=%s as global-redirect-peers= is not set",
+			     socket_path);
+		}
+		return;
+	}
+
+	if (socket_path == NULL) {
+		fatal(PLUTO_EXIT_FAIL, logger, /*no-errno*/0,
+		      "global-redirect-peers= requires global-redirect-load-socket=");
+	}
+
+	err_t e = parse_peers(peers, logger);
+	if (e != NULL) {
+		fatal(PLUTO_EXIT_FAIL, logger, /*no-errno*/0,
+		      "global-redirect-peers=%s invalid, %s", peers, e);
+	}
+
+	struct sockaddr_un sun;
+	e = fill_sockaddr_un(&sun, shunk1(socket_path));
+	if (e != NULL) {
+		fatal(PLUTO_EXIT_FAIL, logger, /*no-errno*/0,
+		      "global-redirect-load-socket=%s invalid, %s", socket_path, e);
+	}
+
+	int fd = socket(AF_UNIX, SOCK_DGRAM|SOCK_CLOEXEC|SOCK_NONBLOCK, 0);
+	if (fd < 0) {
+		fatal(PLUTO_EXIT_FAIL, logger, errno,
+		      "global-redirect-load-socket: unable to create socket for %s", socket_path);
+	}
+	unlink(socket_path);
+	/* reports steer redirects; create the socket private */
+	mode_t old_mask = umask(S_IRWXG|S_IRWXO);
+	int r = bind(fd, (struct sockaddr *)&sun, sizeof(sun));
+	int bind_errno = errno;
+	umask(old_mask);
+	if (r != 0) {
+		fatal(PLUTO_EXIT_FAIL, logger, bind_errno,
+		      "global-redirect-load-socket: unable to bind %s", socket_path);
+	}
+	/* have each report carry its sender's credentials */
+	int on = 1;
+	if (setsockopt(fd, SOL_SOCKET, SO_PASSCRED, &on, sizeof(on)) != 0) {
+		fatal(PLUTO_EXIT_FAIL, logger, errno,
+		      "global-redirect-load-socket: unable to pass credentials on %s", socket_path);
+	}
+
+	redirect_load.fd = fd;
+	redirect_load.socket = clone_str(socket_path, "global-redirect-load-socket");
+	attach_fd_read_listener(&redirect_load.listener, fd,
+				"global-redirect-load", read_report, NULL);
+	enable_periodic_timer(EVENT_REDIRECT_LOAD, send_reports,
+			      deltatime(REDIRECT_LOAD_REPORT_SECONDS), logger);
+	llog(RC_LOG, logger, "global-redirect: exchanging load with %u peers via %s",
+	     redirect_load.nr_peers, socket_path);
+}
+
+void free_redirect_load(struct logger *logger UNUSED)
+{
+	if (redirect_load.fd >= 0) {
+		detach_fd_read_listener(&redirect_load.listener);
+		close(redirect_load.fd);
+		redirect_load.fd = -1;
+		unlink(redirect_load.socket);
+	}
+	pfreeany(redirect_load.socket);
+	for (unsigned p = 0; p < redirect_load.nr_peers; p++) {
+		pfreeany(redirect_load.peers[p].dest);
+	}
+	pfreeany(redirect_load.peers);
+	redirect_load.nr_peers = 0;
+}
+
+void show_redirect_load(struct show *s)
+{
+	SHOW_JAMBUF(s, buf) {
+		jam(buf, "global-redirect-load=%u%%, global-redirect-capacity=%ju, load=%u%%",
+		    redirect_load.threshold, redirect_load.capacity,
+		    local_redirect_load());
+		jam(buf, " (halfopen=%lu, backlog=%u, established=%lu)",
+		    total_halfopen_ike(), server_backlog(), total_established_ike());
+	}
+	for (unsigned p = 0; p < redirect_load.nr_peers; p++) {
+		const struct redirect_peer *peer = &redirect_load.peers[p];
+		SHOW_JAMBUF(s, buf) {
+			jam(buf, "global-redirect-peer %s: ", peer->dest);
+			unsigned load;
+			if (peer_load(peer, &load)) {
+				jam(buf, "load=%u%%", load);
+			} else {
+				jam_string(buf, "load=<unknown>");
+			}
+			jam(buf, ", weight=%u, reports=%ju",
+			    redirect_dest_weight(shunk1(peer->dest)), peer->reports);
+		}
+	}
+}
@@ -0,0 +1,56 @@
+/* load-aware global redirect, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#ifndef REDIRECT_LOAD_H
+#define REDIRECT_LOAD_H
+
+#include <stdbool.h>
+
+#include "shunk.h"
+
+struct config_setup;
+struct logger;
+struct show;
+
+/*
+ * A cluster member's load is a percentage: the largest of its
+ * half-open IKE SAs relative to max-halfopen-ike=, its helper
+ * backlog relative to the number of helpers, and its established
+ * IKE SAs relative to global-redirect-capacity=.
+ *
+ * With global-redirect=auto, IKE_SA_INIT requests are redirected
+ * while the local load is at or above global-redirect-load=.
+ *
+ * With global-redirect-peers=, the members exchange their load
+ * over UNIX datagram sockets (global-redirect-load-socket=) and
+ * redirect destinations are chosen in proportion to their spare
+ * capacity.
+ */
+
+void init_redirect_load(const struct config_setup *oco, struct logger *logger);
+void free_redirect_load(struct logger *logger);
+void show_redirect_load(struct show *s);
+
+unsigned local_redirect_load(void);
+bool redirect_load_exceeded(void);
+
+/*
+ * When false, global-redirect-to= is round-robined; else
+ * redirect_dest_weight() gives each destination's share.
+ */
+bool redirect_load_weighted(void);
+unsigned redirect_dest_weight(shunk_t dest);
+
+#endif
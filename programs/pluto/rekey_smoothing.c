@@ -0,0 +1,159 @@
+/* rekey smoothing, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#include "ipsecconf/config_setup.h"
+
+#include "defs.h"
+
+#include "log.h"
+#include "show.h"
+#include "rekey_smoothing.h"
+
+/*
+ * A ring of per-second counts of scheduled rekeys, indexed by
+ * monotonic second.  It covers 36 hours which is more than the
+ * longest lifetime; rekeys further out than that aren't tracked.
+ */
+
+#define REKEY_HORIZON (1 << 17)	/* seconds */
+#define REKEY_SLOT(SECOND) ((SECOND) & (REKEY_HORIZON - 1))
+
+static struct {
+	unsigned rate;		/* per second; 0 disables */
+	uint16_t *counts;	/* [REKEY_HORIZON] */
+	uintmax_t booked;	/* currently */
+	uintmax_t moved;
+	uintmax_t over;		/* no second in window had room */
+} rekeys;
+
+deltatime_t smooth_rekey_delay(deltatime_t delay, deltatime_t window,
+			       struct logger *logger)
+{
+	if (rekeys.rate == 0) {
+		return delay;
+	}
+
+	intmax_t now = monosecs(mononow());
+	intmax_t at = now + seconds_from_deltatime(delay);
+	intmax_t earliest = at - seconds_from_deltatime(window);
+	if (earliest <= now) {
+		earliest = now + 1;
+	}
+	if (at - now >= REKEY_HORIZON || at <= earliest) {
+		return delay;
+	}
+
+	intmax_t best = at;
+	for (intmax_t s = at; s >= earliest; s--) {
+		unsigned count = rekeys.counts[REKEY_SLOT(s)];
+		if (count < rekeys.rate) {
+			best = s;
+			break;
+		}
+		if (count < rekeys.counts[REKEY_SLOT(best)]) {
+			best = s;
+		}
+	}
+
+	if (rekeys.counts[REKEY_SLOT(best)] >= rekeys.rate) {
+		rekeys.over++;
+	}
+	if (best == at) {
+		return delay;
+	}
+
+	rekeys.moved++;
+	ldbg(logger, "rekey-rate=%u: second %+jd is full; rekeying %jd seconds earlier",
+	     rekeys.rate, at - now, at - best);
+	return deltatime_sub(delay, deltatime(at - best));
+}
+
+bool book_rekey(monotime_t when)
+{
+	if (rekeys.rate == 0) {
+		return false;
+	}
+	intmax_t s = monosecs(when);
+	if (s - monosecs(mononow()) >= REKEY_HORIZON) {
+		return false;
+	}
+	uint16_t *count = &rekeys.counts[REKEY_SLOT(s)];
+	if (*count == UINT16_MAX) {
+		return false;
+	}
+	(*count)++;
+	rekeys.booked++;
+	return true;
+}
+
+void unbook_rekey(monotime_t when)
+{
+	if (rekeys.counts == NULL) {
+		/* shutting down */
+		return;
+	}
+	uint16_t *count = &rekeys.counts[REKEY_SLOT(monosecs(when))];
+	if (PEXPECT(&global_logger, rekeys.booked > 0 && *count > 0)) {
+		(*count)--;
+		rekeys.booked--;
+	}
+}
+
+void init_rekey_smoothing(const struct config_setup *oco, struct logger *logger)
+{
+	rekeys.rate = config_setup_option(oco, KBF_REKEY_RATE);
+	if (rekeys.rate > 0) {
+		rekeys.counts = alloc_things(uint16_t, REKEY_HORIZON, "rekey counts");
+		llog(RC_LOG, logger, "smoothing rekeys to %u per second", rekeys.rate);
+	}
+}
+
+void free_rekey_smoothing(void)
+{
+	pfreeany(rekeys.counts);
+	rekeys.rate = 0;
+}
+
+/*
+ * Upcoming rekeys in five minute buckets for the next hour, and then
+ * everything after that.
+ */
+
+void show_rekey_smoothing_status(struct show *s)
+{
+	show(s, "config.setup.rekey_rate=%u", rekeys.rate);
+	if (rekeys.rate == 0) {
+		return;
+	}
+
+	intmax_t now = monosecs(mononow());
+	uintmax_t later = rekeys.booked;
+	unsigned peak = 0;
+	for (intmax_t from = 0; from < 3600; from += 300) {
+		uintmax_t count = 0;
+		for (intmax_t t = from; t < from + 300; t++) {
+			unsigned c = rekeys.counts[REKEY_SLOT(now + t)];
+			count += c;
+			peak = (c > peak ? c : peak);
+		}
+		later -= (count < later ? count : later);
+		show(s, "current.rekeys.upcoming.%jd-%jds=%ju", from, from + 300, count);
+	}
+	show(s, "current.rekeys.upcoming.3600s-=%ju", later);
+	show(s, "current.rekeys.peak_per_second=%u", peak);
+	show(s, "current.rekeys.booked=%ju", rekeys.booked);
+	show(s, "total.rekeys.moved=%ju", rekeys.moved);
+	show(s, "total.rekeys.over_rate=%ju", rekeys.over);
+}
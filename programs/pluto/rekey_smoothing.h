@@ -0,0 +1,51 @@
+/* rekey smoothing, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#ifndef REKEY_SMOOTHING_H
+#define REKEY_SMOOTHING_H
+
+#include <stdbool.h>
+
+#include "deltatime.h"
+#include "monotime.h"
+
+struct config_setup;
+struct logger;
+struct show;
+
+/*
+ * Keep the number of rekeys scheduled for any one second at or below
+ * config-setup's rekey-rate= (0, the default, disables this).
+ *
+ * smooth_rekey_delay() returns DELAY, or when that second is already
+ * full, the latest second no more than WINDOW earlier that has room
+ * (failing that, the least busy one).  Rekeys are only ever moved
+ * earlier.
+ *
+ * book_rekey() records a scheduled rekey, returning false when it
+ * isn't tracked; unbook_rekey() is called when a booked rekey event
+ * is deleted.
+ */
+
+deltatime_t smooth_rekey_delay(deltatime_t delay, deltatime_t window,
+			       struct logger *logger);
+bool book_rekey(monotime_t when);
+void unbook_rekey(monotime_t when);
+
+void init_rekey_smoothing(const struct config_setup *oco, struct logger *logger);
+void free_rekey_smoothing(void);
+void show_rekey_smoothing_status(struct show *s);
+
+#endif
@@ -0,0 +1,1072 @@
+/* active/standby replication, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#define _GNU_SOURCE		/* for struct ucred */
+
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>		/* for umask() */
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdlib.h>		/* for qsort() */
+#include <string.h>
+#include <time.h>		/* for clock_gettime() */
+
+#include "lswalloc.h"
+#include "ip_sockaddr.h"
+#include "ipsecconf/config_setup.h"
+
+#include "defs.h"
+#include "log.h"
+#include "show.h"
+#include "state.h"
+#include "connections.h"		/* for st_ike_version */
+#include "server.h"		/* for schedule_timeout() */
+#include "hash_table.h"		/* for hash_bytes() */
+#include "checkpoint.h"
+#include "replication.h"
+
+/*
+ * The active pluto (replicate-to=) streams checkpoint records (see
+ * checkpoint.h) to the standby (replicate-from=):
+ *
+ * - on connecting, a checkpoint header followed by the IKE and Child
+ *   record of every established SA (the snapshot)
+ *
+ * - then, each time an SA is established, rekeyed, or moved to a
+ *   new IKE SA, its IKE or Child record; as an IKE SA's Message IDs
+ *   advance, a MSGID record; and when an SA goes away, a DELETE
+ *   record
+ *
+ * The main thread accumulates records in .pending and, every
+ * REPLICATION_BATCH_MILLISECONDS, hands them to a sender thread so
+ * that the event loop never blocks on the socket.  Should the
+ * connection drop, or the standby fall too far behind, batches are
+ * discarded and a new snapshot is sent once re-connected.
+ *
+ * The standby keeps the latest record of each SA.  "ipsec whack
+ * --takeover" assembles them into a checkpoint and hands it to
+ * adopt_checkpoint().
+ */
+
+#define REPLICATION_BATCH_MILLISECONDS 50
+#define REPLICATION_RETRY_SECONDS 5
+#define REPLICATION_TIMEOUT_SECONDS 5
+#define REPLICATION_MAX_QUEUED (16 * 1024 * 1024)
+#define REPLICATION_MAX_RECORD (64 * 1024)
+#define REPLICA_BUCKETS 1024
+
+struct replication_address {
+	struct sockaddr_storage sa;
+	socklen_t len;
+};
+
+static void wipe_and_free(void *ptr, size_t len)
+{
+	if (ptr != NULL) {
+		memset(ptr, 0, len);
+		pfree(ptr);
+	}
+}
+
+/*
+ * The stream's keys are wrapped using checkpoint_kek(), so the active
+ * and standby share that key (the same NSS DB, or a copy).  On
+ * takeover the stream is installed into the kernel, so only a UNIX
+ * socket, private to root, is allowed.  A standby on another host
+ * needs a transport such as an SSH forwarded socket.
+ */
+
+static err_t parse_replication_address(const char *value,
+				       struct replication_address *address)
+{
+	zero(address);
+
+	if (value[0] != '/') {
+		return "expecting the absolute path of a UNIX socket";
+	}
+
+	struct sockaddr_un *sun = (struct sockaddr_un *)&address->sa;
+	if (strlen(value) >= sizeof(sun->sun_path)) {
+		return "socket path too long";
+	}
+	sun->sun_family = AF_UNIX;
+	jam_str(sun->sun_path, sizeof(sun->sun_path), value);
+	address->len = sizeof(*sun);
+	return NULL;
+}
+
+/*
+ * Active.
+ */
+
+struct batch {
+	struct batch *next;
+	size_t len;
+	uint8_t bytes[];
+};
+
+static struct {
+	char *to;
+	struct replication_address address;
+	struct logger *logger;		/* for the sender thread */
+	PK11SymKey *kek;		/* see checkpoint_kek() */
+	bool running;
+	/* main thread */
+	struct timeout *timeout;
+	uint8_t *pending;
+	size_t pending_len;
+	size_t pending_size;
+	so_serial_t *dirty;		/* SAs to (re)send */
+	unsigned nr_dirty;
+	unsigned max_dirty;
+	/* protected by .mutex */
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	struct batch *queue;
+	struct batch **tail;
+	size_t queued;			/* bytes */
+	bool connected;			/* also read, unlocked, by the main thread */
+	bool snapshot;			/* connected; snapshot not yet queued */
+	bool resync;			/* drop the connection and start again */
+	bool stopping;
+	uintmax_t connects;
+	uintmax_t batches;
+	uintmax_t bytes;
+	uintmax_t dropped;
+} active = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER,
+};
+
+static bool active_connected(void)
+{
+	return __atomic_load_n(&active.connected, __ATOMIC_RELAXED);
+}
+
+/* with .mutex held */
+static void discard_queue(void)
+{
+	while (active.queue != NULL) {
+		struct batch *batch = active.queue;
+		active.queue = batch->next;
+		wipe_and_free(batch, sizeof(*batch) + batch->len);
+	}
+	active.tail = &active.queue;
+	active.queued = 0;
+}
+
+/* with .mutex held */
+static void queue_pending(void)
+{
+	struct batch *batch = alloc_bytes(sizeof(*batch) + active.pending_len,
+					  "replication batch");
+	batch->len = active.pending_len;
+	memcpy(batch->bytes, active.pending, active.pending_len);
+	*active.tail = batch;
+	active.tail = &batch->next;
+	active.queued += batch->len;
+	pthread_cond_signal(&active.cond);
+}
+
+static void discard_pending(void)
+{
+	memset(active.pending, 0, active.pending_len);
+	active.pending_len = 0;
+	active.nr_dirty = 0;
+}
+
+static uint8_t *reserve_pending(size_t len)
+{
+	if (active.pending_len + len > active.pending_size) {
+		size_t size = max(2 * active.pending_size, active.pending_len + len);
+		uint8_t *pending = alloc_bytes(size, "replication pending");
+		if (active.pending != NULL) {
+			memcpy(pending, active.pending, active.pending_len);
+			wipe_and_free(active.pending, active.pending_size);
+		}
+		active.pending = pending;
+		active.pending_size = size;
+	}
+	return active.pending + active.pending_len;
+}
+
+static void *append_pending(size_t len)
+{
+	uint8_t *record = reserve_pending(len);
+	memset(record, 0, len);
+	active.pending_len += len;
+	return record;
+}
+
+static void append_state(struct state *st, struct logger *logger)
+{
+	size_t len;
+	if (IS_IKE_SA(st)) {
+		struct ike_sa *ike = pexpect_ike_sa(st);
+		size_t bound = checkpoint_ike_bound(ike);
+		if (bound == 0) {
+			return;
+		}
+		len = checkpoint_save_ike(reserve_pending(bound), bound, ike,
+					  active.kek, logger);
+	} else {
+		struct child_sa *child = pexpect_child_sa(st);
+		size_t bound = (child == NULL ? 0 : checkpoint_child_bound(child));
+		if (bound == 0) {
+			return;
+		}
+		/* the standby links Child SAs using .ike_spis */
+		len = checkpoint_save_child(reserve_pending(bound), bound, 0, child,
+					    active.kek, logger);
+	}
+	if (len > 0) {
+		active.pending_len += len;
+		st->st_replicated = true;
+	}
+}
+
+static int serialno_cmp(const void *l, const void *r)
+{
+	const so_serial_t *ls = l;
+	const so_serial_t *rs = r;
+	return (*ls < *rs ? -1 : *ls > *rs ? 1 : 0);
+}
+
+static void append_dirty(struct logger *logger)
+{
+	/* oldest first, and only once */
+	qsort(active.dirty, active.nr_dirty, sizeof(active.dirty[0]), serialno_cmp);
+	for (unsigned i = 0; i < active.nr_dirty; i++) {
+		if (i > 0 && active.dirty[i] == active.dirty[i - 1]) {
+			continue;
+		}
+		struct state *st = state_by_serialno(active.dirty[i]);
+		if (st != NULL &&
+		    (IS_IKE_SA_ESTABLISHED(st) || IS_CHILD_SA_ESTABLISHED(st))) {
+			append_state(st, logger);
+		}
+	}
+	active.nr_dirty = 0;
+}
+
+static void flush_pending(void *arg UNUSED, const struct timer_event *event)
+{
+	destroy_timeout(&active.timeout);
+	append_dirty(event->logger);
+
+	pthread_mutex_lock(&active.mutex);
+	if (active.pending_len > 0 && active.connected && !active.snapshot) {
+		if (active.queued + active.pending_len > REPLICATION_MAX_QUEUED) {
+			/* the standby is too far behind; start again */
+			discard_queue();
+			active.resync = true;
+			active.dropped++;
+			pthread_cond_signal(&active.cond);
+		} else {
+			queue_pending();
+		}
+	}
+	/* else the snapshot will include it */
+	pthread_mutex_unlock(&active.mutex);
+	discard_pending();
+}
+
+static void schedule_flush(void)
+{
+	if (active.timeout == NULL) {
+		schedule_timeout("replication", &active.timeout,
+				 deltatime_from_milliseconds(REPLICATION_BATCH_MILLISECONDS),
+				 flush_pending, NULL);
+	}
+}
+
+void replicate_state(struct state *st)
+{
+	if (!active_connected() || st->st_ike_version != IKEv2) {
+		return;
+	}
+	/* encoded when flushed; by then the state is settled */
+	if (active.nr_dirty >= active.max_dirty) {
+		unsigned max_dirty = max(2 * active.max_dirty, 64U);
+		realloc_things(active.dirty, active.max_dirty, max_dirty, "replication dirty");
+		active.max_dirty = max_dirty;
+	}
+	active.dirty[active.nr_dirty++] = st->st_serialno;
+	schedule_flush();
+}
+
+void replicate_v2_msgid(struct ike_sa *ike)
+{
+	if (!active_connected() || !ike->sa.st_replicated) {
+		return;
+	}
+	const struct v2_msgid_windows *windows = &ike->sa.st_v2_msgid_windows;
+	struct checkpoint_msgid *rec = append_pending(checkpoint_align(sizeof(*rec)));
+	rec->record.type = CHECKPOINT_MSGID;
+	rec->record.size = checkpoint_align(sizeof(*rec));
+	rec->spis = ike->sa.st_ike_spis;
+	rec->msgid[0] = windows->initiator.sent;
+	rec->msgid[1] = windows->initiator.recv;
+	rec->msgid[2] = windows->responder.sent;
+	rec->msgid[3] = windows->responder.recv;
+	schedule_flush();
+}
+
+void replicate_delete(struct state *st)
+{
+	if (!active_connected() || !st->st_replicated) {
+		return;
+	}
+	if (IS_IKE_SA(st)) {
+		struct checkpoint_delete_ike *rec = append_pending(checkpoint_align(sizeof(*rec)));
+		rec->record.type = CHECKPOINT_DELETE_IKE;
+		rec->record.size = checkpoint_align(sizeof(*rec));
+		rec->spis = st->st_ike_spis;
+	} else {
+		struct child_sa *child = pexpect_child_sa(st);
+		const struct ipsec_proto_info *proto_info =
+			(child == NULL ? NULL : outer_ipsec_proto_info(child));
+		if (proto_info == NULL) {
+			return;
+		}
+		struct checkpoint_delete_child *rec = append_pending(checkpoint_align(sizeof(*rec)));
+		rec->record.type = CHECKPOINT_DELETE_CHILD;
+		rec->record.size = checkpoint_align(sizeof(*rec));
+		rec->ipproto = proto_info->protocol->ipproto;
+		rec->inbound_spi = proto_info->inbound.spi;
+	}
+	schedule_flush();
+}
+
+static callback_cb send_snapshot; /* type assertion */
+
+static void send_snapshot(const char *story UNUSED,
+			  struct state *st UNUSED,
+			  void *context UNUSED)
+{
+	pthread_mutex_lock(&active.mutex);
+	bool wanted = (active.connected && active.snapshot);
+	pthread_mutex_unlock(&active.mutex);
+	if (!wanted) {
+		/* already sent, or gone */
+		return;
+	}
+
+	/* supersedes anything pending */
+	discard_pending();
+
+	struct logger *logger = &global_logger;
+	struct checkpoint_header *header = append_pending(checkpoint_align(sizeof(*header)));
+	checkpoint_init_header(header, active.kek, logger);
+
+	unsigned nr_ike = 0, nr_child = 0;
+	struct state_filter sf = {
+		.ike_version = IKEv2,
+		.search = {
+			.order = OLD2NEW,
+			.verbose.logger = logger,
+			.where = HERE,
+		},
+	};
+	while (next_state(&sf)) {
+		size_t len = active.pending_len;
+		if (IS_IKE_SA_ESTABLISHED(sf.st) || IS_CHILD_SA_ESTABLISHED(sf.st)) {
+			append_state(sf.st, logger);
+		}
+		if (active.pending_len > len) {
+			(IS_IKE_SA(sf.st) ? nr_ike++ : nr_child++);
+		}
+	}
+
+	pthread_mutex_lock(&active.mutex);
+	if (active.connected && active.snapshot) {
+		queue_pending();
+		active.snapshot = false;
+	}
+	pthread_mutex_unlock(&active.mutex);
+	discard_pending();
+
+	llog(RC_LOG, logger, "replication: sent %u IKE SAs and %u Child SAs to standby %s",
+	     nr_ike, nr_child, active.to);
+}
+
+static int connect_standby(bool *quiet)
+{
+	struct logger *logger = active.logger;
+	int fd = socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "replication: unable to create socket for %s: ", active.to);
+		return -1;
+	}
+
+	/* bound connect() and send() so that shutdown isn't held up */
+	struct timeval timeout = { .tv_sec = REPLICATION_TIMEOUT_SECONDS, };
+	if (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) != 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "replication: unable to set send timeout for %s: ", active.to);
+	}
+
+	if (connect(fd, (struct sockaddr *)&active.address.sa, active.address.len) != 0) {
+		if (!*quiet) {
+			llog_errno(RC_LOG, logger, errno,
+				   "replication: unable to connect to standby %s, will keep trying: ",
+				   active.to);
+			*quiet = true;
+		}
+		close(fd);
+		return -1;
+	}
+
+	llog(RC_LOG, logger, "replication: connected to standby %s", active.to);
+	*quiet = false;
+	return fd;
+}
+
+static bool send_batch(int fd, const struct batch *batch)
+{
+	const uint8_t *ptr = batch->bytes;
+	size_t len = batch->len;
+	while (len > 0) {
+		ssize_t n = send(fd, ptr, len, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			llog_errno(RC_LOG, active.logger, (n < 0 ? errno : 0),
+				   "replication: lost connection to standby %s: ", active.to);
+			return false;
+		}
+		ptr += n;
+		len -= n;
+	}
+	return true;
+}
+
+static void *sender_thread(void *arg UNUSED)
+{
+	int fd = -1;
+	bool quiet = false;
+
+	pthread_mutex_lock(&active.mutex);
+	while (true) {
+
+		if (active.resync && fd >= 0) {
+			llog(RC_LOG, active.logger,
+			     "replication: standby %s fell behind; re-connecting", active.to);
+			close(fd);
+			fd = -1;
+			__atomic_store_n(&active.connected, false, __ATOMIC_RELAXED);
+		}
+		active.resync = false;
+
+		if (fd < 0) {
+			if (active.stopping) {
+				break;
+			}
+			pthread_mutex_unlock(&active.mutex);
+			fd = connect_standby(&quiet);
+			pthread_mutex_lock(&active.mutex);
+			if (fd < 0) {
+				struct timespec retry;
+				clock_gettime(CLOCK_REALTIME, &retry);
+				retry.tv_sec += REPLICATION_RETRY_SECONDS;
+				if (!active.stopping) {
+					pthread_cond_timedwait(&active.cond, &active.mutex, &retry);
+				}
+				continue;
+			}
+			/* anything queued is stale; the snapshot replaces it */
+			discard_queue();
+			__atomic_store_n(&active.connected, true, __ATOMIC_RELAXED);
+			active.snapshot = true;
+			active.connects++;
+			schedule_callback("replication snapshot", deltatime(0), SOS_NOBODY,
+					  send_snapshot, NULL, active.logger);
+			continue;
+		}
+
+		if (active.queue == NULL) {
+			if (active.stopping) {
+				break;
+			}
+			pthread_cond_wait(&active.cond, &active.mutex);
+			continue;
+		}
+
+		struct batch *batch = active.queue;
+		active.queue = batch->next;
+		if (active.queue == NULL) {
+			active.tail = &active.queue;
+		}
+		active.queued -= batch->len;
+		pthread_mutex_unlock(&active.mutex);
+
+		bool ok = send_batch(fd, batch);
+		size_t len = batch->len;
+		wipe_and_free(batch, sizeof(*batch) + len);
+
+		pthread_mutex_lock(&active.mutex);
+		if (ok) {
+			active.batches++;
+			active.bytes += len;
+		} else {
+			close(fd);
+			fd = -1;
+			__atomic_store_n(&active.connected, false, __ATOMIC_RELAXED);
+			discard_queue();
+			active.dropped++;
+		}
+	}
+	__atomic_store_n(&active.connected, false, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&active.mutex);
+
+	if (fd >= 0) {
+		close(fd);
+	}
+	return NULL;
+}
+
+static void init_active(const char *to, struct logger *logger)
+{
+	err_t e = parse_replication_address(to, &active.address);
+	if (e != NULL) {
+		fatal(PLUTO_EXIT_FAIL, logger, /*no-errno*/0,
+		      "replicate-to=%s invalid, %s", to, e);
+	}
+
+	/* the standby must hold the same key */
+	active.kek = checkpoint_kek(logger);
+	if (active.kek == NULL) {
+		fatal(PLUTO_EXIT_FAIL, logger, /*no-errno*/0,
+		      "replication: no key-wrapping key \"%s\" in the NSS DB",
+		      CHECKPOINT_KEK_NICKNAME);
+	}
+
+	active.to = clone_str(to, "replicate-to");
+	active.logger = clone_logger(logger, HERE);
+	active.tail = &active.queue;
+	int err = pthread_create(&active.thread, NULL, sender_thread, NULL);
+	if (err != 0) {
+		fatal(PLUTO_EXIT_FAIL, logger, err,
+		      "replication: unable to create sender thread");
+	}
+	active.running = true;
+	llog(RC_LOG, logger, "replication: replicating SAs to standby %s", to);
+}
+
+static void free_active(struct logger *logger)
+{
+	if (!active.running) {
+		return;
+	}
+
+	/* send what's left, typically deletes */
+	destroy_timeout(&active.timeout);
+	append_dirty(logger);
+	pthread_mutex_lock(&active.mutex);
+	if (active.pending_len > 0 && active.connected && !active.snapshot) {
+		queue_pending();
+	}
+	active.stopping = true;
+	pthread_cond_signal(&active.cond);
+	pthread_mutex_unlock(&active.mutex);
+	pthread_join(active.thread, NULL);
+	active.running = false;
+
+	discard_queue();
+	discard_pending();
+	wipe_and_free(active.pending, active.pending_size);
+	active.pending = NULL;
+	active.pending_size = 0;
+	pfreeany(active.dirty);
+	active.max_dirty = 0;
+	pfreeany(active.to);
+	active.kek = NULL;	/* borrowed */
+	free_logger(&active.logger, HERE);
+}
+
+/*
+ * Standby.
+ *
+ * The latest record of each IKE SA, hashed by IKE SPIs, and each
+ * Child SA, hashed by protocol and inbound SPI.
+ */
+
+struct replica {
+	struct replica *next;		/* in bucket */
+	struct replica *children;	/* IKE; when taking over */
+	struct replica *sibling;	/* Child; when taking over */
+	size_t len;
+	uint8_t *record;
+};
+
+static struct {
+	char *from;
+	struct replication_address address;
+	PK11SymKey *kek;		/* see checkpoint_kek() */
+	struct fd_accept_listener *listener;
+	int fd;				/* from the active */
+	struct fd_read_listener *reader;
+	uint8_t *buf;
+	size_t len;
+	size_t size;
+	bool header;			/* seen */
+	bool taken_over;
+	struct replica *ike[REPLICA_BUCKETS];
+	struct replica *child[REPLICA_BUCKETS];
+	unsigned nr_ike;
+	unsigned nr_child;
+	uintmax_t connects;
+	uintmax_t records;
+} standby = {
+	.fd = -1,
+};
+
+static struct replica **ike_replica(const ike_spis_t *spis)
+{
+	hash_t hash = hash_bytes(spis, sizeof(*spis), zero_hash);
+	struct replica **rp = &standby.ike[hash.hash % REPLICA_BUCKETS];
+	for (; *rp != NULL; rp = &(*rp)->next) {
+		const struct checkpoint_ike *rec = (const void *)(*rp)->record;
+		if (ike_spis_eq(&rec->spis, spis)) {
+			break;
+		}
+	}
+	return rp;
+}
+
+static struct replica **child_replica(uint32_t ipproto, ipsec_spi_t spi)
+{
+	hash_t hash = hash_bytes(&ipproto, sizeof(ipproto), zero_hash);
+	hash = hash_bytes(&spi, sizeof(spi), hash);
+	struct replica **rp = &standby.child[hash.hash % REPLICA_BUCKETS];
+	for (; *rp != NULL; rp = &(*rp)->next) {
+		const struct checkpoint_child *rec = (const void *)(*rp)->record;
+		if (rec->ipproto == ipproto && rec->inbound_spi == spi) {
+			break;
+		}
+	}
+	return rp;
+}
+
+static void free_replica(struct replica **rp)
+{
+	struct replica *r = *rp;
+	*rp = r->next;
+	wipe_and_free(r->record, r->len);
+	pfree(r);
+}
+
+static void update_replica(struct replica **rp, unsigned *nr,
+			   const struct checkpoint_record *record)
+{
+	if (*rp == NULL) {
+		*rp = alloc_thing(struct replica, "replica");
+		(*nr)++;
+	} else {
+		wipe_and_free((*rp)->record, (*rp)->len);
+	}
+	(*rp)->len = record->size;
+	(*rp)->record = clone_bytes(record, record->size, "replica record");
+}
+
+static void free_replicas(void)
+{
+	for (unsigned b = 0; b < REPLICA_BUCKETS; b++) {
+		while (standby.ike[b] != NULL) {
+			free_replica(&standby.ike[b]);
+		}
+		while (standby.child[b] != NULL) {
+			free_replica(&standby.child[b]);
+		}
+	}
+	standby.nr_ike = standby.nr_child = 0;
+}
+
+static bool apply_record(const struct checkpoint_record *record)
+{
+	switch (record->type) {
+	case CHECKPOINT_IKE:
+	{
+		const struct checkpoint_ike *rec = (const void *)record;
+		if (record->size < sizeof(*rec)) {
+			return false;
+		}
+		update_replica(ike_replica(&rec->spis), &standby.nr_ike, record);
+		return true;
+	}
+	case CHECKPOINT_CHILD:
+	{
+		const struct checkpoint_child *rec = (const void *)record;
+		if (record->size < sizeof(*rec)) {
+			return false;
+		}
+		update_replica(child_replica(rec->ipproto, rec->inbound_spi),
+			       &standby.nr_child, record);
+		return true;
+	}
+	case CHECKPOINT_MSGID:
+	{
+		const struct checkpoint_msgid *rec = (const void *)record;
+		if (record->size < sizeof(*rec)) {
+			return false;
+		}
+		struct replica **rp = ike_replica(&rec->spis);
+		if (*rp != NULL) {
+			struct checkpoint_ike *ike = (void *)(*rp)->record;
+			memcpy(ike->msgid, rec->msgid, sizeof(ike->msgid));
+		}
+		return true;
+	}
+	case CHECKPOINT_DELETE_IKE:
+	{
+		const struct checkpoint_delete_ike *rec = (const void *)record;
+		if (record->size < sizeof(*rec)) {
+			return false;
+		}
+		/* its Child SAs are deleted, or have moved, separately */
+		struct replica **rp = ike_replica(&rec->spis);
+		if (*rp != NULL) {
+			free_replica(rp);
+			standby.nr_ike--;
+		}
+		return true;
+	}
+	case CHECKPOINT_DELETE_CHILD:
+	{
+		const struct checkpoint_delete_child *rec = (const void *)record;
+		if (record->size < sizeof(*rec)) {
+			return false;
+		}
+		struct replica **rp = child_replica(rec->ipproto, rec->inbound_spi);
+		if (*rp != NULL) {
+			free_replica(rp);
+			standby.nr_child--;
+		}
+		return true;
+	}
+	}
+	return false;
+}
+
+static void close_active(void)
+{
+	detach_fd_read_listener(&standby.reader);
+	if (standby.fd >= 0) {
+		close(standby.fd);
+		standby.fd = -1;
+	}
+	wipe_and_free(standby.buf, standby.size);
+	standby.buf = NULL;
+	standby.len = standby.size = 0;
+	standby.header = false;
+}
+
+/* returns the bytes consumed, or an error */
+
+static const char *read_records(size_t *used, struct logger *logger)
+{
+	*used = 0;
+	if (!standby.header) {
+		size_t len = checkpoint_align(sizeof(struct checkpoint_header));
+		if (standby.len < len) {
+			return NULL;
+		}
+		const char *why = checkpoint_check_header((const void *)standby.buf,
+							  standby.kek, logger);
+		if (why != NULL) {
+			return why;
+		}
+		/* a snapshot follows */
+		free_replicas();
+		standby.header = true;
+		*used = len;
+	}
+
+	while (standby.len - *used >= sizeof(struct checkpoint_record)) {
+		const struct checkpoint_record *record = (const void *)(standby.buf + *used);
+		if (record->size < sizeof(*record) ||
+		    record->size % CHECKPOINT_ALIGN != 0 ||
+		    record->size > REPLICATION_MAX_RECORD) {
+			return "corrupt record";
+		}
+		if (standby.len - *used < record->size) {
+			break;
+		}
+		if (!apply_record(record)) {
+			return "corrupt record";
+		}
+		standby.records++;
+		*used += record->size;
+	}
+	return NULL;
+}
+
+static void read_active(int fd, void *arg UNUSED, struct logger *logger)
+{
+	if (standby.size - standby.len < REPLICATION_MAX_RECORD) {
+		size_t size = standby.len + 2 * REPLICATION_MAX_RECORD;
+		uint8_t *buf = alloc_bytes(size, "replication buffer");
+		if (standby.buf != NULL) {
+			memcpy(buf, standby.buf, standby.len);
+			wipe_and_free(standby.buf, standby.size);
+		}
+		standby.buf = buf;
+		standby.size = size;
+	}
+
+	ssize_t n = read(fd, standby.buf + standby.len, standby.size - standby.len);
+	if (n < 0) {
+		if (errno == EAGAIN || errno == EINTR) {
+			return;
+		}
+		llog_errno(RC_LOG, logger, errno,
+			   "replication: lost connection to active: ");
+		close_active();
+		return;
+	}
+	if (n == 0) {
+		llog(RC_LOG, logger,
+		     "replication: active closed the connection; holding %u IKE SAs and %u Child SAs for \"ipsec whack --takeover\"",
+		     standby.nr_ike, standby.nr_child);
+		close_active();
+		return;
+	}
+	standby.len += n;
+
+	size_t used;
+	const char *why = read_records(&used, logger);
+	if (why != NULL) {
+		llog(RC_LOG, logger, "replication: dropping connection from active, %s", why);
+		close_active();
+		return;
+	}
+	memmove(standby.buf, standby.buf + used, standby.len - used);
+	memset(standby.buf + standby.len - used, 0, used);
+	standby.len -= used;
+}
+
+static void accept_active(int fd, ip_sockaddr *sa UNUSED,
+			  void *arg UNUSED, struct logger *logger)
+{
+	if (standby.taken_over) {
+		close(fd);
+		return;
+	}
+
+	/* only pluto, running as the same user, can replicate */
+	struct ucred cred;
+	socklen_t cred_len = sizeof(cred);
+	if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) != 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "replication: rejecting connection, unable to get peer credentials: ");
+		close(fd);
+		return;
+	}
+	if (cred.uid != geteuid()) {
+		llog(RC_LOG, logger,
+		     "replication: rejecting connection from pid %d uid %u, expecting uid %u",
+		     (int)cred.pid, (unsigned)cred.uid, (unsigned)geteuid());
+		close(fd);
+		return;
+	}
+	if (standby.fd >= 0) {
+		llog(RC_LOG, logger, "replication: replacing existing connection from active");
+		close_active();
+	}
+	standby.fd = fd;
+	standby.connects++;
+	attach_fd_read_listener(&standby.reader, fd, "replication", read_active, NULL);
+	llog(RC_LOG, logger, "replication: active connected");
+}
+
+static void init_standby(const char *from, struct logger *logger)
+{
+	err_t e = parse_replication_address(from, &standby.address);
+	if (e != NULL) {
+		fatal(PLUTO_EXIT_FAIL, logger, /*no-errno*/0,
+		      "replicate-from=%s invalid, %s", from, e);
+	}
+
+	/* the active must hold the same key */
+	standby.kek = checkpoint_kek(logger);
+	if (standby.kek == NULL) {
+		fatal(PLUTO_EXIT_FAIL, logger, /*no-errno*/0,
+		      "replication: no key-wrapping key \"%s\" in the NSS DB",
+		      CHECKPOINT_KEK_NICKNAME);
+	}
+
+	int fd = socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		fatal(PLUTO_EXIT_FAIL, logger, errno,
+		      "replication: unable to create socket for %s", from);
+	}
+	unlink(from);
+	/* the stream contains keys; create the socket private */
+	mode_t old_mask = umask(S_IRWXG|S_IRWXO);
+	int r = bind(fd, (struct sockaddr *)&standby.address.sa, standby.address.len);
+	int bind_errno = errno;
+	umask(old_mask);
+	if (r != 0) {
+		fatal(PLUTO_EXIT_FAIL, logger, bind_errno,
+		      "replication: unable to bind %s", from);
+	}
+	if (listen(fd, 1) != 0) {
+		fatal(PLUTO_EXIT_FAIL, logger, errno,
+		      "replication: unable to listen on %s", from);
+	}
+
+	standby.from = clone_str(from, "replicate-from");
+	/* the listener owns FD */
+	attach_fd_accept_listener("replication", &standby.listener, fd,
+				  accept_active, NULL);
+	llog(RC_LOG, logger, "replication: standing by for SAs from %s", from);
+}
+
+static void free_standby(void)
+{
+	if (standby.from == NULL) {
+		return;
+	}
+	close_active();
+	detach_fd_accept_listener(&standby.listener);
+	unlink(standby.from);
+	free_replicas();
+	pfreeany(standby.from);
+	standby.kek = NULL;	/* borrowed */
+}
+
+/*
+ * Assemble the replicas into a checkpoint: each IKE record followed
+ * by the records of its Child SAs.  Child SAs whose IKE SA is gone
+ * are dropped.
+ */
+
+void whack_takeover(const struct whack_message *wm UNUSED, struct show *s)
+{
+	struct logger *logger = show_logger(s);
+
+	if (standby.from == NULL) {
+		llog(RC_LOG, logger, "takeover: replicate-from= is not configured");
+		return;
+	}
+	if (standby.taken_over) {
+		llog(RC_LOG, logger, "takeover: already taken over");
+		return;
+	}
+	if (checkpoint_has_child_sas()) {
+		llog(RC_LOG, logger, "takeover: warm-restart still in progress");
+		return;
+	}
+
+	/* no more updates */
+	close_active();
+	detach_fd_accept_listener(&standby.listener);
+	standby.taken_over = true;
+
+	size_t size = checkpoint_align(sizeof(struct checkpoint_header));
+	unsigned nr_ike = 0, nr_child = 0;
+	for (unsigned b = 0; b < REPLICA_BUCKETS; b++) {
+		for (struct replica *r = standby.ike[b]; r != NULL; r = r->next) {
+			r->children = NULL;
+			size += r->len;
+			nr_ike++;
+		}
+	}
+	for (unsigned b = 0; b < REPLICA_BUCKETS; b++) {
+		for (struct replica *r = standby.child[b]; r != NULL; r = r->next) {
+			const struct checkpoint_child *rec = (const void *)r->record;
+			struct replica *ike = *ike_replica(&rec->ike_spis);
+			if (ike != NULL) {
+				r->sibling = ike->children;
+				ike->children = r;
+				size += r->len;
+				nr_child++;
+			}
+		}
+	}
+
+	uint8_t *image = alloc_bytes(size, "takeover checkpoint");
+	struct checkpoint_header *header = (void *)image;
+	checkpoint_init_header(header, standby.kek, logger);
+	header->nr_ike = nr_ike;
+	header->nr_child = nr_child;
+	header->size = size;
+
+	uint8_t *ptr = image + checkpoint_align(sizeof(*header));
+	unsigned ike_index = 0;
+	for (unsigned b = 0; b < REPLICA_BUCKETS; b++) {
+		for (struct replica *r = standby.ike[b]; r != NULL; r = r->next) {
+			memcpy(ptr, r->record, r->len);
+			ptr += r->len;
+			for (struct replica *c = r->children; c != NULL; c = c->sibling) {
+				memcpy(ptr, c->record, c->len);
+				struct checkpoint_child *rec = (void *)ptr;
+				rec->ike = ike_index;
+				ptr += c->len;
+			}
+			ike_index++;
+		}
+	}
+	passert(ptr == image + size);
+
+	free_replicas();
+	adopt_checkpoint(image, size, standby.kek, logger);
+}
+
+void init_replication(const struct config_setup *oco, struct logger *logger)
+{
+	const char *to = config_setup_string(oco, KSF_REPLICATE_TO);
+	if (to != NULL) {
+		init_active(to, logger);
+	}
+	const char *from = config_setup_string(oco, KSF_REPLICATE_FROM);
+	if (from != NULL) {
+		init_standby(from, logger);
+	}
+}
+
+void free_replication(struct logger *logger)
+{
+	free_active(logger);
+	free_standby();
+}
+
+void show_replication_status(struct show *s)
+{
+	show(s, "config.setup.replicate_to=%s", (active.to == NULL ? "" : active.to));
+	show(s, "config.setup.replicate_from=%s", (standby.from == NULL ? "" : standby.from));
+	if (active.running) {
+		pthread_mutex_lock(&active.mutex);
+		show(s, "current.replication.connected=%s", bool_str(active.connected));
+		show(s, "current.replication.queued=%zu", active.queued);
+		show(s, "total.replication.connects=%ju", active.connects);
+		show(s, "total.replication.batches=%ju", active.batches);
+		show(s, "total.replication.bytes=%ju", active.bytes);
+		show(s, "total.replication.dropped=%ju", active.dropped);
+		pthread_mutex_unlock(&active.mutex);
+	}
+	if (standby.from != NULL) {
+		show(s, "current.replication.connected=%s", bool_str(standby.fd >= 0));
+		show(s, "current.replication.ike=%u", standby.nr_ike);
+		show(s, "current.replication.child=%u", standby.nr_child);
+		show(s, "total.replication.connects=%ju", standby.connects);
+		show(s, "total.replication.records=%ju", standby.records);
+	}
+}
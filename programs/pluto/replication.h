@@ -0,0 +1,45 @@
+/* active/standby replication, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+struct config_setup;
+struct logger;
+struct show;
+struct state;
+struct ike_sa;
+struct whack_message;
+
+/*
+ * With config-setup's replicate-to=, pluto streams its established
+ * IKEv2 SAs, and changes to them, to a standby pluto configured with
+ * replicate-from=.  "ipsec whack --takeover" on the standby then
+ * adopts them.
+ */
+
+void init_replication(const struct config_setup *oco, struct logger *logger);
+void free_replication(struct logger *logger);
+void show_replication_status(struct show *s);
+
+/* active; cheap no-ops when not connected */
+void replicate_state(struct state *st);
+void replicate_v2_msgid(struct ike_sa *ike);
+void replicate_delete(struct state *st);
+
+/* standby */
+void whack_takeover(const struct whack_message *wm, struct show *s);
+
+#endif
@@ -0,0 +1,158 @@
+/* Reply cache, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#include "defs.h"
+#include "log.h"
+#include "state.h"
+#include "demux.h"		/* for struct msg_digest, NSIZEOF_isakmp_hdr */
+#include "hash_table.h"		/* for hash_hunk() */
+#include "ikev2_msgid.h"	/* for v2_msgid_recorded_response() */
+#include "ikev2_send.h"		/* for send_recorded_v2_message() */
+#ifdef USE_IKEv1
+#include "ikev1.h"		/* for ikev1_duplicate() */
+#endif
+#include "reply_cache.h"
+
+/*
+ * Direct mapped; a new entry evicts whatever was there.
+ *
+ * An entry matches when the sender, interface, length, hash, and the
+ * entire ISAKMP header (SPIs, exchange, flags, Message ID) match.  A
+ * hash collision on the rest of the message results in the recorded
+ * response being re-sent to the peer owning the SPIs; for IKEv2 this
+ * is no worse than the existing Message ID only check; for IKEv1
+ * ikev1_duplicate() still compares the full packet.
+ */
+
+#define REPLY_CACHE_SIZE 256	/* power of 2 */
+#define REPLY_CACHE_LIFETIME deltatime(30)
+
+struct reply_cache_entry {
+	so_serial_t serialno;		/* SOS_NOBODY when empty */
+	monotime_t expires;
+	hash_t hash;
+	size_t len;
+	uint8_t hdr[NSIZEOF_isakmp_hdr];
+	ip_endpoint sender;
+	const struct iface_endpoint *iface;	/* compare only */
+	enum ike_version ike_version;
+	enum ikev2_exchange xchg;
+	intmax_t msgid;
+};
+
+static struct reply_cache_entry reply_cache[REPLY_CACHE_SIZE];
+
+static hash_t hash_request(const struct msg_digest *md)
+{
+	return hash_hunk(md->packet, zero_hash);
+}
+
+void cache_duplicate_request(const struct msg_digest *md,
+			     const struct state *st, intmax_t msgid)
+{
+	if (md->packet.len < NSIZEOF_isakmp_hdr) {
+		return;
+	}
+	hash_t hash = hash_request(md);
+	struct reply_cache_entry *e = &reply_cache[hash.hash & (REPLY_CACHE_SIZE - 1)];
+	*e = (struct reply_cache_entry) {
+		.serialno = st->st_serialno,
+		.expires = monotime_add(mononow(), REPLY_CACHE_LIFETIME),
+		.hash = hash,
+		.len = md->packet.len,
+		.sender = md->sender,
+		.iface = md->iface,
+		.ike_version = st->st_ike_version,
+		.xchg = md->hdr.isa_xchg,
+		.msgid = msgid,
+	};
+	memcpy(e->hdr, md->packet.ptr, sizeof(e->hdr));
+	ldbg(st->logger, "reply cache: caching duplicate request for Message ID %jd in slot %u",
+	     msgid, (unsigned)(e - reply_cache));
+}
+
+static bool resend_v2_reply(struct state *st, const struct reply_cache_entry *e)
+{
+	struct ike_sa *ike = pexpect_ike_sa(st);
+	if (ike == NULL) {
+		return false;
+	}
+
+	unsigned recv_frags = 0;
+	struct v2_outgoing_fragments *recorded_response =
+		v2_msgid_recorded_response(ike, e->msgid, &recv_frags);
+	if (recorded_response == NULL) {
+		return false;
+	}
+
+	name_buf xb;
+	llog_sa(RC_LOG, ike,
+		"%s request has duplicate Message ID %jd; retransmitting response",
+		str_enum_short(&ikev2_exchange_names, e->xchg, &xb),
+		e->msgid);
+	send_recorded_v2_message(ike, recorded_response);
+	return true;
+}
+
+bool resend_cached_reply(struct msg_digest *md)
+{
+	if (md->packet.len < NSIZEOF_isakmp_hdr) {
+		return false;
+	}
+
+	hash_t hash = hash_request(md);
+	struct reply_cache_entry *e = &reply_cache[hash.hash & (REPLY_CACHE_SIZE - 1)];
+	if (e->serialno == SOS_NOBODY ||
+	    e->hash.hash != hash.hash ||
+	    e->len != md->packet.len ||
+	    e->iface != md->iface ||
+	    !endpoint_eq_endpoint(e->sender, md->sender) ||
+	    memcmp(e->hdr, md->packet.ptr, sizeof(e->hdr)) != 0) {
+		return false;
+	}
+
+	struct state *st = state_by_serialno(e->serialno);
+	if (st == NULL || monotime_cmp(mononow(), >=, e->expires)) {
+		ldbg(md->logger, "reply cache: dropping stale slot %u",
+		     (unsigned)(e - reply_cache));
+		zero(e);
+		return false;
+	}
+
+	ldbg(st->logger, "reply cache: hit in slot %u for Message ID %jd",
+	     (unsigned)(e - reply_cache), e->msgid);
+
+	bool sent = false;
+	switch (e->ike_version) {
+#ifdef USE_IKEv1
+	case IKEv1:
+		/* also does the full packet compare */
+		sent = (!v1_state_busy(st) && ikev1_duplicate(st, md));
+		break;
+#endif
+	case IKEv2:
+		sent = resend_v2_reply(st, e);
+		break;
+	default:
+		break;
+	}
+
+	if (!sent) {
+		ldbg(st->logger, "reply cache: slot %u no longer valid",
+		     (unsigned)(e - reply_cache));
+		zero(e);
+	}
+	return sent;
+}
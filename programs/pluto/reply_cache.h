@@ -0,0 +1,42 @@
+/* Reply cache, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#ifndef REPLY_CACHE_H
+#define REPLY_CACHE_H
+
+#include <stdint.h>		/* for intmax_t */
+#include <stdbool.h>
+
+struct msg_digest;
+struct state;
+
+/*
+ * A small global table of requests that were found to be duplicates
+ * and had their response re-transmitted.
+ *
+ * When a further copy of the same request arrives, the recorded
+ * response is re-sent straight from process_md(), before the ISAKMP
+ * header is parsed and the state is looked up by SPI.
+ *
+ * Entries are only a hint: on a hit the state and its recorded
+ * response are re-validated; and when either has gone the entry is
+ * dropped and the packet processed normally.
+ */
+
+void cache_duplicate_request(const struct msg_digest *md,
+			     const struct state *st, intmax_t msgid);
+bool resend_cached_reply(struct msg_digest *md);
+
+#endif
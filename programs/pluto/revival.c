@@ -42,6 +42,7 @@
 #include "ikev2_replace.h"
 #include "orient.h"
 #include "ikev1.h"	/* for established_isakmp_sa_for_state() */
+#include "pacer.h"	/* for pace_revival_delay() */
 
 /*
  * This code path can't tell if the flush is due to an initiate or a
@@ -187,7 +188,8 @@ static void schedule_revival_event(struct connection *c, struct logger *logger,
 	     c->revival.attempt,
 	     str_deltatime(delay, &db));
 
-	schedule_connection_event(c, CONNECTION_REVIVAL, subplot, delay,
+	schedule_connection_event(c, CONNECTION_REVIVAL, subplot,
+				  pace_revival_delay(delay),
 				  (impair.revival ? "revival" : NULL), logger);
 }
 
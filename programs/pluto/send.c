@@ -63,7 +63,9 @@
  * is suppressed.
  *
  * send_packet() sends a UDP packet, possibly prefixed by a non-ESP Marker
- * for NATT.  It accepts two chunks because this avoids double-copying.
+ * for NATT.  It accepts two chunks and hands them, along with any
+ * marker, to write_packet() as a scatter/gather list; nothing is
+ * copied.
  */
 
 static bool send_shunks(const char *where, bool just_a_keepalive,
@@ -130,32 +132,37 @@ static bool send_shunks(const char *where, bool just_a_keepalive,
 	}
 
 	/*
-	 * BUF must be same scope as PACKET.  Use dummy assignment to
-	 * enforce this.
-	 *
-	 * NOTE: on system with limited stack, buf could be made
-	 * static.  XXX: except this is going to be made parallel.
-	 *
-	 * Instead of the copy, should write_packet act more like
-	 * iovec?
+	 * Gather the pieces: the optional non-ESP marker, A, and B.
+	 * Neither A nor B (typically the IKE SA's recorded message)
+	 * is copied.
 	 */
-	uint8_t buf[MAX_OUTPUT_UDP_SIZE];
-	shunk_t packet = THING_AS_HUNK(buf);
-	if (len != a.len) {
-		/* copying required */
-
-		/* 1. non-ESP Marker (0x00 octets) */
-		memset(buf, 0x00, natt_bonus);
-
-		/* 2. chunk a */
-		memcpy(buf + natt_bonus, a.ptr, a.len);
-
-		/* 3. chunk b */
-		memcpy(buf + natt_bonus + a.len, b.ptr, b.len);
+	static const uint8_t non_esp_marker[NON_ESP_MARKER_SIZE]; /* 0x00 octets */
+	shunk_t pieces[MAX_WRITE_PACKET_PIECES];
+	unsigned nr_pieces = 0;
+	if (natt_bonus > 0) {
+		pieces[nr_pieces++] = shunk2(non_esp_marker, natt_bonus);
+	}
+	pieces[nr_pieces++] = a;
+	if (b.len > 0) {
+		pieces[nr_pieces++] = b;
+	}
 
+	/*
+	 * Only the impairments, which save or re-send the message,
+	 * need it flattened.
+	 *
+	 * BUF must be same scope as PACKET.
+	 */
+	uint8_t *buf = NULL; /* must free */
+	shunk_t packet = a;
+	if (nr_pieces > 1 && (impair.record_outbound || impair.jacob_two_two)) {
+		buf = alloc_bytes(len, "flattened packet");
+		size_t off = 0;
+		for (unsigned i = 0; i < nr_pieces; i++) {
+			memcpy(buf + off, pieces[i].ptr, pieces[i].len);
+			off += pieces[i].len;
+		}
 		packet = shunk2(buf, len);
-	} else {
-		packet = a;
 	}
 
 	if (LDBGP(DBG_BASE, logger)) {
@@ -163,17 +170,19 @@ static bool send_shunks(const char *where, bool just_a_keepalive,
 		endpoint_buf rb;
 		llog(DEBUG_STREAM, logger,
 		     "sending %zu bytes for %s through %s from %s to %s using %s (for "PRI_SO")",
-		     packet.len, where,
+		     len, where,
 		     interface->ip_dev->real_device_name,
 		     str_endpoint(&interface->local_endpoint, &lb),
 		     str_endpoint(&remote_endpoint, &rb),
 		     interface->io->protocol->name,
 		     pri_so(serialno));
-		llog_hunk(DEBUG_STREAM, logger, &packet);
+		for (unsigned i = 0; i < nr_pieces; i++) {
+			llog_hunk(DEBUG_STREAM, logger, &pieces[i]);
+		}
 	}
 
 	if (!impair_outbound(interface, packet, &remote_endpoint, logger)) {
-		ssize_t wlen = interface->io->write_packet(interface, packet,
+		ssize_t wlen = interface->io->write_packet(interface, pieces, nr_pieces,
 							   &remote_endpoint, logger);
 		if (wlen != (ssize_t)len) {
 			if (!just_a_keepalive) {
@@ -187,6 +196,7 @@ static bool send_shunks(const char *where, bool just_a_keepalive,
 					   interface->io->protocol->name,
 					   where);
 			}
+			pfreeany(buf);
 			return false;
 		}
 		pstats_ike_bytes.out += len;
@@ -220,9 +230,11 @@ static bool send_shunks(const char *where, bool just_a_keepalive,
 					   str_endpoint(&remote_endpoint, &b),
 					   where);
 			}
+			pfreeany(buf);
 			return false;
 		}
 	}
+	pfreeany(buf);
 	return true;
 }
 
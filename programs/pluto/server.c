@@ -248,6 +248,8 @@ static struct global_timer_desc global_timers[] = {
 	E(EVENT_CHECK_CRLS),
 	E(EVENT_FREE_ROOT_CERTS),
 	E(EVENT_RESET_LOG_LIMITER),
+	E(EVENT_SPI_POOL),
+	E(EVENT_REDIRECT_LOAD),
 #undef E
 };
 
@@ -531,6 +533,8 @@ struct timeout {
 	struct event ev;
 };
 
+static struct slab timeout_slab = SLAB(struct timeout, "timeout");
+
 static void timeout(evutil_socket_t fd UNUSED,
 		    const short ev_event UNUSED, void *arg)
 {
@@ -547,7 +551,7 @@ void schedule_timeout(const char *name,
 		      void (*cb)(void *arg, const struct timer_event *event),
 		      void *arg)
 {
-	*tt = alloc_thing(struct timeout, name);
+	*tt = alloc_slab_thing(&timeout_slab, struct timeout, name);
 	ldbg_newref(&global_logger, *tt);
 	(*tt)->name = name;
 	(*tt)->cb = cb;
@@ -573,7 +577,7 @@ void destroy_timeout(struct timeout **tt)
 	if (*tt != NULL) {
 		EVENT_DEL(*tt, &global_logger);
 		ldbg_delref(&global_logger, *tt);
-		pfree(*tt);
+		pfree_slab(&timeout_slab, *tt);
 		*tt = NULL;
 	}
 }
@@ -614,53 +618,49 @@ void complete_state_transition(struct state *st, struct msg_digest *md, stf_stat
 	}
 }
 
-static void resume_handler(void *arg, const struct timer_event *event)
+void run_resume(const char *name, so_serial_t serialno,
+		struct msg_digest **mdp,
+		resume_cb *callback, void *context,
+		const struct logger *logger)
 {
-	struct resume_event *e = (struct resume_event *)arg;
-	/*
-	 * At one point, .ne_event was was being set after the event
-	 * was enabled.  With multiple threads this resulted in a race
-	 * where the event ran before .ne_event was set.  The
-	 * pexpect() followed by the passert() demonstrated this - the
-	 * pexpect() failed yet the passert() passed.
-	 */
-	pexpect(e->timer != NULL);
-	ldbg(event->logger, "processing resume %s for "PRI_SO"",
-	     e->name, pri_so(e->serialno));
+	passert(in_main_thread());
+	struct msg_digest *md = (mdp == NULL ? NULL : *mdp);
+	ldbg(logger, "processing resume %s for "PRI_SO"",
+	     name, pri_so(serialno));
 	/*
 	 * XXX: Don't confuse this and the "callback") code path.
 	 * This unsuspends MD, "callback" does not.
 	 */
-	struct state *st = state_by_serialno(e->serialno);
+	struct state *st = state_by_serialno(serialno);
 	if (st == NULL) {
 		threadtime_t start = threadtime_start();
-		stf_status status = e->callback(NULL, NULL, e->context);
+		stf_status status = callback(NULL, NULL, context);
 		pexpect(status == STF_SKIP_COMPLETE_STATE_TRANSITION);
-		threadtime_stop(&start, e->serialno, "resume %s", e->name);
+		threadtime_stop(&start, serialno, "resume %s", name);
 	} else {
 		/* no previous state */
 		statetime_t start = statetime_start(st);
 
 		/* trust nothing; so save everything */
 		so_serial_t old_st = st->st_serialno;
-		so_serial_t old_md_st = (e->md == NULL ? SOS_NOBODY :
-					 e->md->v1_st == NULL ? SOS_NOBODY :
-					 e->md->v1_st->st_serialno);
+		so_serial_t old_md_st = (md == NULL ? SOS_NOBODY :
+					 md->v1_st == NULL ? SOS_NOBODY :
+					 md->v1_st->st_serialno);
 		const enum ike_version ike_version = st->st_ike_version;
 		/* when MD.ST it matches ST */
 		pexpect(old_md_st == SOS_NOBODY || old_md_st == old_st);
 
 		/* run the callback */
-		stf_status status = e->callback(st, e->md, e->context);
+		stf_status status = callback(st, md, context);
 		/* this may trash ST and/or MD.ST */
 
 		if (status == STF_SKIP_COMPLETE_STATE_TRANSITION) {
 			/* MD.ST may have been freed! */
-			ldbg(event->logger,
+			ldbg(logger,
 			     "resume %s for "PRI_SO" suppressed complete_v%d_state_transition()%s",
-			     e->name, pri_so(e->serialno), ike_version,
-			     (old_md_st != SOS_NOBODY && e->md->v1_st == NULL ? "; MD.ST disappeared" :
-			      old_md_st != SOS_NOBODY && e->md->v1_st != st ? "; MD.ST was switched" :
+			     name, pri_so(serialno), ike_version,
+			     (old_md_st != SOS_NOBODY && md->v1_st == NULL ? "; MD.ST disappeared" :
+			      old_md_st != SOS_NOBODY && md->v1_st != st ? "; MD.ST was switched" :
 			      ""));
 		} else {
 			/* XXX: mumble something about struct ike_version */
@@ -670,12 +670,12 @@ static void resume_handler(void *arg, const struct timer_event *event)
 				/* no switching MD.ST */
 				if (old_md_st == SOS_NOBODY) {
 					/* (old)md->v1_st == (new)md->v1_st == NULL */
-					pexpect(e->md == NULL || e->md->v1_st == NULL);
+					pexpect(md == NULL || md->v1_st == NULL);
 				} else {
 					/* md->v1_st didn't change */
-					pexpect(e->md != NULL &&
-						e->md->v1_st != NULL &&
-						e->md->v1_st->st_serialno == old_md_st);
+					pexpect(md != NULL &&
+						md->v1_st != NULL &&
+						md->v1_st->st_serialno == old_md_st);
 				}
 				pexpect(st != NULL); /* see above */
 				break;
@@ -685,13 +685,30 @@ static void resume_handler(void *arg, const struct timer_event *event)
 			default:
 				bad_case(ike_version);
 			}
-			complete_state_transition(st, e->md, status);
+			complete_state_transition(st, md, status);
 		}
-		statetime_stop(&start, "resume %s", e->name);
+		statetime_stop(&start, "resume %s", name);
+	}
+	if (mdp != NULL) {
+		md_delref(mdp);
 	}
+}
+
+static void resume_handler(void *arg, const struct timer_event *event)
+{
+	struct resume_event *e = (struct resume_event *)arg;
+	/*
+	 * At one point, .ne_event was was being set after the event
+	 * was enabled.  With multiple threads this resulted in a race
+	 * where the event ran before .ne_event was set.  The
+	 * pexpect() followed by the passert() demonstrated this - the
+	 * pexpect() failed yet the passert() passed.
+	 */
+	pexpect(e->timer != NULL);
+	run_resume(e->name, e->serialno, &e->md, e->callback, e->context,
+		   event->logger);
 	passert(e->timer != NULL);
 	destroy_timeout(&e->timer);
-	md_delref(&e->md);
 	pfree(e);
 }
 
@@ -1051,12 +1068,27 @@ void run_server(const char *conffile, struct logger *logger)
 		fatal(PLUTO_EXIT_FAIL, logger, errno, "%s: missing or not executable", addconn_path);
 	}
 
+	/*
+	 * Let addconn skip parsing when ipsec.conf et.al. haven't
+	 * changed since the last start.
+	 */
+	char configcache[PATH_MAX];
+	int n = snprintf(configcache, sizeof(configcache), "%s/ipsec.conf.cache",
+			 config_setup_string(oco, KSF_RUNDIR));
+	if (n < 0 || (size_t)n >= sizeof(configcache)) {
+		fatal(PLUTO_EXIT_FAIL, logger, /*no-errno*/0,
+		      "rundir=%s is too long for the config cache path",
+		      config_setup_string(oco, KSF_RUNDIR));
+	}
+
 	char *newargv[] = {
 		DISCARD_CONST(char *, "addconn"),
 		DISCARD_CONST(char *, "--ctlsocket"),
 		DISCARD_CONST(char *, ctl_addr.sun_path),
 		DISCARD_CONST(char *, "--config"),
 		DISCARD_CONST(char *, conffile),
+		DISCARD_CONST(char *, "--configcache"),
+		configcache,
 		DISCARD_CONST(char *, "--autoall"),
 		NULL,
 	};
@@ -124,6 +124,16 @@ void schedule_resume(const char *name,
 		     struct msg_digest **mdp,
 		     resume_cb *callback, void *context);
 
+/*
+ * Run a resume now, on the main thread, consuming *MDP (when
+ * non-NULL).  Used by schedule_resume() and by the helper completion
+ * queue.
+ */
+void run_resume(const char *name, so_serial_t serialno,
+		struct msg_digest **mdp,
+		resume_cb *callback, void *context,
+		const struct logger *logger);
+
 /*
  * Schedule a callback on the main event loop now.
  *
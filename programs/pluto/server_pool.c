@@ -34,6 +34,11 @@
 
 #include <unistd.h>	/* for sleep() */
 #include <limits.h>	/* for UINT_MAX, ULONG_MAX */
+#include <errno.h>
+#include <fcntl.h>	/* for O_NONBLOCK */
+#if defined(linux)
+#include <sys/eventfd.h>
+#endif
 
 #include "ttodata.h"
 #include "refcnt.h"
@@ -85,6 +90,7 @@ struct job {
 	struct task *task;
 	const struct task_handler *handler;
 	struct list_entry backlog;
+	struct job *next_completed;		/* see completions */
 	so_serial_t callback_so;		/* sponsoring state-object's serial number */
 	so_serial_t task_so;			/* sponsoring state-object's serial number */
 	struct msg_digest *md;
@@ -98,6 +104,8 @@ struct job {
 	struct logger *logger;
 };
 
+static struct slab job_slab = SLAB(struct job, "job");
+
 #define PRI_JOB "job %u helper %u "PRI_SO"/"PRI_SO" %s (%s)"
 #define pri_job(JOB)							\
 	JOB->job_id,							\
@@ -147,7 +155,7 @@ static pthread_mutex_t backlog_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t backlog_cond = PTHREAD_COND_INITIALIZER;
 
 struct list_head backlog = INIT_LIST_HEAD(&backlog, &backlog_info);
-static int backlog_queue_len = 0;
+static unsigned backlog_queue_len = 0;
 
 static void message_helpers(struct job *job)
 {
@@ -182,6 +190,148 @@ unsigned server_nhelpers(void)
 	return (helper_threads_started - helper_threads_stopped);
 }
 
+/* jobs waiting for a helper */
+
+unsigned server_backlog(void)
+{
+	pthread_mutex_lock(&backlog_mutex);
+	unsigned len = backlog_queue_len;
+	pthread_mutex_unlock(&backlog_mutex);
+	return len;
+}
+
+/*
+ * Completed jobs are handed back to the main thread using a lock-free
+ * multi-producer single-consumer stack.
+ *
+ * A helper pushes the job using compare-and-swap and, only when the
+ * stack was empty, pokes the main thread's wake-up FD (an eventfd(),
+ * else a pipe).  The main thread clears the FD, takes the entire
+ * stack in one exchange, reverses it (so jobs complete in the order
+ * they finished), and then completes each job.
+ *
+ * Since the FD is cleared before the stack is taken, a job pushed
+ * after the exchange always finds an empty stack and pokes the FD
+ * again; the worst case is a spurious wake-up.
+ */
+
+static struct {
+	struct job *head;		/* atomic */
+	int fd[2];			/* [0] read, [1] write */
+	struct fd_read_listener *listener;
+} completions = {
+	.fd = { -1, -1, },
+};
+
+/*
+ * IN A HELPER THREAD
+ *
+ * Once pushed, the main thread can free JOB at any moment so JOB
+ * must not be touched after the compare-and-swap.
+ */
+static void push_completion(struct job *job)
+{
+	struct job *head = __atomic_load_n(&completions.head, __ATOMIC_RELAXED);
+	do {
+		job->next_completed = head;
+	} while (!__atomic_compare_exchange_n(&completions.head, &head, job,
+					      /*weak*/true,
+					      __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+	if (head != NULL) {
+		/* main thread already poked */
+		return;
+	}
+#if defined(linux)
+	uint64_t one = 1;
+#else
+	uint8_t one = 1;
+#endif
+	if (write(completions.fd[1], &one, sizeof(one)) < 0 && errno != EAGAIN) {
+		llog_errno(ERROR_STREAM, &global_logger, errno,
+			   "waking main thread for completed job failed: ");
+	}
+}
+
+static void drain_completions(const struct logger *logger)
+{
+	passert(in_main_thread());
+	struct job *stack = __atomic_exchange_n(&completions.head, NULL, __ATOMIC_ACQUIRE);
+
+	/* LIFO -> FIFO */
+	struct job *fifo = NULL;
+	while (stack != NULL) {
+		struct job *next = stack->next_completed;
+		stack->next_completed = fifo;
+		fifo = stack;
+		stack = next;
+	}
+
+	unsigned nr = 0;
+	while (fifo != NULL) {
+		struct job *job = fifo;
+		fifo = job->next_completed;
+		/* steal MD; JOB is freed by handle_helper_answer() */
+		struct msg_digest *md = job->md;
+		job->md = NULL;
+		run_resume("sending job back to main thread",
+			   job->callback_so, &md,
+			   handle_helper_answer, job, logger);
+		nr++;
+	}
+	if (nr > 0) {
+		ldbg(logger, "completed %u helper jobs", nr);
+	}
+}
+
+static void completions_listener(int fd, void *arg UNUSED, struct logger *logger)
+{
+	/* clear the wake-up before taking the stack; see above */
+	uint8_t buf[64];
+	if (read(fd, buf, sizeof(buf)) < 0 && errno != EAGAIN) {
+		llog_errno(ERROR_STREAM, logger, errno,
+			   "clearing helper completion wake-up failed: ");
+	}
+	drain_completions(logger);
+}
+
+static bool init_completions(struct logger *logger)
+{
+#if defined(linux)
+	int fd = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+	if (fd < 0) {
+		llog_errno(ERROR_STREAM, logger, errno, "eventfd() failed: ");
+		return false;
+	}
+	completions.fd[0] = completions.fd[1] = fd;
+#else
+	if (pipe(completions.fd) < 0) {
+		llog_errno(ERROR_STREAM, logger, errno, "pipe() failed: ");
+		return false;
+	}
+	FOR_EACH_ELEMENT(fd, completions.fd) {
+		fcntl(*fd, F_SETFL, O_NONBLOCK);
+		fcntl(*fd, F_SETFD, FD_CLOEXEC);
+	}
+#endif
+	attach_fd_read_listener(&completions.listener, completions.fd[0],
+				"helper completions", completions_listener, NULL);
+	return true;
+}
+
+static void free_completions(const struct logger *logger)
+{
+	/* anything that slipped in */
+	drain_completions(logger);
+	detach_fd_read_listener(&completions.listener);
+	if (completions.fd[0] >= 0) {
+		close(completions.fd[0]);
+	}
+	if (completions.fd[1] >= 0 && completions.fd[1] != completions.fd[0]) {
+		close(completions.fd[1]);
+	}
+	completions.fd[0] = completions.fd[1] = -1;
+}
+
 /*
  * If there are any helper threads, this code is always executed IN A HELPER
  * THREAD. Otherwise it is executed in the main (only) thread.
@@ -200,9 +350,14 @@ static void do_job(struct job *job, helper_id_t helper_id)
 	}
 
 	job->time_used = logtime_stop(&start, PRI_JOB, pri_job(job));
-	schedule_resume("sending job back to main thread",
-			job->callback_so, &job->md/*stolen*/,
-			handle_helper_answer, job);
+	if (in_main_thread()) {
+		/* inline; see inline_worker() */
+		schedule_resume("sending job back to main thread",
+				job->callback_so, &job->md/*stolen*/,
+				handle_helper_answer, job);
+		return;
+	}
+	push_completion(job);
 }
 
 /* IN A HELPER THREAD */
@@ -246,6 +401,7 @@ static void *helper_thread(void *arg)
 					 * started.
 					 */
 					remove_list_entry(&job->backlog);
+					backlog_queue_len--;
 					job->helper_id = w->helper_id;
 					break;
 				}
@@ -381,7 +537,7 @@ void submit_task(struct state *callback_sa,
 		return;
 	}
 
-	struct job *job = alloc_thing(struct job, where->func);
+	struct job *job = alloc_slab_thing(&job_slab, struct job, where->func);
 	ldbg_newref(&global_logger, job);
 	job->cancelled = false;
 	job->where = where;
@@ -499,7 +655,7 @@ static void free_job(struct job **jobp)
 	/* now free up the continuation */
 	free_logger(&job->logger, HERE);
 	ldbg_delref(&global_logger, job);
-	pfree(job);
+	pfree_slab(&job_slab, job);
 	*jobp = NULL;
 }
 
@@ -583,6 +739,12 @@ void start_server_helpers(uintmax_t nhelpers, struct logger *logger)
 			nhelpers = ncpu_online - 1;
 	}
 
+	if (nhelpers > 0 && !init_completions(logger)) {
+		llog(RC_LOG, logger,
+		     "unable to create helper completion queue; all cryptographic operations will be done inline");
+		nhelpers = 0;
+	}
+
 	if (nhelpers > 0) {
 		llog(RC_LOG, logger, "starting up %ju helper threads", nhelpers);
 
@@ -632,6 +794,13 @@ static void helper_thread_stopped_callback(const char *story UNUSED,
 	ldbg(&global_logger, "one helper thread exited, %u remaining",
 	    helper_threads_started-helper_threads_stopped);
 
+	/*
+	 * The exiting helper pushed its last job before scheduling
+	 * this callback; complete it now so that nothing is left
+	 * behind once all the helpers are gone.
+	 */
+	drain_completions(&global_logger);
+
 	/* wait for more? */
 	if (helper_threads_started > helper_threads_stopped) {
 		/* poke threads waiting for work */
@@ -647,6 +816,7 @@ static void helper_thread_stopped_callback(const char *story UNUSED,
 
 	pfreeany(helper_threads);
 	helper_threads = NULL;
+	free_completions(&global_logger);
 	server_helpers_stopped_callback();
 }
 
@@ -682,6 +852,7 @@ void free_server_helper_jobs(struct logger *logger)
 		struct job *job = NULL;
 		FOR_EACH_LIST_ENTRY_OLD2NEW(job, &backlog) {
 			remove_list_entry(&job->backlog);
+			backlog_queue_len--;
 			free_job(&job);
 		}
 	} else {
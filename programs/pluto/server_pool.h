@@ -73,5 +73,6 @@ void start_server_helpers(uintmax_t nhelpers, struct logger *logger);
 void stop_server_helpers(void (*all_server_helpers_stopped)(void), struct logger *logger);
 void free_server_helper_jobs(struct logger *logger);
 unsigned server_nhelpers(void);
+unsigned server_backlog(void);
 
 #endif
@@ -76,6 +76,10 @@
 #include "ikev2_states.h"
 #include "crypt_cipher.h"		/* for cipher_context_destroy() */
 #include "ddos.h"
+#include "pacer.h"		/* for show_pacer_status() */
+#include "rekey_smoothing.h"	/* for show_rekey_smoothing_status() */
+#include "checkpoint.h"		/* for show_checkpoint_status() */
+#include "replication.h"		/* for replicate_state() */
 #include "ipsecconf/config_setup.h"
 
 static void delete_state(struct state *st);
@@ -172,6 +176,11 @@ cat_t total_halfopen_ike(void)
 	return cat_count[CAT_HALF_OPEN_IKE_SA];
 }
 
+cat_t total_established_ike(void)
+{
+	return cat_count[CAT_ESTABLISHED_IKE_SA];
+}
+
 static cat_t total_ike_sa(void)
 {
 	return (cat_count[CAT_HALF_OPEN_IKE_SA] +
@@ -295,7 +304,9 @@ static void change_state(struct state *st, enum state_kind new_state_kind)
 		update_state_stats(st, old_state, new_state);
 		binlog_state(st, new_state_kind /* XXX */);
 		ldbg(st->logger, "transition %s->%s", old_state->short_name, new_state->short_name);
+		remove_v2_larval_child(st);
 		st->st_state = new_state;
+		add_v2_larval_child(st);
 	}
 }
 
@@ -308,6 +319,9 @@ void change_v2_state(struct state *st)
 {
 	if (pexpect(st->st_v2_transition != NULL)) {
 		change_state(st, st->st_v2_transition->to->kind);
+		if (IS_IKE_SA_ESTABLISHED(st) || IS_CHILD_SA_ESTABLISHED(st)) {
+			replicate_state(st);
+		}
 #if 0
 		/*
 		 * Breaks IKE_AUTH where IKE SA changes state twice:
@@ -432,6 +446,14 @@ struct child_sa *pexpect_child_sa_where(struct state *st, where_t where)
  * leak.  Caller must add_state_to_db().
  */
 
+union sas {
+	struct child_sa child;
+	struct ike_sa ike;
+	struct state st;
+};
+
+static struct slab state_slab = SLAB(union sas, "state");
+
 static struct state *new_state(struct connection *c,
 			       so_serial_t clonedfrom,
 			       struct iface_endpoint *local_iface_endpoint,
@@ -442,12 +464,7 @@ static struct state *new_state(struct connection *c,
 			       enum sa_role sa_role,
 			       where_t where)
 {
-	union sas {
-		struct child_sa child;
-		struct ike_sa ike;
-		struct state st;
-	};
-	union sas *sap = alloc_thing(union sas, "struct state");
+	union sas *sap = alloc_slab_thing(&state_slab, union sas, "struct state");
 	passert(&sap->st == &sap->child.sa);
 	passert(&sap->st == &sap->ike.sa);
 	struct state *st = &sap->st;
@@ -718,6 +735,34 @@ struct ike_sa *new_v2_ike_sa_responder(struct connection *c,
 			     ike_responder_spi(&md->sender, md->logger));
 }
 
+/*
+ * An established IKE SA re-adopted from a warm-restart checkpoint;
+ * the caller fills in the keys et.al.
+ *
+ * ANON is set before the state changes so that the established
+ * counts are right.
+ */
+
+struct ike_sa *new_v2_ike_sa_restored(struct connection *c,
+				      enum sa_role sa_role,
+				      struct iface_endpoint *local_iface_endpoint,
+				      ip_endpoint remote_endpoint,
+				      const ike_spis_t *ike_spis,
+				      bool anon)
+{
+	struct state *st = new_state(c, SOS_NOBODY,
+				     iface_endpoint_addref(local_iface_endpoint),
+				     remote_endpoint,
+				     ike_spis->initiator, ike_spis->responder,
+				     IKE_SA, sa_role, HERE);
+	struct ike_sa *ike = pexpect_ike_sa(st);
+	v2_msgid_init_ike(ike);
+	ike->sa.st_ikev2_anon = anon;
+	ike->sa.st_restored = true;
+	change_state(&ike->sa, STATE_V2_ESTABLISHED_IKE_SA);
+	return ike;
+}
+
 /*
  * Initialize the state table.
  */
@@ -907,6 +952,9 @@ void delete_state(struct state *st)
 	}
 
 	pstat_sa_deleted(st);
+	replicate_delete(st);
+	remove_v2_larval_child(st);
+	free_v2_larval_children(st);
 
 	/*
 	 * Even though code tries to always track CPU time, only log
@@ -1207,7 +1255,7 @@ void delete_state(struct state *st)
 
 	free_logger(&st->logger, HERE);
 	messup(st);
-	pfree(st);
+	pfree_slab(&state_slab, st);
 }
 
 /*
@@ -1788,6 +1836,10 @@ void show_globalstate_status(struct show *s)
 
 	show(s, "config.setup.ike.ddos_threshold=%ju", config_setup_option(oco, KBF_DDOS_IKE_THRESHOLD));
 	show(s, "config.setup.ike.max_halfopen=%ju", config_setup_option(oco, KBF_MAX_HALFOPEN_IKE));
+	show_pacer_status(s);
+	show_rekey_smoothing_status(s);
+	show_checkpoint_status(s);
+	show_replication_status(s);
 
 	/* technically shunts are not a struct state's - but makes it easier to group */
 	show(s, "current.states.all="PRI_CAT, shunts + total_sa());
@@ -2013,8 +2065,10 @@ void connswitch_state_and_log(struct state *st, struct connection *new)
 	st->logger->debugging |= new->logger->debugging;
 
 	/* and switch */
+	remove_v2_larval_child(st);
 	st->st_connection = connection_addref(new, st->logger);
 	state_db_rehash_connection_serialno(st);
+	add_v2_larval_child(st);
 	connection_delref(&old, st->logger);
 }
 
@@ -70,6 +70,7 @@ struct ikev2_ipseckey_dns; /* forward declaration of tag */
 
 struct state;   /* forward declaration of tag */
 struct eap_state;
+struct v2_larval_children;
 
 struct child_policy {
 	bool is_set;
@@ -246,6 +247,8 @@ struct state {
 	so_serial_t st_v1_ipsec_pred;		/* IKEv1: replacing established IPsec SA */
 	so_serial_t st_v2_ike_pred;		/* IKEv2: replacing established IKE SA */
 	so_serial_t st_v2_rekey_pred;		/* IKEv2: rekeying established IKE or CHILD SA */
+	bool st_restored;			/* IKEv2: re-adopted from a warm-restart checkpoint */
+	bool st_replicated;			/* IKEv2: sent to the standby */
 
 #ifdef USE_PAM_AUTH
 	struct pam_auth *st_pam_auth;		/* per state auth/pam thread */
@@ -307,6 +310,12 @@ struct state {
 	 */
 	struct resume_session *st_v2_resume_session;
 
+	/*
+	 * IKE SA: the larval Child SAs being negotiated, by
+	 * connection; see already_has_larval_v2_child().
+	 */
+	struct v2_larval_children *st_v2_larval_children;
+
 	/*
 	 * Digital Signature authentication.
 	 *
@@ -815,6 +824,12 @@ struct child_sa *new_v1_child_sa(struct connection *c,
 				 enum sa_role sa_role);
 
 struct ike_sa *new_v2_ike_sa_initiator(struct connection *c);
+struct ike_sa *new_v2_ike_sa_restored(struct connection *c,
+				      enum sa_role sa_role,
+				      struct iface_endpoint *local_iface_endpoint,
+				      ip_endpoint remote_endpoint,
+				      const ike_spis_t *ike_spis,
+				      bool anon);
 
 struct ike_sa *new_v2_ike_sa_responder(struct connection *c,
 				       const struct finite_state *state,
@@ -888,6 +903,7 @@ extern void change_v1_state(struct state *st, enum state_kind new_state);
 extern void change_v2_state(struct state *st);
 
 extern unsigned long total_halfopen_ike(void);
+extern unsigned long total_established_ike(void);
 extern void show_globalstate_status(struct show *s);
 
 void append_st_cfg_domain(struct state *st, struct pbs_in *pbs,
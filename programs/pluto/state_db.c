@@ -20,6 +20,7 @@
 #include "state.h"
 #include "connections.h"
 #include "hash_table.h"
+#include "ikev2.h"			/* for add_v2_larval_child() */
 
 /*
  * Legacy search functions.
@@ -284,8 +285,10 @@ static REHASH_DB_ENTRY(state, clonedfrom, .st_clonedfrom);
 
 void update_sa_clonedfrom(struct child_sa *sa, so_serial_t clonedfrom)
 {
+	remove_v2_larval_child(&sa->sa);
 	sa->sa.st_clonedfrom = clonedfrom;
 	state_db_rehash_clonedfrom(&sa->sa);
+	add_v2_larval_child(&sa->sa);
 }
 
 /*
@@ -61,6 +61,7 @@
 #include "ikev2_delete.h"
 #include "pluto_stats.h"
 #include "revival.h"
+#include "pacer.h"		/* for remove_connection_from_pacer() */
 
 static void terminate_v1_state(struct connection *c,
 			       struct ike_sa **ike,
@@ -324,6 +325,12 @@ void terminate_connection(struct connection *c, where_t where)
 	 */
 	remove_connection_from_pending(c);
 	pmemory(c); /* should not disappear; caller holds ref */
+
+	/*
+	 * Remove any initiate waiting on the pacer.
+	 */
+	remove_connection_from_pacer(c);
+	pmemory(c); /* should not disappear; caller holds ref */
 }
 
 static void terminate_and_unroute_connection(struct connection *c, where_t where)
@@ -48,6 +48,7 @@
 #include "log.h"
 #include "rnd.h"
 #include "timer.h"
+#include "rekey_smoothing.h"	/* for unbook_rekey() */
 #include "whack.h"
 #include "ikev1_dpd.h"
 #include "ikev2.h"
@@ -162,6 +163,8 @@ struct state_event **state_event_slot(struct state *st, enum event_type type)
 	bad_case(type);
 }
 
+static struct slab state_event_slab = SLAB(struct state_event, "state_event");
+
 void delete_state_event(struct state_event **evp, where_t where UNUSED)
 {
 	struct state_event *e = (*evp);
@@ -176,11 +179,15 @@ void delete_state_event(struct state_event **evp, where_t where UNUSED)
 	     pri_so(e->ev_state->st_serialno),
 	     str_enum_long(&event_type_names, e->ev_type, &tb));
 
+	if (e->ev_rekey_booked) {
+		unbook_rekey(e->ev_time);
+	}
+
 	/* first the event */
 	destroy_timeout(&e->timeout);
 	/* then the structure */
 	ldbg_delref(&global_logger, e);
-	pfree(e);
+	pfree_slab(&state_event_slab, e);
 	*evp = NULL;
 
 }
@@ -625,7 +632,7 @@ void event_schedule_where(enum event_type type, deltatime_t delay, struct state
 		delete_state_event(evp, where);
 	}
 
-	struct state_event *ev = alloc_thing(struct state_event, __func__);
+	struct state_event *ev = alloc_slab_thing(&state_event_slab, struct state_event, __func__);
 	ldbg_newref(st->logger, ev);
 	ev->ev_type = type;
 	ev->ev_state = st;
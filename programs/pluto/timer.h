@@ -36,6 +36,7 @@ struct state_event {
 	monotime_t ev_epoch;		/* it was scheduled ... */
 	deltatime_t ev_delay;		/* ... with the delay ... */
 	monotime_t ev_time;		/* ... so should happen after ...*/
+	bool ev_rekey_booked;		/* counted by book_rekey() */
 };
 
 void state_event_sort(const struct state_event **events, unsigned nr_events);
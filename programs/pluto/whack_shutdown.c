@@ -64,8 +64,17 @@
 #include "ikev2_redirect.h"	/* for free_global_redirect_dests() */
 #include "ipsecconf/config_setup.h"	/* for free_config_setup() */
 #include "pending.h"
+#include "pacer.h"		/* for free_pacer() */
+#include "rekey_smoothing.h"	/* for free_rekey_smoothing() */
+#include "checkpoint.h"		/* for save_checkpoint() */
+#include "replication.h"	/* for free_replication() */
+#include "redirect_load.h"	/* for free_redirect_load() */
+#include "rcv_whack.h"		/* for free_whack_batches() */
 #include "connection_event.h"
 #include "terminate.h"
+#ifdef USE_IKEv1
+#include "xauth_passwd.h"	/* for free_xauth_passwd() */
+#endif
 
 server_stopped_cb server_stopped_callback NEVER_RETURNS;
 
@@ -157,6 +166,9 @@ static void delete_every_connection(struct logger *logger)
 void exit_epilogue(struct logger *logger)
 {
 	if (pluto_leave_state) {
+		save_checkpoint(logger);	/* needs NSS */
+		free_replication(logger);
+		free_redirect_load(logger);
 		shutdown_nss();
 		free_preshared_secrets(logger);
 		delete_lock_file();	/* delete any lock files */
@@ -180,12 +192,22 @@ void exit_epilogue(struct logger *logger)
 	 * revivals, ...
 	 */
 	delete_every_connection(logger);
+	free_pacer(logger);
+	free_rekey_smoothing();
+	free_replication(logger);	/* borrows checkpoint_kek() */
+	free_checkpoint(logger);
+	free_redirect_load(logger);
+	free_whack_batches();
 
 	free_server_helper_jobs(logger);
 
 	free_root_certs(logger);
 	free_preshared_secrets(logger);
 	free_remembered_public_keys();
+#ifdef USE_IKEv1
+	free_xauth_passwd();
+#endif
+	free_struct_codecs();
 	/*
 	 * free memory allocated by initialization routines.  Please don't
 	 * forget to do this.
@@ -0,0 +1,329 @@
+/* XAUTH password file, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>		/* for UINT_MAX */
+#include <string.h>
+
+#include "lswalloc.h"
+#include "ipsecconf/config_setup.h"	/* for config_setup_ipsecdir() */
+
+#include "defs.h"
+#include "log.h"
+#include "hash_table.h"		/* for hash_bytes() */
+#include "xauth_passwd.h"
+
+/*
+ * The loaded file.  TEXT is the file's contents with each ':' and
+ * '\n' replaced by '\0'; the entries point into it.
+ *
+ * Entries with the same userid are chained, in file order, from
+ * BUCKETS[hash(userid)].
+ */
+
+#define NO_ENTRY UINT_MAX
+
+struct passwd_entry {
+	struct xauth_passwd_entry entry;
+	unsigned next;		/* in bucket, or NO_ENTRY */
+};
+
+static struct {
+	char *path;
+	struct stat stat;
+	char *text;
+	unsigned nr_entries;
+	struct passwd_entry *entries;
+	unsigned nr_buckets;	/* power of 2 */
+	unsigned *buckets;	/* first entry, or NO_ENTRY */
+	unsigned *tails;	/* last entry, or NO_ENTRY */
+} passwd;
+
+static unsigned bucket(const char *userid)
+{
+	hash_t hash = hash_bytes(userid, strlen(userid), zero_hash);
+	return hash.hash & (passwd.nr_buckets - 1);
+}
+
+void free_xauth_passwd(void)
+{
+	pfreeany(passwd.path);
+	pfreeany(passwd.text);
+	pfreeany(passwd.entries);
+	pfreeany(passwd.buckets);
+	pfreeany(passwd.tails);
+	zero(&passwd);
+}
+
+static bool same_file(const struct stat *l, const struct stat *r)
+{
+	return (l->st_dev == r->st_dev &&
+		l->st_ino == r->st_ino &&
+		l->st_size == r->st_size &&
+		l->st_mtim.tv_sec == r->st_mtim.tv_sec &&
+		l->st_mtim.tv_nsec == r->st_mtim.tv_nsec);
+}
+
+static char *read_passwd(const char *path, struct stat *st, struct logger *logger)
+{
+	int fd = open(path, O_RDONLY|O_CLOEXEC);
+	if (fd < 0) {
+		/* unable to open the password file */
+		llog(RC_LOG, logger,
+		     "XAUTH: unable to open password file (%s) for verification",
+		     path);
+		return NULL;
+	}
+
+	if (fstat(fd, st) != 0) {
+		llog_errno(RC_LOG, logger, errno,
+			   "XAUTH: unable to stat password file (%s): ", path);
+		close(fd);
+		return NULL;
+	}
+
+	size_t size = st->st_size;
+	char *text = alloc_bytes(size + 1, "xauth passwd text");
+	size_t len = 0;
+	while (len < size) {
+		ssize_t n = read(fd, text + len, size - len);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			llog_errno(RC_LOG, logger, (n < 0 ? errno : 0),
+				   "XAUTH: unable to read password file (%s): ", path);
+			pfree(text);
+			close(fd);
+			return NULL;
+		}
+		len += n;
+	}
+	text[len] = '\0';
+	close(fd);
+	return text;
+}
+
+static bool load_passwd(const char *path, struct logger *logger)
+{
+	struct stat st;
+	char *text = read_passwd(path, &st, logger);
+	if (text == NULL) {
+		free_xauth_passwd();
+		return false;
+	}
+
+	free_xauth_passwd();
+	passwd.path = clone_str(path, "xauth passwd path");
+	passwd.stat = st;
+	passwd.text = text;
+
+	/* upper bound on entries */
+	unsigned nr_lines = 1;
+	for (const char *c = text; *c != '\0'; c++) {
+		if (*c == '\n') {
+			nr_lines++;
+		}
+	}
+	passwd.entries = alloc_things(struct passwd_entry, nr_lines, "xauth passwd entries");
+
+	/** simple stuff read in a line then go through positioning
+	 * userid, passwd and conniectionname at the beginning of each of the
+	 * memory locations of our real data and replace the ':' with '\0'
+	 */
+
+	unsigned lineno = 0;
+	char *line = text;
+	while (*line != '\0') {
+		char *p;	/* current position */
+		lineno++;
+
+		/* terminate line; (optional: we accept a partial last line) */
+		char *next = strchr(line, '\n');
+		if (next != NULL) {
+			*next++ = '\0';
+		} else {
+			next = line + strlen(line);
+		}
+
+		/* ignore empty or comment line */
+		if (*line == '\0' || *line == '#') {
+			line = next;
+			continue;
+		}
+
+		/* get userid */
+		char *userid = line;
+		p = strchr(userid, ':');	/* find end */
+		if (p == NULL) {
+			/* no end: skip line */
+			llog(RC_LOG, logger,
+			     "XAUTH: %s:%d missing password hash field",
+			     path, lineno);
+			line = next;
+			continue;
+		}
+
+		*p++ ='\0'; /* terminate string by overwriting : */
+
+		/* get password hash */
+		char *passwdhash = p;
+		char *connectionname = NULL;
+		char *addresspool = NULL;
+		p = strchr(passwdhash, ':'); /* find end */
+		if (p != NULL) {
+			/* optional connectionname */
+			*p++='\0';     /* terminate string by overwriting : */
+			connectionname = p;
+			p = strchr(connectionname, ':'); /* find end */
+			/* ??? any whitespace is included */
+		}
+
+		if (p != NULL) {
+			/* optional addresspool */
+			*p++ ='\0'; /* terminate connectionname string by overwriting : */
+			addresspool = p;
+		}
+
+		/* now connnectionname is terminated; set to NULL if empty */
+		if (connectionname != NULL && connectionname[0] == '\0')
+			connectionname = NULL;
+		if (addresspool != NULL && addresspool[0] == '\0')
+			addresspool = NULL;
+
+		passwd.entries[passwd.nr_entries++] = (struct passwd_entry) {
+			.entry = {
+				.userid = userid,
+				.passwdhash = passwdhash,
+				.connname = connectionname,
+				.addresspool = addresspool,
+				.lineno = lineno,
+			},
+			.next = NO_ENTRY,
+		};
+		line = next;
+	}
+
+	/* size the table so chains are short */
+	passwd.nr_buckets = 16;
+	while (passwd.nr_buckets < passwd.nr_entries) {
+		passwd.nr_buckets <<= 1;
+	}
+	passwd.buckets = alloc_things(unsigned, passwd.nr_buckets, "xauth passwd buckets");
+	passwd.tails = alloc_things(unsigned, passwd.nr_buckets, "xauth passwd tails");
+	for (unsigned b = 0; b < passwd.nr_buckets; b++) {
+		passwd.buckets[b] = passwd.tails[b] = NO_ENTRY;
+	}
+
+	/* append, so each chain stays in file order */
+	for (unsigned e = 0; e < passwd.nr_entries; e++) {
+		unsigned b = bucket(passwd.entries[e].entry.userid);
+		if (passwd.tails[b] == NO_ENTRY) {
+			passwd.buckets[b] = e;
+		} else {
+			passwd.entries[passwd.tails[b]].next = e;
+		}
+		passwd.tails[b] = e;
+	}
+
+	llog(RC_LOG, logger, "XAUTH: password file (%s) loaded, %u entries",
+	     path, passwd.nr_entries);
+	return true;
+}
+
+bool xauth_passwd_lookup(const char *name, const char *connname,
+			 struct xauth_passwd_entry **entries,
+			 unsigned *nr_entries,
+			 struct logger *logger)
+{
+	*entries = NULL;
+	*nr_entries = 0;
+
+	char *path = alloc_printf("%s/passwd", config_setup_ipsecdir()); /* must free */
+
+	struct stat st;
+	bool fresh = (passwd.path != NULL &&
+		      streq(passwd.path, path) &&
+		      stat(path, &st) == 0 &&
+		      same_file(&st, &passwd.stat));
+	if (!fresh && !load_passwd(path, logger)) {
+		pfree(path);
+		return false;
+	}
+	pfree(path);
+
+	/* count, then copy, the matches */
+	for (unsigned pass = 0; pass < 2; pass++) {
+		unsigned nr = 0;
+		for (unsigned e = passwd.buckets[bucket(name)];
+		     e != NO_ENTRY; e = passwd.entries[e].next) {
+			const struct xauth_passwd_entry *entry = &passwd.entries[e].entry;
+
+			if (pass == 0) {
+				ldbg(logger, "XAUTH: found user(%s/%s) pass(%s) connid(%s/%s) addresspool(%s)",
+				     entry->userid, name, entry->passwdhash,
+				     entry->connname == NULL ? "" : entry->connname,
+				     connname,
+				     entry->addresspool == NULL ? "" : entry->addresspool);
+			}
+
+			/* If connectionname is null, it applies to all connections */
+			if (!streq(entry->userid, name) ||
+			    (entry->connname != NULL && !streq(entry->connname, connname))) {
+				continue;
+			}
+
+			if (pass == 1) {
+				(*entries)[nr] = (struct xauth_passwd_entry) {
+					.userid = clone_str(entry->userid, "xauth userid"),
+					.passwdhash = clone_str(entry->passwdhash, "xauth passwdhash"),
+					.connname = clone_str(entry->connname, "xauth connname"),
+					.addresspool = clone_str(entry->addresspool, "xauth addresspool"),
+					.lineno = entry->lineno,
+				};
+			}
+			nr++;
+		}
+		if (nr == 0) {
+			break;
+		}
+		if (pass == 0) {
+			*entries = alloc_things(struct xauth_passwd_entry, nr, "xauth entries");
+		}
+		*nr_entries = nr;
+	}
+
+	return true;
+}
+
+void free_xauth_passwd_entries(struct xauth_passwd_entry **entries,
+			       unsigned nr_entries)
+{
+	if (*entries == NULL) {
+		return;
+	}
+	for (unsigned e = 0; e < nr_entries; e++) {
+		struct xauth_passwd_entry *entry = &(*entries)[e];
+		pfreeany(entry->userid);
+		pfreeany(entry->passwdhash);
+		pfreeany(entry->connname);
+		pfreeany(entry->addresspool);
+	}
+	pfree(*entries);
+	*entries = NULL;
+}
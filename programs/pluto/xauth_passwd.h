@@ -0,0 +1,57 @@
+/* XAUTH password file, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#ifndef XAUTH_PASSWD_H
+#define XAUTH_PASSWD_H
+
+struct logger;
+
+/*
+ * An entry from $ipsecdir/passwd:
+ *
+ *	username:passwdhash[:connectioname[:addresspool]]
+ *
+ * CONNNAME and ADDRESSPOOL are NULL when empty or missing.
+ */
+
+struct xauth_passwd_entry {
+	char *userid;
+	char *passwdhash;
+	char *connname;
+	char *addresspool;
+	unsigned lineno;
+};
+
+/*
+ * Return, in file order, a copy of each entry for NAME that applies
+ * to connection CONNNAME; or NULL when there are none (*NR_ENTRIES is
+ * zero).
+ *
+ * The file is loaded into an in-memory table on first use and then
+ * re-loaded whenever stat() shows it has changed.  Returns false when
+ * the file can't be read.
+ */
+
+bool xauth_passwd_lookup(const char *name, const char *connname,
+			 struct xauth_passwd_entry **entries,
+			 unsigned *nr_entries,
+			 struct logger *logger);
+
+void free_xauth_passwd_entries(struct xauth_passwd_entry **entries,
+			       unsigned nr_entries);
+
+void free_xauth_passwd(void);
+
+#endif
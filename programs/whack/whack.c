@@ -104,7 +104,7 @@ static void help(void)
 		"	[--retransmit-interval <msecs>] \\\n"
 		"	[--send-redirect] [--redirect-to <ip>] \\\n"
 		"	[--accept-redirect] [--accept-redirect-to <ip>] \\\n"
-		"	[--replay-window <num>] \\\n"
+		"	[--replay-window <num>] [--ike-window <num>] \\\n"
 		"	[--esp <esp-algos>] \\\n"
 		"	[--remote-peer-type <cisco>] \\\n"
 		"	[--mtu <mtu>] \\\n"
@@ -197,6 +197,8 @@ static void help(void)
 		"\n"
 		"listen: whack (--listen | --unlisten)\n"
 		"\n"
+		"takeover: whack --takeover\n"
+		"\n"
 		"socket buffers: whack --ike-socket-bufsize <bufsize>\n"
 		"socket errqueue: whack --ike-socket-errqueue-toggle\n"
 		"\n"
@@ -411,6 +413,8 @@ enum opt {
 
 	OPT_DDNS,
 
+	OPT_TAKEOVER,
+
 	OPT_REREADSECRETS,
 	OPT_FETCHCRLS,
 	OPT_REREADCERTS,
@@ -548,6 +552,7 @@ enum opt {
 	CD_REKEYMARGIN,
 	CD_REKEYFUZZ,
 	CD_REPLAY_WINDOW,
+	CD_IKE_WINDOW,
 	CD_DPDDELAY,
 	CD_DPDTIMEOUT,
 	CD_OBSOLETE,
@@ -709,6 +714,7 @@ const struct option optarg_options[] = {
 	{ REPLACE_OPT("ddos-auto", "ddos-mode", "5.3"), no_argument, NULL, OPT_DDOS_AUTO },
 
 	{ "ddns\0", no_argument, NULL, OPT_DDNS },
+	{ OPT("takeover"), no_argument, NULL, OPT_TAKEOVER },
 
 	{ "rereadsecrets\0", no_argument, NULL, OPT_REREADSECRETS },
 	{ FATAL_OPT("rereadcrls", "5.0"), no_argument, NULL, 0, }, /* obsolete */
@@ -925,6 +931,7 @@ const struct option optarg_options[] = {
 	{ "rekeyfuzz\0", required_argument, NULL, CD_REKEYFUZZ },
 	{ IGNORE_OPT("keyingtries", "5.0"), required_argument, NULL, 0 },
 	{ "replay-window\0", required_argument, NULL, CD_REPLAY_WINDOW },
+	{ "ike-window\0", required_argument, NULL, CD_IKE_WINDOW },
 	{ "ike\0",    required_argument, NULL, CD_IKE },
 	{ "ikealg\0", required_argument, NULL, CD_IKE },
 	{ FATAL_OPT("pfsgroup", "5.3"), required_argument, NULL, 0 },
@@ -1279,6 +1286,10 @@ int main(int argc, char **argv)
 			whack_command(&msg, WHACK_DDNS);
 			continue;
 
+		case OPT_TAKEOVER:	/* --takeover */
+			whack_command(&msg, WHACK_TAKEOVER);
+			continue;
+
 		case OPT_LISTEN:	/* --listen */
 			whack_command(&msg, WHACK_LISTEN);
 			continue;
@@ -1790,6 +1801,10 @@ int main(int argc, char **argv)
 			msg.wm_replay_window = optarg;
 			continue;
 
+		case CD_IKE_WINDOW: /* --ike-window <num> */
+			msg.wm_ike_window = optarg;
+			continue;
+
 		case CD_SENDCA:	/* --sendca */
 			msg.wm_sendca = optarg;
 			continue;
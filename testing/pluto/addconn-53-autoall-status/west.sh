@@ -0,0 +1,7 @@
+/testing/guestbin/swan-prep
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec addconn --config $PWD/autoall.conf --autoall > /tmp/addconn.out 2> /tmp/addconn.err ; echo status=$?
+cat /tmp/addconn.err
+grep 'failed to add' /tmp/addconn.out
+ipsec connectionstatus | sed -n -e 's/^\("[^"]*"\):.*/\1/p' | sort -u
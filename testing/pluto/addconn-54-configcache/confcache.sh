@@ -0,0 +1,7 @@
+#!/bin/sh
+# load the config through the cache; show what the cache did and the
+# connections that were loaded
+ipsec addconn --config /tmp/confcache/ipsec.conf --configcache /tmp/confcache/ipsec.cache --debug --listall > /tmp/confcache/out 2> /tmp/confcache/err
+echo status=$?
+grep -o -e 'confcache: .*' -e 'using compiled config .*' /tmp/confcache/err
+cat /tmp/confcache/out
@@ -0,0 +1,19 @@
+/testing/guestbin/swan-prep
+mkdir -p /tmp/confcache
+cp cache.conf /tmp/confcache/ipsec.conf
+cp west-a.conf west-b.conf /tmp/confcache/
+# miss, no cache
+./confcache.sh
+# hit
+./confcache.sh
+# miss, a nested include changed
+cat west-c.conf >> /tmp/confcache/west-b.conf
+./confcache.sh
+./confcache.sh
+# miss, truncated
+truncate -s $(( $(stat -c %s /tmp/confcache/ipsec.cache) / 2 )) /tmp/confcache/ipsec.cache
+./confcache.sh
+# miss, corrupt (the strings are no longer terminated)
+printf X | dd of=/tmp/confcache/ipsec.cache bs=1 seek=$(( $(stat -c %s /tmp/confcache/ipsec.cache) - 1 )) conv=notrunc 2>/dev/null
+./confcache.sh
+./confcache.sh
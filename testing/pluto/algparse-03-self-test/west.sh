@@ -0,0 +1,20 @@
+../../guestbin/swan-prep
+
+# Fail HMAC_SHA1's test; only the PRF and the integrity algorithm
+# built on it should be disabled.
+
+ipsec algparse -v -ta -fail HMAC_SHA1 2>&1 | grep -e FAILED -e disabled | sed -e 's/ in .*s$//'
+
+# The default proposals drop SHA1; asking for it is an error.
+
+ipsec algparse -ta -fail HMAC_SHA1 -v1 ike esp ah
+ipsec algparse -ta -fail HMAC_SHA1 -v1 ike=aes-sha1 esp=aes-sha1
+
+# Fail AES_CBC's test; nothing is built on it.
+
+ipsec algparse -v -ta -fail AES_CBC 2>&1 | grep -e FAILED -e disabled | sed -e 's/ in .*s$//'
+
+# The default proposals using AES_CBC are dropped.
+
+ipsec algparse -ta -fail AES_CBC -v1 ike esp
+ipsec algparse -ta -fail AES_CBC -v2 ike esp
@@ -4,6 +4,7 @@ valgrind --quiet $(ipsec -n _authbycheck) > /dev/null || echo failed
 valgrind --quiet $(ipsec -n _jambufcheck) > /dev/null || echo failed
 valgrind --quiet $(ipsec -n _timecheck) > /dev/null || echo failed
 valgrind --quiet $(ipsec -n _hunkcheck) > /dev/null || echo failed
+valgrind --quiet $(ipsec -n _slabcheck) > /dev/null || echo failed
 valgrind --quiet $(ipsec -n _dncheck) > /dev/null || echo failed
 valgrind --quiet $(ipsec -n _keyidcheck) > /dev/null || echo failed
 valgrind --quiet $(ipsec -n _asn1check) > /dev/null || echo failed
@@ -0,0 +1,7 @@
+/testing/guestbin/swan-prep --nokey
+../../guestbin/wait-until-alive -I 192.0.1.254 192.0.2.254
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec add westnet-eastnet
+ipsec route westnet-eastnet
+echo "initdone"
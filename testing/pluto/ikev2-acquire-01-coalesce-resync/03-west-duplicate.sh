@@ -0,0 +1,9 @@
+# Each acquire is seen twice; the repeat is coalesced.
+
+ipsec whack --impair xfrm_event_duplicate
+../../guestbin/ping-once.sh --forget -I 192.0.1.254 192.0.2.254
+../../guestbin/wait-for.sh --match westnet-eastnet -- ipsec whack --trafficstatus
+ipsec whack --no-impair xfrm_event_duplicate
+grep -c -e '^| queued (1 in queue) ' /tmp/pluto.log
+grep -c -e '^| coalescing repeated ' /tmp/pluto.log
+ipsec down westnet-eastnet
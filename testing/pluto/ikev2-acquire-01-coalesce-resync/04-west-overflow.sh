@@ -0,0 +1,9 @@
+# The acquire is lost; it is recovered from the SADB dump.
+
+ipsec whack --impair xfrm_event_overflow
+../../guestbin/ping-once.sh --forget -I 192.0.1.254 192.0.2.254
+../../guestbin/wait-for-pluto.sh 'kernel: recovered lost initiate on-demand'
+ipsec whack --no-impair xfrm_event_overflow
+../../guestbin/wait-for.sh --match westnet-eastnet -- ipsec whack --trafficstatus
+../../guestbin/ping-once.sh --up -I 192.0.1.254 192.0.2.254
+grep -e 'dump returned' /tmp/pluto.log | sed -e 's/ [0-9]* entries/ N entries/'
@@ -0,0 +1,11 @@
+/testing/guestbin/swan-prep --nokey
+
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec add a0
+ipsec add a1
+ipsec add a2
+ipsec add a3
+ipsec add a4
+ipsec add a5
+echo "initdone"
@@ -0,0 +1,23 @@
+ipsec up a0
+../../guestbin/ping-once.sh --up -I 192.0.1.254 192.0.2.254
+
+# Block the CREATE_CHILD_SA requests so that the Child SAs stay
+# larval.
+
+ipsec whack --impair block_outbound
+ipsec up a1 --asynchronous
+ipsec up a2 --asynchronous
+ipsec up a3 --asynchronous
+ipsec up a4 --asynchronous
+ipsec up a5 --asynchronous
+../../guestbin/wait-for-outbound.sh 1
+
+# Each connection is found in the index; A3 is refused.
+
+ipsec up a3
+
+# Release the requests.
+
+ipsec whack --no-impair block_outbound
+../../guestbin/drip-outbound.sh 1 '#3: initiator established Child SA using #1'
+../../guestbin/wait-for-pluto.sh '#7: initiator established Child SA using #1'
@@ -0,0 +1 @@
+ipsec trafficstatus | cut -d, -f1
@@ -0,0 +1,10 @@
+/testing/guestbin/swan-prep --nokey
+
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec add east-a
+ipsec add east-b
+ipsec add east-c
+ipsec add east-d
+ipsec add east-e
+echo "initdone"
@@ -0,0 +1,11 @@
+/testing/guestbin/swan-prep --nokey
+
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec add west-a
+ipsec add west-b
+ipsec add west-c
+ipsec add west-d
+ipsec add west-e
+ipsec route west-d
+echo "initdone"
@@ -0,0 +1,16 @@
+# west-a uses up the budget; the rest are queued.
+ipsec up --asynchronous west-a
+ipsec up --asynchronous west-b
+ipsec up --asynchronous west-c
+ipsec whack --asynchronous --oppohere 192.0.1.254 --oppothere 192.0.22.254
+ipsec up --asynchronous west-e
+ipsec whack --globalstatus | grep -e pacer
+
+# west-e jumps the queue; its queued initiate is flushed
+ipsec up west-e
+grep '^| pacer: flushing queued start initiate' /tmp/pluto.log
+
+# ondemand is released before start
+../../guestbin/wait-for-pluto.sh '"west-c" #[0-9]*: initiator established Child SA'
+grep -v '^|' /tmp/pluto.log | grep -e 'initiating IKEv2 connection' | sed -e 's/ to 192.*//'
+ipsec whack --globalstatus | grep -e pacer
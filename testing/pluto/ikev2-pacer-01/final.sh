@@ -0,0 +1 @@
+ipsec showstates | grep -e '#[0-9]*:.*STATE_V2_ESTABLISHED_IKE_SA' | sed -e 's/ .*:500//' | sort
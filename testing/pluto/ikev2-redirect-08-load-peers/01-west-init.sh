@@ -0,0 +1,15 @@
+/testing/guestbin/swan-prep --nokey
+
+# WEST's own pluto isn't started; a and b each get a namespace.
+
+ip netns add a
+ip netns add b
+ip netns exec a ../../guestbin/ip.sh link set dev lo up
+ip netns exec b ../../guestbin/ip.sh link set dev lo up
+mkdir -p /tmp/a /tmp/b
+ip netns exec a ipsec pluto --config /testing/pluto/ikev2-redirect-08-load-peers/a.conf --rundir /tmp/a
+ip netns exec b ipsec pluto --config /testing/pluto/ikev2-redirect-08-load-peers/b.conf --rundir /tmp/b
+../../guestbin/wait-for.sh --match 'exchanging load' -- cat /tmp/a.log
+../../guestbin/wait-for.sh --match 'exchanging load' -- cat /tmp/b.log
+stat -c '%a %U' /tmp/a.sock /tmp/b.sock
+echo "initdone"
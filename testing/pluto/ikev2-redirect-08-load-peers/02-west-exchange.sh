@@ -0,0 +1,20 @@
+# Each hears from the other.
+
+../../guestbin/wait-for.sh --match 'reports=[1-9]' -- ipsec whack --rundir /tmp/a --status | sed -e 's/reports=[0-9]*/reports=N/'
+../../guestbin/wait-for.sh --match 'reports=[1-9]' -- ipsec whack --rundir /tmp/b --status | sed -e 's/reports=[0-9]*/reports=N/'
+
+# A report from a socket that isn't a peer's is ignored.
+
+echo 'load 100' | socat - UNIX-SENDTO:/tmp/a.sock,bind=/tmp/x.sock
+../../guestbin/wait-for.sh --match 'unknown sender' -- cat /tmp/a.log
+
+# With B stopped, a non-root user binding B's path can't reach A's
+# socket; and, were it accessible, its report is still ignored.
+
+ipsec whack --rundir /tmp/b --shutdown
+runuser -u nobody -- sh -c "echo 'load 100' | socat - UNIX-SENDTO:/tmp/a.sock,bind=/tmp/b.sock" 2>&1 | grep -o 'Permission denied'
+rm -f /tmp/b.sock
+chmod 666 /tmp/a.sock
+runuser -u nobody -- sh -c "echo 'load 100' | socat - UNIX-SENDTO:/tmp/a.sock,bind=/tmp/b.sock"
+../../guestbin/wait-for.sh --match 'uid 65534' -- cat /tmp/a.log | sed -e 's/pid [0-9]*/pid PID/'
+grep -e 'reports load 100' /tmp/a.log
@@ -0,0 +1,3 @@
+ipsec whack --rundir /tmp/a --shutdown
+ip netns del a
+ip netns del b
@@ -0,0 +1,7 @@
+ipsec up west-a > /dev/null
+ipsec up west-b > /dev/null
+ipsec up west-c > /dev/null
+
+# the three Child SAs rekey 1500s in (1200-1500s from now); the IKE
+# SA 3300s in.
+ipsec whack --globalstatus | grep -e rekey | grep -v -e '=0$' -e moved
@@ -0,0 +1,24 @@
+/testing/guestbin/swan-prep --nokey
+
+# WEST's own pluto isn't started; the active gets WEST's public
+# interface.
+
+ip netns add active
+ip netns add standby
+ip netns exec active ../../guestbin/ip.sh link set dev lo up
+ip netns exec standby ../../guestbin/ip.sh link set dev lo up
+../../guestbin/ip.sh link set eth1 netns active
+./netns.sh active
+
+# The standby, started first, creates the key-wrapping key in the
+# shared NSS DB; the active finds it.
+
+mkdir -p /tmp/standby /tmp/active
+ip netns exec standby ipsec pluto --config /testing/pluto/ikev2-replication-01-netns/standby.conf --rundir /tmp/standby
+../../guestbin/wait-for.sh --match 'standing by' -- cat /tmp/standby.log
+ip netns exec standby ipsec addconn --config /testing/pluto/ikev2-replication-01-netns/standby.conf --ctlsocket /tmp/standby/pluto.ctl west
+ip netns exec active ipsec pluto --config /testing/pluto/ikev2-replication-01-netns/active.conf --rundir /tmp/active
+../../guestbin/wait-for.sh --match 'connected to standby' -- cat /tmp/active.log
+ip netns exec active ipsec addconn --config /testing/pluto/ikev2-replication-01-netns/active.conf --ctlsocket /tmp/active/pluto.ctl west
+grep -c "created key-wrapping key" /tmp/standby.log /tmp/active.log
+echo "initdone"
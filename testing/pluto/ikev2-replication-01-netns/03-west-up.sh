@@ -0,0 +1,8 @@
+ip netns exec active ipsec whack --rundir /tmp/active --name west --initiate
+ip netns exec active ../../guestbin/ping-once.sh --up -I 192.0.1.254 192.0.2.254
+ip netns exec active ipsec whack --rundir /tmp/active --trafficstatus
+
+# The standby has both SAs.
+
+../../guestbin/wait-for.sh --match 'replication.child=1' -- ipsec whack --rundir /tmp/standby --globalstatus
+ipsec whack --rundir /tmp/standby --globalstatus | grep -e current.replication
@@ -0,0 +1,19 @@
+# The active fails, leaving EAST's SAs behind.
+
+kill -9 $(cat /tmp/active/pluto.pid)
+ip netns exec active ../../guestbin/ip.sh link set eth1 netns 1
+ip netns del active
+
+# The standby gets WEST's addresses and takes over.
+
+../../guestbin/ip.sh link set eth1 netns standby
+./netns.sh standby
+ipsec whack --rundir /tmp/standby --listen > /dev/null
+ipsec whack --rundir /tmp/standby --takeover
+../../guestbin/wait-for.sh --match 'adopted.child=1' -- ipsec whack --rundir /tmp/standby --globalstatus
+grep -e 'restored IKE SA' -e 'restored Child SA' /tmp/standby.log | sed -e 's/ {.*//'
+
+# Nothing was negotiated and traffic flows.
+
+grep -e 'sent IKE_SA_INIT' -e 'sent IKE_AUTH' /tmp/standby.log
+ip netns exec standby ../../guestbin/ping-once.sh --up -I 192.0.1.254 192.0.2.254
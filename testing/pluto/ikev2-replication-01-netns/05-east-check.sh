@@ -0,0 +1,4 @@
+# One IKE SA was negotiated; the Child SA was rekeyed by the standby.
+
+grep -c 'processing IKE_SA_INIT request' /tmp/pluto.log
+ipsec showstates | grep -e '#[0-9]*:.*STATE_V2_ESTABLISHED' | sed -e 's/ .*:500//' | sort
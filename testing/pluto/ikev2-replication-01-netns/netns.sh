@@ -0,0 +1,9 @@
+#!/bin/sh
+# arg is the namespace to give WEST's public interface and client
+# address
+name=$1
+
+ip netns exec $name ../../guestbin/ip.sh address add 192.1.2.45/24 dev eth1
+ip netns exec $name ../../guestbin/ip.sh link set dev eth1 up
+ip netns exec $name ../../guestbin/ip.sh address add 192.0.1.254/32 dev lo
+ip netns exec $name ../../guestbin/ip.sh route add 192.0.2.0/24 via 192.1.2.23
@@ -0,0 +1,7 @@
+/testing/guestbin/swan-prep --nokey
+
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec whack --impair record_inbound
+ipsec add east
+echo "initdone"
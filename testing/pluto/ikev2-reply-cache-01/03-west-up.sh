@@ -0,0 +1,3 @@
+ipsec up west
+
+# back to EAST
@@ -0,0 +1,9 @@
+# Inbound message 2 is the IKE_AUTH request (Message ID 1).
+
+# The first re-transmit is found by Message ID and then cached; the
+# second is answered from the cache.
+ipsec whack --impair drip_inbound:2
+ipsec whack --impair drip_inbound:2
+grep -e '^| reply cache:' -e 'duplicate Message ID' /tmp/pluto.log | sed -e 's/slot [0-9]*/slot N/'
+
+# back to WEST
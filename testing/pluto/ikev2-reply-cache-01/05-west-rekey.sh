@@ -0,0 +1,5 @@
+# The CREATE_CHILD_SA and INFORMATIONAL exchanges (Message IDs 2
+# and 3) replace the recorded IKE_AUTH response.
+ipsec whack --rekey-child --name west
+
+# back to EAST
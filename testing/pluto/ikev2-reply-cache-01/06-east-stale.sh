@@ -0,0 +1,4 @@
+# The cached IKE_AUTH request still hits, but the response it points
+# at has gone; the entry is dropped and the request is discarded.
+ipsec whack --impair drip_inbound:2
+grep -e '^| reply cache:' -e 'duplicate Message ID' /tmp/pluto.log | sed -e 's/slot [0-9]*/slot N/'
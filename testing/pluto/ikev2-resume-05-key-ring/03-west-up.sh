@@ -0,0 +1,4 @@
+# create snapshot
+ipsec up west-east
+../../guestbin/ping-once.sh --up -I 192.0.1.254 192.0.2.254
+ipsec whack --suspend --name west-east
@@ -0,0 +1,4 @@
+# roll over key three times; the key west used is still in the ring
+ipsec whack --impair trigger:EVENT_REINIT_SECRET
+ipsec whack --impair trigger:EVENT_REINIT_SECRET
+ipsec whack --impair trigger:EVENT_REINIT_SECRET
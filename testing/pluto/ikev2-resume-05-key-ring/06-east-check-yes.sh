@@ -0,0 +1,2 @@
+grep -e 'using session resume key' -e 'invalid ticket' /tmp/pluto.log
+ipsec whack --globalstatus | grep session_resume
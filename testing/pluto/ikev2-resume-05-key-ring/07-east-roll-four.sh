@@ -0,0 +1,5 @@
+# roll over key four times; looses key west used
+ipsec whack --impair trigger:EVENT_REINIT_SECRET
+ipsec whack --impair trigger:EVENT_REINIT_SECRET
+ipsec whack --impair trigger:EVENT_REINIT_SECRET
+ipsec whack --impair trigger:EVENT_REINIT_SECRET
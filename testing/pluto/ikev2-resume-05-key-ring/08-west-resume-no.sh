@@ -0,0 +1,3 @@
+# east has lost the key; revival kicks in
+ipsec up west-east
+../../guestbin/ping-once.sh --up -I 192.0.1.254 192.0.2.254
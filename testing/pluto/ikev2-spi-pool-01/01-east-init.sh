@@ -0,0 +1,6 @@
+/testing/guestbin/swan-prep --nokey
+../../guestbin/ifconfig.sh eth0 add 192.0.20.254/24
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec add east
+echo "initdone"
@@ -0,0 +1,6 @@
+/testing/guestbin/swan-prep --nokey
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec add west-a
+ipsec add west-b
+echo "initdone"
@@ -0,0 +1,8 @@
+# The first Child SA creates the pool and uses XFRM_MSG_ALLOCSPI.
+ipsec up west-a
+../../guestbin/wait-for.sh --match 'refilled to 16' -- grep -e '^| xfrm: SPI pool esp' /tmp/pluto.log
+ipsec _kernel state | grep -c -e 'spi 0x.* reqid 0 mode transport'
+
+# The second takes a pooled SPI.
+ipsec up west-b
+grep -c -e '^| xfrm: using pooled SPI' /tmp/pluto.log
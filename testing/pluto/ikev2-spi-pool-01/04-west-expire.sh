@@ -0,0 +1,8 @@
+# After 5 seconds the pooled SPIs are stale; they are deleted and,
+# since the pool was used recently, replaced.
+../../guestbin/wait-for.sh --match '^2$' -- grep -c -e '^| xfrm: SPI pool esp .* refilled to 16' /tmp/pluto.log
+
+# After 15 idle seconds the pool is emptied and released.
+../../guestbin/wait-for.sh --timeout 40 --match 'releasing idle SPI pool' -- grep -e '^| xfrm: releasing idle SPI pool' /tmp/pluto.log
+ipsec _kernel state | grep -c -e 'spi 0x.* reqid 0 mode transport'
+ipsec trafficstatus
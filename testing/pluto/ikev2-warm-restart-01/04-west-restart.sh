@@ -0,0 +1,22 @@
+# The checkpoint is private; its keys are wrapped.
+
+ipsec whack --shutdown --leave-state
+stat -c '%a %U' /run/pluto/pluto.checkpoint
+grep -c "created key-wrapping key" /tmp/pluto.log
+
+# Adding the connection re-adopts both SAs.
+
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec add west
+ipsec whack --globalstatus | grep -e warm_restart
+
+# Nothing was negotiated and traffic still flows.
+
+grep -e 'sent IKE_SA_INIT' -e 'sent IKE_AUTH' /tmp/pluto.log
+../../guestbin/ping-once.sh --up -I 192.0.1.254 192.0.2.254
+ipsec trafficstatus
+
+# The restored IKE SA's keys work.
+
+ipsec whack --rekey-child --name west
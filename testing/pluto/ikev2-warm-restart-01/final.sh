@@ -0,0 +1 @@
+ipsec showstates | grep -e '#[0-9]*:.*STATE_V2_ESTABLISHED' | sed -e 's/ .*:500//' | sort
@@ -0,0 +1,8 @@
+/testing/guestbin/swan-prep --nokey
+
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec whack --impair suppress_retransmits
+ipsec add west-a
+ipsec add west-b
+echo "initdone"
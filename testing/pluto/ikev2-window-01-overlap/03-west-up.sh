@@ -0,0 +1,8 @@
+# IKE_AUTH carries SET_WINDOW_SIZE both ways; west-b is then
+# established using CREATE_CHILD_SA (Message ID 2).
+
+ipsec up west-a
+ipsec up west-b
+grep -e 'peer window is' /tmp/pluto.log | sed -e 's/^.*peer window/peer window/'
+
+# back to EAST
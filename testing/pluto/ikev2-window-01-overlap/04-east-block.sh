@@ -0,0 +1,5 @@
+# On EAST, block the two rekey requests that are about to be sent.
+
+ipsec whack --impair block_inbound
+
+# back to WEST
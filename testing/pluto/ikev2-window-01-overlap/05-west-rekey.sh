@@ -0,0 +1,12 @@
+# Also block the responses, so they can be released out of order.
+
+ipsec whack --impair block_inbound
+
+# Rekey both Child SAs; the second request (Message ID 4) is sent
+# without waiting for the response to the first (Message ID 3).
+
+ipsec whack --rekey-child --name west-a --asynchronous
+ipsec whack --rekey-child --name west-b --asynchronous
+../../guestbin/wait-for-pluto.sh '#5: sent CREATE_CHILD_SA request to rekey Child SA #3'
+
+# back to EAST
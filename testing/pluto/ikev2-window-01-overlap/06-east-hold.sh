@@ -0,0 +1,17 @@
+../../guestbin/wait-for-pluto.sh 'IMPAIR: blocking inbound message 2'
+ipsec whack --no-impair block_inbound
+
+# Message ID 4 arrives first; it is decrypted and then held.
+ipsec whack --impair drip_inbound:2
+grep -o 'holding request [0-9]*' /tmp/pluto.log
+
+# Message ID 3 arrives; it is processed, followed by the held 4.
+ipsec whack --impair drip_inbound:1
+../../guestbin/wait-for-pluto.sh 'processing held request 4'
+
+# A retransmit of Message ID 3 is answered from the recorded
+# responses, not the last response.
+ipsec whack --impair drip_inbound:1
+../../guestbin/wait-for-pluto.sh 'duplicate Message ID 3; retransmitting response'
+
+# back to WEST
@@ -0,0 +1,8 @@
+../../guestbin/wait-for-pluto.sh 'IMPAIR: blocking inbound message 2'
+ipsec whack --no-impair block_inbound
+
+# The response to Message ID 4 arrives first, then 3.
+ipsec whack --impair drip_inbound:2
+ipsec whack --impair drip_inbound:1
+../../guestbin/wait-for-pluto.sh '#5: initiator rekeyed Child SA #3'
+../../guestbin/wait-for-pluto.sh '#4: initiator rekeyed Child SA #2'
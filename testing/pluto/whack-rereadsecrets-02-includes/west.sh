@@ -0,0 +1,13 @@
+/testing/guestbin/swan-prep
+cp a.secrets b.secrets /etc/ipsec.d/
+ipsec start
+../../guestbin/wait-until-pluto-started
+# nothing changed, nothing is parsed
+ipsec rereadsecrets
+ipsec whack --listpsks | grep PSK
+# @bob becomes @bot in place; size, inode and mtime are unchanged
+cp -p /etc/ipsec.d/b.secrets /tmp/b.secrets
+printf t | dd of=/etc/ipsec.d/b.secrets bs=1 seek=3 conv=notrunc 2>/dev/null
+touch -r /tmp/b.secrets /etc/ipsec.d/b.secrets
+ipsec rereadsecrets
+ipsec whack --listpsks | grep PSK
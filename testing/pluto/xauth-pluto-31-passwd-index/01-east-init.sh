@@ -0,0 +1,9 @@
+/testing/guestbin/swan-prep
+echo "xwest:xOzlFlqtwJIu2:other-conn" > /etc/ipsec.d/passwd
+echo "xwest:xAAAAAAAAAAAA:east-any" >> /etc/ipsec.d/passwd
+echo "xwest:xOzlFlqtwJIu2:east-any" >> /etc/ipsec.d/passwd
+echo "xwest:xOzlFlqtwJIu2" >> /etc/ipsec.d/passwd
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec auto --add east-any
+echo initdone
@@ -0,0 +1,5 @@
+/testing/guestbin/swan-prep
+ipsec start
+../../guestbin/wait-until-pluto-started
+ipsec auto --add west-east
+echo initdone
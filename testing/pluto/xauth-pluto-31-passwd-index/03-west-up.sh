@@ -0,0 +1,2 @@
+ipsec whack --xauthname 'xwest' --xauthpass 'use1pass' --name west-east --initiate
+ipsec down west-east
@@ -0,0 +1,3 @@
+# only the two east-any entries, in file order, were tried
+grep -o 'XAUTH: [a-z]* user([^)]*)' /tmp/pluto.log
+echo "xlate:xOzlFlqtwJIu2:east-any" >> /etc/ipsec.d/passwd
@@ -0,0 +1,2 @@
+ipsec whack --xauthname 'xlate' --xauthpass 'use1pass' --name west-east --initiate
+ipsec down west-east
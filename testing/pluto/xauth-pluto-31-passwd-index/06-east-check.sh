@@ -0,0 +1,3 @@
+# the changed file was re-loaded
+grep -o 'XAUTH: password file .* loaded, .*' /tmp/pluto.log
+grep -o 'XAUTH: [a-z]* user([^)]*)' /tmp/pluto.log
@@ -24,6 +24,7 @@
 #include "x509.h"
 #include "asn1.h"
 #include "lswalloc.h"		/* for leak_detective; */
+#include "lswlog.h"		/* for LDBGP() */
 
 int fails = 0;
 
@@ -257,12 +258,71 @@ static void dn_check(void)
 	}
 }
 
+static void match_check(struct logger *logger)
+{
+	static const struct test {
+		const char *a;
+		const char *b;
+		bool match;
+		int wildcards;
+		bool same_hash;
+	} tests[] = {
+		{ "CN=a, O=b", "CN=a, O=b", true, 0, true, },
+		{ "CN=a, O=b", "O=b, CN=a", true, 0, true, },
+		{ "CN=a, O=b", "o=B, cn=A", true, 0, true, },
+		{ "CN=a, O=b, C=CA", "C=CA, CN=a, O=b", true, 0, true, },
+		{ "CN=a, O=b", "O=b, CN=*", true, 1, false, },
+		{ "CN=a, OU=c, O=b", "OU=*, CN=*, O=b", true, 2, false, },
+		{ "CN=a, O=b", "O=b, CN=c", false, 0, false, },
+		{ "CN=a, O=b", "O=b, OU=a", false, 0, false, },
+		/* any order only needs B's RDNs */
+		{ "CN=a, O=b", "CN=a", true, 0, false, },
+		{ "CN=a", "CN=a, O=b", false, 0, false, },
+	};
+
+	for (size_t ti = 0; ti < elemsof(tests); ti++) {
+		const struct test *t = &tests[ti];
+		PRINT(stdout, " '%s' vs '%s'", t->a, t->b);
+
+		chunk_t a, b;
+		err_t err = atodn(t->a, &a);
+		if (err != NULL) {
+			FAIL(" atodn('%s') failed: %s", t->a, err);
+		}
+		err = atodn(t->b, &b);
+		if (err != NULL) {
+			free_chunk_content(&a);
+			FAIL(" atodn('%s') failed: %s", t->b, err);
+		}
+
+		struct verbose verbose = VERBOSE(DEBUG_STREAM, logger, NULL);
+		int wildcards;
+		bool match = match_dn_any_order_wild(ASN1(a), ASN1(b), &wildcards, verbose);
+		bool same_hash = (hash_dn(ASN1(a)) == hash_dn(ASN1(b)));
+		free_chunk_content(&a);
+		free_chunk_content(&b);
+
+		if (match != t->match) {
+			FAIL(" match_dn_any_order_wild() returned %s, expecting %s",
+			     bool_str(match), bool_str(t->match));
+		}
+		if (match && wildcards != t->wildcards) {
+			FAIL(" match_dn_any_order_wild() returned %d wildcards, expecting %d",
+			     wildcards, t->wildcards);
+		}
+		if (t->same_hash && !same_hash) {
+			FAIL(" hash_dn() differs for matching DNs");
+		}
+	}
+}
+
 int main(int argc UNUSED, char *argv[])
 {
 	leak_detective = true;
 	struct logger *logger = tool_logger(argc, argv);
 
 	dn_check();
+	match_check(logger);
 
 	if (report_leaks(logger)) {
 		fails++;
@@ -0,0 +1,302 @@
+/* test slab allocator, for libreswan
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.  See <https://www.gnu.org/licenses/gpl2.txt>.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ */
+
+#include <pthread.h>	/* pthread.h must be first include file */
+#include <stdio.h>
+#include <string.h>
+
+#include "lswcdefs.h"		/* for elemsof() */
+#include "lswlog.h"		/* for cur_debugging */
+#include "lswalloc.h"
+#include "lswtool.h"		/* for tool_logger() */
+
+/*
+ * These match lib/libswan/slab.c.
+ */
+#define SLAB_CHUNK_OBJECTS 64
+#define SLAB_CACHE_BATCH 16
+
+unsigned fails;
+
+#define FAIL(FMT, ...)							\
+	{								\
+		fails++;						\
+		fprintf(stderr, "%s:%d: "FMT"\n",			\
+			__func__, __LINE__, ##__VA_ARGS__);		\
+	}
+
+struct object {
+	unsigned owner;
+	unsigned nr;
+	char pad[40];
+};
+
+static struct slab_stats find_stats(const struct slab *slab)
+{
+	struct slab_stats stats[16];
+	unsigned nr = slab_stats(stats, elemsof(stats));
+	for (unsigned i = 0; i < nr && i < elemsof(stats); i++) {
+		if (streq(stats[i].name, slab->name)) {
+			return stats[i];
+		}
+	}
+	return (struct slab_stats) { .name = NULL, };
+}
+
+#define CHECK_STATS(SLAB, LIVE, PEAK, RESERVED)				\
+	{								\
+		struct slab_stats s_ = find_stats(SLAB);		\
+		if (s_.name == NULL) {					\
+			FAIL("slab %s missing from slab_stats()", (SLAB)->name); \
+		} else if (s_.live != (LIVE) ||				\
+			   s_.peak != (PEAK) ||				\
+			   s_.reserved != (RESERVED)) {			\
+			FAIL("slab %s: live=%ju peak=%ju reserved=%ju; expecting %u %u %u", \
+			     (SLAB)->name, s_.live, s_.peak, s_.reserved, \
+			     (LIVE), (PEAK), (RESERVED));		\
+		}							\
+	}
+
+/*
+ * Allocate a chunk's worth of objects on this thread, free them all
+ * on another thread, and then allocate them again on a third.
+ *
+ * The first thread refills its cache from the slab's free list a
+ * batch at a time.  The freeing thread's cache spills back to the
+ * free list each time it grows past two batches, so the third thread
+ * finds most of the objects there and only carves a new chunk once
+ * they are used up.
+ */
+
+static struct slab refill_slab = SLAB(struct object, "refill");
+static struct object *refill_objects[SLAB_CHUNK_OBJECTS];
+
+static void *free_refill_objects(void *arg UNUSED)
+{
+	FOR_EACH_ELEMENT(o, refill_objects) {
+		pfree_slab(&refill_slab, *o);
+		*o = NULL;
+	}
+	return NULL;
+}
+
+static unsigned nr_spilled(unsigned nr_freed)
+{
+	/* each spill happens at 2*BATCH+1 and leaves BATCH */
+	unsigned spilled = 0;
+	unsigned cached = 0;
+	for (unsigned i = 0; i < nr_freed; i++) {
+		cached++;
+		if (cached > 2 * SLAB_CACHE_BATCH) {
+			spilled += cached - SLAB_CACHE_BATCH;
+			cached = SLAB_CACHE_BATCH;
+		}
+	}
+	return spilled;
+}
+
+static void *realloc_refill_objects(void *arg UNUSED)
+{
+	unsigned spilled = nr_spilled(SLAB_CHUNK_OBJECTS);
+	for (unsigned i = 0; i < spilled; i++) {
+		refill_objects[i] = alloc_slab_thing(&refill_slab, struct object, "refill");
+	}
+	/* everything came from the free list */
+	CHECK_STATS(&refill_slab, spilled, SLAB_CHUNK_OBJECTS, SLAB_CHUNK_OBJECTS);
+	/* one more carves a new chunk */
+	refill_objects[spilled] = alloc_slab_thing(&refill_slab, struct object, "refill");
+	CHECK_STATS(&refill_slab, spilled + 1, SLAB_CHUNK_OBJECTS, 2 * SLAB_CHUNK_OBJECTS);
+	for (unsigned i = 0; i <= spilled; i++) {
+		pfree_slab(&refill_slab, refill_objects[i]);
+		refill_objects[i] = NULL;
+	}
+	return NULL;
+}
+
+static void check_refill_spill(void)
+{
+	FOR_EACH_ELEMENT(o, refill_objects) {
+		*o = alloc_slab_thing(&refill_slab, struct object, "refill");
+		if (*o == NULL) {
+			FAIL("allocation failed");
+			return;
+		}
+		(*o)->nr = o - refill_objects;
+	}
+	/* one chunk, refilled a batch at a time */
+	CHECK_STATS(&refill_slab, SLAB_CHUNK_OBJECTS, SLAB_CHUNK_OBJECTS, SLAB_CHUNK_OBJECTS);
+
+	/* objects are distinct and zeroed */
+	FOR_EACH_ELEMENT(o, refill_objects) {
+		for (struct object **p = refill_objects; p < o; p++) {
+			if (*p == *o) {
+				FAIL("object %td handed out twice", o - refill_objects);
+			}
+		}
+		if ((*o)->nr != (unsigned)(o - refill_objects) || (*o)->owner != 0) {
+			FAIL("object %td corrupt", o - refill_objects);
+		}
+	}
+
+	pthread_t t;
+	pthread_create(&t, NULL, free_refill_objects, NULL);
+	pthread_join(t, NULL);
+	CHECK_STATS(&refill_slab, 0, SLAB_CHUNK_OBJECTS, SLAB_CHUNK_OBJECTS);
+
+	pthread_create(&t, NULL, realloc_refill_objects, NULL);
+	pthread_join(t, NULL);
+	CHECK_STATS(&refill_slab, 0, SLAB_CHUNK_OBJECTS, 2 * SLAB_CHUNK_OBJECTS);
+}
+
+/*
+ * Several threads allocate, scribble on, and free objects, half of
+ * which were allocated by the previous thread in the ring.
+ */
+
+#define NR_THREADS 4
+#define NR_ROUNDS 200
+#define NR_OBJECTS 50
+
+static struct slab threads_slab = SLAB(struct object, "threads");
+
+static struct {
+	pthread_mutex_t mutex;
+	struct object *handoff[NR_THREADS][NR_OBJECTS];
+	unsigned nr_handoff[NR_THREADS];
+} ring = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static void *churn_objects(void *arg)
+{
+	unsigned me = (uintptr_t)arg;
+	unsigned next = (me + 1) % NR_THREADS;
+	struct object *mine[NR_OBJECTS];
+
+	for (unsigned round = 0; round < NR_ROUNDS; round++) {
+		for (unsigned i = 0; i < NR_OBJECTS; i++) {
+			mine[i] = alloc_slab_thing(&threads_slab, struct object, "threads");
+			if (mine[i]->owner != 0) {
+				FAIL("thread %u: object not zeroed", me);
+			}
+			mine[i]->owner = me + 1;
+			mine[i]->nr = i;
+			memset(mine[i]->pad, me, sizeof(mine[i]->pad));
+		}
+		for (unsigned i = 0; i < NR_OBJECTS; i++) {
+			if (mine[i]->owner != me + 1 || mine[i]->nr != i) {
+				FAIL("thread %u: object %u was changed", me, i);
+			}
+		}
+
+		/* free half; hand the rest to the next thread */
+		pthread_mutex_lock(&ring.mutex);
+		for (unsigned i = 0; i < NR_OBJECTS; i++) {
+			if (i % 2 == 0 && ring.nr_handoff[next] < NR_OBJECTS) {
+				ring.handoff[next][ring.nr_handoff[next]++] = mine[i];
+			} else {
+				pfree_slab(&threads_slab, mine[i]);
+			}
+		}
+		/* free what the previous thread handed over */
+		while (ring.nr_handoff[me] > 0) {
+			struct object *o = ring.handoff[me][--ring.nr_handoff[me]];
+			if (o->owner == 0 || o->owner == me + 1) {
+				FAIL("thread %u: handed its own object", me);
+			}
+			pfree_slab(&threads_slab, o);
+		}
+		pthread_mutex_unlock(&ring.mutex);
+	}
+	return NULL;
+}
+
+static void check_threads(void)
+{
+	pthread_t threads[NR_THREADS];
+	for (unsigned t = 0; t < NR_THREADS; t++) {
+		pthread_create(&threads[t], NULL, churn_objects, (void *)(uintptr_t)t);
+	}
+	for (unsigned t = 0; t < NR_THREADS; t++) {
+		pthread_join(threads[t], NULL);
+	}
+	/* drain what is left in the ring */
+	for (unsigned t = 0; t < NR_THREADS; t++) {
+		while (ring.nr_handoff[t] > 0) {
+			pfree_slab(&threads_slab, ring.handoff[t][--ring.nr_handoff[t]]);
+		}
+	}
+
+	struct slab_stats s = find_stats(&threads_slab);
+	if (s.live != 0) {
+		FAIL("threads: %ju objects still live", s.live);
+	}
+	if (s.peak < NR_OBJECTS || s.peak > NR_THREADS * NR_OBJECTS * 2) {
+		FAIL("threads: peak %ju out of range", s.peak);
+	}
+	if (s.reserved < s.peak) {
+		FAIL("threads: reserved %ju less than peak %ju", s.reserved, s.peak);
+	}
+}
+
+/*
+ * With leak-detective, each object is an individual allocation that
+ * report_leaks() can see; pfree() asserts that it was.  The counts
+ * are still kept, but nothing is reserved.
+ */
+
+static struct slab leak_slab = SLAB(struct object, "leak");
+
+static void check_leak_detective(void)
+{
+	bool old = leak_detective;
+	leak_detective = true;
+
+	struct object *a = alloc_slab_thing(&leak_slab, struct object, "leak a");
+	struct object *b = alloc_slab_thing(&leak_slab, struct object, "leak b");
+	CHECK_STATS(&leak_slab, 2, 2, 0);
+
+	pfree_slab(&leak_slab, a);
+	CHECK_STATS(&leak_slab, 1, 2, 0);
+
+	pfree_slab(&leak_slab, b);
+	CHECK_STATS(&leak_slab, 0, 2, 0);
+
+	leak_detective = old;
+}
+
+int main(int argc, char *argv[])
+{
+	struct logger *logger = tool_logger(argc, argv);
+
+	if (argc > 1) {
+		cur_debugging = -1;
+	}
+
+	check_refill_spill();
+	check_threads();
+	check_leak_detective();
+
+	if (report_leaks(logger)) {
+		fails++;
+	}
+
+	if (fails > 0) {
+		fprintf(stderr, "TOTAL FAILURES: %d\n", fails);
+		return 1;
+	} else {
+		return 0;
+	}
+}